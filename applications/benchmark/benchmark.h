@@ -0,0 +1,147 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <deal.II/base/types.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <string>
+
+/**
+ * The operators compared by cross_backend_benchmark, all on the unit cube
+ * refined globally:
+ * - mass: (u, v) with continuous Q_k elements,
+ * - laplace: (grad u, grad v) with continuous Q_k elements,
+ * - sipg: the symmetric interior penalty Laplacian of
+ *   StandardForms::sipg_laplace_form() with discontinuous Q_k elements,
+ * - schloegl: the Jacobian (grad e, grad v) + (3 u^2 e - alpha e, v) of
+ *   matrixfree_schloegl with continuous Q_k elements, linearized at the
+ *   function with the entries state_entry(i),
+ * - stokes: StandardForms::stokes_form() with Taylor-Hood elements
+ *   Q_k^dim x Q_{k-1}, k >= 2.
+ */
+enum class BenchmarkForm
+{
+  mass,
+  laplace,
+  sipg,
+  schloegl,
+  stokes
+};
+
+/// The parameter alpha of the Schloegl model
+constexpr double schloegl_alpha = 1.;
+
+inline std::string
+name(const BenchmarkForm form)
+{
+  switch (form)
+  {
+    case BenchmarkForm::mass:
+      return "mass";
+    case BenchmarkForm::laplace:
+      return "laplace";
+    case BenchmarkForm::sipg:
+      return "sipg";
+    case BenchmarkForm::schloegl:
+      return "schloegl";
+    case BenchmarkForm::stokes:
+      return "stokes";
+  }
+  return "unknown";
+}
+
+/**
+ * The lowest polynomial degree of <code>form</code>, the velocity degree
+ * for Stokes.
+ */
+inline unsigned int
+min_degree(const BenchmarkForm form)
+{
+  return form == BenchmarkForm::stokes ? 2 : 1;
+}
+
+/**
+ * Why the MeshWorker backend cannot evaluate <code>form</code>, empty if
+ * it can.
+ */
+inline std::string
+meshworker_limitation(const BenchmarkForm form)
+{
+  if (form == BenchmarkForm::stokes)
+    return "the MeshWorker backend has no divergence and pressure lift terminals";
+  return "";
+}
+
+/**
+ * The time of one operator application and its result for the source
+ * vector with the entries source_entry(i), in the numbering of the
+ * DoFHandler. For Stokes, the pressure follows the velocity, for the
+ * Schloegl Jacobian only the result for e is stored.
+ */
+struct BackendResult
+{
+  double seconds = 0.;
+  ::dealii::Vector<double> result;
+};
+
+/**
+ * The hand-written deal.II operator and the CFL MatrixFree operator share
+ * the MatrixFree object, so they differ only in the code evaluating the
+ * Forms.
+ */
+struct MatrixFreeResults
+{
+  unsigned int n_cells = 0;
+  ::dealii::types::global_dof_index n_dofs = 0;
+  BackendResult native;
+  BackendResult cfl;
+};
+
+inline double
+source_entry(const ::dealii::types::global_dof_index i)
+{
+  return std::sin(1. + i);
+}
+
+inline double
+state_entry(const ::dealii::types::global_dof_index i)
+{
+  return std::cos(2. + i);
+}
+
+/**
+ * The minimal time of <code>n_repetitions</code> calls of
+ * <code>apply</code> after one warm up call.
+ */
+template <class Apply>
+double
+time_vmult(const Apply& apply, const unsigned int n_repetitions)
+{
+  apply();
+  double time = std::numeric_limits<double>::max();
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    apply();
+    time = std::min(
+      time, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  }
+  return time;
+}
+
+MatrixFreeResults
+run_matrixfree(BenchmarkForm form, int dim, unsigned int degree, unsigned int refine,
+               unsigned int n_repetitions);
+
+/**
+ * Only for the forms without meshworker_limitation().
+ */
+BackendResult
+run_meshworker(BenchmarkForm form, int dim, unsigned int degree, unsigned int refine,
+               unsigned int n_repetitions);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,579 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "benchmark.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+
+#include <cfl/matrixfree/auto_tuner.h>
+#include <cfl/matrixfree/degree_dispatch.h>
+#include <cfl/matrixfree/fe_data.h>
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+#include <cfl/matrixfree/matrix_free_integrator.h>
+#include <cfl/matrixfree/standard_forms.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+namespace
+{
+/**
+ * The operators of BenchmarkForm written directly with FEEvaluation and
+ * FEFaceEvaluation, like the LaplaceOperator of deal.II's step-37.
+ */
+template <int dim, unsigned int degree, BenchmarkForm form>
+class NativeOperator
+  : public MatrixFreeOperators::Base<dim, LinearAlgebra::distributed::Vector<double>>
+{
+public:
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+  void
+  compute_diagonal() override
+  {
+    AssertThrow(false, ExcNotImplemented());
+  }
+
+private:
+  void
+  apply_add(VectorType& dst, const VectorType& src) const override
+  {
+    if constexpr(form == BenchmarkForm::sipg)
+      this->data->loop(&NativeOperator::local_apply_cell,
+                       &NativeOperator::local_apply_face,
+                       &NativeOperator::local_apply_boundary,
+                       this,
+                       dst,
+                       src,
+                       false,
+                       MatrixFree<dim, double>::DataAccessOnFaces::gradients,
+                       MatrixFree<dim, double>::DataAccessOnFaces::gradients);
+    else
+      this->data->cell_loop(&NativeOperator::local_apply_cell, this, dst, src);
+  }
+
+  void
+  local_apply_cell(const MatrixFree<dim, double>& data, VectorType& dst, const VectorType& src,
+                   const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    constexpr bool values = form == BenchmarkForm::mass;
+    FEEvaluation<dim, degree> phi(data);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi.reinit(cell);
+      phi.read_dof_values(src);
+      phi.evaluate(values, !values);
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+        if constexpr(values)
+          phi.submit_value(phi.get_value(q), q);
+        else
+          phi.submit_gradient(phi.get_gradient(q), q);
+      phi.integrate(values, !values);
+      phi.distribute_local_to_global(dst);
+    }
+  }
+
+  void
+  local_apply_face(const MatrixFree<dim, double>& data, VectorType& dst, const VectorType& src,
+                   const std::pair<unsigned int, unsigned int>& face_range) const
+  {
+    FEFaceEvaluation<dim, degree> phi_p(data, true);
+    FEFaceEvaluation<dim, degree> phi_m(data, false);
+    for (unsigned int face = face_range.first; face < face_range.second; ++face)
+    {
+      phi_p.reinit(face);
+      phi_m.reinit(face);
+      phi_p.read_dof_values(src);
+      phi_m.read_dof_values(src);
+      phi_p.evaluate(true, true);
+      phi_m.evaluate(true, true);
+      for (unsigned int q = 0; q < phi_p.n_q_points; ++q)
+      {
+        const auto jump = phi_p.get_value(q) - phi_m.get_value(q);
+        const auto value_flux =
+          jump - 0.5 * (phi_p.get_normal_derivative(q) - phi_m.get_normal_derivative(q));
+        phi_p.submit_value(value_flux, q);
+        phi_m.submit_value(-value_flux, q);
+        phi_p.submit_normal_derivative(-0.5 * jump, q);
+        phi_m.submit_normal_derivative(0.5 * jump, q);
+      }
+      phi_p.integrate(true, true);
+      phi_m.integrate(true, true);
+      phi_p.distribute_local_to_global(dst);
+      phi_m.distribute_local_to_global(dst);
+    }
+  }
+
+  void
+  local_apply_boundary(const MatrixFree<dim, double>& data, VectorType& dst,
+                       const VectorType& src,
+                       const std::pair<unsigned int, unsigned int>& face_range) const
+  {
+    FEFaceEvaluation<dim, degree> phi(data, true);
+    for (unsigned int face = face_range.first; face < face_range.second; ++face)
+    {
+      phi.reinit(face);
+      phi.read_dof_values(src);
+      phi.evaluate(true, true);
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+      {
+        const auto value = phi.get_value(q);
+        phi.submit_value(2. * value - phi.get_normal_derivative(q), q);
+        phi.submit_normal_derivative(-value, q);
+      }
+      phi.integrate(true, true);
+      phi.distribute_local_to_global(dst);
+    }
+  }
+};
+
+/**
+ * The finite element, the FEDatas and the Forms of the CFL operator, taken
+ * from StandardForms such that the integrators for the degrees compiled
+ * into libcfl are reused.
+ */
+template <int dim, unsigned int degree, BenchmarkForm form>
+struct CFLOperator
+{
+  using FiniteElementType = FE_Q<dim>;
+  using Standard = std::conditional_t<form == BenchmarkForm::mass,
+                                      StandardForms::Mass<dim, degree, double>,
+                                      StandardForms::Laplace<dim, degree, double>>;
+
+  static auto
+  forms()
+  {
+    if constexpr(form == BenchmarkForm::mass)
+      return StandardForms::mass_form<dim>();
+    else
+      return StandardForms::laplace_form<dim>();
+  }
+
+  static typename Standard::FEDatasType
+  fe_datas(const FiniteElementType& fe)
+  {
+    FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+    return typename Standard::FEDatasType{ fedata };
+  }
+};
+
+template <int dim, unsigned int degree>
+struct CFLOperator<dim, degree, BenchmarkForm::sipg>
+{
+  using FiniteElementType = FE_DGQ<dim>;
+  using Standard = StandardForms::SIPGLaplace<dim, degree, double>;
+
+  static auto
+  forms()
+  {
+    return StandardForms::sipg_laplace_form<dim>();
+  }
+
+  static typename Standard::FEDatasType
+  fe_datas(const FiniteElementType& fe)
+  {
+    FEDataFace<FE_DGQ, degree, 1, dim, 0, degree> fedata_face(fe);
+    FEData<FE_DGQ, degree, 1, dim, 0, degree> fedata(fe);
+    return (fedata_face, fedata);
+  }
+};
+
+/**
+ * The Jacobian of BenchmarkForm::schloegl written with FEEvaluation. The
+ * linearization point is read with the second DoFHandler of the MatrixFree
+ * object, like the FE function u of the CFL Forms.
+ */
+template <int dim, unsigned int degree>
+class NativeSchloeglJacobian
+{
+public:
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+  void
+  initialize(std::shared_ptr<const MatrixFree<dim, double>> data_, const VectorType& state_)
+  {
+    data = std::move(data_);
+    state = state_;
+    state.update_ghost_values();
+  }
+
+  void
+  vmult(VectorType& dst, const VectorType& src) const
+  {
+    data->cell_loop(&NativeSchloeglJacobian::local_apply_cell, this, dst, src, true);
+  }
+
+private:
+  void
+  local_apply_cell(const MatrixFree<dim, double>& data, VectorType& dst, const VectorType& src,
+                   const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    FEEvaluation<dim, degree> phi(data, 0);
+    FEEvaluation<dim, degree> phi_state(data, 1);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi.reinit(cell);
+      phi.read_dof_values(src);
+      phi.evaluate(true, true);
+      phi_state.reinit(cell);
+      phi_state.read_dof_values(state);
+      phi_state.evaluate(true, false);
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+      {
+        const auto u = phi_state.get_value(q);
+        phi.submit_value((3. * u * u - schloegl_alpha) * phi.get_value(q), q);
+        phi.submit_gradient(phi.get_gradient(q), q);
+      }
+      phi.integrate(true, true);
+      phi.distribute_local_to_global(dst);
+    }
+  }
+
+  std::shared_ptr<const MatrixFree<dim, double>> data;
+  VectorType state;
+};
+
+/**
+ * BenchmarkForm::stokes written with FEEvaluation, the velocity of degree
+ * <code>degree</code> on the first and the pressure on the second
+ * DoFHandler of the MatrixFree object.
+ */
+template <int dim, unsigned int degree>
+class NativeStokes
+{
+public:
+  using VectorType = LinearAlgebra::distributed::BlockVector<double>;
+
+  void
+  initialize(std::shared_ptr<const MatrixFree<dim, double>> data_)
+  {
+    data = std::move(data_);
+  }
+
+  void
+  vmult(VectorType& dst, const VectorType& src) const
+  {
+    data->cell_loop(&NativeStokes::local_apply_cell, this, dst, src, true);
+  }
+
+private:
+  void
+  local_apply_cell(const MatrixFree<dim, double>& data, VectorType& dst, const VectorType& src,
+                   const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    FEEvaluation<dim, degree, degree + 1, dim> velocity(data, 0);
+    FEEvaluation<dim, degree - 1, degree + 1, 1> pressure(data, 1);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      velocity.reinit(cell);
+      velocity.read_dof_values(src.block(0));
+      velocity.evaluate(false, true);
+      pressure.reinit(cell);
+      pressure.read_dof_values(src.block(1));
+      pressure.evaluate(true, false);
+      for (unsigned int q = 0; q < velocity.n_q_points; ++q)
+      {
+        const auto symmetric_gradient = velocity.get_symmetric_gradient(q);
+        const auto p = pressure.get_value(q);
+        Tensor<2, dim, VectorizedArray<double>> flux;
+        for (unsigned int d = 0; d < dim; ++d)
+        {
+          for (unsigned int e = 0; e < dim; ++e)
+            flux[d][e] = symmetric_gradient[d][e];
+          flux[d][d] += p;
+        }
+        pressure.submit_value(velocity.get_divergence(q), q);
+        velocity.submit_gradient(flux, q);
+      }
+      velocity.integrate(false, true);
+      velocity.distribute_local_to_global(dst.block(0));
+      pressure.integrate(true, false);
+      pressure.distribute_local_to_global(dst.block(1));
+    }
+  }
+
+  std::shared_ptr<const MatrixFree<dim, double>> data;
+};
+
+/**
+ * Copy the first <code>n_blocks</code> blocks of <code>vector</code> one
+ * after the other into a Vector in the numbering of the DoFHandlers.
+ */
+Vector<double>
+gather(const LinearAlgebra::distributed::BlockVector<double>& vector, const unsigned int n_blocks)
+{
+  types::global_dof_index size = 0;
+  for (unsigned int b = 0; b < n_blocks; ++b)
+    size += vector.block(b).size();
+  Vector<double> result(size);
+  types::global_dof_index offset = 0;
+  for (unsigned int b = 0; b < n_blocks; ++b)
+  {
+    const auto& block = vector.block(b);
+    for (unsigned int i = 0; i < block.local_size(); ++i)
+      result[offset + block.get_partitioner()->local_to_global(i)] = block.local_element(i);
+    offset += block.size();
+  }
+  return result;
+}
+
+/**
+ * The additional data of a MatrixFree object for the cell terms of the
+ * forms without face integrals, as in MatrixFreeData without tuning.
+ */
+template <int dim>
+typename MatrixFree<dim, double>::AdditionalData
+cell_additional_data()
+{
+  typename MatrixFree<dim, double>::AdditionalData additional_data;
+  ExecutionParameters().apply(additional_data);
+  additional_data.mapping_update_flags = update_gradients | update_JxW_values;
+  return additional_data;
+}
+
+template <int dim, unsigned int degree, BenchmarkForm form>
+MatrixFreeResults
+run(unsigned int refine, unsigned int n_repetitions)
+{
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  using CFLOperatorType = CFLOperator<dim, degree, form>;
+
+  Triangulation<dim> tr;
+  GridGenerator::hyper_cube(tr);
+  tr.refine_global(refine);
+  const typename CFLOperatorType::FiniteElementType fe(degree);
+  DoFHandler<dim> dof(tr);
+  dof.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  // face data for SIPG
+  auto additional_data = cell_additional_data<dim>();
+  if constexpr(form == BenchmarkForm::sipg)
+    {
+      additional_data.mapping_update_flags_inner_faces =
+        update_gradients | update_JxW_values | update_normal_vectors;
+      additional_data.mapping_update_flags_boundary_faces =
+        update_gradients | update_JxW_values | update_normal_vectors;
+    }
+  const MappingQGeneric<dim> mapping(1);
+  auto mf = std::make_shared<MatrixFree<dim, double>>();
+  mf->reinit(mapping, dof, constraints, QGauss<1>(degree + 1), additional_data);
+
+  NativeOperator<dim, degree, form> native;
+  native.initialize(mf);
+  typename CFLOperatorType::Standard::Integrator cfl;
+  cfl.initialize(mf,
+                 std::make_shared<typename CFLOperatorType::Standard::FormType>(
+                   CFLOperatorType::forms()),
+                 std::make_shared<typename CFLOperatorType::Standard::FEDatasType>(
+                   CFLOperatorType::fe_datas(fe)));
+
+  VectorType src, dst;
+  mf->initialize_dof_vector(src);
+  mf->initialize_dof_vector(dst);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = source_entry(src.get_partitioner()->local_to_global(i));
+
+  const auto measure = [&](const auto& op) {
+    BackendResult result;
+    result.seconds = time_vmult([&]() { op.vmult(dst, src); }, n_repetitions);
+    result.result.reinit(dof.n_dofs());
+    for (unsigned int i = 0; i < dst.local_size(); ++i)
+      result.result[dst.get_partitioner()->local_to_global(i)] = dst.local_element(i);
+    return result;
+  };
+
+  MatrixFreeResults results;
+  results.n_cells = tr.n_active_cells();
+  results.n_dofs = dof.n_dofs();
+  results.native = measure(native);
+  results.cfl = measure(cfl);
+  return results;
+}
+
+template <int dim, unsigned int degree>
+MatrixFreeResults
+run_schloegl(unsigned int refine, unsigned int n_repetitions)
+{
+  using BlockVectorType = LinearAlgebra::distributed::BlockVector<double>;
+
+  Triangulation<dim> tr;
+  GridGenerator::hyper_cube(tr);
+  tr.refine_global(refine);
+  const FE_Q<dim> fe(degree);
+  DoFHandler<dim> dof(tr);
+  dof.distribute_dofs(fe);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  // e and the linearization point u use the same DoFHandler
+  const MappingQGeneric<dim> mapping(1);
+  auto mf = std::make_shared<MatrixFree<dim, double>>();
+  mf->reinit(mapping,
+             std::vector<const DoFHandler<dim>*>{ &dof, &dof },
+             std::vector<const AffineConstraints<double>*>{ &constraints, &constraints },
+             std::vector<QGauss<1>>{ QGauss<1>(degree + 1) },
+             cell_additional_data<dim>());
+
+  const Base::TestFunction<0, dim, 0> v;
+  const Base::FEFunction<0, dim, 0> e;
+  const Base::FEFunction<0, dim, 1> u;
+  auto forms = transform(Base::form(grad(e), grad(v)) +
+                         Base::form(3 * u * u * e - schloegl_alpha * e, v));
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata_e(fe);
+  FEData<FE_Q, degree, 1, dim, 1, degree> fedata_u(fe);
+  auto fe_datas = (fedata_e, fedata_u);
+  MatrixFreeIntegrator<dim, BlockVectorType, decltype(forms), decltype(fe_datas)> cfl;
+  cfl.initialize(mf,
+                 std::make_shared<decltype(forms)>(forms),
+                 std::make_shared<decltype(fe_datas)>(fe_datas));
+
+  BlockVectorType src(2), dst(2), state(2);
+  cfl.initialize_dof_vector(src);
+  cfl.initialize_dof_vector(dst);
+  cfl.initialize_dof_vector(state);
+  for (unsigned int i = 0; i < src.block(0).local_size(); ++i)
+  {
+    const types::global_dof_index index = src.block(0).get_partitioner()->local_to_global(i);
+    src.block(0).local_element(i) = source_entry(index);
+    state.block(1).local_element(i) = state_entry(index);
+  }
+  // only e is applied to, u stays at the linearization point
+  cfl.set_nonlinearities({ false, true }, state);
+
+  NativeSchloeglJacobian<dim, degree> native;
+  native.initialize(mf, state.block(1));
+
+  MatrixFreeResults results;
+  results.n_cells = tr.n_active_cells();
+  results.n_dofs = dof.n_dofs();
+  results.native.seconds =
+    time_vmult([&]() { native.vmult(dst.block(0), src.block(0)); }, n_repetitions);
+  results.native.result = gather(dst, 1);
+  results.cfl.seconds = time_vmult([&]() { cfl.vmult(dst, src); }, n_repetitions);
+  results.cfl.result = gather(dst, 1);
+  return results;
+}
+
+template <int dim, unsigned int degree>
+MatrixFreeResults
+run_stokes(unsigned int refine, unsigned int n_repetitions)
+{
+  using Standard = StandardForms::Stokes<dim, degree, double>;
+  using BlockVectorType = typename Standard::VectorType;
+
+  Triangulation<dim> tr;
+  GridGenerator::hyper_cube(tr);
+  tr.refine_global(refine);
+  const FESystem<dim> fe_u(FE_Q<dim>(degree), dim);
+  const FE_Q<dim> fe_p(degree - 1);
+  DoFHandler<dim> dof_u(tr);
+  dof_u.distribute_dofs(fe_u);
+  DoFHandler<dim> dof_p(tr);
+  dof_p.distribute_dofs(fe_p);
+  AffineConstraints<double> constraints;
+  constraints.close();
+
+  const MappingQGeneric<dim> mapping(1);
+  auto mf = std::make_shared<MatrixFree<dim, double>>();
+  mf->reinit(mapping,
+             std::vector<const DoFHandler<dim>*>{ &dof_u, &dof_p },
+             std::vector<const AffineConstraints<double>*>{ &constraints, &constraints },
+             std::vector<QGauss<1>>{ QGauss<1>(degree + 1) },
+             cell_additional_data<dim>());
+
+  FEData<FESystem, degree, dim, dim, 0, degree> fedata_u(fe_u);
+  FEData<FE_Q, degree - 1, 1, dim, 1, degree> fedata_p(fe_p);
+  const typename Standard::FEDatasType fe_datas = (fedata_u, fedata_p);
+  typename Standard::Integrator cfl;
+  cfl.initialize(mf,
+                 std::make_shared<typename Standard::FormType>(StandardForms::stokes_form<dim>()),
+                 std::make_shared<typename Standard::FEDatasType>(fe_datas));
+
+  NativeStokes<dim, degree> native;
+  native.initialize(mf);
+
+  BlockVectorType src(2), dst(2);
+  cfl.initialize_dof_vector(src);
+  cfl.initialize_dof_vector(dst);
+  types::global_dof_index offset = 0;
+  for (unsigned int b = 0; b < 2; ++b)
+  {
+    for (unsigned int i = 0; i < src.block(b).local_size(); ++i)
+      src.block(b).local_element(i) =
+        source_entry(offset + src.block(b).get_partitioner()->local_to_global(i));
+    offset += src.block(b).size();
+  }
+
+  const auto measure = [&](const auto& op) {
+    BackendResult result;
+    result.seconds = time_vmult([&]() { op.vmult(dst, src); }, n_repetitions);
+    result.result = gather(dst, 2);
+    return result;
+  };
+
+  MatrixFreeResults results;
+  results.n_cells = tr.n_active_cells();
+  results.n_dofs = dof_u.n_dofs() + dof_p.n_dofs();
+  results.native = measure(native);
+  results.cfl = measure(cfl);
+  return results;
+}
+
+template <int dim>
+MatrixFreeResults
+run(BenchmarkForm form, unsigned int degree, unsigned int refine, unsigned int n_repetitions)
+{
+  return dispatch_degree(degree, [&](auto degree_constant) {
+    constexpr unsigned int fe_degree = decltype(degree_constant)::value;
+    switch (form)
+    {
+      case BenchmarkForm::mass:
+        return run<dim, fe_degree, BenchmarkForm::mass>(refine, n_repetitions);
+      case BenchmarkForm::laplace:
+        return run<dim, fe_degree, BenchmarkForm::laplace>(refine, n_repetitions);
+      case BenchmarkForm::sipg:
+        return run<dim, fe_degree, BenchmarkForm::sipg>(refine, n_repetitions);
+      case BenchmarkForm::schloegl:
+        return run_schloegl<dim, fe_degree>(refine, n_repetitions);
+      case BenchmarkForm::stokes:
+        if constexpr(fe_degree >= 2)
+          return run_stokes<dim, fe_degree>(refine, n_repetitions);
+        AssertThrow(false, ExcMessage("The velocity degree has to be at least 2"));
+        break;
+    }
+    AssertThrow(false, ExcNotImplemented());
+    return MatrixFreeResults();
+  });
+}
+} // namespace
+
+MatrixFreeResults
+run_matrixfree(BenchmarkForm form, int dim, unsigned int degree, unsigned int refine,
+               unsigned int n_repetitions)
+{
+  AssertThrow(dim == 2 || dim == 3, ExcNotImplemented());
+  if (dim == 2)
+    return run<2>(form, degree, refine, n_repetitions);
+  return run<3>(form, degree, refine, n_repetitions);
+}
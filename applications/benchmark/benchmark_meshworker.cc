@@ -0,0 +1,110 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "benchmark.h"
+
+#include "../meshworker/meshworker_data.h"
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <cfl/meshworker/fefunctions.h>
+#include <cfl/meshworker/forms.h>
+
+#include <memory>
+
+using namespace CFL::dealii::MeshWorker;
+using namespace ::dealii;
+
+namespace
+{
+// with_field adds the vector with the entries state_entry(i) as data index 1
+template <int dim, class Form>
+BackendResult
+measure(const FiniteElement<dim>& fe, unsigned int refine, unsigned int n_repetitions,
+        Form& form, const bool with_field = false)
+{
+  MeshworkerData<dim> data(0, refine, fe);
+
+  Vector<double> src, dst, field;
+  data.resize_vector(src);
+  data.resize_vector(dst);
+  data.resize_vector(field);
+  for (unsigned int i = 0; i < src.size(); ++i)
+  {
+    src[i] = source_entry(i);
+    field[i] = state_entry(i);
+  }
+
+  BackendResult result;
+  result.seconds = time_vmult(
+    [&]() {
+      dst = 0.;
+      data.vmult(dst, src, form, with_field ? &field : nullptr);
+    },
+    n_repetitions);
+  result.result = dst;
+  return result;
+}
+
+// the Forms of StandardForms written with the MeshWorker FE functions
+template <int dim>
+BackendResult
+run(BenchmarkForm form, unsigned int degree, unsigned int refine, unsigned int n_repetitions)
+{
+  TestFunction<0, dim> v(0, 0);
+  FEFunction<0, dim> u(0, 0);
+
+  if (form == BenchmarkForm::mass)
+  {
+    auto f = CFL::dealii::MeshWorker::form(u, v);
+    return measure<dim>(FE_Q<dim>(degree), refine, n_repetitions, f);
+  }
+  if (form == BenchmarkForm::laplace)
+  {
+    auto f = CFL::dealii::MeshWorker::form(grad(u), grad(v));
+    return measure<dim>(FE_Q<dim>(degree), refine, n_repetitions, f);
+  }
+  if (form == BenchmarkForm::schloegl)
+  {
+    // u is the increment e and the linearization point the FE function w
+    FEFunction<0, dim> w(1, 0);
+    auto f = CFL::dealii::MeshWorker::form(grad(u), grad(v)) +
+             3. * CFL::dealii::MeshWorker::form(w * w * u, v) +
+             (-schloegl_alpha) * CFL::dealii::MeshWorker::form(u, v);
+    return measure<dim>(FE_Q<dim>(degree), refine, n_repetitions, f, true);
+  }
+  AssertThrow(form == BenchmarkForm::sipg, ExcMessage(meshworker_limitation(form)));
+
+  TestFunctionInteriorFace<0, dim> v_p(0, 0);
+  TestFunctionExteriorFace<0, dim> v_m(0, 0);
+  TestNormalGradientInteriorFace<0, dim> Dnv_p(0, 0);
+  TestNormalGradientExteriorFace<0, dim> Dnv_m(0, 0);
+  FEFunctionInteriorFace<0, dim> u_p(0, 0);
+  FEFunctionExteriorFace<0, dim> u_m(0, 0);
+  FENormalGradientInteriorFace<0, dim> Dnu_p(0, 0);
+  FENormalGradientExteriorFace<0, dim> Dnu_m(0, 0);
+
+  auto flux = u_p - u_m;
+  auto flux_grad = Dnu_p - Dnu_m;
+  auto flux1 = -CFL::dealii::MeshWorker::face_form(flux, Dnv_p) +
+               CFL::dealii::MeshWorker::face_form(flux, Dnv_m);
+  auto flux2 = CFL::dealii::MeshWorker::face_form(-flux + .5 * flux_grad, v_p) -
+               CFL::dealii::MeshWorker::face_form(-flux + .5 * flux_grad, v_m);
+  auto boundary1 = CFL::dealii::MeshWorker::boundary_form(2. * u_p - Dnu_p, v_p);
+  auto boundary2 = -CFL::dealii::MeshWorker::boundary_form(u_p, Dnv_p);
+
+  auto f = CFL::dealii::MeshWorker::form(grad(u), grad(v)) + (-flux2 + .5 * flux1) + boundary1 +
+           boundary2;
+  return measure<dim>(FE_DGQ<dim>(degree), refine, n_repetitions, f);
+}
+} // namespace
+
+BackendResult
+run_meshworker(BenchmarkForm form, int dim, unsigned int degree, unsigned int refine,
+               unsigned int n_repetitions)
+{
+  AssertThrow(dim == 2 || dim == 3, ExcNotImplemented());
+  if (dim == 2)
+    return run<2>(form, degree, refine, n_repetitions);
+  return run<3>(form, degree, refine, n_repetitions);
+}
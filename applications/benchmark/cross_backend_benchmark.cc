@@ -0,0 +1,158 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "benchmark.h"
+
+#include <deal.II/base/logstream.h>
+
+#include <cfl/matrixfree/degree_dispatch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace dealii;
+
+// Apply the same Forms with hand-written deal.II MatrixFree operators, the
+// CFL MatrixFree backend and the CFL MeshWorker backend:
+//   ./cross_backend_benchmark <dim> <max_degree> <max_dofs> <max_overhead> <n_repetitions>
+// For every Form and degree, the unit cube is refined until the mesh has
+// more than max_dofs degrees of freedom. Each line reports the throughput of
+// the three backends in million DoFs per second, the overhead of the CFL
+// MatrixFree operator, i.e. its time divided by the time of the deal.II
+// operator, and the largest relative l2 difference of the results of the
+// CFL backends to the result of the deal.II operator.
+//
+// The Forms are the mass matrix, the Laplacian, the SIPG Laplacian, the
+// Jacobian of the Schloegl model and the Stokes operator, see BenchmarkForm.
+// The MeshWorker backend cannot evaluate the Stokes operator; the program
+// prints a note for it and "-" in its column.
+//
+// The program fails if any difference exceeds 1e-10 or, if max_overhead is
+// positive, if the overhead on the finest mesh of a Form and degree exceeds
+// max_overhead. Smaller meshes are timed too inaccurately for the latter.
+namespace
+{
+double
+relative_difference(const Vector<double>& result, const Vector<double>& reference)
+{
+  Vector<double> difference = result;
+  difference -= reference;
+  return difference.l2_norm() / std::max(reference.l2_norm(), 1.e-300);
+}
+
+types::global_dof_index
+estimate_n_dofs(BenchmarkForm form, int dim, unsigned int degree, unsigned int refine)
+{
+  const double n_cells_1d = std::pow(2., refine);
+  if (form == BenchmarkForm::sipg)
+    return static_cast<types::global_dof_index>(std::pow((degree + 1) * n_cells_1d, dim));
+  if (form == BenchmarkForm::stokes)
+    return static_cast<types::global_dof_index>(
+      dim * std::pow(degree * n_cells_1d + 1, dim) + std::pow((degree - 1) * n_cells_1d + 1, dim));
+  return static_cast<types::global_dof_index>(std::pow(degree * n_cells_1d + 1, dim));
+}
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  deallog.depth_console(0);
+  try
+  {
+    const int dim = (argc > 1) ? std::stoi(argv[1]) : 2;
+    const unsigned int max_degree = (argc > 2) ? std::stoi(argv[2]) : CFL_MATRIXFREE_MAX_DEGREE;
+    const types::global_dof_index max_dofs = (argc > 3) ? std::stoull(argv[3]) : 100000;
+    const double max_overhead = (argc > 4) ? std::stod(argv[4]) : 0.;
+    const unsigned int n_repetitions = (argc > 5) ? std::stoi(argv[5]) : 10;
+    const double tolerance = 1.e-10;
+
+    std::cout << "form     degree   cells       DoFs   deal.II      CFL  MeshWorker  overhead"
+              << "  difference" << std::endl;
+    bool passed = true;
+    for (const BenchmarkForm form : { BenchmarkForm::mass,
+                                      BenchmarkForm::laplace,
+                                      BenchmarkForm::sipg,
+                                      BenchmarkForm::schloegl,
+                                      BenchmarkForm::stokes })
+    {
+      const std::string limitation = meshworker_limitation(form);
+      if (!limitation.empty())
+        std::cout << name(form) << ": MeshWorker skipped, " << limitation << std::endl;
+      const unsigned int min_form_degree =
+        std::max<unsigned int>(CFL_MATRIXFREE_MIN_DEGREE, min_degree(form));
+      for (unsigned int degree = min_form_degree; degree <= max_degree; ++degree)
+      {
+        double overhead = 0.;
+        for (unsigned int refine = 1;
+             refine == 1 || estimate_n_dofs(form, dim, degree, refine - 1) <= max_dofs;
+             ++refine)
+        {
+          const MatrixFreeResults matrixfree =
+            run_matrixfree(form, dim, degree, refine, n_repetitions);
+          BackendResult meshworker;
+          if (limitation.empty())
+            meshworker = run_meshworker(form, dim, degree, refine, n_repetitions);
+
+          overhead = matrixfree.cfl.seconds / matrixfree.native.seconds;
+          double difference =
+            relative_difference(matrixfree.cfl.result, matrixfree.native.result);
+          if (limitation.empty())
+            difference = std::max(difference,
+                                  relative_difference(meshworker.result, matrixfree.native.result));
+          const bool agrees = difference <= tolerance;
+          passed &= agrees;
+
+          const auto mdofs = [&](const double seconds) {
+            return 1.e-6 * matrixfree.n_dofs / seconds;
+          };
+          std::cout << std::left << std::setw(8) << name(form) << std::right << std::setw(7)
+                    << degree << std::setw(8) << matrixfree.n_cells << std::setw(11)
+                    << matrixfree.n_dofs << std::fixed << std::setprecision(2) << std::setw(10)
+                    << mdofs(matrixfree.native.seconds) << std::setw(9)
+                    << mdofs(matrixfree.cfl.seconds) << std::setw(12);
+          if (limitation.empty())
+            std::cout << mdofs(meshworker.seconds);
+          else
+            std::cout << "-";
+          std::cout << std::setw(10) << overhead << std::scientific
+                    << std::setprecision(2) << std::setw(12) << difference
+                    << (agrees ? "" : "  FAILED") << std::defaultfloat << std::endl;
+        }
+        if (max_overhead > 0. && overhead > max_overhead)
+        {
+          std::cout << name(form) << " degree " << degree << ": overhead " << overhead
+                    << " exceeds " << max_overhead << "  FAILED" << std::endl;
+          passed = false;
+        }
+      }
+    }
+
+    std::cout << (passed ? "OK" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,117 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <cfl/reference/forms.h>
+#include <cfl/reference/reference_integrator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "laplace_form.h"
+#include "laplace_kernel.h"
+
+using namespace CFL;
+using namespace CFL::Reference;
+
+/**
+ * Replaces the evaluation of a Form of the reference backend in the
+ * quadrature points by the generated kernel. The evaluation and
+ * integration flags are taken from the Form.
+ */
+template <class FormType>
+class GeneratedForm
+{
+public:
+  explicit GeneratedForm(const FormType& form)
+    : form(form)
+  {
+  }
+
+  template <class FEEvaluation>
+  void
+  set_evaluation_flags(FEEvaluation& phi) const
+  {
+    form.set_evaluation_flags(phi);
+  }
+
+  template <class FEEvaluation>
+  static void
+  set_integration_flags(FEEvaluation& phi)
+  {
+    FormType::set_integration_flags(phi);
+  }
+
+  template <class FEEvaluation>
+  void
+  evaluate(FEEvaluation& phi, unsigned int q) const
+  {
+    laplace_kernel(phi, q);
+  }
+
+private:
+  const FormType form;
+};
+
+template <class Integrator>
+double
+time_vmult(const Integrator& integrator, std::vector<double>& dst, const std::vector<double>& src,
+           unsigned int n_repetitions)
+{
+  integrator.vmult(dst, src);
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+    integrator.vmult(dst, src);
+  const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+  return time.count() / n_repetitions;
+}
+
+// Apply the operator of laplace_form() once with the expression templates
+// of the reference backend and once with the kernel generated from the same
+// Forms. The results must coincide up to roundoff.
+template <int degree>
+bool
+run(unsigned int n_cells_1d, unsigned int n_repetitions)
+{
+  constexpr int dim = 3;
+  CartesianGrid<dim> grid(n_cells_1d, degree);
+
+  const auto f = transform(laplace_form<dim>());
+  const GeneratedForm<decltype(f)> generated(f);
+  ReferenceIntegrator<dim, degree, degree + 1, decltype(f)> templates(grid, f);
+  ReferenceIntegrator<dim, degree, degree + 1, decltype(generated)> kernel(grid, generated);
+
+  std::vector<double> src(grid.n_dofs()), dst_templates, dst_kernel;
+  for (unsigned int i = 0; i < src.size(); ++i)
+    src[i] = std::sin(0.1 * i);
+
+  const double time_templates = time_vmult(templates, dst_templates, src, n_repetitions);
+  const double time_kernel = time_vmult(kernel, dst_kernel, src, n_repetitions);
+
+  double difference = 0., norm = 0.;
+  for (unsigned int i = 0; i < src.size(); ++i)
+  {
+    difference = std::max(difference, std::abs(dst_templates[i] - dst_kernel[i]));
+    norm = std::max(norm, std::abs(dst_templates[i]));
+  }
+  const bool equal = difference <= 1.e-12 * norm;
+
+  std::cout << "degree " << degree << " DoFs " << grid.n_dofs() << " templates " << time_templates
+            << "s generated " << time_kernel << "s relative difference " << difference / norm
+            << (equal ? " OK" : " FAILED") << std::endl;
+  return equal;
+}
+
+int
+main(int argc, char** argv)
+{
+  const unsigned int n_cells_1d = argc > 1 ? std::atoi(argv[1]) : 4;
+  const unsigned int n_repetitions = argc > 2 ? std::atoi(argv[2]) : 1;
+
+  bool equal = run<1>(2 * n_cells_1d, n_repetitions);
+  equal &= run<2>(n_cells_1d, n_repetitions);
+  equal &= run<4>(n_cells_1d, n_repetitions);
+  return equal ? 0 : 1;
+}
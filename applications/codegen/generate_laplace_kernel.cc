@@ -0,0 +1,27 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <cfl/codegen/forms.h>
+#include <cfl/codegen/kernel_generator.h>
+
+#include <fstream>
+#include <iostream>
+
+#include "laplace_form.h"
+
+using namespace CFL;
+
+int
+main(int argc, char** argv)
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <output file>" << std::endl;
+    return 1;
+  }
+
+  const auto f = Codegen::transform(laplace_form<3>());
+  std::ofstream out(argv[1]);
+  Codegen::KernelGenerator<decltype(f)>(f, "laplace_kernel").print(out);
+  return out ? 0 : 1;
+}
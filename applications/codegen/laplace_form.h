@@ -0,0 +1,21 @@
+#ifndef CODEGEN_LAPLACE_FORM_H
+#define CODEGEN_LAPLACE_FORM_H
+
+#include <cfl/base/fefunctions.h>
+#include <cfl/base/forms.h>
+
+/**
+ * The Forms of a nonlinear reaction-diffusion operator, shared by the
+ * generator of the kernel and the program that compares it with the
+ * expression templates.
+ */
+template <int dim>
+constexpr auto
+laplace_form()
+{
+  constexpr CFL::Base::TestFunction<0, dim, 0> v;
+  constexpr CFL::Base::FEFunction<0, dim, 0> u;
+  return form(grad(u), grad(v)) + form(u * u * 0.5 + u * 2. - u * u * u, v);
+}
+
+#endif // CODEGEN_LAPLACE_FORM_H
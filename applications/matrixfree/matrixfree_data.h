@@ -1,15 +1,30 @@
 #ifndef MATRIXFREE_DATA_H
 #define MATRIXFREE_DATA_H
 
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/dofs/dof_tools.h>
 #include <deal.II/fe/mapping_q.h>
 #include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_refinement.h>
 #include <deal.II/grid/manifold_lib.h>
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/numerics/error_estimator.h>
+#ifdef DEAL_II_WITH_P4EST
+#include <deal.II/distributed/grid_refinement.h>
+#include <deal.II/distributed/tria.h>
+#endif
 
 #include <cfl/base/fefunctions.h>
 
+#include <cfl/matrixfree/auto_tuner.h>
+#include <cfl/matrixfree/capture.h>
 #include <cfl/matrixfree/fe_data.h>
 #include <cfl/matrixfree/matrix_free_integrator.h>
 
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <utility>
 
 /**
@@ -18,14 +33,30 @@
 * This class provides a simplified interface to the integration kernel using
 * MatrixFree evaluation technique as prescribed in step-37
 *
+* The available grids are
+* - 0: hyper_cube refined globally <code>refine</code> times
+* - 1: hyper_ball refined globally <code>refine</code> times
+* - 2: hyper_cube refined globally <code>refine</code> times and once more in
+*      the quadrant closest to the origin, i.e. a mesh with hanging nodes
+* - 3: subdivided_hyper_rectangle with <code>repetitions[d]</code> unit cells
+*      in direction d refined globally <code>refine</code> times
 *
+* The mesh can be adapted further with refine_adaptive(). Hanging node
+* constraints are always built, so the integrator is applied to the
+* conforming subspace also on locally refined meshes.
+*
+* If MPI has been initialized, e.g. by dealii::Utilities::MPI::MPI_InitFinalize,
+* and deal.II was configured with p4est, the mesh is a
+* parallel::distributed::Triangulation on MPI_COMM_WORLD with a multigrid
+* hierarchy, the vectors are distributed accordingly and only rank 0 prints.
+* Otherwise, a serial Triangulation is used.
 */
 template <int dim, class FEDatas, class Forms, typename VectorType>
 class MatrixFreeData
 {
   const dealii::MappingQ<dim, dim> mapping;
   dealii::SphericalManifold<dim> sphere;
-  dealii::Triangulation<dim> tr;
+  std::unique_ptr<dealii::Triangulation<dim>> tr;
   std::vector<std::unique_ptr<dealii::DoFHandler<dim>>> dh_ptr_vector;
   std::vector<const dealii::DoFHandler<dim>*> dh_const_ptr_vector;
   std::vector<std::unique_ptr<dealii::AffineConstraints<double>>> constraint_ptr_vector;
@@ -36,56 +67,85 @@ class MatrixFreeData
   std::shared_ptr<Forms> forms;
   const dealii::Quadrature<1> quadrature;
   MatrixFreeIntegrator<dim, VectorType, Forms, FEDatas> integrator;
+  CFL::dealii::MatrixFree::ExecutionParameters execution_parameters;
 
 public:
   // constructor for multiple FiniteElements
   MatrixFreeData(unsigned int grid_index, unsigned int refine,
                  const std::vector<dealii::FiniteElement<dim>*>& fe,
-                 std::shared_ptr<FEDatas> fe_datas_, std::shared_ptr<Forms> forms_)
+                 std::shared_ptr<FEDatas> fe_datas_, std::shared_ptr<Forms> forms_,
+                 const std::vector<unsigned int>& repetitions = {})
     : mapping(FEDatas::max_degree)
+    , tr(create_triangulation())
     , fe_datas(std::move(fe_datas_))
     , forms(std::move(forms_))
     , quadrature(FEDatas::max_degree + 1)
   {
     AssertThrow(!fe.empty(), dealii::ExcInternalError());
     if (grid_index == 0)
-      dealii::GridGenerator::hyper_cube(tr);
+      dealii::GridGenerator::hyper_cube(*tr);
     else if (grid_index == 1)
     {
-      dealii::GridGenerator::hyper_ball(tr);
-      tr.set_manifold(0, sphere);
-      tr.set_all_manifold_ids(0);
+      dealii::GridGenerator::hyper_ball(*tr);
+      tr->set_manifold(0, sphere);
+      tr->set_all_manifold_ids(0);
+    }
+    else if (grid_index == 2)
+      dealii::GridGenerator::hyper_cube(*tr);
+    else if (grid_index == 3)
+    {
+      AssertDimension(repetitions.size(), dim);
+      dealii::Point<dim> upper_corner;
+      for (unsigned int d = 0; d < dim; ++d)
+        upper_corner[d] = repetitions[d];
+      dealii::GridGenerator::subdivided_hyper_rectangle(
+        *tr, repetitions, dealii::Point<dim>(), upper_corner);
     }
     else
       throw std::logic_error(std::string("Unknown grid index") + std::to_string(grid_index));
-    tr.refine_global(refine);
+    tr->refine_global(refine);
+    if (grid_index == 2)
+    {
+      for (const auto& cell : tr->active_cell_iterators())
+      {
+        if (!cell->is_locally_owned())
+          continue;
+        bool in_corner = true;
+        for (unsigned int d = 0; d < dim; ++d)
+          in_corner = in_corner && cell->center()[d] < 0.5;
+        if (in_corner)
+          cell->set_refine_flag();
+      }
+      tr->execute_coarsening_and_refinement();
+    }
 
     for (size_t i = 0; i < fe.size(); ++i)
     {
       dh_ptr_vector.push_back(std::make_unique<dealii::DoFHandler<dim>>());
-      dh_ptr_vector[i]->initialize(tr, *(fe[i]));
+      dh_ptr_vector[i]->initialize(*tr, *(fe[i]));
       dh_const_ptr_vector.push_back(dh_ptr_vector[i].get());
       // dh_vector[i].initialize_local_block_info();
       constraint_ptr_vector.push_back(std::make_unique<dealii::AffineConstraints<double>>());
       constraint_const_ptr_vector.push_back(constraint_ptr_vector[i].get());
-      quadrature_vector.push_back(dealii::QGauss<1>(fe[i]->degree + 1));
+    }
+    // the quadratures requested by the FEData objects, max_degree+1 Gauss points otherwise
+    for (unsigned int q = 0; q < std::max<unsigned int>(fe.size(), FEDatas::n_quadratures); ++q)
+    {
+      const unsigned int n_q_points_1d = FEDatas::get_n_q_points_1d(q);
+      quadrature_vector.push_back(
+        dealii::QGauss<1>(n_q_points_1d != 0 ? n_q_points_1d : FEDatas::max_degree + 1));
     }
 
-    dealii::deallog << "Grid type " << grid_index << " Cells " << tr.n_active_cells() << " DoFs ";
-    for (size_t i = 0; i < fe.size() - 1; ++i)
-      dealii::deallog << dh_ptr_vector[i]->n_dofs() << "+";
-    dealii::deallog << dh_ptr_vector[fe.size() - 1]->n_dofs() << std::endl;
-
-    typename dealii::MatrixFree<dim, double>::AdditionalData addit_data;
-    addit_data.tasks_parallel_scheme = dealii::MatrixFree<dim, double>::AdditionalData::none;
-    addit_data.tasks_block_size = 3;
-    addit_data.level_mg_handler = dealii::numbers::invalid_unsigned_int;
-
-    mf = std::make_shared<dealii::MatrixFree<dim, double>>();
-    mf->reinit(
-      mapping, dh_const_ptr_vector, constraint_const_ptr_vector, quadrature_vector, addit_data);
+    if (is_root())
+    {
+      dealii::deallog << "Grid type " << grid_index << " Cells " << tr->n_global_active_cells()
+                      << " DoFs ";
+      for (size_t i = 0; i < fe.size() - 1; ++i)
+        dealii::deallog << dh_ptr_vector[i]->n_dofs() << "+";
+      dealii::deallog << dh_ptr_vector[fe.size() - 1]->n_dofs() << std::endl;
+    }
 
-    integrator.initialize(mf, forms, fe_datas);
+    setup_matrix_free();
   }
 
   // constructor for multiple FiniteElements
@@ -97,6 +157,77 @@ public:
   {
   }
 
+  /**
+   * Refine the fraction <code>top_fraction</code> of the cells with the largest
+   * Kelly error indicators of <code>solution</code> and rebuild the DoFs,
+   * the hanging node constraints and the MatrixFree object. For block vectors,
+   * the indicators of all blocks are summed up. All vectors have to be resized
+   * afterwards. The execution parameters are kept; tune() chooses new ones
+   * for the refined mesh and then also tries to group the cells by level,
+   * see ExecutionParameters.
+   */
+  void
+  refine_adaptive(const VectorType& solution, const double top_fraction = 0.3)
+  {
+    dealii::Vector<float> indicators(tr->n_active_cells());
+    for (size_t i = 0; i < dh_ptr_vector.size(); ++i)
+    {
+      // the estimator needs the constrained entries and the ghost values
+      dealii::LinearAlgebra::distributed::Vector<double> ghosted;
+      mf->initialize_dof_vector(ghosted, i);
+      const auto& owned = get_block(solution, i);
+      AssertDimension(owned.local_size(), ghosted.local_size());
+      for (unsigned int j = 0; j < ghosted.local_size(); ++j)
+        ghosted.local_element(j) = owned.local_element(j);
+      constraint_ptr_vector[i]->distribute(ghosted);
+      ghosted.update_ghost_values();
+
+      dealii::Vector<float> block_indicators(tr->n_active_cells());
+      dealii::KellyErrorEstimator<dim>::estimate(
+        mapping,
+        *dh_ptr_vector[i],
+        dealii::QGauss<dim - 1>(dh_ptr_vector[i]->get_fe().degree + 1),
+        typename dealii::FunctionMap<dim>::type(),
+        ghosted,
+        block_indicators);
+      indicators += block_indicators;
+    }
+
+#ifdef DEAL_II_WITH_P4EST
+    if (auto* distributed =
+          dynamic_cast<dealii::parallel::distributed::Triangulation<dim>*>(tr.get()))
+      dealii::parallel::distributed::GridRefinement::refine_and_coarsen_fixed_number(
+        *distributed, indicators, top_fraction, 0.);
+    else
+#endif
+      dealii::GridRefinement::refine_and_coarsen_fixed_number(*tr, indicators, top_fraction, 0.);
+    tr->execute_coarsening_and_refinement();
+    for (auto& dh : dh_ptr_vector)
+      dh->distribute_dofs(dh->get_fe());
+
+    setup_matrix_free();
+  }
+
+  const dealii::Triangulation<dim>&
+  get_triangulation() const
+  {
+    return *tr;
+  }
+
+  const dealii::DoFHandler<dim>&
+  get_dof_handler(const unsigned int i = 0) const
+  {
+    AssertIndexRange(i, dh_ptr_vector.size());
+    return *dh_ptr_vector[i];
+  }
+
+  const dealii::AffineConstraints<double>&
+  get_constraints(const unsigned int i = 0) const
+  {
+    AssertIndexRange(i, constraint_ptr_vector.size());
+    return *constraint_ptr_vector[i];
+  }
+
   void
   resize_vector(VectorType& v) const
   {
@@ -114,7 +245,8 @@ public:
                 VectorType>::value) mf->initialize_dof_vector(v.block(i), i);
           else
             v.block(i).reinit(dh_ptr_vector[i].n_dofs());
-          std::cout << "Vector " << i << " has size " << v.block(i).size() << std::endl;
+          if (is_root())
+            std::cout << "Vector " << i << " has size " << v.block(i).size() << std::endl;
         }
       }
     else
@@ -126,10 +258,17 @@ public:
                        VectorType>::value) mf->initialize_dof_vector(v, 0);
       else
         v.reinit(dh_ptr_vector[0].n_dofs());
-      std::cout << "Vector has size " << v.size() << std::endl;
+      if (is_root())
+        std::cout << "Vector has size " << v.size() << std::endl;
     }
   }
 
+  const dealii::MatrixFree<dim, double>&
+  get_matrix_free() const
+  {
+    return *mf;
+  }
+
   void
   vmult(VectorType& dst, const VectorType& src) const
   {
@@ -141,5 +280,148 @@ public:
   {
     integrator.vmult_add(dst, src);
   }
+
+  static constexpr bool only_cell_forms =
+    MatrixFreeIntegrator<dim, VectorType, Forms, FEDatas>::only_cell_forms;
+
+  template <class CellOperation>
+  void
+  apply_on_cells(const VectorType& src, const std::pair<unsigned int, unsigned int>& cell_range,
+                 const CellOperation& cell_operation) const
+  {
+    integrator.apply_on_cells(src, cell_range, cell_operation);
+  }
+
+  /**
+   * Rebuild the MatrixFree object with the given execution parameters.
+   */
+  void
+  set_execution_parameters(const CFL::dealii::MatrixFree::ExecutionParameters& parameters)
+  {
+    execution_parameters = parameters;
+    setup_matrix_free();
+  }
+
+  /**
+   * Choose the execution parameters of the MatrixFree object with
+   * <code>tuner</code> and rebuild it with them, see AutoTuner.
+   */
+  CFL::dealii::MatrixFree::ExecutionParameters
+  tune(CFL::dealii::MatrixFree::AutoTuner& tuner)
+  {
+    const bool locally_refined = is_locally_refined();
+    const std::string key = CFL::dealii::MatrixFree::AutoTuner::key<Forms>(
+      FEDatas::max_degree, dim, tr->n_global_active_cells(), locally_refined);
+    const auto setup = [this](const CFL::dealii::MatrixFree::ExecutionParameters& parameters) {
+      execution_parameters = parameters;
+      setup_matrix_free();
+      auto src = std::make_shared<VectorType>();
+      auto dst = std::make_shared<VectorType>();
+      if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
+        {
+          src->reinit(dh_ptr_vector.size());
+          dst->reinit(dh_ptr_vector.size());
+        }
+      integrator.initialize_dof_vector(*src);
+      integrator.initialize_dof_vector(*dst);
+      *src = 1.;
+      return [this, src, dst]() { integrator.vmult(*dst, *src); };
+    };
+    execution_parameters = tuner.tune(key, setup, locally_refined);
+    setup_matrix_free();
+    return execution_parameters;
+  }
+
+  /**
+   * Write the setup of the integrator and <code>src</code> to
+   * <code>filename</code>, see CFL::dealii::MatrixFree::capture(). Only
+   * serial runs can be captured.
+   */
+  void
+  capture(const std::string& filename, const VectorType& src) const
+  {
+    CFL::dealii::MatrixFree::capture(filename,
+                                     integrator,
+                                     mapping,
+                                     constraint_const_ptr_vector,
+                                     quadrature_vector,
+                                     additional_data(),
+                                     src);
+  }
+
+private:
+  // a distributed mesh if MPI is running, see the class documentation
+  static std::unique_ptr<dealii::Triangulation<dim>>
+  create_triangulation()
+  {
+#ifdef DEAL_II_WITH_P4EST
+    if constexpr(dim > 1)
+      if (dealii::Utilities::MPI::job_supports_mpi())
+        return std::make_unique<dealii::parallel::distributed::Triangulation<dim>>(
+          MPI_COMM_WORLD,
+          dealii::Triangulation<dim>::limit_level_difference_at_vertices,
+          dealii::parallel::distributed::Triangulation<dim>::construct_multigrid_hierarchy);
+#endif
+    return std::make_unique<dealii::Triangulation<dim>>();
+  }
+
+  // true if MPI is not running or this is the first process
+  static bool
+  is_root()
+  {
+    return !dealii::Utilities::MPI::job_supports_mpi() ||
+           dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0;
+  }
+
+  // true if not all active cells are on the finest level
+  bool
+  is_locally_refined() const
+  {
+    const std::uint64_t n_uniform_cells = static_cast<std::uint64_t>(tr->n_cells(0))
+                                          << (dim * (tr->n_global_levels() - 1));
+    return tr->n_global_active_cells() != n_uniform_cells;
+  }
+
+  static const auto&
+  get_block(const VectorType& v, [[maybe_unused]] const unsigned int i)
+  {
+    if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
+      return v.block(i);
+    else
+      return v;
+  }
+
+  typename dealii::MatrixFree<dim, double>::AdditionalData
+  additional_data() const
+  {
+    typename dealii::MatrixFree<dim, double>::AdditionalData addit_data;
+    execution_parameters.apply(addit_data, *tr);
+    addit_data.level_mg_handler = dealii::numbers::invalid_unsigned_int;
+    return addit_data;
+  }
+
+  // (re)build the hanging node constraints and the MatrixFree object for the current mesh
+  void
+  setup_matrix_free()
+  {
+    for (size_t i = 0; i < dh_ptr_vector.size(); ++i)
+    {
+      dealii::IndexSet locally_relevant_dofs;
+      dealii::DoFTools::extract_locally_relevant_dofs(*dh_ptr_vector[i], locally_relevant_dofs);
+      constraint_ptr_vector[i]->clear();
+      constraint_ptr_vector[i]->reinit(locally_relevant_dofs);
+      dealii::DoFTools::make_hanging_node_constraints(*dh_ptr_vector[i], *constraint_ptr_vector[i]);
+      constraint_ptr_vector[i]->close();
+    }
+
+    mf = std::make_shared<dealii::MatrixFree<dim, double>>();
+    mf->reinit(mapping,
+               dh_const_ptr_vector,
+               constraint_const_ptr_vector,
+               quadrature_vector,
+               additional_data());
+
+    integrator.initialize(mf, forms, fe_datas);
+  }
 };
 #endif // MATRIXFREE_DATA_H
@@ -0,0 +1,93 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/fe/fe_q.h>
+
+#include <deal.II/base/timer.h>
+
+#include <cfl/matrixfree/degree_dispatch.h>
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+#include <cfl/matrixfree/standard_forms.h>
+
+#include <string>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// Apply the Laplace operator with a polynomial degree chosen at run time:
+//   ./matrixfree_laplace_degree <degree> <refine>
+// All degrees in [CFL_MATRIXFREE_MIN_DEGREE, CFL_MATRIXFREE_MAX_DEGREE] are
+// compiled into this binary. The integrators for the degrees up to 6 are
+// taken from libcfl.
+template <int dim, unsigned int degree>
+void
+run(unsigned int grid_index, unsigned int refine)
+{
+  FE_Q<dim> fe_u(degree);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe_u);
+  typename StandardForms::Laplace<dim, degree, double>::FEDatasType fe_datas{ fedata };
+
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe_u);
+
+  auto f = StandardForms::laplace_form<dim>();
+
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  MatrixFreeData<dim, decltype(fe_datas), decltype(f), VectorType> data(
+    grid_index, refine, fes, fe_datas, f);
+
+  VectorType in, out;
+  data.resize_vector(in);
+  data.resize_vector(out);
+  for (types::global_dof_index j = 0; j < in.size(); ++j)
+    in[j] = j;
+
+  const unsigned int n_vmults = 20;
+  Timer timer;
+  for (unsigned int i = 0; i < n_vmults; ++i)
+    data.vmult(out, in);
+  timer.stop();
+  std::cout << "Degree " << degree << ": " << timer.wall_time() / n_vmults
+            << " s per vmult, result norm " << out.l2_norm() << std::endl;
+}
+
+int
+main(int argc, char** argv)
+{
+  deallog.depth_console(10);
+  try
+  {
+    const unsigned int degree = (argc > 1) ? std::stoi(argv[1]) : 2;
+    const unsigned int refine = (argc > 2) ? std::stoi(argv[2]) : 3;
+    dispatch_degree(degree, [&](auto degree_constant) {
+      run<2, decltype(degree_constant)::value>(0, refine);
+    });
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
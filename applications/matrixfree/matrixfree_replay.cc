@@ -0,0 +1,335 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <cfl/matrixfree/capture.h>
+#include <cfl/matrixfree/degree_dispatch.h>
+#include <cfl/matrixfree/standard_forms.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+using namespace dealii;
+using namespace CFL::dealii::MatrixFree;
+
+// Time the operator apply of a file written by CFL::dealii::MatrixFree::capture():
+//   ./matrixfree_replay <capture file> <n_repetitions>
+// The mesh, the DoF numbering, the constraints, the MatrixFree setup and the
+// source vector are those of the captured run. The Form is recognized by its
+// type identifier, so it has to be one of the Forms of StandardForms compiled
+// into this binary, i.e. Mass, Laplace, SIPGLaplace or Stokes, captured by a
+// binary built with the same compiler. The polynomial degree is taken from
+// the captured finite element, the velocity element for Stokes.
+//
+// Captures are only written by serial runs, see CFL::dealii::MatrixFree::Capture,
+// and the replay runs on a single process as well.
+//
+// The minimum and the average time of a vmult are printed together with the
+// l2 norm of the result, which has to be the same for two builds compared
+// while bisecting a performance regression.
+namespace
+{
+enum class ReplayedForm
+{
+  mass,
+  laplace,
+  sipg,
+  stokes
+};
+
+/**
+ * The finite element, the FEDatas and the Forms of StandardForms for each
+ * ReplayedForm, such that the integrators compiled into libcfl are reused.
+ */
+template <int dim, unsigned int degree, ReplayedForm form>
+struct Replayed
+{
+  using FiniteElementType = FE_Q<dim>;
+  using Standard = std::conditional_t<form == ReplayedForm::mass,
+                                      StandardForms::Mass<dim, degree, double>,
+                                      StandardForms::Laplace<dim, degree, double>>;
+
+  static auto
+  forms()
+  {
+    if constexpr(form == ReplayedForm::mass)
+      return StandardForms::mass_form<dim>();
+    else
+      return StandardForms::laplace_form<dim>();
+  }
+
+  static typename Standard::FEDatasType
+  fe_datas(const FiniteElementType& fe)
+  {
+    FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+    return typename Standard::FEDatasType{ fedata };
+  }
+};
+
+template <int dim, unsigned int degree>
+struct Replayed<dim, degree, ReplayedForm::sipg>
+{
+  using FiniteElementType = FE_DGQ<dim>;
+  using Standard = StandardForms::SIPGLaplace<dim, degree, double>;
+
+  static auto
+  forms()
+  {
+    return StandardForms::sipg_laplace_form<dim>();
+  }
+
+  static typename Standard::FEDatasType
+  fe_datas(const FiniteElementType& fe)
+  {
+    FEDataFace<FE_DGQ, degree, 1, dim, 0, degree> fedata_face(fe);
+    FEData<FE_DGQ, degree, 1, dim, 0, degree> fedata(fe);
+    return (fedata_face, fedata);
+  }
+};
+
+/**
+ * Distribute the DoFs of the <code>i</code>th captured DoFHandler with
+ * <code>fe</code>, which has to be the captured element, in the captured
+ * numbering and fill <code>constraints</code> with the captured ones.
+ */
+template <int dim>
+void
+setup_dofs(const Capture<dim>& capture, const unsigned int i, const FiniteElement<dim>& fe,
+           DoFHandler<dim>& dof, AffineConstraints<double>& constraints)
+{
+  AssertThrow(capture.components[i].fe_name == fe.get_name(),
+              ExcMessage("The Form expects " + fe.get_name() + ", but the capture uses " +
+                         capture.components[i].fe_name));
+  dof.distribute_dofs(fe);
+  capture.renumber_dofs(i, dof);
+  capture.make_constraints(i, constraints);
+}
+
+/**
+ * Time <code>n_repetitions</code> applications of <code>integrator</code>
+ * after one warm up application and print the results.
+ */
+template <class Integrator, typename VectorType>
+void
+time_vmult(const Integrator& integrator, VectorType& dst, const VectorType& src,
+           const unsigned int n_repetitions, const unsigned int n_cells,
+           const types::global_dof_index n_dofs, const types::global_dof_index n_constraints)
+{
+  integrator.vmult(dst, src);
+  double min_time = std::numeric_limits<double>::max(), sum_time = 0.;
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+  {
+    Timer timer;
+    integrator.vmult(dst, src);
+    timer.stop();
+    min_time = std::min(min_time, timer.wall_time());
+    sum_time += timer.wall_time();
+  }
+
+  std::cout << "Cells " << n_cells << " DoFs " << n_dofs << " constraints " << n_constraints
+            << std::endl;
+  std::cout << "vmult: min " << min_time << " s, avg " << sum_time / n_repetitions << " s, "
+            << 1.e-6 * n_dofs / min_time << " MDoFs/s, result norm " << dst.l2_norm()
+            << std::endl;
+}
+
+template <int dim, unsigned int degree, ReplayedForm form>
+void
+replay(const Capture<dim>& capture, const unsigned int n_repetitions)
+{
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  using ReplayedType = Replayed<dim, degree, form>;
+
+  Triangulation<dim> tr;
+  capture.create_triangulation(tr);
+
+  AssertThrow(capture.components.size() == 1, ExcNotImplemented());
+  const typename ReplayedType::FiniteElementType fe(degree);
+  DoFHandler<dim> dof(tr);
+  AffineConstraints<double> constraints;
+  setup_dofs(capture, 0, fe, dof, constraints);
+
+  const auto mapping = capture.create_mapping();
+  auto mf = std::make_shared<MatrixFree<dim, double>>();
+  mf->reinit(*mapping,
+             std::vector<const DoFHandler<dim>*>{ &dof },
+             std::vector<const AffineConstraints<double>*>{ &constraints },
+             capture.create_quadratures(),
+             capture.template create_additional_data<double>());
+
+  typename ReplayedType::Standard::Integrator integrator;
+  integrator.initialize(mf,
+                        std::make_shared<typename ReplayedType::Standard::FormType>(
+                          ReplayedType::forms()),
+                        std::make_shared<typename ReplayedType::Standard::FEDatasType>(
+                          ReplayedType::fe_datas(fe)));
+
+  VectorType src, dst;
+  mf->initialize_dof_vector(src);
+  mf->initialize_dof_vector(dst);
+  capture.fill_src(src);
+
+  time_vmult(integrator,
+             dst,
+             src,
+             n_repetitions,
+             tr.n_active_cells(),
+             dof.n_dofs(),
+             constraints.n_constraints());
+}
+
+// Taylor-Hood elements with the velocity degree <code>degree</code> on the
+// first and the pressure on the second DoFHandler, as in StandardForms::Stokes
+template <int dim, unsigned int degree>
+void
+replay_stokes(const Capture<dim>& capture, const unsigned int n_repetitions)
+{
+  using Standard = StandardForms::Stokes<dim, degree, double>;
+
+  Triangulation<dim> tr;
+  capture.create_triangulation(tr);
+
+  AssertThrow(capture.components.size() == 2, ExcNotImplemented());
+  const FESystem<dim> fe_u(FE_Q<dim>(degree), dim);
+  const FE_Q<dim> fe_p(degree - 1);
+  DoFHandler<dim> dof_u(tr), dof_p(tr);
+  AffineConstraints<double> constraints_u, constraints_p;
+  setup_dofs(capture, 0, fe_u, dof_u, constraints_u);
+  setup_dofs(capture, 1, fe_p, dof_p, constraints_p);
+
+  const auto mapping = capture.create_mapping();
+  auto mf = std::make_shared<MatrixFree<dim, double>>();
+  mf->reinit(*mapping,
+             std::vector<const DoFHandler<dim>*>{ &dof_u, &dof_p },
+             std::vector<const AffineConstraints<double>*>{ &constraints_u, &constraints_p },
+             capture.create_quadratures(),
+             capture.template create_additional_data<double>());
+
+  FEData<FESystem, degree, dim, dim, 0, degree> fedata_u(fe_u);
+  FEData<FE_Q, degree - 1, 1, dim, 1, degree> fedata_p(fe_p);
+  const typename Standard::FEDatasType fe_datas = (fedata_u, fedata_p);
+  typename Standard::Integrator integrator;
+  integrator.initialize(
+    mf,
+    std::make_shared<typename Standard::FormType>(StandardForms::stokes_form<dim>()),
+    std::make_shared<typename Standard::FEDatasType>(fe_datas));
+
+  typename Standard::VectorType src(2), dst(2);
+  integrator.initialize_dof_vector(src);
+  integrator.initialize_dof_vector(dst);
+  capture.fill_src(src);
+
+  time_vmult(integrator,
+             dst,
+             src,
+             n_repetitions,
+             tr.n_active_cells(),
+             dof_u.n_dofs() + dof_p.n_dofs(),
+             constraints_u.n_constraints() + constraints_p.n_constraints());
+}
+
+template <int dim>
+void
+replay(const std::string& filename, const unsigned int n_repetitions)
+{
+  const auto capture = Capture<dim>::read(filename);
+  AssertThrow(!capture.components.empty(), ExcMessage("The capture contains no DoFHandler"));
+  std::cout << "Replaying " << filename << ": " << dim << "D, " << capture.components[0].fe_name
+            << std::endl;
+
+  ReplayedForm form = ReplayedForm::mass;
+  if (capture.form == typeid(StandardForms::MassForm<dim>).name())
+    form = ReplayedForm::mass;
+  else if (capture.form == typeid(StandardForms::LaplaceForm<dim>).name())
+    form = ReplayedForm::laplace;
+  else if (capture.form == typeid(StandardForms::SIPGLaplaceForm<dim>).name())
+    form = ReplayedForm::sipg;
+  else if (capture.form == typeid(StandardForms::StokesForm<dim>).name())
+    form = ReplayedForm::stokes;
+  else
+    AssertThrow(false,
+                ExcMessage("The Form " + capture.form + " is not compiled into this replay!"));
+
+  dispatch_degree(capture.create_fe(0)->degree, [&](auto degree_constant) {
+    constexpr unsigned int fe_degree = decltype(degree_constant)::value;
+    switch (form)
+    {
+      case ReplayedForm::mass:
+        return replay<dim, fe_degree, ReplayedForm::mass>(capture, n_repetitions);
+      case ReplayedForm::laplace:
+        return replay<dim, fe_degree, ReplayedForm::laplace>(capture, n_repetitions);
+      case ReplayedForm::sipg:
+        return replay<dim, fe_degree, ReplayedForm::sipg>(capture, n_repetitions);
+      case ReplayedForm::stokes:
+        if constexpr(fe_degree >= 2)
+          return replay_stokes<dim, fe_degree>(capture, n_repetitions);
+        AssertThrow(false, ExcMessage("The velocity degree has to be at least 2"));
+        break;
+    }
+  });
+}
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  deallog.depth_console(0);
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <capture file> <n_repetitions>" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    const std::string filename = argv[1];
+    const unsigned int n_repetitions = (argc > 2) ? std::stoi(argv[2]) : 20;
+    const unsigned int dim = Capture<2>::dimension(filename);
+    AssertThrow(dim == 2 || dim == 3, ExcNotImplemented());
+    if (dim == 2)
+      replay<2>(filename, n_repetitions);
+    else
+      replay<3>(filename, n_repetitions);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
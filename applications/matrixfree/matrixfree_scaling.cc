@@ -0,0 +1,300 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/base/conditional_ostream.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/multigrid/mg_matrix.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_tools.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+#include <deal.II/multigrid/multigrid.h>
+
+#include <cfl/matrixfree/degree_dispatch.h>
+#include <cfl/matrixfree/standard_forms.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+const unsigned int dimension = 3;
+
+// Weak and strong scaling of the Laplace operator of StandardForms on the
+// distributed mesh of MatrixFreeData:
+//   mpirun -np <ranks> ./matrixfree_scaling weak <degree> <dofs_per_rank> <n_repetitions>
+//   mpirun -np <ranks> ./matrixfree_scaling strong <degree> <refine> <n_repetitions>
+// In weak mode, the mesh is a box of m * ranks unit cells, each refined
+// globally r times. r is the largest refinement for which one cell has at
+// most dofs_per_rank degrees of freedom and m the closest number of cells
+// giving dofs_per_rank. Since m and r do not depend on the number of ranks,
+// every rank owns m * 2^(dim r) cells at any rank count. The box is
+// subdivided as evenly as the factors of m * ranks allow. In strong mode,
+// the unit cube is refined refine times independently of the number of
+// ranks.
+//
+// Each rank times the operator apply, the ghost exchange of one apply, i.e.
+// the import of the ghost values of the source and the export of the ghost
+// contributions to the destination, and one V-cycle of the geometric
+// multigrid preconditioner of step-37. The minimum, average and maximum
+// over the ranks are printed, the throughput is computed from the maximum.
+namespace
+{
+template <class Function>
+Utilities::MPI::MinMaxAvg
+time_per_rank(const Function& function, const unsigned int n_repetitions)
+{
+  function();
+  MPI_Barrier(MPI_COMM_WORLD);
+  Timer timer;
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+    function();
+  timer.stop();
+  return Utilities::MPI::min_max_avg(timer.wall_time() / n_repetitions, MPI_COMM_WORLD);
+}
+
+// n split into dim factors, as close to each other as its prime factors allow
+std::vector<unsigned int>
+balanced_factors(unsigned int n, const unsigned int dim)
+{
+  std::vector<unsigned int> primes;
+  for (unsigned int p = 2; p * p <= n; ++p)
+    for (; n % p == 0; n /= p)
+      primes.push_back(p);
+  if (n > 1)
+    primes.push_back(n);
+
+  std::vector<unsigned int> factors(dim, 1);
+  for (auto p = primes.rbegin(); p != primes.rend(); ++p)
+    *std::min_element(factors.begin(), factors.end()) *= *p;
+  std::sort(factors.rbegin(), factors.rend());
+  return factors;
+}
+
+void
+print(ConditionalOStream& pcout, const std::string& name, const Utilities::MPI::MinMaxAvg& time,
+      const types::global_dof_index n_dofs)
+{
+  pcout << std::left << std::setw(16) << name << std::right << std::scientific
+        << std::setprecision(3) << std::setw(12) << time.min << std::setw(12) << time.avg
+        << std::setw(12) << time.max << std::fixed << std::setprecision(2) << std::setw(10)
+        << 1.e-6 * n_dofs / time.max << std::defaultfloat << std::endl;
+}
+
+template <int dim, unsigned int degree>
+void
+run(const std::vector<unsigned int>& repetitions, unsigned int refine, unsigned int n_repetitions,
+    ConditionalOStream& pcout)
+{
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  using LevelVectorType = LinearAlgebra::distributed::Vector<float>;
+  using LevelOperator = typename StandardForms::Laplace<dim, degree, float>::Integrator;
+
+  FE_Q<dim> fe(degree);
+  FEData<FE_Q, degree, 1, dim, 0, degree, double> fedata(fe);
+  typename StandardForms::Laplace<dim, degree, double>::FEDatasType fe_datas{ fedata };
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe);
+  auto form = std::make_shared<StandardForms::LaplaceForm<dim>>(StandardForms::laplace_form<dim>());
+
+  MatrixFreeData<dim, decltype(fe_datas), StandardForms::LaplaceForm<dim>, VectorType> data(
+    3, refine, fes, std::make_shared<decltype(fe_datas)>(fe_datas), form, repetitions);
+  const types::global_dof_index n_dofs = data.get_dof_handler().n_dofs();
+  pcout << "Cells " << data.get_triangulation().n_global_active_cells() << " DoFs " << n_dofs
+        << " DoFs per rank " << n_dofs / Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD)
+        << std::endl;
+
+  VectorType src, dst;
+  data.get_matrix_free().initialize_dof_vector(src);
+  data.get_matrix_free().initialize_dof_vector(dst);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = std::sin(1. + src.get_partitioner()->local_to_global(i));
+
+  const auto apply = time_per_rank([&]() { data.vmult(dst, src); }, n_repetitions);
+  const auto exchange = time_per_rank(
+    [&]() {
+      src.update_ghost_values();
+      src.zero_out_ghosts();
+      dst.compress(VectorOperation::add);
+    },
+    n_repetitions);
+
+  // the level operators of step-37 on a second DoFHandler with level DoFs
+  DoFHandler<dim> dof_handler(data.get_triangulation());
+  dof_handler.distribute_dofs(fe);
+  dof_handler.distribute_mg_dofs();
+
+  MGConstrainedDoFs mg_constrained_dofs;
+  mg_constrained_dofs.initialize(dof_handler);
+  mg_constrained_dofs.make_zero_boundary_constraints(dof_handler,
+                                                     std::set<types::boundary_id>{ 0 });
+
+  FEData<FE_Q, degree, 1, dim, 0, degree, float> fedata_level(fe);
+  const typename StandardForms::Laplace<dim, degree, float>::FEDatasType fe_datas_level{
+    fedata_level
+  };
+  const unsigned int n_levels = data.get_triangulation().n_global_levels();
+  MGLevelObject<LevelOperator> mg_matrices(0, n_levels - 1);
+  for (unsigned int level = 0; level < n_levels; ++level)
+  {
+    IndexSet relevant_dofs;
+    DoFTools::extract_locally_relevant_level_dofs(dof_handler, level, relevant_dofs);
+    AffineConstraints<double> level_constraints;
+    level_constraints.reinit(relevant_dofs);
+    level_constraints.add_lines(mg_constrained_dofs.get_boundary_indices(level));
+    level_constraints.close();
+
+    typename MatrixFree<dim, float>::AdditionalData additional_data;
+    ExecutionParameters().apply(additional_data);
+    additional_data.mapping_update_flags = update_gradients | update_JxW_values;
+    additional_data.level_mg_handler = level;
+    auto level_mf = std::make_shared<MatrixFree<dim, float>>();
+    level_mf->reinit(dof_handler, level_constraints, QGauss<1>(degree + 1), additional_data);
+    mg_matrices[level].initialize(
+      level_mf,
+      mg_constrained_dofs,
+      level,
+      std::make_shared<StandardForms::LaplaceForm<dim>>(*form),
+      std::make_shared<typename StandardForms::Laplace<dim, degree, float>::FEDatasType>(
+        fe_datas_level));
+  }
+
+  MGTransferMatrixFree<dim, float> mg_transfer(mg_constrained_dofs);
+  mg_transfer.build(dof_handler);
+
+  using SmootherType = PreconditionChebyshev<LevelOperator, LevelVectorType>;
+  mg::SmootherRelaxation<SmootherType, LevelVectorType> mg_smoother;
+  MGLevelObject<typename SmootherType::AdditionalData> smoother_data(0, n_levels - 1);
+  for (unsigned int level = 0; level < n_levels; ++level)
+  {
+    if (level > 0)
+    {
+      smoother_data[level].smoothing_range = 15.;
+      smoother_data[level].degree = 4;
+      smoother_data[level].eig_cg_n_iterations = 10;
+    }
+    else
+    {
+      smoother_data[0].smoothing_range = 1e-3;
+      smoother_data[0].degree = numbers::invalid_unsigned_int;
+      smoother_data[0].eig_cg_n_iterations = mg_matrices[0].m();
+    }
+    mg_matrices[level].compute_diagonal();
+    smoother_data[level].preconditioner = mg_matrices[level].get_matrix_diagonal_inverse();
+  }
+  mg_smoother.initialize(mg_matrices, smoother_data);
+
+  MGCoarseGridApplySmoother<LevelVectorType> mg_coarse;
+  mg_coarse.initialize(mg_smoother);
+  mg::Matrix<LevelVectorType> mg_matrix(mg_matrices);
+  MGLevelObject<MatrixFreeOperators::MGInterfaceOperator<LevelOperator>> mg_interface_matrices(
+    0, n_levels - 1);
+  for (unsigned int level = 0; level < n_levels; ++level)
+    mg_interface_matrices[level].initialize(mg_matrices[level]);
+  mg::Matrix<LevelVectorType> mg_interface(mg_interface_matrices);
+
+  Multigrid<LevelVectorType> mg(mg_matrix, mg_coarse, mg_transfer, mg_smoother, mg_smoother);
+  mg.set_edge_matrices(mg_interface, mg_interface);
+  PreconditionMG<dim, LevelVectorType, MGTransferMatrixFree<dim, float>> preconditioner(
+    dof_handler, mg, mg_transfer);
+
+  IndexSet relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs(dof_handler, relevant_dofs);
+  VectorType residual(dof_handler.locally_owned_dofs(), relevant_dofs, MPI_COMM_WORLD);
+  VectorType correction(dof_handler.locally_owned_dofs(), relevant_dofs, MPI_COMM_WORLD);
+  for (unsigned int i = 0; i < residual.local_size(); ++i)
+    residual.local_element(i) = std::sin(1. + residual.get_partitioner()->local_to_global(i));
+
+  const auto v_cycle =
+    time_per_rank([&]() { preconditioner.vmult(correction, residual); }, n_repetitions);
+
+  pcout << "                    min [s]     avg [s]     max [s]   MDoFs/s" << std::endl;
+  print(pcout, "operator apply", apply, n_dofs);
+  print(pcout, "ghost exchange", exchange, n_dofs);
+  print(pcout, "V-cycle", v_cycle, n_dofs);
+}
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  try
+  {
+    Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+    deallog.depth_console(0);
+    ConditionalOStream pcout(std::cout, Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0);
+
+    const std::string mode = (argc > 1) ? argv[1] : "weak";
+    const unsigned int degree = (argc > 2) ? std::stoi(argv[2]) : 2;
+    const unsigned int n_repetitions = (argc > 4) ? std::stoi(argv[4]) : 20;
+    const unsigned int n_ranks = Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD);
+    AssertThrow(mode == "weak" || mode == "strong",
+                ExcMessage("The mode has to be \"weak\" or \"strong\", not \"" + mode + "\""));
+#ifndef DEAL_II_WITH_P4EST
+    AssertThrow(n_ranks == 1, ExcMessage("Scaling over several ranks needs deal.II with p4est"));
+#endif
+
+    unsigned int refine = 0;
+    std::vector<unsigned int> repetitions(dimension, 1);
+    if (mode == "strong")
+      refine = (argc > 3) ? std::stoi(argv[3]) : 4;
+    else
+    {
+      const double dofs_per_rank = (argc > 3) ? std::stod(argv[3]) : 1.e5;
+      const double cells_per_rank = dofs_per_rank / std::pow(degree, dimension);
+      while (std::pow(2., dimension * (refine + 1)) <= cells_per_rank)
+        ++refine;
+      const unsigned int coarse_cells_per_rank = std::max(
+        1., std::round(cells_per_rank / std::pow(2., dimension * refine)));
+      repetitions = balanced_factors(coarse_cells_per_rank * n_ranks, dimension);
+    }
+
+    pcout << "Scaling " << mode << ", ranks " << n_ranks << ", degree " << degree << ", "
+          << dimension << "D, coarse cells";
+    for (unsigned int d = 0; d < dimension; ++d)
+      pcout << (d == 0 ? " " : "x") << repetitions[d];
+    pcout << ", refine " << refine << std::endl;
+    dispatch_degree(degree, [&](auto degree_constant) {
+      run<dimension, decltype(degree_constant)::value>(repetitions, refine, n_repetitions, pcout);
+    });
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
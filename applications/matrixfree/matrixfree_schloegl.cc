@@ -59,6 +59,7 @@
 #include <iostream>
 #include <sstream>
 
+#include <cfl/matrixfree/async_output.h>
 #include <cfl/matrixfree/fe_data.h>
 #include <cfl/matrixfree/fefunctions.h>
 #include <cfl/matrixfree/forms.h>
@@ -179,6 +180,9 @@ private:
   LinearAlgebra::distributed::BlockVector<double> solution_update;
   LinearAlgebra::distributed::BlockVector<double> system_rhs;
 
+  // writes the VTU files while the next cycle is computed
+  mutable AsyncDataOut<dim> data_out;
+
   double setup_time{};
   ConditionalOStream pcout;
   ConditionalOStream time_details;
@@ -205,6 +209,7 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, FormSystem, FormRHS>::LaplacePr
   , solution(2)
   , solution_update(2)
   , system_rhs(2)
+  , data_out(dof_handler, degree_finite_element)
   , pcout(std::cout, Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
   , time_details(std::cout, false)
 {
@@ -214,6 +219,9 @@ template <int dim, class FEDatasSystem, class FEDatasLevel, class FormSystem, cl
 void
 LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, FormSystem, FormRHS>::setup_system()
 {
+  // pending output refers to the old degrees of freedom
+  data_out.flush();
+
   Timer time;
   time.start();
   setup_time = 0;
@@ -502,34 +510,7 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, FormSystem, FormRHS>::output_re
   if (triangulation.n_global_active_cells() > 1000000)
     return;
 
-  DataOut<dim> data_out;
-
-  solution.update_ghost_values();
-  data_out.attach_dof_handler(dof_handler);
-  data_out.add_data_vector(solution.block(0), "solution");
-  data_out.build_patches(degree_finite_element);
-
-  std::ostringstream filename;
-  filename << "solution-" << cycle << "." << Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)
-           << ".vtu";
-
-  std::ofstream output(filename.str().c_str());
-  data_out.write_vtu(output);
-
-  if (Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)
-  {
-    std::vector<std::string> filenames;
-    for (unsigned int i = 0; i < Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD); ++i)
-    {
-      std::ostringstream filename;
-      filename << "solution-" << cycle << "." << i << ".vtu";
-
-      filenames.emplace_back(filename.str());
-    }
-    std::string master_name = "solution-" + Utilities::to_string(cycle) + ".pvtu";
-    std::ofstream master_output(master_name.c_str());
-    data_out.write_pvtu_record(master_output, filenames);
-  }
+  data_out.write("solution", cycle, { { &solution.block(0), "solution" } });
 }
 
 template <int dim, class FEDatasSystem, class FEDatasLevel, class FormSystem, class FormRHS>
@@ -35,6 +35,7 @@
 #include <deal.II/fe/fe_values.h>
 
 #include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_refinement.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_accessor.h>
 #include <deal.II/grid/tria_iterator.h>
@@ -47,15 +48,24 @@
 #include <deal.II/multigrid/multigrid.h>
 
 #include <deal.II/numerics/data_out.h>
+#include <deal.II/numerics/error_estimator.h>
 #include <deal.II/numerics/vector_tools.h>
 
+#ifdef DEAL_II_WITH_P4EST
+#include <deal.II/distributed/grid_refinement.h>
+#endif
+
 #include <deal.II/matrix_free/fe_evaluation.h>
 #include <deal.II/matrix_free/matrix_free.h>
 
+#include <cstdint>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <sstream>
+#include <string>
 
+#include <cfl/matrixfree/auto_tuner.h>
 #include <cfl/matrixfree/fe_data.h>
 #include <cfl/matrixfree/fefunctions.h>
 #include <cfl/matrixfree/forms.h>
@@ -73,15 +83,21 @@ template <int dim, class FEDatasSystem, class FEDatasLevel, class Form>
 class LaplaceProblem
 {
 public:
-  LaplaceProblem(FEDatasSystem& mf_cfl_data_system_, FEDatasLevel& mf_cfl_data_level_, Form& form_);
+  LaplaceProblem(FEDatasSystem& mf_cfl_data_system_, FEDatasLevel& mf_cfl_data_level_, Form& form_,
+                 const bool adaptive_refinement_ = false);
   void run();
 
 private:
   void setup_system();
+  void setup_system_matrix(const ExecutionParameters& parameters);
   void assemble_rhs();
+  void measure_vmult() const;
   void solve();
+  void refine_grid();
   void output_results(const unsigned int cycle) const;
 
+  const bool adaptive_refinement;
+
   FEDatasSystem& mf_cfl_data_system;
   FEDatasLevel& mf_cfl_data_level;
   Form& form;
@@ -100,6 +116,7 @@ private:
   typedef MatrixFreeIntegrator<dim, LinearAlgebra::distributed::Vector<double>, Form, FEDatasSystem>
     SystemMatrixType;
   SystemMatrixType system_matrix;
+  AutoTuner tuner;
 
   MGLevelObject<MatrixFree<dim, float>> mg_mf_storage;
   typedef MatrixFreeIntegrator<dim, LinearAlgebra::distributed::Vector<float>, Form, FEDatasLevel>
@@ -118,8 +135,10 @@ private:
 
 template <int dim, class FEDatasSystem, class FEDatasLevel, class Form>
 LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::LaplaceProblem(
-  FEDatasSystem& mf_cfl_data_system_, FEDatasLevel& mf_cfl_data_level_, Form& form_)
-  : mf_cfl_data_system(mf_cfl_data_system_)
+  FEDatasSystem& mf_cfl_data_system_, FEDatasLevel& mf_cfl_data_level_, Form& form_,
+  const bool adaptive_refinement_)
+  : adaptive_refinement(adaptive_refinement_)
+  , mf_cfl_data_system(mf_cfl_data_system_)
   , mf_cfl_data_level(mf_cfl_data_level_)
   , form(form_)
   ,
@@ -163,23 +182,34 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::setup_system()
   DoFTools::make_hanging_node_constraints(dof_handler, constraints);
   VectorTools::interpolate_boundary_values(dof_handler, 0, ZeroFunction<dim>(), constraints);
   constraints.close();
+  pcout << "Number of constrained DoFs:   " << constraints.n_constraints() << std::endl;
   setup_time += time.wall_time();
   time_details << "Distribute DoFs & B.C.     (CPU/wall) " << time.cpu_time() << "s/"
                << time.wall_time() << "s" << std::endl;
   time.restart();
+  ExecutionParameters parameters;
+  if (adaptive_refinement)
   {
-    typename MatrixFree<dim, double>::AdditionalData additional_data;
-    additional_data.tasks_parallel_scheme = MatrixFree<dim, double>::AdditionalData::none;
-    additional_data.mapping_update_flags =
-      (update_gradients | update_JxW_values | update_quadrature_points);
-    system_mf_storage.reinit(dof_handler, constraints, QGauss<1>(fe.degree + 1), additional_data);
+    // on locally refined meshes, the tuner also tries to group the cells by level
+    const std::uint64_t n_uniform_cells = static_cast<std::uint64_t>(triangulation.n_cells(0))
+                                          << (dim * (triangulation.n_global_levels() - 1));
+    const bool locally_refined = triangulation.n_global_active_cells() != n_uniform_cells;
+    parameters = tuner.tune(
+      AutoTuner::key<Form>(fe.degree, dim, triangulation.n_global_active_cells(), locally_refined),
+      [this](const ExecutionParameters& candidate) -> std::function<void()> {
+        setup_system_matrix(candidate);
+        auto src = std::make_shared<LinearAlgebra::distributed::Vector<double>>();
+        auto dst = std::make_shared<LinearAlgebra::distributed::Vector<double>>();
+        system_matrix.initialize_dof_vector(*src);
+        system_matrix.initialize_dof_vector(*dst);
+        *src = 1.;
+        return [this, src, dst]() { system_matrix.vmult(*dst, *src); };
+      },
+      locally_refined);
+    pcout << "Cells grouped by level:       " << (parameters.group_cells_by_level ? "yes" : "no")
+          << std::endl;
   }
-
-  system_matrix.initialize(std::make_shared<MatrixFree<dim, double>>(system_mf_storage),
-                           std::make_shared<Form>(form),
-                           std::make_shared<FEDatasSystem>(mf_cfl_data_system));
-
-  //    system_matrix.evaluate_coefficient(Coefficient<dim>());
+  setup_system_matrix(parameters);
 
   system_matrix.initialize_dof_vector(solution);
   system_matrix.initialize_dof_vector(system_rhs);
@@ -228,6 +258,24 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::setup_system()
                << time.wall_time() << "s" << std::endl;
 }
 
+template <int dim, class FEDatasSystem, class FEDatasLevel, class Form>
+void
+LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::setup_system_matrix(
+  const ExecutionParameters& parameters)
+{
+  typename MatrixFree<dim, double>::AdditionalData additional_data;
+  parameters.apply(additional_data, triangulation);
+  additional_data.mapping_update_flags =
+    (update_gradients | update_JxW_values | update_quadrature_points);
+  system_mf_storage.reinit(dof_handler, constraints, QGauss<1>(fe.degree + 1), additional_data);
+
+  system_matrix.initialize(std::make_shared<MatrixFree<dim, double>>(system_mf_storage),
+                           std::make_shared<Form>(form),
+                           std::make_shared<FEDatasSystem>(mf_cfl_data_system));
+
+  //    system_matrix.evaluate_coefficient(Coefficient<dim>());
+}
+
 template <int dim, class FEDatasSystem, class FEDatasLevel, class Form>
 void
 LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::assemble_rhs()
@@ -251,6 +299,29 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::assemble_rhs()
                << time.wall_time() << "s" << std::endl;
 }
 
+// Time the application of the system matrix, which is dominated by the
+// cell loop for uniform meshes and picks up the hanging node resolution
+// in read_dof_values() and distribute_local_to_global() for adaptive ones.
+template <int dim, class FEDatasSystem, class FEDatasLevel, class Form>
+void
+LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::measure_vmult() const
+{
+  LinearAlgebra::distributed::Vector<double> src, dst;
+  system_matrix.initialize_dof_vector(src);
+  system_matrix.initialize_dof_vector(dst);
+  src = 1.;
+
+  const unsigned int n_repetitions = 20;
+  Timer time;
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+    system_matrix.vmult(dst, src);
+  time.stop();
+
+  const double time_per_vmult = time.wall_time() / n_repetitions;
+  pcout << "Time matrix-vector product     (wall) " << time_per_vmult << "s, "
+        << dof_handler.n_dofs() / time_per_vmult << " DoFs/s\n";
+}
+
 template <int dim, class FEDatasSystem, class FEDatasLevel, class Form>
 void
 LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::solve()
@@ -322,6 +393,30 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::solve()
         << time.cpu_time() << "s/" << time.wall_time() << "s\n";
 }
 
+// Refine the cells with the largest Kelly error indicators. The mesh
+// keeps the level difference at vertices limited to one as required by
+// the multigrid setup.
+template <int dim, class FEDatasSystem, class FEDatasLevel, class Form>
+void
+LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::refine_grid()
+{
+  Vector<float> estimated_error_per_cell(triangulation.n_active_cells());
+  solution.update_ghost_values();
+  KellyErrorEstimator<dim>::estimate(dof_handler,
+                                     QGauss<dim - 1>(fe.degree + 1),
+                                     typename FunctionMap<dim>::type(),
+                                     solution,
+                                     estimated_error_per_cell);
+#ifdef DEAL_II_WITH_P4EST
+  parallel::distributed::GridRefinement::refine_and_coarsen_fixed_number(
+    triangulation, estimated_error_per_cell, 0.3, 0.03);
+#else
+  GridRefinement::refine_and_coarsen_fixed_number(
+    triangulation, estimated_error_per_cell, 0.3, 0.03);
+#endif
+  triangulation.execute_coarsening_and_refinement();
+}
+
 template <int dim, class FEDatasSystem, class FEDatasLevel, class Form>
 void
 LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::output_results(
@@ -373,10 +468,15 @@ LaplaceProblem<dim, FEDatasSystem, FEDatasLevel, Form>::run()
     {
       GridGenerator::hyper_cube(triangulation, 0., 1.);
       triangulation.refine_global(3 - dim);
+      triangulation.refine_global(1);
     }
-    triangulation.refine_global(1);
+    else if (adaptive_refinement)
+      refine_grid();
+    else
+      triangulation.refine_global(1);
     setup_system();
     assemble_rhs();
+    measure_vmult();
     solve();
     // output_results(cycle);
     pcout << std::endl;
@@ -393,6 +493,9 @@ main(int argc, char* argv[])
 
     Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
 
+    // run with "adaptive" as first argument to refine by Kelly indicators instead of globally
+    const bool adaptive_refinement = argc > 1 && std::string(argv[1]) == "adaptive";
+
     FE_Q<dimension> fe_u(degree_finite_element);
 
     FEData<FE_Q, 2, 1, dimension, 0, 2, double> fedata_double(fe_u);
@@ -410,7 +513,7 @@ main(int argc, char* argv[])
                    decltype(fe_datas_system),
                    decltype(fe_datas_level),
                    decltype(f_system)>
-      laplace_problem(fe_datas_system, fe_datas_level, f_system);
+      laplace_problem(fe_datas_system, fe_datas_level, f_system, adaptive_refinement);
     laplace_problem.run();
   }
   catch (std::exception& exc)
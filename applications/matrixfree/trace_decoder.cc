@@ -0,0 +1,50 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <cfl/matrixfree/trace.h>
+
+#include <exception>
+#include <iostream>
+
+using namespace CFL::dealii::MatrixFree;
+
+// Prints a trace file written by Trace::Recorder::write(), one line per
+// event with the thread and the cell or face batch.
+int
+main(int argc, char** argv)
+{
+  if (argc != 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <trace file>" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    for (const auto& thread : Trace::Recorder::read(argv[1]))
+    {
+      std::cout << "thread " << thread.thread << ": " << thread.n_recorded
+                << " events recorded, the last " << thread.events.size() << " kept" << std::endl;
+      for (const auto& event : thread.events)
+      {
+        std::cout << "thread " << thread.thread << " batch " << event.batch << ": ";
+        Trace::print(std::cout, event);
+        std::cout << std::endl;
+      }
+    }
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "meshworker_data.h"
+#include <deal.II/base/timer.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/lac/vector.h>
+#include <cfl/meshworker/forms.h>
+#include <cfl/meshworker/fefunctions.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MeshWorker;
+using namespace ::dealii;
+
+// The interior penalty discretization of the Laplacian in
+// matrixfree_laplace_dg.cc evaluated with the MeshWorker backend. The time
+// for applying the operator can be compared with the one of the matrix-free
+// implementation on the same mesh and polynomial degree.
+template <int dim>
+void
+run(unsigned int grid_index, unsigned int refine, unsigned int degree, unsigned int n_repeat)
+{
+  FE_DGQ<dim> fe(degree);
+  MeshworkerData<dim> data(grid_index, refine, fe);
+
+  TestFunction<0, dim> v(0, 0);
+  auto Dv = grad(v);
+  TestFunctionInteriorFace<0, dim> v_p(0, 0);
+  TestFunctionExteriorFace<0, dim> v_m(0, 0);
+  TestNormalGradientInteriorFace<0, dim> Dnv_p(0, 0);
+  TestNormalGradientExteriorFace<0, dim> Dnv_m(0, 0);
+
+  FEFunction<0, dim> u(0, 0);
+  auto Du = grad(u);
+  FEFunctionInteriorFace<0, dim> u_p(0, 0);
+  FEFunctionExteriorFace<0, dim> u_m(0, 0);
+  FENormalGradientInteriorFace<0, dim> Dnu_p(0, 0);
+  FENormalGradientExteriorFace<0, dim> Dnu_m(0, 0);
+
+  auto cell = CFL::dealii::MeshWorker::form(Du, Dv);
+
+  auto flux = u_p - u_m;
+  auto flux_grad = Dnu_p - Dnu_m;
+
+  auto flux1 = -CFL::dealii::MeshWorker::face_form(flux, Dnv_p) +
+               CFL::dealii::MeshWorker::face_form(flux, Dnv_m);
+  auto flux2 = CFL::dealii::MeshWorker::face_form(-flux + .5 * flux_grad, v_p) -
+               CFL::dealii::MeshWorker::face_form(-flux + .5 * flux_grad, v_m);
+
+  auto boundary1 = CFL::dealii::MeshWorker::boundary_form(2. * u_p - Dnu_p, v_p);
+  auto boundary3 = -CFL::dealii::MeshWorker::boundary_form(u_p, Dnv_p);
+
+  auto face = -flux2 + .5 * flux1;
+  auto f = cell + face + boundary1 + boundary3;
+
+  Vector<double> x, b;
+  data.resize_vector(x);
+  data.resize_vector(b);
+
+  for (unsigned int i = 0; i < b.size(); ++i)
+    b[i] = i;
+
+  Timer timer;
+  for (unsigned int i = 0; i < n_repeat; ++i)
+  {
+    x = 0.;
+    data.vmult(x, b, f);
+  }
+  timer.stop();
+  deallog << "Residual |x| " << x.l2_norm() << " time per evaluation "
+          << timer.wall_time() / n_repeat << " s" << std::endl;
+
+  SparseMatrix<double> matrix;
+  timer.restart();
+  data.assemble_matrix(matrix, f);
+  timer.stop();
+  deallog << "Matrix assembly time " << timer.wall_time() << " s" << std::endl;
+
+  Vector<double> product;
+  data.resize_vector(product);
+  timer.restart();
+  for (unsigned int i = 0; i < n_repeat; ++i)
+    matrix.vmult(product, b);
+  timer.stop();
+  deallog << "Matrix |Ab| " << product.l2_norm() << " time per product "
+          << timer.wall_time() / n_repeat << " s" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+  deallog.depth_console(10);
+  ::dealii::MultithreadInfo::set_thread_limit((argc > 1) ? atoi(argv[1]) : 1);
+  std::cout << ::dealii::MultithreadInfo::n_threads() << std::endl;
+  try
+  {
+    for (unsigned int refine = 1; refine < 5; ++refine)
+      run<2>(0, refine, 2, 10);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,169 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "meshworker_data.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/lac/vector.h>
+#include <cfl/meshworker/forms.h>
+#include <cfl/meshworker/fefunctions.h>
+
+#include <array>
+#include <iomanip>
+#include <string>
+
+using namespace CFL;
+using namespace CFL::dealii::MeshWorker;
+using namespace ::dealii;
+
+// Strong scaling of the MeshWorker backend from 1 to N threads:
+//   ./meshworker_scaling <max_threads> <refine>
+// Apply and assemble the interior penalty operator of
+// meshworker_laplace_dg.cc on a fixed mesh and print the wall time per call
+// and the speedup over one thread. The plain MeshWorker loop serializes
+// adding local results to the global vector or matrix, while the colored
+// loop adds them in parallel. The results of the colored loop are checked
+// against the serial plain loop for every number of threads.
+template <int dim>
+void
+run(unsigned int refine, unsigned int degree, unsigned int max_threads, unsigned int n_repeat)
+{
+  FE_DGQ<dim> fe(degree);
+  MeshworkerData<dim> data(0, refine, fe);
+
+  TestFunction<0, dim> v(0, 0);
+  auto Dv = grad(v);
+  TestFunctionInteriorFace<0, dim> v_p(0, 0);
+  TestFunctionExteriorFace<0, dim> v_m(0, 0);
+  TestNormalGradientInteriorFace<0, dim> Dnv_p(0, 0);
+  TestNormalGradientExteriorFace<0, dim> Dnv_m(0, 0);
+
+  FEFunction<0, dim> u(0, 0);
+  auto Du = grad(u);
+  FEFunctionInteriorFace<0, dim> u_p(0, 0);
+  FEFunctionExteriorFace<0, dim> u_m(0, 0);
+  FENormalGradientInteriorFace<0, dim> Dnu_p(0, 0);
+  FENormalGradientExteriorFace<0, dim> Dnu_m(0, 0);
+
+  auto cell = CFL::dealii::MeshWorker::form(Du, Dv);
+
+  auto flux = u_p - u_m;
+  auto flux_grad = Dnu_p - Dnu_m;
+
+  auto flux1 = -CFL::dealii::MeshWorker::face_form(flux, Dnv_p) +
+               CFL::dealii::MeshWorker::face_form(flux, Dnv_m);
+  auto flux2 = CFL::dealii::MeshWorker::face_form(-flux + .5 * flux_grad, v_p) -
+               CFL::dealii::MeshWorker::face_form(-flux + .5 * flux_grad, v_m);
+
+  auto boundary1 = CFL::dealii::MeshWorker::boundary_form(2. * u_p - Dnu_p, v_p);
+  auto boundary3 = -CFL::dealii::MeshWorker::boundary_form(u_p, Dnv_p);
+
+  auto face = -flux2 + .5 * flux1;
+  auto f = cell + face + boundary1 + boundary3;
+
+  Vector<double> x, b, serial, product;
+  data.resize_vector(x);
+  data.resize_vector(b);
+  data.resize_vector(serial);
+  data.resize_vector(product);
+  SparseMatrix<double> matrix;
+
+  for (unsigned int i = 0; i < b.size(); ++i)
+    b[i] = i;
+
+  const auto time_vmult = [&]() {
+    x = 0.;
+    data.vmult(x, b, f);
+    Timer timer;
+    for (unsigned int i = 0; i < n_repeat; ++i)
+    {
+      x = 0.;
+      data.vmult(x, b, f);
+    }
+    timer.stop();
+    return timer.wall_time() / n_repeat;
+  };
+  const auto time_assemble = [&]() {
+    Timer timer;
+    for (unsigned int i = 0; i < n_repeat; ++i)
+      data.assemble_matrix(matrix, f);
+    timer.stop();
+    return timer.wall_time() / n_repeat;
+  };
+
+  MultithreadInfo::set_thread_limit(1);
+  data.disable_coloring();
+  data.vmult(serial, b, f);
+
+  // plain vmult, colored vmult, plain assembly, colored assembly
+  std::array<double, 4> times_serial{};
+  std::cout << "threads     vmult plain  speedup     colored  speedup  assemble plain  speedup"
+               "     colored  speedup"
+            << std::endl;
+  for (unsigned int n_threads = 1; n_threads <= max_threads; ++n_threads)
+  {
+    MultithreadInfo::set_thread_limit(n_threads);
+
+    std::array<double, 4> times;
+    data.disable_coloring();
+    times[0] = time_vmult();
+    times[2] = time_assemble();
+    data.use_coloring(true);
+    times[1] = time_vmult();
+    times[3] = time_assemble();
+
+    x -= serial;
+    matrix.vmult(product, b);
+    product -= serial;
+    AssertThrow(x.linfty_norm() <= 1.e-12 * serial.linfty_norm() &&
+                  product.linfty_norm() <= 1.e-12 * serial.linfty_norm(),
+                ExcMessage("Colored loop differs from serial loop with " +
+                           std::to_string(n_threads) + " threads"));
+
+    if (n_threads == 1)
+      times_serial = times;
+    std::cout << std::setw(7) << n_threads;
+    for (unsigned int i = 0; i < times.size(); ++i)
+      std::cout << std::scientific << std::setprecision(3) << std::setw(i % 2 == 0 ? 16 : 12)
+                << times[i] << std::fixed << std::setprecision(2) << std::setw(9)
+                << times_serial[i] / times[i];
+    std::cout << std::defaultfloat << std::endl;
+  }
+}
+
+int
+main(int argc, char* argv[])
+{
+  deallog.depth_console(10);
+  const unsigned int max_threads = (argc > 1) ? atoi(argv[1]) : MultithreadInfo::n_cores();
+  const unsigned int refine = (argc > 2) ? atoi(argv[2]) : 5;
+  try
+  {
+    run<2>(refine, 2, max_threads, 10);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
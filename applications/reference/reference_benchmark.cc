@@ -0,0 +1,79 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <cfl/base/fefunctions.h>
+#include <cfl/base/forms.h>
+
+#include <cfl/reference/forms.h>
+#include <cfl/reference/reference_integrator.h>
+#include <cfl/reference/solver_cg.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using namespace CFL;
+using namespace CFL::Reference;
+
+// Measure the throughput of the matrix-free Laplace operator
+// grad(u) * grad(v) + u * v of the reference backend in three dimensions
+// and the time of an unpreconditioned CG solve with this operator. The
+// grid is chosen such that it has about n_dofs degrees of freedom for each
+// degree.
+template <int degree>
+void
+run(unsigned int n_dofs, unsigned int n_repetitions)
+{
+  constexpr int dim = 3;
+  unsigned int n_cells_1d = 1;
+  while (std::pow(n_cells_1d * degree + 1, dim) < n_dofs)
+    ++n_cells_1d;
+  CartesianGrid<dim> grid(n_cells_1d, degree);
+
+  constexpr Base::TestFunction<0, dim, 0> v;
+  constexpr Base::FEFunction<0, dim, 0> u;
+  auto f = transform(Base::form(grad(u), grad(v)) + Base::form(u, v));
+  ReferenceIntegrator<dim, degree, degree + 1, decltype(f)> integrator(grid, f);
+
+  std::vector<double> src, dst;
+  integrator.initialize_vector(src);
+  integrator.initialize_vector(dst);
+  for (unsigned int i = 0; i < src.size(); ++i)
+    src[i] = 1. + (i % 7) * 0.1;
+
+  integrator.vmult(dst, src);
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < n_repetitions; ++i)
+    integrator.vmult(dst, src);
+  const std::chrono::duration<double> vmult_time = std::chrono::steady_clock::now() - start;
+
+  std::vector<double> x;
+  SolverCG solver(10000, 1.e-8);
+  const auto solve_start = std::chrono::steady_clock::now();
+  solver.solve(integrator, x, src);
+  const std::chrono::duration<double> solve_time = std::chrono::steady_clock::now() - solve_start;
+
+  const double time_per_vmult = vmult_time.count() / n_repetitions;
+  std::cout << "degree " << degree << " cells " << grid.n_cells() << " DoFs " << grid.n_dofs()
+            << " vmult " << std::setprecision(3) << std::scientific << time_per_vmult << "s "
+            << std::fixed << std::setprecision(1) << grid.n_dofs() / time_per_vmult * 1.e-6
+            << " MDoF/s CG " << solver.last_step() << " iterations " << std::setprecision(3)
+            << std::scientific << solve_time.count() << "s" << std::endl;
+}
+
+int
+main(int argc, char** argv)
+{
+  const unsigned int n_dofs = argc > 1 ? std::atoi(argv[1]) : 100000;
+  const unsigned int n_repetitions = argc > 2 ? std::atoi(argv[2]) : 10;
+
+  std::cout << "Vectorization width " << CFL_REFERENCE_VECTORIZATION_WIDTH << std::endl;
+  run<1>(n_dofs, n_repetitions);
+  run<2>(n_dofs, n_repetitions);
+  run<3>(n_dofs, n_repetitions);
+  run<4>(n_dofs, n_repetitions);
+  run<5>(n_dofs, n_repetitions);
+  run<6>(n_dofs, n_repetitions);
+}
@@ -0,0 +1,55 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <cfl/runtime/kernel_cache.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace CFL;
+
+// Apply a Form given on the command line with the reference backend, e.g.
+//   runtime_form "form(grad(u), grad(v)) + 2 * form(u * u, v)" 3 4 8
+// The first run for a Form, dimension and degree compiles it into the
+// kernel cache, later runs load the library from there.
+int
+main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <form> [dim] [degree] [cells per direction]"
+              << std::endl;
+    return 1;
+  }
+  const std::string text = argv[1];
+  const int dim = argc > 2 ? std::atoi(argv[2]) : 2;
+  const int degree = argc > 3 ? std::atoi(argv[3]) : 2;
+  const unsigned int n_cells_1d = argc > 4 ? std::atoi(argv[4]) : 16;
+
+  try
+  {
+    Runtime::KernelCache cache;
+    const auto start = std::chrono::steady_clock::now();
+    const auto op = cache.create_operator(text, dim, degree, n_cells_1d);
+    const std::chrono::duration<double> setup = std::chrono::steady_clock::now() - start;
+    std::cout << (cache.n_compilations() > 0 ? "Compiled " : "Loaded ")
+              << cache.library_path(text, dim, degree) << " in " << setup.count() << "s"
+              << std::endl;
+
+    std::vector<double> src(op->m(), 1.), dst;
+    const unsigned int n_repetitions = 10;
+    const auto vmult_start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < n_repetitions; ++i)
+      op->vmult(dst, src);
+    const std::chrono::duration<double> vmult = std::chrono::steady_clock::now() - vmult_start;
+    std::cout << "DoFs " << op->m() << " vmult " << vmult.count() / n_repetitions << "s"
+              << std::endl;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,31 @@
+#
+# A macro to generate a quadrature point kernel with the code generation
+# backend at build time.
+#
+# The program <generator> is compiled into the executable
+# <target>_<name of generator> and run with the path of <header> in the
+# current binary directory as only argument. The generated header can be
+# included by <target>, which is compiled with the additional flags in
+# CFL_CODEGEN_CXX_FLAGS.
+#
+# Usage:
+#     CFL_GENERATE_KERNEL(<target> <generator> <header>)
+#
+
+FUNCTION(CFL_GENERATE_KERNEL _target _generator _header)
+  GET_FILENAME_COMPONENT(_name ${_generator} NAME_WE)
+  SET(_generator_target ${_target}_${_name})
+  SET(_output ${CMAKE_CURRENT_BINARY_DIR}/${_header})
+
+  ADD_EXECUTABLE(${_generator_target} ${_generator})
+  ADD_CUSTOM_COMMAND(OUTPUT ${_output}
+                     COMMAND ${_generator_target} ${_output}
+                     DEPENDS ${_generator_target}
+                     COMMENT "Generating quadrature point kernel ${_header}")
+  ADD_CUSTOM_TARGET(${_generator_target}_output DEPENDS ${_output})
+
+  ADD_DEPENDENCIES(${_target} ${_generator_target}_output)
+  TARGET_INCLUDE_DIRECTORIES(${_target} PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+  SEPARATE_ARGUMENTS(_flags UNIX_COMMAND "${CFL_CODEGEN_CXX_FLAGS}")
+  TARGET_COMPILE_OPTIONS(${_target} PRIVATE ${_flags})
+ENDFUNCTION()
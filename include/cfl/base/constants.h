@@ -41,7 +41,7 @@ public:
   }
 
   template <typename... Types>
-  auto value (Types... args) const
+  auto value (const Types&... args) const
   {
     return factor * t.value(args...);
   }
@@ -69,6 +69,12 @@ scale(number factor, const T& t)
     {
       static const CFL::ObjectType value = fe_function_set_type<T>::value;
     };
+
+    template <typename T, typename number>
+    struct is_symmetric<ConstantScaled<T, number>>
+    {
+      static constexpr bool value = is_symmetric<T>::value;
+    };
   }
 } // namespace CFL
 
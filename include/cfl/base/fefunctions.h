@@ -241,6 +241,16 @@ namespace Traits
     static constexpr bool value = true;
   };
 
+  /**
+   * @brief A sum is symmetric if all summands are
+   *
+   */
+  template <typename... Types>
+  struct is_symmetric<Base::SumFEFunctions<Types...>>
+  {
+    static constexpr bool value = (is_symmetric<Types>::value && ...);
+  };
+
   /**
    * @brief Trait to determine if a given type is CFL object
    *
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <cfl/base/traits.h>
+#include <stdexcept>
 #include <string>
 
 namespace CFL
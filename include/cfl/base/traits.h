@@ -129,6 +129,18 @@ namespace Traits
     static constexpr bool value = false;
   };
 
+  /**
+   * \brief Indicator for objects whose values are symmetric tensors
+   *
+   * Backends can use this to evaluate only the independent components
+   * of a symmetric tensor of rank 2.
+   */
+  template <class T>
+  struct is_symmetric
+  {
+    static constexpr bool value = false;
+  };
+
   /**
    * \brief Indicator for test functions used in forms
    *
@@ -0,0 +1,280 @@
+#ifndef CODEGEN_EXPRESSION_H
+#define CODEGEN_EXPRESSION_H
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace CFL::Codegen
+{
+enum class Operation
+{
+  constant,
+  input,
+  add,
+  multiply,
+  negate
+};
+
+/**
+ * A scalar node of an ExpressionGraph. Inputs refer to an expression in the
+ * generated code, e.g. a component of a value read from an FEEvaluation
+ * object, and to the statement that has to be emitted before they can be
+ * used.
+ */
+struct Node
+{
+  Operation operation;
+  double constant;
+  std::string code;
+  unsigned int load;
+  unsigned int left;
+  unsigned int right;
+};
+
+/**
+ * A directed acyclic graph of scalar operations. Nodes are hash-consed, i.e.
+ * creating a node that already exists returns the existing one, which
+ * removes common subexpressions. Operations on constants are folded and
+ * additions and multiplications with neutral or absorbing elements are
+ * simplified. Constant factors are moved to the front of products. Since
+ * the operands always exist before a node is created, the node indices are
+ * in topological order.
+ */
+class ExpressionGraph
+{
+public:
+  unsigned int
+  constant(double value)
+  {
+    return insert({ Operation::constant, value, "", 0, 0, 0 });
+  }
+
+  unsigned int
+  input(const std::string& code, unsigned int load)
+  {
+    return insert({ Operation::input, 0., code, load, 0, 0 });
+  }
+
+  unsigned int
+  add(unsigned int a, unsigned int b)
+  {
+    if (is_constant(a) && is_constant(b))
+      return constant(nodes[a].constant + nodes[b].constant);
+    if (is_constant(a, 0.))
+      return b;
+    if (is_constant(b, 0.))
+      return a;
+    if ((nodes[a].operation == Operation::negate && nodes[a].left == b) ||
+        (nodes[b].operation == Operation::negate && nodes[b].left == a))
+      return constant(0.);
+    if (a == b)
+      return multiply(constant(2.), a);
+    if (a > b)
+      std::swap(a, b);
+    return insert({ Operation::add, 0., "", 0, a, b });
+  }
+
+  unsigned int
+  multiply(unsigned int a, unsigned int b)
+  {
+    if (is_constant(b))
+      std::swap(a, b);
+    if (is_constant(a))
+    {
+      const double factor = nodes[a].constant;
+      if (is_constant(b))
+        return constant(factor * nodes[b].constant);
+      if (factor == 0.)
+        return constant(0.);
+      if (factor == 1.)
+        return b;
+      if (factor == -1.)
+        return negate(b);
+      // c1 * (c2 * x) = (c1 * c2) * x
+      if (nodes[b].operation == Operation::multiply && is_constant(nodes[b].left))
+        return multiply(constant(factor * nodes[nodes[b].left].constant), nodes[b].right);
+      if (nodes[b].operation == Operation::negate)
+        return multiply(constant(-factor), nodes[b].left);
+      return insert({ Operation::multiply, 0., "", 0, a, b });
+    }
+    // move constant factors and negations to the front, such that the
+    // remaining products can be shared: (c * x) * y = c * (x * y)
+    for (const auto& [first, second] : { std::make_pair(a, b), std::make_pair(b, a) })
+    {
+      if (nodes[first].operation == Operation::multiply && is_constant(nodes[first].left))
+        return multiply(nodes[first].left, multiply(nodes[first].right, second));
+      if (nodes[first].operation == Operation::negate)
+        return negate(multiply(nodes[first].left, second));
+    }
+    if (a > b)
+      std::swap(a, b);
+    return insert({ Operation::multiply, 0., "", 0, a, b });
+  }
+
+  unsigned int
+  negate(unsigned int a)
+  {
+    if (is_constant(a))
+      return constant(-nodes[a].constant);
+    if (nodes[a].operation == Operation::negate)
+      return nodes[a].left;
+    if (nodes[a].operation == Operation::multiply && is_constant(nodes[a].left))
+      return multiply(constant(-nodes[nodes[a].left].constant), nodes[a].right);
+    return insert({ Operation::negate, 0., "", 0, a, 0 });
+  }
+
+  bool
+  is_constant(unsigned int a) const
+  {
+    return nodes[a].operation == Operation::constant;
+  }
+
+  bool
+  is_constant(unsigned int a, double value) const
+  {
+    return is_constant(a) && nodes[a].constant == value;
+  }
+
+  const Node& operator[](unsigned int a) const
+  {
+    return nodes[a];
+  }
+
+  unsigned int
+  size() const
+  {
+    return nodes.size();
+  }
+
+private:
+  using Key = std::tuple<Operation, double, std::string, unsigned int, unsigned int>;
+
+  unsigned int
+  insert(const Node& node)
+  {
+    const Key key(node.operation, node.constant, node.code, node.left, node.right);
+    const auto position = lookup.find(key);
+    if (position != lookup.end())
+      return position->second;
+    nodes.push_back(node);
+    lookup.emplace(key, nodes.size() - 1);
+    return nodes.size() - 1;
+  }
+
+  std::vector<Node> nodes;
+  std::map<Key, unsigned int> lookup;
+};
+
+/**
+ * A tensor of rank <code>rank</code> in <code>dim</code> dimensions whose
+ * components, stored in row-major order, are nodes of an ExpressionGraph.
+ * The arithmetic operators follow the rules of ::dealii::Tensor, in
+ * particular the product of two tensors contracts the last index of the
+ * first with the first index of the second factor.
+ */
+class Expression
+{
+public:
+  Expression(ExpressionGraph& graph, unsigned int rank, unsigned int dim,
+             std::vector<unsigned int> components)
+    : graph(&graph)
+    , rank(rank)
+    , dim(dim)
+    , components(std::move(components))
+  {
+    if (this->components.size() != n_components(rank, dim))
+      throw std::invalid_argument("The number of components does not match the tensor rank!");
+  }
+
+  static unsigned int
+  n_components(unsigned int rank, unsigned int dim)
+  {
+    unsigned int n = 1;
+    for (unsigned int r = 0; r < rank; ++r)
+      n *= dim;
+    return n;
+  }
+
+  ExpressionGraph* graph;
+  unsigned int rank;
+  unsigned int dim;
+  std::vector<unsigned int> components;
+};
+
+inline Expression
+operator+(const Expression& a, const Expression& b)
+{
+  if (a.rank != b.rank || a.dim != b.dim)
+    throw std::invalid_argument("Only tensors of the same rank and dimension can be added!");
+  std::vector<unsigned int> components(a.components.size());
+  for (unsigned int i = 0; i < components.size(); ++i)
+    components[i] = a.graph->add(a.components[i], b.components[i]);
+  return Expression(*a.graph, a.rank, a.dim, components);
+}
+
+inline Expression
+operator-(const Expression& a)
+{
+  std::vector<unsigned int> components(a.components.size());
+  for (unsigned int i = 0; i < components.size(); ++i)
+    components[i] = a.graph->negate(a.components[i]);
+  return Expression(*a.graph, a.rank, a.dim, components);
+}
+
+inline Expression
+operator-(const Expression& a, const Expression& b)
+{
+  return a + (-b);
+}
+
+inline Expression operator*(double factor, const Expression& a)
+{
+  const unsigned int c = a.graph->constant(factor);
+  std::vector<unsigned int> components(a.components.size());
+  for (unsigned int i = 0; i < components.size(); ++i)
+    components[i] = a.graph->multiply(c, a.components[i]);
+  return Expression(*a.graph, a.rank, a.dim, components);
+}
+
+inline Expression operator*(const Expression& a, double factor)
+{
+  return factor * a;
+}
+
+inline Expression operator*(const Expression& a, const Expression& b)
+{
+  ExpressionGraph& graph = *a.graph;
+  if (a.rank == 0 || b.rank == 0)
+  {
+    const Expression& scalar = a.rank == 0 ? a : b;
+    const Expression& tensor = a.rank == 0 ? b : a;
+    std::vector<unsigned int> components(tensor.components.size());
+    for (unsigned int i = 0; i < components.size(); ++i)
+      components[i] = graph.multiply(scalar.components[0], tensor.components[i]);
+    return Expression(graph, tensor.rank, tensor.dim, components);
+  }
+
+  if (a.dim != b.dim)
+    throw std::invalid_argument("Only tensors of the same dimension can be multiplied!");
+  const unsigned int dim = a.dim;
+  const unsigned int n_outer = Expression::n_components(a.rank - 1, dim);
+  const unsigned int n_inner = Expression::n_components(b.rank - 1, dim);
+  std::vector<unsigned int> components(n_outer * n_inner);
+  for (unsigned int i = 0; i < n_outer; ++i)
+    for (unsigned int j = 0; j < n_inner; ++j)
+    {
+      unsigned int sum = graph.constant(0.);
+      for (unsigned int k = 0; k < dim; ++k)
+        sum = graph.add(
+          sum, graph.multiply(a.components[i * dim + k], b.components[k * n_inner + j]));
+      components[i * n_inner + j] = sum;
+    }
+  return Expression(graph, a.rank + b.rank - 2, dim, components);
+}
+} // namespace CFL::Codegen
+
+#endif // CODEGEN_EXPRESSION_H
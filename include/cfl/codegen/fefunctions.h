@@ -0,0 +1,352 @@
+#ifndef CODEGEN_FEFUNCTIONS_H
+#define CODEGEN_FEFUNCTIONS_H
+
+#include <cfl/base/fefunctions.h>
+#include <cfl/codegen/kernel_builder.h>
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace CFL
+{
+/**
+ * @brief A backend that generates C++ source code
+ *
+ * Like the LaTeX backend, this backend walks the tree of a Form and prints
+ * it. The result is a flattened quadrature point kernel for FEEvaluation
+ * objects, see KernelBuilder, that can be compiled independently of the
+ * expression templates.
+ */
+namespace Codegen
+{
+  /**
+   * Top level base class for FE Functions, should never be constructed
+   * Defined for safety reasons
+   *
+   */
+  template <class Derived>
+  class FEFunctionBaseBase;
+
+  /**
+   * Top level base class for FE Functions
+   *
+   */
+  template <template <int, int, unsigned int> class Derived, int rank, int dim, unsigned int idx>
+  class FEFunctionBaseBase<Derived<rank, dim, idx>>
+  {
+  public:
+    using TensorTraits = Traits::Tensor<rank, dim>;
+    static constexpr unsigned int index = idx;
+    const double scalar_factor = 1.;
+
+    constexpr explicit FEFunctionBaseBase(double new_factor = 1.)
+      : scalar_factor(new_factor)
+    {
+    }
+
+    template <template <int, int, unsigned int> class OtherFunction>
+    constexpr explicit FEFunctionBaseBase(const OtherFunction<rank, dim, idx>& other_function)
+      : scalar_factor(other_function.scalar_factor)
+    {
+    }
+
+  protected:
+    Expression
+    evaluate(const KernelBuilder& builder, KernelBuilder::Evaluation kind) const
+    {
+      return scalar_factor * builder.evaluate(idx, kind, rank, dim);
+    }
+  };
+
+  /**
+   * FE Function which provides evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class FEFunction final : public FEFunctionBaseBase<FEFunction<rank, dim, idx>>
+  {
+  public:
+    using Base = FEFunctionBaseBase<FEFunction<rank, dim, idx>>;
+    // inherit constructors
+    using Base::Base;
+
+    Expression
+    value(const KernelBuilder& builder) const
+    {
+      return Base::evaluate(builder, KernelBuilder::Evaluation::value);
+    }
+  };
+
+  /**
+   * FE Function which provides gradient evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class FEGradient final : public FEFunctionBaseBase<FEGradient<rank, dim, idx>>
+  {
+  public:
+    using Base = FEFunctionBaseBase<FEGradient<rank, dim, idx>>;
+    // inherit constructors
+    using Base::Base;
+
+    Expression
+    value(const KernelBuilder& builder) const
+    {
+      return Base::evaluate(builder, KernelBuilder::Evaluation::gradient);
+    }
+  };
+
+  /**
+   * FE Function which provides divergence evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class FEDivergence final : public FEFunctionBaseBase<FEDivergence<rank, dim, idx>>
+  {
+  public:
+    using Base = FEFunctionBaseBase<FEDivergence<rank, dim, idx>>;
+    // inherit constructors
+    using Base::Base;
+
+    Expression
+    value(const KernelBuilder& builder) const
+    {
+      return Base::evaluate(builder, KernelBuilder::Evaluation::divergence);
+    }
+  };
+
+  /**
+   * FE Function which provides Laplacian evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class FELaplacian final : public FEFunctionBaseBase<FELaplacian<rank, dim, idx>>
+  {
+  public:
+    using Base = FEFunctionBaseBase<FELaplacian<rank, dim, idx>>;
+    // inherit constructors
+    using Base::Base;
+
+    Expression
+    value(const KernelBuilder& builder) const
+    {
+      return Base::evaluate(builder, KernelBuilder::Evaluation::laplacian);
+    }
+  };
+
+  /**
+   * FE Function which provides Hessian evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class FEHessian final : public FEFunctionBaseBase<FEHessian<rank, dim, idx>>
+  {
+  public:
+    using Base = FEFunctionBaseBase<FEHessian<rank, dim, idx>>;
+    // inherit constructors
+    using Base::Base;
+
+    Expression
+    value(const KernelBuilder& builder) const
+    {
+      return Base::evaluate(builder, KernelBuilder::Evaluation::hessian);
+    }
+  };
+
+  /**
+   * FE Function which provides symmetric gradient evaluation on cells. The
+   * symmetric gradient is computed from the components of the gradient,
+   * such that it shares them with other terms of the kernel.
+   */
+  template <int rank, int dim, unsigned int idx>
+  class FESymmetricGradient final : public FEFunctionBaseBase<FESymmetricGradient<rank, dim, idx>>
+  {
+  public:
+    using Base = FEFunctionBaseBase<FESymmetricGradient<rank, dim, idx>>;
+    // inherit constructors
+    using Base::Base;
+
+    static_assert(rank == 2, "The symmetric gradient is only defined for vector valued elements!");
+
+    Expression
+    value(const KernelBuilder& builder) const
+    {
+      const Expression gradient = Base::evaluate(builder, KernelBuilder::Evaluation::gradient);
+      ExpressionGraph& graph = *gradient.graph;
+      const unsigned int half = graph.constant(.5);
+      std::vector<unsigned int> components(dim * dim);
+      for (unsigned int i = 0; i < dim; ++i)
+        for (unsigned int j = 0; j < dim; ++j)
+          components[i * dim + j] = graph.multiply(
+            half, graph.add(gradient.components[i * dim + j], gradient.components[j * dim + i]));
+      return Expression(graph, rank, dim, components);
+    }
+  };
+
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::FEFunction<ints...>& f)
+  {
+    return FEFunction<ints...>(f.scalar_factor);
+  }
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::FEGradient<ints...>& f)
+  {
+    return FEGradient<ints...>(f.scalar_factor);
+  }
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::FEDivergence<ints...>& f)
+  {
+    return FEDivergence<ints...>(f.scalar_factor);
+  }
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::FELaplacian<ints...>& f)
+  {
+    return FELaplacian<ints...>(f.scalar_factor);
+  }
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::FEHessian<ints...>& f)
+  {
+    return FEHessian<ints...>(f.scalar_factor);
+  }
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::FESymmetricGradient<ints...>& f)
+  {
+    return FESymmetricGradient<ints...>(f.scalar_factor);
+  }
+
+  template <class... Types>
+  constexpr auto transform(const Base::SumFEFunctions<Types...>& f);
+
+  template <class... Types>
+  constexpr auto transform(const Base::ProductFEFunctions<Types...>& f);
+
+  template <class... Types>
+  constexpr auto
+  transform(const Base::SumFEFunctions<Types...>& f)
+  {
+    return Base::SumFEFunctions<decltype(transform(std::declval<Types>()))...>(f);
+  }
+
+  template <class... Types>
+  constexpr auto
+  transform(const Base::ProductFEFunctions<Types...>& f)
+  {
+    return Base::ProductFEFunctions<decltype(transform(std::declval<Types>()))...>(f);
+  }
+
+  /**
+   * Top level base class for Test Functions, should never be constructed
+   * Defined for safety reasons
+   *
+   */
+  template <class T>
+  class TestFunctionBaseBase
+  {
+  public:
+    // This class should never be constructed
+    TestFunctionBaseBase() = delete;
+  };
+
+  /**
+   * Top level base class for Test Functions
+   *
+   */
+  template <template <int, int, unsigned int> class T, int rank, int dim, unsigned int idx>
+  class TestFunctionBaseBase<T<rank, dim, idx>>
+  {
+  public:
+    using TensorTraits = Traits::Tensor<rank, dim>;
+
+    static constexpr unsigned int index = idx;
+
+  protected:
+    static void
+    submit(KernelBuilder& builder, KernelBuilder::Integration kind, const Expression& value)
+    {
+      if (value.rank != rank || value.dim != dim)
+        throw std::invalid_argument("The tensor rank of the expression and of the test function "
+                                    "must coincide!");
+      builder.submit(idx, kind, value);
+    }
+  };
+
+  /**
+   * Test Function which provides evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class TestFunction final : public TestFunctionBaseBase<TestFunction<rank, dim, idx>>
+  {
+  public:
+    using Base = TestFunctionBaseBase<TestFunction<rank, dim, idx>>;
+
+    static void
+    submit(KernelBuilder& builder, const Expression& value)
+    {
+      Base::submit(builder, KernelBuilder::Integration::value, value);
+    }
+  };
+
+  /**
+   * Test Function which provides gradient evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class TestGradient final : public TestFunctionBaseBase<TestGradient<rank, dim, idx>>
+  {
+  public:
+    using Base = TestFunctionBaseBase<TestGradient<rank, dim, idx>>;
+
+    static void
+    submit(KernelBuilder& builder, const Expression& value)
+    {
+      Base::submit(builder, KernelBuilder::Integration::gradient, value);
+    }
+  };
+
+  /**
+   * Test Function which provides divergence evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class TestDivergence final : public TestFunctionBaseBase<TestDivergence<rank, dim, idx>>
+  {
+  public:
+    using Base = TestFunctionBaseBase<TestDivergence<rank, dim, idx>>;
+
+    static void
+    submit(KernelBuilder& builder, const Expression& value)
+    {
+      Base::submit(builder, KernelBuilder::Integration::divergence, value);
+    }
+  };
+
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::TestFunction<ints...>&)
+  {
+    return TestFunction<ints...>();
+  }
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::TestGradient<ints...>&)
+  {
+    return TestGradient<ints...>();
+  }
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::TestDivergence<ints...>&)
+  {
+    return TestDivergence<ints...>();
+  }
+} // namespace Codegen
+} // namespace CFL
+
+#endif // CODEGEN_FEFUNCTIONS_H
@@ -0,0 +1,88 @@
+#ifndef CODEGEN_FORMS_H
+#define CODEGEN_FORMS_H
+
+#include <cfl/base/forms.h>
+#include <cfl/codegen/fefunctions.h>
+
+#include <utility>
+
+namespace CFL::Codegen
+{
+template <class CodegenTest, class CodegenExpr, FormKind kind_of_form>
+class Form
+{
+public:
+  static_assert(kind_of_form == FormKind::cell,
+                "The code generation backend only supports integrals over cells!");
+
+  template <class Test, class Expr, typename NumberType>
+  explicit constexpr Form(const Base::Form<Test, Expr, kind_of_form, NumberType> f)
+    : expr(transform(f.expr))
+    , test(transform(f.test))
+  {
+  }
+
+  void
+  generate(KernelBuilder& builder) const
+  {
+    test.submit(builder, expr.value(builder));
+  }
+
+private:
+  const CodegenExpr expr;
+  const CodegenTest test;
+};
+
+template <typename... FormTypes>
+class Forms;
+
+template <>
+class Forms<>
+{
+public:
+  explicit constexpr Forms(const Base::Forms<>& /*f*/)
+  {
+  }
+};
+
+template <typename FormType, typename... FormTypes>
+class Forms<FormType, FormTypes...> : public Forms<FormTypes...>
+{
+public:
+  template <class OtherType, class... OtherTypes,
+            typename std::enable_if<sizeof...(OtherTypes) == sizeof...(FormTypes)>::type* = nullptr>
+  explicit constexpr Forms(const Base::Forms<OtherType, OtherTypes...>& f)
+    : Forms<FormTypes...>(static_cast<const Base::Forms<OtherTypes...>&>(f))
+    , form(f.get_form())
+  {
+  }
+
+  void
+  generate(KernelBuilder& builder) const
+  {
+    form.generate(builder);
+    if constexpr(sizeof...(FormTypes) != 0) Forms<FormTypes...>::generate(builder);
+  }
+
+private:
+  const FormType form;
+};
+
+template <class Test, class Expr, FormKind kind_of_form, typename NumberType>
+constexpr auto
+transform(const Base::Form<Test, Expr, kind_of_form, NumberType>& f)
+{
+  return Form<decltype(transform(std::declval<Test>())),
+              decltype(transform(std::declval<Expr>())),
+              kind_of_form>(f);
+}
+
+template <typename... Types>
+constexpr auto
+transform(const Base::Forms<Types...>& f)
+{
+  return Forms<decltype(transform(std::declval<Types>()))...>(f);
+}
+} // namespace CFL::Codegen
+
+#endif // CODEGEN_FORMS_H
@@ -0,0 +1,306 @@
+#ifndef CODEGEN_KERNEL_BUILDER_H
+#define CODEGEN_KERNEL_BUILDER_H
+
+#include <cfl/codegen/expression.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace CFL::Codegen
+{
+/**
+ * Collects the values requested from and submitted to the FEEvaluation
+ * objects by the Forms of a kernel and prints the kernel as a function
+ * template
+ * @code
+ * template <class FEEvaluation0, class FEEvaluation1, ...>
+ * inline void
+ * name(FEEvaluation0& phi0, FEEvaluation1& phi1, ..., const unsigned int q)
+ * @endcode
+ * with one FEEvaluation object per finite element index. The body is
+ * straight-line code with one temporary per operation that is needed for
+ * the submitted values. The scalar type of the temporaries is
+ * <code>FEEvaluation0::VectorizedArrayType</code>.
+ */
+class KernelBuilder
+{
+public:
+  enum class Evaluation
+  {
+    value,
+    gradient,
+    hessian,
+    divergence,
+    laplacian
+  };
+
+  enum class Integration
+  {
+    value,
+    gradient,
+    divergence
+  };
+
+  /**
+   * Return the tensor of rank <code>rank</code> that is the result of the
+   * evaluation <code>kind</code> of the finite element <code>index</code> in
+   * the current quadrature point.
+   *
+   * This function is const since Base::SumFEFunctions and
+   * Base::ProductFEFunctions pass their parameters by const reference to
+   * the value() functions of their summands.
+   */
+  Expression
+  evaluate(unsigned int index, Evaluation kind, unsigned int rank, unsigned int dim) const
+  {
+    n_fe = std::max(n_fe, index + 1);
+    const std::string variable = evaluation_name(kind) + "_" + std::to_string(index);
+    unsigned int load = 0;
+    while (load < loads.size() && loads[load].first != variable)
+      ++load;
+    if (load == loads.size())
+      loads.emplace_back(variable, "phi" + std::to_string(index) + ".get_" +
+                                     evaluation_name(kind) + "(q)");
+
+    std::vector<unsigned int> components(Expression::n_components(rank, dim));
+    for (unsigned int c = 0; c < components.size(); ++c)
+      components[c] = graph.input(variable + component_string(c, rank, dim), load);
+    return Expression(graph, rank, dim, components);
+  }
+
+  /**
+   * Submit <code>value</code> for the test function <code>kind</code> of
+   * the finite element <code>index</code>. Several submissions for the same
+   * test function are added up.
+   */
+  void
+  submit(unsigned int index, Integration kind, const Expression& value)
+  {
+    n_fe = std::max(n_fe, index + 1);
+    for (auto& submission : submissions)
+      if (submission.index == index && submission.kind == kind)
+      {
+        submission.value = submission.value + value;
+        return;
+      }
+    submissions.push_back({ index, kind, value });
+  }
+
+  /**
+   * The number of arithmetic operations in the generated code.
+   */
+  unsigned int
+  n_operations() const
+  {
+    const std::vector<bool> needed = needed_nodes();
+    unsigned int n = 0;
+    for (unsigned int i = 0; i < graph.size(); ++i)
+      if (needed[i] && graph[i].operation != Operation::constant &&
+          graph[i].operation != Operation::input)
+        ++n;
+    return n;
+  }
+
+  void
+  print(std::ostream& out, const std::string& name) const
+  {
+    const std::vector<bool> needed = needed_nodes();
+
+    out << "template <";
+    for (unsigned int i = 0; i < n_fe; ++i)
+      out << (i == 0 ? "" : ", ") << "class FEEvaluation" << i;
+    out << ">\ninline void\n" << name << "(";
+    for (unsigned int i = 0; i < n_fe; ++i)
+      out << "FEEvaluation" << i << "& phi" << i << ", ";
+    out << "const unsigned int q)\n{\n";
+
+    std::ostringstream body;
+
+    for (unsigned int load = 0; load < loads.size(); ++load)
+      for (unsigned int i = 0; i < graph.size(); ++i)
+        if (needed[i] && graph[i].operation == Operation::input && graph[i].load == load)
+        {
+          body << "  const auto " << loads[load].first << " = " << loads[load].second << ";\n";
+          break;
+        }
+
+    std::vector<std::string> names(graph.size());
+    unsigned int n_temporaries = 0;
+    for (unsigned int i = 0; i < graph.size(); ++i)
+    {
+      if (!needed[i])
+        continue;
+      const Node& node = graph[i];
+      switch (node.operation)
+      {
+        case Operation::constant:
+          names[i] = double_to_string(node.constant);
+          continue;
+        case Operation::input:
+          names[i] = node.code;
+          continue;
+        default:
+          break;
+      }
+      names[i] = "t" + std::to_string(n_temporaries++);
+      body << "  const VectorizedArrayType " << names[i] << " = ";
+      switch (node.operation)
+      {
+        case Operation::add:
+          if (graph[node.right].operation == Operation::negate)
+            body << scalar_string(names, node.left) << " - "
+                << scalar_string(names, graph[node.right].left);
+          else if (graph[node.left].operation == Operation::negate)
+            body << scalar_string(names, node.right) << " - "
+                << scalar_string(names, graph[node.left].left);
+          else
+            body << scalar_string(names, node.left) << " + " << scalar_string(names, node.right);
+          break;
+        case Operation::multiply:
+          body << names[node.left] << " * " << names[node.right];
+          break;
+        default:
+          body << "-" << names[node.left];
+      }
+      body << ";\n";
+    }
+
+    for (const auto& submission : submissions)
+    {
+      const std::string phi = "phi" + std::to_string(submission.index);
+      const std::string function = "submit_" + integration_name(submission.kind);
+      const Expression& value = submission.value;
+      if (value.rank == 0)
+      {
+        body << "  " << phi << "." << function << "(" << scalar_string(names, value.components[0])
+            << ", q);\n";
+        continue;
+      }
+      const std::string variable = function + "_" + std::to_string(submission.index);
+      body << "  typename FEEvaluation" << submission.index << "::"
+          << (submission.kind == Integration::gradient ? "gradient_type " : "value_type ")
+          << variable << ";\n";
+      for (unsigned int c = 0; c < value.components.size(); ++c)
+        body << "  " << variable << component_string(c, value.rank, value.dim) << " = "
+            << scalar_string(names, value.components[c]) << ";\n";
+      body << "  " << phi << "." << function << "(" << variable << ", q);\n";
+    }
+    // the scalar type is only needed for temporaries and constants
+    if (body.str().find("VectorizedArrayType") != std::string::npos)
+      out << "  using VectorizedArrayType = typename FEEvaluation0::VectorizedArrayType;\n";
+    out << body.str();
+    out << "}\n";
+  }
+
+private:
+  struct Submission
+  {
+    unsigned int index;
+    Integration kind;
+    Expression value;
+  };
+
+  /**
+   * Mark the nodes the submitted values depend on. A negation that is
+   * added to another node is printed as a subtraction and is not needed
+   * itself.
+   */
+  std::vector<bool>
+  needed_nodes() const
+  {
+    std::vector<bool> needed(graph.size(), false);
+    for (const auto& submission : submissions)
+      for (const unsigned int c : submission.value.components)
+        needed[c] = true;
+    for (unsigned int i = graph.size(); i-- > 0;)
+      if (needed[i])
+      {
+        const Node& node = graph[i];
+        if (node.operation == Operation::add && graph[node.right].operation == Operation::negate)
+          needed[node.left] = needed[graph[node.right].left] = true;
+        else if (node.operation == Operation::add &&
+                 graph[node.left].operation == Operation::negate)
+          needed[node.right] = needed[graph[node.left].left] = true;
+        else if (node.operation == Operation::add || node.operation == Operation::multiply)
+          needed[node.left] = needed[node.right] = true;
+        else if (node.operation == Operation::negate)
+          needed[node.left] = true;
+      }
+    return needed;
+  }
+
+  std::string
+  scalar_string(const std::vector<std::string>& names, unsigned int node) const
+  {
+    if (graph.is_constant(node))
+      return "VectorizedArrayType(" + names[node] + ")";
+    return names[node];
+  }
+
+  static std::string
+  evaluation_name(Evaluation kind)
+  {
+    switch (kind)
+    {
+      case Evaluation::value:
+        return "value";
+      case Evaluation::gradient:
+        return "gradient";
+      case Evaluation::hessian:
+        return "hessian";
+      case Evaluation::divergence:
+        return "divergence";
+      default:
+        return "laplacian";
+    }
+  }
+
+  static std::string
+  integration_name(Integration kind)
+  {
+    switch (kind)
+    {
+      case Integration::value:
+        return "value";
+      case Integration::gradient:
+        return "gradient";
+      default:
+        return "divergence";
+    }
+  }
+
+  static std::string
+  component_string(unsigned int component, unsigned int rank, unsigned int dim)
+  {
+    std::string result;
+    for (unsigned int r = 0; r < rank; ++r, component /= dim)
+      result = "[" + std::to_string(component % dim) + "]" + result;
+    return result;
+  }
+
+  static std::string
+  double_to_string(double d)
+  {
+    std::ostringstream stream;
+    stream << std::setprecision(std::numeric_limits<double>::max_digits10) << d;
+    std::string result = stream.str();
+    if (result.find_first_of(".en") == std::string::npos)
+      result += ".";
+    return result;
+  }
+
+  // the graph and the values read from the FEEvaluation objects grow during evaluate()
+  mutable ExpressionGraph graph;
+  mutable std::vector<std::pair<std::string, std::string>> loads;
+  std::vector<Submission> submissions;
+  mutable unsigned int n_fe = 0;
+};
+} // namespace CFL::Codegen
+
+#endif // CODEGEN_KERNEL_BUILDER_H
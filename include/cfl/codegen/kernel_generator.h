@@ -0,0 +1,48 @@
+#ifndef CODEGEN_KERNEL_GENERATOR_H
+#define CODEGEN_KERNEL_GENERATOR_H
+
+#include <cfl/codegen/kernel_builder.h>
+
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace CFL::Codegen
+{
+/**
+ * Print the quadrature point kernel of a Form or Forms object of the code
+ * generation backend. print() writes a self-contained header.
+ */
+template <class FormContainer>
+class KernelGenerator
+{
+public:
+  KernelGenerator(const FormContainer& form_container, std::string kernel_name)
+    : _kernel_name(std::move(kernel_name))
+  {
+    form_container.generate(_builder);
+  }
+
+  void
+  print(std::ostream& out) const
+  {
+    out << "// This file has been generated by CFL::Codegen::KernelGenerator.\n"
+        << "// Arithmetic operations per quadrature point: " << _builder.n_operations()
+        << "\n\n"
+        << "#pragma once\n\n";
+    _builder.print(out, _kernel_name);
+  }
+
+  unsigned int
+  n_operations() const
+  {
+    return _builder.n_operations();
+  }
+
+private:
+  const std::string _kernel_name;
+  KernelBuilder _builder;
+};
+} // namespace CFL::Codegen
+
+#endif // CODEGEN_KERNEL_GENERATOR_H
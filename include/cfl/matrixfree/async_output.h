@@ -0,0 +1,230 @@
+#ifndef DEALII_MATRIXFREE_ASYNC_OUTPUT_H
+#define DEALII_MATRIXFREE_ASYNC_OUTPUT_H
+
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace CFL::dealii::MatrixFree
+{
+/**
+ * @brief Writes solution vectors in VTU format on a background thread
+ *
+ * write() copies the given vectors, updates the ghost values of the
+ * copies and returns. A worker thread then builds the patches with
+ * ::dealii::DataOut and writes compressed VTU files, one per process, and
+ * the PVTU record on the first process. The solver can thus continue
+ * while the output is written.
+ *
+ * At most <code>max_queued</code> snapshots, but at least one, wait for the
+ * worker. If the queue is full, write() blocks until the worker has taken a
+ * snapshot, which limits the memory used for the copies. flush() waits until all
+ * snapshots are written and is called by the destructor. Exceptions
+ * thrown by the worker are rethrown by the next call of write() or
+ * flush().
+ *
+ * The worker does not communicate, all MPI communication happens in
+ * write(). If MPI is not initialized, there is a single process. The
+ * DoFHandler must not change while snapshots are queued: call flush()
+ * before refining the mesh or distributing the degrees of freedom again.
+ *
+ * <h3> Usage example </h3>
+ * <code>
+ *   AsyncDataOut<dim> output(dof_handler, fe_degree);
+ *   output.write("solution", cycle, {{&solution.block(0), "solution"}});
+ * </code>
+ */
+template <int dim, typename VectorType = ::dealii::LinearAlgebra::distributed::Vector<double>>
+class AsyncDataOut
+{
+public:
+  AsyncDataOut(const ::dealii::DoFHandler<dim>& dof_handler, unsigned int n_subdivisions,
+               unsigned int max_queued = 1, MPI_Comm communicator = MPI_COMM_WORLD)
+    : dof_handler(dof_handler)
+    , n_subdivisions(n_subdivisions)
+    , max_queued(std::max(max_queued, 1u))
+    , this_process(::dealii::Utilities::MPI::job_supports_mpi()
+                     ? ::dealii::Utilities::MPI::this_mpi_process(communicator)
+                     : 0)
+    , n_processes(::dealii::Utilities::MPI::job_supports_mpi()
+                    ? ::dealii::Utilities::MPI::n_mpi_processes(communicator)
+                    : 1)
+    , worker([this]() { work(); })
+  {
+  }
+
+  AsyncDataOut(const AsyncDataOut&) = delete;
+  AsyncDataOut&
+  operator=(const AsyncDataOut&) = delete;
+
+  ~AsyncDataOut()
+  {
+    try
+    {
+      flush();
+    }
+    catch (const std::exception& exc)
+    {
+      std::cerr << "Writing the output failed: " << exc.what() << std::endl;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    queue_changed.notify_all();
+    worker.join();
+  }
+
+  /**
+   * Queue the output of <code>vectors</code>, pairs of vectors and their
+   * names, to the files <code>basename</code>-<code>cycle</code>.*.vtu and
+   * <code>basename</code>-<code>cycle</code>.pvtu.
+   */
+  void
+  write(const std::string& basename, unsigned int cycle,
+        const std::vector<std::pair<const VectorType*, std::string>>& vectors)
+  {
+    Snapshot snapshot{ basename, cycle, {} };
+    snapshot.vectors.reserve(vectors.size());
+    for (const auto& [vector, name] : vectors)
+    {
+      snapshot.vectors.emplace_back(*vector, name);
+      snapshot.vectors.back().first.update_ghost_values();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    queue_changed.wait(lock, [this]() { return queue.size() < max_queued || error; });
+    rethrow();
+    queue.push_back(std::move(snapshot));
+    queue_changed.notify_all();
+  }
+
+  /**
+   * Wait until all queued snapshots are written.
+   */
+  void
+  flush()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    queue_changed.wait(lock, [this]() { return (queue.empty() && !busy) || error; });
+    rethrow();
+  }
+
+private:
+  struct Snapshot
+  {
+    std::string basename;
+    unsigned int cycle;
+    std::vector<std::pair<VectorType, std::string>> vectors;
+  };
+
+  void
+  work()
+  {
+    while (true)
+    {
+      Snapshot snapshot;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        queue_changed.wait(lock, [this]() { return !queue.empty() || stop; });
+        if (queue.empty())
+          return;
+        snapshot = std::move(queue.front());
+        queue.pop_front();
+        busy = true;
+      }
+      // the queue has space again
+      queue_changed.notify_all();
+
+      std::exception_ptr exception;
+      try
+      {
+        write_files(snapshot);
+      }
+      catch (...)
+      {
+        exception = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        busy = false;
+        if (exception && !error)
+          error = exception;
+      }
+      queue_changed.notify_all();
+    }
+  }
+
+  void
+  write_files(const Snapshot& snapshot) const
+  {
+    ::dealii::DataOut<dim> data_out;
+    data_out.attach_dof_handler(dof_handler);
+    for (const auto& [vector, name] : snapshot.vectors)
+      data_out.add_data_vector(vector, name);
+    data_out.build_patches(n_subdivisions);
+
+    ::dealii::DataOutBase::VtkFlags flags;
+    flags.compression_level = ::dealii::DataOutBase::VtkFlags::best_speed;
+    data_out.set_flags(flags);
+
+    const std::string prefix =
+      snapshot.basename + "-" + ::dealii::Utilities::to_string(snapshot.cycle);
+    std::ofstream output(prefix + "." + ::dealii::Utilities::to_string(this_process) + ".vtu");
+    data_out.write_vtu(output);
+
+    if (this_process == 0)
+    {
+      std::vector<std::string> filenames;
+      for (unsigned int i = 0; i < n_processes; ++i)
+        filenames.emplace_back(prefix + "." + ::dealii::Utilities::to_string(i) + ".vtu");
+      std::ofstream master_output(prefix + ".pvtu");
+      data_out.write_pvtu_record(master_output, filenames);
+    }
+  }
+
+  /**
+   * Rethrow an exception of the worker, the mutex must be locked.
+   */
+  void
+  rethrow()
+  {
+    if (error)
+      std::rethrow_exception(std::exchange(error, nullptr));
+  }
+
+  const ::dealii::DoFHandler<dim>& dof_handler;
+  const unsigned int n_subdivisions;
+  const unsigned int max_queued;
+  const unsigned int this_process;
+  const unsigned int n_processes;
+
+  std::mutex mutex;
+  std::condition_variable queue_changed;
+  std::deque<Snapshot> queue;
+  bool busy = false;
+  bool stop = false;
+  std::exception_ptr error;
+
+  // started last, when all other members are initialized
+  std::thread worker;
+};
+} // namespace CFL::dealii::MatrixFree
+
+#endif // DEALII_MATRIXFREE_ASYNC_OUTPUT_H
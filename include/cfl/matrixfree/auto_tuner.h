@@ -0,0 +1,420 @@
+#ifndef DEALII_MATRIXFREE_AUTO_TUNER_H
+#define DEALII_MATRIXFREE_AUTO_TUNER_H
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/vectorization.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace CFL::dealii::MatrixFree
+{
+/**
+ * The parameters of the loops of a ::dealii::MatrixFree object which are
+ * chosen by the AutoTuner. <code>tasks_parallel_scheme</code> is the value
+ * of ::dealii::MatrixFree::AdditionalData::TasksParallelScheme. If
+ * <code>group_cells_by_level</code> is set, the SIMD batches of cells only
+ * combine cells of the same refinement level. On locally refined meshes,
+ * the cells of a batch then have the same size, and on affine meshes the
+ * same Jacobian, and the cells next to hanging nodes are batched together.
+ */
+struct ExecutionParameters
+{
+  unsigned int tasks_parallel_scheme = 0;
+  unsigned int tasks_block_size = 3;
+  bool overlap_communication_computation = true;
+  bool group_cells_by_level = false;
+
+  template <typename AdditionalData>
+  void
+  apply(AdditionalData& additional_data) const
+  {
+    additional_data.tasks_parallel_scheme =
+      static_cast<typename AdditionalData::TasksParallelScheme>(tasks_parallel_scheme);
+    additional_data.tasks_block_size = tasks_block_size;
+    additional_data.overlap_communication_computation = overlap_communication_computation;
+  }
+
+  /**
+   * Like apply(), and sort the active cells of <code>triangulation</code>
+   * into vectorization categories by their level if
+   * <code>group_cells_by_level</code> is set.
+   */
+  template <typename AdditionalData, class Triangulation>
+  void
+  apply(AdditionalData& additional_data, const Triangulation& triangulation) const
+  {
+    apply(additional_data);
+    if (group_cells_by_level)
+    {
+      additional_data.cell_vectorization_category.assign(triangulation.n_active_cells(), 0);
+      for (const auto& cell : triangulation.active_cell_iterators())
+        additional_data.cell_vectorization_category[cell->active_cell_index()] = cell->level();
+      additional_data.cell_vectorization_categories_strict = true;
+    }
+  }
+
+  bool
+  operator==(const ExecutionParameters& other) const
+  {
+    return tasks_parallel_scheme == other.tasks_parallel_scheme &&
+           tasks_block_size == other.tasks_block_size &&
+           overlap_communication_computation == other.overlap_communication_computation &&
+           group_cells_by_level == other.group_cells_by_level;
+  }
+};
+
+/**
+ * @brief Chooses the fastest ExecutionParameters of an operator once per machine
+ *
+ * tune() applies an operator set up with each candidate a few times and
+ * returns the parameters of the fastest application. The result is stored
+ * in a small text file together with a key describing the operator, see
+ * key(), such that later runs on the same kind of machine start with the
+ * tuned parameters without any trial applications.
+ *
+ * With several threads, the threaded task schemes partition_partition,
+ * partition_color and color are tried with several block sizes; each thread
+ * evaluates the Forms with its own copy of the FEDatas of the integrator.
+ * With several processes, the loops which exchange the ghost values before
+ * the loop over the cells are tried in addition to the ones which overlap
+ * the exchange with the computation on the cells which need no ghost
+ * values. On locally refined meshes, every candidate is also tried with
+ * the cells grouped by level. Runs with one thread and one process on a
+ * uniform mesh use the default parameters without any trial applications.
+ * The vectorization width and the number of threads are fixed when the
+ * program starts and are therefore part of the key instead of being tuned.
+ *
+ * All processes must call tune(). Only the first process looks the key up
+ * in the cache and writes the cache file; whether it found the key is sent
+ * to the other processes, such that either all processes or none run the
+ * trial applications, even if their cache files or CPU models differ. The
+ * processes take the maximum time over all processes and thus choose the
+ * same parameters.
+ *
+ * <h3> Usage example </h3>
+ * <code>
+ *   AutoTuner tuner;
+ *   const auto parameters = tuner.tune(AutoTuner::key<Forms>(degree, dim, n_cells),
+ *                                      [&](const ExecutionParameters& parameters) {
+ *                                        // set up the operator with parameters
+ *                                        return [&]() { op.vmult(dst, src); };
+ *                                      });
+ * </code>
+ */
+class AutoTuner
+{
+public:
+  /**
+   * Creates a function which applies the operator set up with the given
+   * parameters once.
+   */
+  using Setup = std::function<std::function<void()>(const ExecutionParameters&)>;
+
+  explicit AutoTuner(std::string cache_file = default_cache_file(),
+                     unsigned int n_repetitions = 3, MPI_Comm communicator = MPI_COMM_WORLD)
+    : cache_file(std::move(cache_file))
+    , n_repetitions(std::max(n_repetitions, 1u))
+    , communicator(communicator)
+  {
+    read_cache();
+  }
+
+  /**
+   * The file given by the environment variable CFL_TUNING_CACHE, or
+   * <code>cfl/tuning.txt</code> in the user's cache directory.
+   */
+  static std::string
+  default_cache_file()
+  {
+    if (const char* file = std::getenv("CFL_TUNING_CACHE"))
+      return file;
+    if (const char* cache = std::getenv("XDG_CACHE_HOME"))
+      return std::string(cache) + "/cfl/tuning.txt";
+    if (const char* home = std::getenv("HOME"))
+      return std::string(home) + "/.cache/cfl/tuning.txt";
+    return (std::filesystem::temp_directory_path() / "cfl" / "tuning.txt").string();
+  }
+
+  /**
+   * The key of an operator evaluating <code>Forms</code> with elements of
+   * degree <code>degree</code> in <code>dim</code> dimensions on a mesh
+   * with <code>n_cells</code> cells, which is <code>locally_refined</code>
+   * or uniform. Meshes whose number of cells has the same binary logarithm
+   * share the key. The key also contains the vectorization width, the
+   * number of threads and the CPU model.
+   */
+  template <class Forms>
+  static std::string
+  key(unsigned int degree, int dim, std::size_t n_cells, bool locally_refined = false)
+  {
+    std::ostringstream key;
+    key << "forms=" << std::hex << std::hash<std::string>()(typeid(Forms).name()) << std::dec
+        << ";dim=" << dim << ";degree=" << degree
+        << ";cells=2^" << static_cast<unsigned int>(std::log2(std::max<std::size_t>(n_cells, 1)))
+        << ";mesh=" << (locally_refined ? "local" : "uniform")
+        << ";simd=" << sizeof(::dealii::VectorizedArray<double>) / sizeof(double)
+        << ";threads=" << ::dealii::MultithreadInfo::n_threads() << ";cpu=" << cpu_model();
+    return key.str();
+  }
+
+  /**
+   * The parameters tried by tune() with <code>n_processes</code> processes
+   * and <code>n_threads</code> threads: the default ones, if there are
+   * several threads, the threaded task schemes with block sizes from 1 to
+   * 64 and, if there are several processes, the ones which exchange the
+   * ghost values before the loop over the cells instead of overlapping the
+   * exchange with the computation on the cells which need no ghost values.
+   * If the mesh is <code>locally_refined</code>, all of them are tried with
+   * the cells grouped by level as well.
+   */
+  static std::vector<ExecutionParameters>
+  candidates(unsigned int n_processes = 1,
+             unsigned int n_threads = ::dealii::MultithreadInfo::n_threads(),
+             bool locally_refined = false)
+  {
+    std::vector<ExecutionParameters> result{ ExecutionParameters() };
+    if (n_threads > 1)
+      // partition_partition, partition_color and color
+      for (unsigned int scheme = 1; scheme < 4; ++scheme)
+        for (const unsigned int block_size : { 1u, 2u, 4u, 8u, 16u, 32u, 64u })
+        {
+          result.push_back(ExecutionParameters());
+          result.back().tasks_parallel_scheme = scheme;
+          result.back().tasks_block_size = block_size;
+        }
+    if (n_processes > 1)
+    {
+      const std::size_t n_overlapping = result.size();
+      for (std::size_t i = 0; i < n_overlapping; ++i)
+      {
+        result.push_back(result[i]);
+        result.back().overlap_communication_computation = false;
+      }
+    }
+    if (locally_refined)
+    {
+      const std::size_t n_ungrouped = result.size();
+      for (std::size_t i = 0; i < n_ungrouped; ++i)
+      {
+        result.push_back(result[i]);
+        result.back().group_cells_by_level = true;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * The cached parameters for <code>key</code> or, if there are none, the
+   * fastest of candidates() for the operator created by <code>setup</code>,
+   * which are added to the cache. <code>locally_refined</code> has to be
+   * the same as for key().
+   */
+  ExecutionParameters
+  tune(const std::string& key, const Setup& setup, const bool locally_refined = false)
+  {
+    const bool root = this_process() == 0;
+    if (const auto cached = broadcast(root ? lookup(key) : std::nullopt))
+    {
+      cache[key] = *cached;
+      return *cached;
+    }
+
+    const std::vector<ExecutionParameters> parameters =
+      candidates(::dealii::Utilities::MPI::job_supports_mpi()
+                   ? ::dealii::Utilities::MPI::n_mpi_processes(communicator)
+                   : 1,
+                 ::dealii::MultithreadInfo::n_threads(),
+                 locally_refined);
+    ExecutionParameters best = parameters[0];
+    if (parameters.size() > 1)
+    {
+      double best_time = std::numeric_limits<double>::max();
+      for (const auto& candidate : parameters)
+      {
+        const double time = measure(setup(candidate));
+        if (time < best_time)
+        {
+          best_time = time;
+          best = candidate;
+        }
+      }
+    }
+
+    if (root)
+    {
+      // keep the entries other runs added meanwhile
+      read_cache();
+      cache[key] = best;
+      write_cache();
+    }
+    else
+      cache[key] = best;
+    return best;
+  }
+
+  /**
+   * The cached parameters for <code>key</code>, if any. Only the cache of
+   * the first process decides whether tune() runs trial applications.
+   */
+  std::optional<ExecutionParameters>
+  lookup(const std::string& key) const
+  {
+    const auto entry = cache.find(key);
+    if (entry == cache.end())
+      return {};
+    return entry->second;
+  }
+
+  /// The number of trial applications of all calls to tune()
+  unsigned int
+  n_trials() const
+  {
+    return trials;
+  }
+
+private:
+  // the rank in the communicator, zero if MPI is not initialized
+  unsigned int
+  this_process() const
+  {
+    return ::dealii::Utilities::MPI::job_supports_mpi()
+             ? ::dealii::Utilities::MPI::this_mpi_process(communicator)
+             : 0;
+  }
+
+  static std::string
+  cpu_model()
+  {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+      if (line.rfind("model name", 0) == 0)
+        return line.substr(line.find(':') + 2);
+    return "unknown";
+  }
+
+  /**
+   * The parameters <code>parameters</code> of the first process, on all
+   * processes.
+   */
+  std::optional<ExecutionParameters>
+  broadcast(const std::optional<ExecutionParameters>& parameters) const
+  {
+    if (!::dealii::Utilities::MPI::job_supports_mpi())
+      return parameters;
+    unsigned int data[5] = { parameters.has_value(), 0, 0, 0, 0 };
+    if (parameters)
+    {
+      data[1] = parameters->tasks_parallel_scheme;
+      data[2] = parameters->tasks_block_size;
+      data[3] = parameters->overlap_communication_computation;
+      data[4] = parameters->group_cells_by_level;
+    }
+    const int ierr = MPI_Bcast(data, 5, MPI_UNSIGNED, 0, communicator);
+    AssertThrowMPI(ierr);
+    if (data[0] == 0)
+      return {};
+    ExecutionParameters result;
+    result.tasks_parallel_scheme = data[1];
+    result.tasks_block_size = data[2];
+    result.overlap_communication_computation = data[3] != 0;
+    result.group_cells_by_level = data[4] != 0;
+    return result;
+  }
+
+  /**
+   * The minimal time of <code>n_repetitions</code> applications after one
+   * warm up application, the maximum over all processes.
+   */
+  double
+  measure(const std::function<void()>& apply)
+  {
+    apply();
+    double time = std::numeric_limits<double>::max();
+    for (unsigned int i = 0; i < n_repetitions; ++i)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      apply();
+      time = std::min(
+        time, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    trials += n_repetitions + 1;
+    if (!::dealii::Utilities::MPI::job_supports_mpi())
+      return time;
+    return ::dealii::Utilities::MPI::max(time, communicator);
+  }
+
+  // one line per key: the key, the task scheme, the block size, whether
+  // communication and computation overlap and whether the cells are grouped
+  // by level, separated by tabs. Entries which are no candidates of any run
+  // are dropped.
+  void
+  read_cache()
+  {
+    const std::vector<ExecutionParameters> allowed = candidates(2, 2, true);
+    std::ifstream file(cache_file);
+    std::string line;
+    while (std::getline(file, line))
+    {
+      std::istringstream fields(line);
+      std::string key;
+      ExecutionParameters parameters;
+      if (std::getline(fields, key, '\t') &&
+          fields >> parameters.tasks_parallel_scheme >> parameters.tasks_block_size >>
+            parameters.overlap_communication_computation >> parameters.group_cells_by_level &&
+          std::find(allowed.begin(), allowed.end(), parameters) != allowed.end())
+        cache[key] = parameters;
+    }
+  }
+
+  // write to a temporary file and rename it, such that concurrent runs never
+  // read incomplete files
+  void
+  write_cache() const
+  {
+    const std::filesystem::path path(cache_file);
+    if (path.has_parent_path())
+      std::filesystem::create_directories(path.parent_path());
+    const std::string temporary = cache_file + "." + std::to_string(getpid());
+    {
+      std::ofstream file(temporary);
+      for (const auto& [key, parameters] : cache)
+        file << key << '\t' << parameters.tasks_parallel_scheme << '\t'
+             << parameters.tasks_block_size << '\t'
+             << parameters.overlap_communication_computation << '\t'
+             << parameters.group_cells_by_level << '\n';
+      if (!file)
+      {
+        std::filesystem::remove(temporary);
+        return;
+      }
+    }
+    std::filesystem::rename(temporary, path);
+  }
+
+  const std::string cache_file;
+  const unsigned int n_repetitions;
+  const MPI_Comm communicator;
+  std::map<std::string, ExecutionParameters> cache;
+  unsigned int trials = 0;
+};
+} // namespace CFL::dealii::MatrixFree
+
+#endif // DEALII_MATRIXFREE_AUTO_TUNER_H
@@ -0,0 +1,681 @@
+#ifndef DEALII_MATRIXFREE_CAPTURE_H
+#define DEALII_MATRIXFREE_CAPTURE_H
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_tools.h>
+#include <deal.II/fe/mapping_q.h>
+#include <deal.II/fe/mapping_q_generic.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <cfl/base/traits.h>
+#include <cfl/matrixfree/auto_tuner.h>
+#include <cfl/matrixfree/matrix_free_integrator.h>
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace CFL::dealii::MatrixFree
+{
+/**
+ * @brief The setup of a MatrixFreeIntegrator together with one source vector
+ *
+ * capture() records what is needed to rebuild the operator in another
+ * program: the mesh, the finite elements and the DoF numbering, the
+ * constraints, the mapping, the quadratures and the AdditionalData passed to
+ * MatrixFree::reinit(), a source vector and a type identifier of the Form.
+ * The matrixfree_replay application reads such a file, rebuilds the operator
+ * for the Forms it is compiled with and times vmult() in isolation, such
+ * that a slow operator apply of a production run can be reproduced and
+ * bisected without the rest of the application.
+ *
+ * The mesh is stored as its coarse cells, one flag per cell of the
+ * hierarchy in depth-first order telling whether the cell is refined, and
+ * the final vertex positions. Manifolds are not stored, so a mapping of
+ * higher degree sees straight edges after replay. The DoF numbering is
+ * stored as the DoF indices of the active cells, so renumberings applied by
+ * the application are reproduced. Only isotropically refined meshes can be
+ * captured.
+ *
+ * Capturing is limited to serial runs: record() reads the whole mesh, all
+ * DoF indices, the constraints and the source vector from the calling
+ * process, and throws if the operator is distributed over several MPI
+ * processes. To reproduce a slow operator of a parallel run, run the same
+ * case on one process and capture it there; matrixfree_replay always
+ * replays serially.
+ *
+ * <h3> Usage example </h3>
+ * <code>
+ *   capture("slow.capture", integrator, mapping, constraints, quadratures,
+ *           additional_data, src);
+ *   // in another program
+ *   const auto capture = Capture<dim>::read("slow.capture");
+ *   Triangulation<dim> tr;
+ *   capture.create_triangulation(tr);
+ *   const auto fe = capture.create_fe(0);
+ *   DoFHandler<dim> dof(tr);
+ *   dof.distribute_dofs(*fe);
+ *   capture.renumber_dofs(0, dof);
+ * </code>
+ */
+template <int dim>
+struct Capture
+{
+  struct ConstraintLine
+  {
+    std::uint64_t index;
+    double inhomogeneity;
+    std::vector<std::pair<std::uint64_t, double>> entries;
+  };
+
+  /// Everything belonging to one DoFHandler of the MatrixFree object
+  struct Component
+  {
+    std::string fe_name;
+    /// The DoF indices of the active cells in depth-first order
+    std::vector<std::uint64_t> cell_dofs;
+    std::vector<ConstraintLine> constraints;
+    std::vector<double> src;
+  };
+
+  /// The type identifier of the Form, i.e. <code>typeid(Form).name()</code>
+  std::string form;
+  /// 0 for MappingQGeneric, 1 for MappingQ
+  std::uint32_t mapping_type = 0;
+  std::uint32_t mapping_degree = 1;
+  ExecutionParameters execution_parameters;
+  std::uint32_t mapping_update_flags = 0;
+  std::uint32_t mapping_update_flags_boundary_faces = 0;
+  std::uint32_t mapping_update_flags_inner_faces = 0;
+  std::uint32_t level_mg_handler = std::numeric_limits<std::uint32_t>::max();
+  /// The vectorization categories of the active cells, empty if none are set
+  std::vector<std::uint32_t> cell_vectorization_category;
+  std::uint32_t cell_vectorization_categories_strict = 0;
+  /// The points and weights of the one-dimensional quadratures
+  std::vector<std::pair<std::vector<double>, std::vector<double>>> quadratures_1d;
+
+  /// The positions of all vertices, dim coordinates each
+  std::vector<double> vertices;
+  /// The vertex indices of the coarse cells
+  std::vector<std::uint32_t> coarse_cells;
+  /// The boundary ids of the faces of the coarse cells, 255 for interior faces
+  std::vector<std::uint8_t> coarse_boundary_ids;
+  /// Whether a cell is refined, for all cells in depth-first order
+  std::vector<std::uint8_t> refined;
+  /// The vertex indices of the active cells in depth-first order
+  std::vector<std::uint32_t> cell_vertices;
+  std::vector<Component> components;
+
+  /**
+   * Record the arguments of MatrixFree::reinit() for <code>data</code> and
+   * <code>src</code>. <code>form</code> identifies the Form.
+   */
+  template <typename Number, typename VectorType>
+  static Capture
+  record(const std::string& form, const ::dealii::MatrixFree<dim, Number>& data,
+         const ::dealii::Mapping<dim>& mapping,
+         const std::vector<const ::dealii::AffineConstraints<double>*>& constraints,
+         const std::vector<::dealii::Quadrature<1>>& quadratures,
+         const typename ::dealii::MatrixFree<dim, Number>::AdditionalData& additional_data,
+         const VectorType& src)
+  {
+    const unsigned int n_processes = data.get_vector_partitioner(0)->n_mpi_processes();
+    AssertThrow(n_processes == 1,
+                ::dealii::ExcMessage("Only serial runs can be captured, but the operator is "
+                                     "distributed over " +
+                                     std::to_string(n_processes) +
+                                     " processes. Run the case on one process to capture it."));
+    AssertDimension(constraints.size(), data.n_components());
+
+    Capture capture;
+    capture.form = form;
+    if (const auto* mapping_q = dynamic_cast<const ::dealii::MappingQ<dim>*>(&mapping))
+    {
+      capture.mapping_type = 1;
+      capture.mapping_degree = mapping_q->get_degree();
+    }
+    else if (const auto* generic = dynamic_cast<const ::dealii::MappingQGeneric<dim>*>(&mapping))
+      capture.mapping_degree = generic->get_degree();
+    else
+      AssertThrow(false, ::dealii::ExcMessage("Only MappingQ and MappingQGeneric are supported!"));
+
+    capture.execution_parameters.tasks_parallel_scheme = additional_data.tasks_parallel_scheme;
+    capture.execution_parameters.tasks_block_size = additional_data.tasks_block_size;
+    capture.execution_parameters.overlap_communication_computation =
+      additional_data.overlap_communication_computation;
+    capture.mapping_update_flags = additional_data.mapping_update_flags;
+    capture.mapping_update_flags_boundary_faces =
+      additional_data.mapping_update_flags_boundary_faces;
+    capture.mapping_update_flags_inner_faces = additional_data.mapping_update_flags_inner_faces;
+    capture.level_mg_handler = additional_data.level_mg_handler;
+    capture.cell_vectorization_category.assign(
+      additional_data.cell_vectorization_category.begin(),
+      additional_data.cell_vectorization_category.end());
+    capture.cell_vectorization_categories_strict =
+      additional_data.cell_vectorization_categories_strict;
+    for (const auto& quadrature : quadratures)
+    {
+      std::vector<double> points;
+      for (const auto& point : quadrature.get_points())
+        points.push_back(point[0]);
+      capture.quadratures_1d.emplace_back(points, quadrature.get_weights());
+    }
+
+    const auto& tr = data.get_dof_handler(0).get_triangulation();
+    for (const auto& vertex : tr.get_vertices())
+      for (unsigned int d = 0; d < dim; ++d)
+        capture.vertices.push_back(vertex[d]);
+    for (const auto& cell : tr.cell_iterators_on_level(0))
+    {
+      for (unsigned int v = 0; v < ::dealii::GeometryInfo<dim>::vertices_per_cell; ++v)
+        capture.coarse_cells.push_back(cell->vertex_index(v));
+      for (unsigned int f = 0; f < ::dealii::GeometryInfo<dim>::faces_per_cell; ++f)
+        capture.coarse_boundary_ids.push_back(
+          cell->face(f)->at_boundary() ? cell->face(f)->boundary_id() : 255);
+      capture.record_cell(cell);
+    }
+
+    for (unsigned int i = 0; i < data.n_components(); ++i)
+    {
+      const auto& dof = data.get_dof_handler(i);
+      Component component;
+      component.fe_name = dof.get_fe().get_name();
+      std::vector<::dealii::types::global_dof_index> dof_indices(dof.get_fe().dofs_per_cell);
+      for (const auto& cell : dof.cell_iterators_on_level(0))
+        for_each_active_cell(cell, [&](const auto& active_cell) {
+          active_cell->get_dof_indices(dof_indices);
+          component.cell_dofs.insert(component.cell_dofs.end(), dof_indices.begin(),
+                                     dof_indices.end());
+        });
+
+      for (::dealii::types::global_dof_index j = 0; j < dof.n_dofs(); ++j)
+        if (constraints[i]->is_constrained(j))
+        {
+          ConstraintLine line{ j, constraints[i]->get_inhomogeneity(j), {} };
+          for (const auto& entry : *constraints[i]->get_constraint_entries(j))
+            line.entries.emplace_back(entry.first, entry.second);
+          component.constraints.push_back(line);
+        }
+
+      const auto& block = get_block(src, i);
+      for (::dealii::types::global_dof_index j = 0; j < block.size(); ++j)
+        component.src.push_back(block(j));
+      capture.components.push_back(component);
+    }
+    return capture;
+  }
+
+  /**
+   * Create the captured mesh in the empty triangulation <code>tr</code>.
+   */
+  void
+  create_triangulation(::dealii::Triangulation<dim>& tr) const
+  {
+    constexpr unsigned int vertices_per_cell = ::dealii::GeometryInfo<dim>::vertices_per_cell;
+    constexpr unsigned int faces_per_cell = ::dealii::GeometryInfo<dim>::faces_per_cell;
+
+    // the coarse cells with the vertices they use
+    std::vector<unsigned int> coarse_index(vertices.size() / dim,
+                                           ::dealii::numbers::invalid_unsigned_int);
+    std::vector<::dealii::Point<dim>> coarse_vertices;
+    std::vector<::dealii::CellData<dim>> cells(coarse_cells.size() / vertices_per_cell);
+    for (std::size_t c = 0; c < cells.size(); ++c)
+      for (unsigned int v = 0; v < vertices_per_cell; ++v)
+      {
+        const unsigned int index = coarse_cells[c * vertices_per_cell + v];
+        if (coarse_index[index] == ::dealii::numbers::invalid_unsigned_int)
+        {
+          coarse_index[index] = coarse_vertices.size();
+          coarse_vertices.push_back(vertex(index));
+        }
+        cells[c].vertices[v] = coarse_index[index];
+      }
+    tr.create_triangulation(coarse_vertices, cells, ::dealii::SubCellData());
+
+    std::size_t c = 0;
+    for (const auto& cell : tr.cell_iterators_on_level(0))
+    {
+      for (unsigned int f = 0; f < faces_per_cell; ++f)
+        if (cell->face(f)->at_boundary())
+          cell->face(f)->set_boundary_id(coarse_boundary_ids[c * faces_per_cell + f]);
+      ++c;
+    }
+
+    // refine one level per sweep until the captured hierarchy is reached
+    for (bool refine = true; refine;)
+    {
+      refine = false;
+      std::size_t position = 0;
+      for (const auto& cell : tr.cell_iterators_on_level(0))
+        flag_cell(cell, position, refine);
+      if (refine)
+        tr.execute_coarsening_and_refinement();
+    }
+
+    std::size_t position = 0;
+    for (const auto& cell : tr.cell_iterators_on_level(0))
+      for_each_active_cell(cell, [&](const auto& active_cell) {
+        for (unsigned int v = 0; v < vertices_per_cell; ++v)
+          active_cell->vertex(v) = vertex(cell_vertices[position++]);
+      });
+  }
+
+  /**
+   * The finite element of the <code>i</code>th DoFHandler.
+   */
+  std::unique_ptr<::dealii::FiniteElement<dim>>
+  create_fe(const unsigned int i) const
+  {
+    AssertIndexRange(i, components.size());
+    return ::dealii::FETools::get_fe_by_name<dim, dim>(components[i].fe_name);
+  }
+
+  /**
+   * Give the DoFs of <code>dof</code>, distributed with create_fe(i) on the
+   * mesh of create_triangulation(), the captured numbering.
+   */
+  void
+  renumber_dofs(const unsigned int i, ::dealii::DoFHandler<dim>& dof) const
+  {
+    AssertIndexRange(i, components.size());
+    std::vector<::dealii::types::global_dof_index> new_numbers(
+      dof.n_dofs(), ::dealii::numbers::invalid_dof_index);
+    std::vector<::dealii::types::global_dof_index> dof_indices(dof.get_fe().dofs_per_cell);
+    std::size_t position = 0;
+    for (const auto& cell : dof.cell_iterators_on_level(0))
+      for_each_active_cell(cell, [&](const auto& active_cell) {
+        active_cell->get_dof_indices(dof_indices);
+        for (const auto index : dof_indices)
+          new_numbers[index] = components[i].cell_dofs.at(position++);
+      });
+    AssertThrow(position == components[i].cell_dofs.size(),
+                ::dealii::ExcMessage("The DoFs do not match the captured ones!"));
+    dof.renumber_dofs(new_numbers);
+  }
+
+  /**
+   * Fill <code>constraints</code> with the captured constraints of the
+   * <code>i</code>th DoFHandler and close it.
+   */
+  void
+  make_constraints(const unsigned int i, ::dealii::AffineConstraints<double>& constraints) const
+  {
+    AssertIndexRange(i, components.size());
+    constraints.clear();
+    for (const auto& line : components[i].constraints)
+    {
+      constraints.add_line(line.index);
+      for (const auto& entry : line.entries)
+        constraints.add_entry(line.index, entry.first, entry.second);
+      constraints.set_inhomogeneity(line.index, line.inhomogeneity);
+    }
+    constraints.close();
+  }
+
+  std::unique_ptr<::dealii::Mapping<dim>>
+  create_mapping() const
+  {
+    if (mapping_type == 1)
+      return std::make_unique<::dealii::MappingQ<dim>>(mapping_degree);
+    return std::make_unique<::dealii::MappingQGeneric<dim>>(mapping_degree);
+  }
+
+  std::vector<::dealii::Quadrature<1>>
+  create_quadratures() const
+  {
+    std::vector<::dealii::Quadrature<1>> quadratures;
+    for (const auto& [points, weights] : quadratures_1d)
+    {
+      std::vector<::dealii::Point<1>> quadrature_points;
+      for (const double point : points)
+        quadrature_points.emplace_back(point);
+      quadratures.emplace_back(quadrature_points, weights);
+    }
+    return quadratures;
+  }
+
+  template <typename Number>
+  typename ::dealii::MatrixFree<dim, Number>::AdditionalData
+  create_additional_data() const
+  {
+    typename ::dealii::MatrixFree<dim, Number>::AdditionalData additional_data;
+    execution_parameters.apply(additional_data);
+    additional_data.mapping_update_flags = ::dealii::UpdateFlags(mapping_update_flags);
+    additional_data.mapping_update_flags_boundary_faces =
+      ::dealii::UpdateFlags(mapping_update_flags_boundary_faces);
+    additional_data.mapping_update_flags_inner_faces =
+      ::dealii::UpdateFlags(mapping_update_flags_inner_faces);
+    additional_data.level_mg_handler = level_mg_handler;
+    additional_data.cell_vectorization_category.assign(cell_vectorization_category.begin(),
+                                                       cell_vectorization_category.end());
+    additional_data.cell_vectorization_categories_strict =
+      cell_vectorization_categories_strict != 0;
+    return additional_data;
+  }
+
+  /**
+   * Copy the captured source vector into <code>src</code>, which has to be
+   * initialized by the MatrixFree object of the replayed operator.
+   */
+  template <typename VectorType>
+  void
+  fill_src(VectorType& src) const
+  {
+    for (unsigned int i = 0; i < components.size(); ++i)
+    {
+      auto& block = get_block(src, i);
+      AssertDimension(block.size(), components[i].src.size());
+      for (::dealii::types::global_dof_index j = 0; j < block.size(); ++j)
+        block(j) = components[i].src[j];
+    }
+  }
+
+  /**
+   * Write the capture to <code>filename</code>. The file starts with
+   * "CFLCAPTR", the version and the dimension, followed by the members in
+   * the order of their declaration.
+   */
+  void
+  write(const std::string& filename) const
+  {
+    std::ofstream file(filename, std::ios::binary);
+    file.write(magic, sizeof(magic));
+    write_value(file, version);
+    write_value(file, static_cast<std::uint32_t>(dim));
+    write_string(file, form);
+    write_value(file, mapping_type);
+    write_value(file, mapping_degree);
+    write_value(file, static_cast<std::uint32_t>(execution_parameters.tasks_parallel_scheme));
+    write_value(file, static_cast<std::uint32_t>(execution_parameters.tasks_block_size));
+    write_value(file,
+                static_cast<std::uint32_t>(execution_parameters.overlap_communication_computation));
+    write_value(file, mapping_update_flags);
+    write_value(file, mapping_update_flags_boundary_faces);
+    write_value(file, mapping_update_flags_inner_faces);
+    write_value(file, level_mg_handler);
+    write_vector(file, cell_vectorization_category);
+    write_value(file, cell_vectorization_categories_strict);
+    write_value(file, static_cast<std::uint64_t>(quadratures_1d.size()));
+    for (const auto& [points, weights] : quadratures_1d)
+    {
+      write_vector(file, points);
+      write_vector(file, weights);
+    }
+    write_vector(file, vertices);
+    write_vector(file, coarse_cells);
+    write_vector(file, coarse_boundary_ids);
+    write_vector(file, refined);
+    write_vector(file, cell_vertices);
+    write_value(file, static_cast<std::uint64_t>(components.size()));
+    for (const auto& component : components)
+    {
+      write_string(file, component.fe_name);
+      write_vector(file, component.cell_dofs);
+      write_value(file, static_cast<std::uint64_t>(component.constraints.size()));
+      for (const auto& line : component.constraints)
+      {
+        write_value(file, line.index);
+        write_value(file, line.inhomogeneity);
+        write_vector(file, line.entries);
+      }
+      write_vector(file, component.src);
+    }
+    if (!file)
+      throw std::runtime_error("Cannot write the capture file " + filename);
+  }
+
+  /**
+   * The dimension of the mesh in the capture file <code>filename</code>, to
+   * choose the template argument of read().
+   */
+  static unsigned int
+  dimension(const std::string& filename)
+  {
+    std::ifstream file(filename, std::ios::binary);
+    return read_header(file, filename);
+  }
+
+  /**
+   * Read a file written by write().
+   */
+  static Capture
+  read(const std::string& filename)
+  {
+    std::ifstream file(filename, std::ios::binary);
+    if (read_header(file, filename) != dim)
+      throw std::runtime_error(filename + " is not a capture of dimension " +
+                               std::to_string(dim) + "!");
+    Capture capture;
+    std::uint32_t scheme = 0, block_size = 0, overlap = 0;
+    read_string(file, capture.form);
+    read_value(file, capture.mapping_type);
+    read_value(file, capture.mapping_degree);
+    read_value(file, scheme);
+    read_value(file, block_size);
+    read_value(file, overlap);
+    capture.execution_parameters.tasks_parallel_scheme = scheme;
+    capture.execution_parameters.tasks_block_size = block_size;
+    capture.execution_parameters.overlap_communication_computation = overlap != 0;
+    read_value(file, capture.mapping_update_flags);
+    read_value(file, capture.mapping_update_flags_boundary_faces);
+    read_value(file, capture.mapping_update_flags_inner_faces);
+    read_value(file, capture.level_mg_handler);
+    read_vector(file, capture.cell_vectorization_category);
+    read_value(file, capture.cell_vectorization_categories_strict);
+    std::uint64_t n_quadratures = 0;
+    read_value(file, n_quadratures);
+    capture.quadratures_1d.resize(n_quadratures);
+    for (auto& [points, weights] : capture.quadratures_1d)
+    {
+      read_vector(file, points);
+      read_vector(file, weights);
+    }
+    read_vector(file, capture.vertices);
+    read_vector(file, capture.coarse_cells);
+    read_vector(file, capture.coarse_boundary_ids);
+    read_vector(file, capture.refined);
+    read_vector(file, capture.cell_vertices);
+    std::uint64_t n_components = 0;
+    read_value(file, n_components);
+    capture.components.resize(n_components);
+    for (auto& component : capture.components)
+    {
+      read_string(file, component.fe_name);
+      read_vector(file, component.cell_dofs);
+      std::uint64_t n_lines = 0;
+      read_value(file, n_lines);
+      component.constraints.resize(n_lines);
+      for (auto& line : component.constraints)
+      {
+        read_value(file, line.index);
+        read_value(file, line.inhomogeneity);
+        read_vector(file, line.entries);
+      }
+      read_vector(file, component.src);
+    }
+    if (!file)
+      throw std::runtime_error("Cannot read the capture file " + filename);
+    return capture;
+  }
+
+private:
+  static constexpr char magic[8] = { 'C', 'F', 'L', 'C', 'A', 'P', 'T', 'R' };
+  static constexpr std::uint32_t version = 3;
+
+  ::dealii::Point<dim>
+  vertex(const std::size_t index) const
+  {
+    ::dealii::Point<dim> point;
+    for (unsigned int d = 0; d < dim; ++d)
+      point[d] = vertices[index * dim + d];
+    return point;
+  }
+
+  template <class CellIterator>
+  void
+  record_cell(const CellIterator& cell)
+  {
+    refined.push_back(cell->has_children());
+    if (cell->has_children())
+    {
+      AssertThrow(cell->refinement_case() == ::dealii::RefinementCase<dim>::isotropic_refinement,
+                  ::dealii::ExcMessage("Only isotropic refinement can be captured!"));
+      for (unsigned int c = 0; c < cell->n_children(); ++c)
+        record_cell(cell->child(c));
+    }
+    else
+      for (unsigned int v = 0; v < ::dealii::GeometryInfo<dim>::vertices_per_cell; ++v)
+        cell_vertices.push_back(cell->vertex_index(v));
+  }
+
+  // set the refine flags of the active cells which are refined in the capture
+  template <class CellIterator>
+  void
+  flag_cell(const CellIterator& cell, std::size_t& position, bool& refine) const
+  {
+    if (!refined.at(position++))
+      return;
+    if (cell->has_children())
+      for (unsigned int c = 0; c < cell->n_children(); ++c)
+        flag_cell(cell->child(c), position, refine);
+    else
+    {
+      cell->set_refine_flag();
+      refine = true;
+      for (unsigned int c = 0; c < ::dealii::GeometryInfo<dim>::max_children_per_cell; ++c)
+        skip_cell(position);
+    }
+  }
+
+  void
+  skip_cell(std::size_t& position) const
+  {
+    if (refined.at(position++))
+      for (unsigned int c = 0; c < ::dealii::GeometryInfo<dim>::max_children_per_cell; ++c)
+        skip_cell(position);
+  }
+
+  template <class CellIterator, class Function>
+  static void
+  for_each_active_cell(const CellIterator& cell, const Function& function)
+  {
+    if (cell->has_children())
+      for (unsigned int c = 0; c < cell->n_children(); ++c)
+        for_each_active_cell(cell->child(c), function);
+    else
+      function(cell);
+  }
+
+  template <typename VectorType>
+  static auto&
+  get_block(VectorType& v, [[maybe_unused]] const unsigned int i)
+  {
+    if constexpr(CFL::Traits::is_block_vector<std::remove_const_t<VectorType>>::value)
+      return v.block(i);
+    else
+    {
+      AssertDimension(i, 0);
+      return v;
+    }
+  }
+
+  static unsigned int
+  read_header(std::istream& file, const std::string& filename)
+  {
+    char header[sizeof(magic)] = {};
+    std::uint32_t file_version = 0, file_dim = 0;
+    file.read(header, sizeof(header));
+    read_value(file, file_version);
+    read_value(file, file_dim);
+    if (!file || std::string(header, sizeof(header)) != std::string(magic, sizeof(magic)) ||
+        file_version != version)
+      throw std::runtime_error(filename + " is not a capture file of this version!");
+    return file_dim;
+  }
+
+  template <typename T>
+  static void
+  write_value(std::ostream& out, const T& value)
+  {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  static void
+  read_value(std::istream& in, T& value)
+  {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  static void
+  write_vector(std::ostream& out, const std::vector<T>& values)
+  {
+    write_value(out, static_cast<std::uint64_t>(values.size()));
+    out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+  }
+
+  template <typename T>
+  static void
+  read_vector(std::istream& in, std::vector<T>& values)
+  {
+    std::uint64_t size = 0;
+    read_value(in, size);
+    if (!in)
+      return;
+    values.resize(size);
+    in.read(reinterpret_cast<char*>(values.data()), size * sizeof(T));
+  }
+
+  static void
+  write_string(std::ostream& out, const std::string& value)
+  {
+    write_vector(out, std::vector<char>(value.begin(), value.end()));
+  }
+
+  static void
+  read_string(std::istream& in, std::string& value)
+  {
+    std::vector<char> characters;
+    read_vector(in, characters);
+    value.assign(characters.begin(), characters.end());
+  }
+};
+
+/**
+ * Write the setup of <code>integrator</code> and <code>src</code> to
+ * <code>filename</code> for the matrixfree_replay application, see Capture.
+ * The arguments are those the MatrixFree object of the integrator was
+ * initialized with.
+ */
+template <int dim, typename VectorType, class FORM, class FEDatas>
+void
+capture(const std::string& filename,
+        const ::MatrixFreeIntegratorBase<dim, VectorType, FORM, FEDatas>& integrator,
+        const ::dealii::Mapping<dim>& mapping,
+        const std::vector<const ::dealii::AffineConstraints<double>*>& constraints,
+        const std::vector<::dealii::Quadrature<1>>& quadratures,
+        const typename ::dealii::MatrixFree<dim, typename VectorType::value_type>::AdditionalData&
+          additional_data,
+        const VectorType& src)
+{
+  const auto data = integrator.get_matrix_free();
+  Assert(data != nullptr, ::dealii::ExcNotInitialized());
+  Capture<dim>::record(
+    typeid(FORM).name(), *data, mapping, constraints, quadratures, additional_data, src)
+    .write(filename);
+}
+} // namespace CFL::dealii::MatrixFree
+#endif // DEALII_MATRIXFREE_CAPTURE_H
@@ -0,0 +1,101 @@
+#ifndef DEALII_MATRIXFREE_DEGREE_DISPATCH_H
+#define DEALII_MATRIXFREE_DEGREE_DISPATCH_H
+
+#include <deal.II/base/exceptions.h>
+
+#include <array>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+/**
+ * The range of polynomial degrees for which dispatch_degree() instantiates
+ * kernels by default. Both can be set at configure time via the CMake cache
+ * variables of the same name.
+ */
+#ifndef CFL_MATRIXFREE_MIN_DEGREE
+#define CFL_MATRIXFREE_MIN_DEGREE 1
+#endif
+#ifndef CFL_MATRIXFREE_MAX_DEGREE
+#define CFL_MATRIXFREE_MAX_DEGREE 8
+#endif
+
+namespace CFL::dealii::MatrixFree
+{
+/**
+ * The polynomial degree as a compile-time constant, passed to the functor
+ * given to dispatch_degree().
+ */
+template <unsigned int degree>
+using DegreeConstant = std::integral_constant<unsigned int, degree>;
+
+namespace internal
+{
+  template <class Functor, unsigned int degree>
+  decltype(auto)
+  invoke_for_degree(Functor& functor)
+  {
+    return functor(DegreeConstant<degree>{});
+  }
+
+  template <unsigned int min_degree, class Functor, unsigned int... offsets>
+  constexpr auto
+  make_degree_table(std::integer_sequence<unsigned int, offsets...>)
+  {
+    using ReturnType = decltype(std::declval<Functor&>()(DegreeConstant<min_degree>{}));
+    static_assert(
+      (std::is_same<ReturnType,
+                    decltype(std::declval<Functor&>()(DegreeConstant<min_degree + offsets>{}))>::value &&
+       ...),
+      "The functor has to return the same type for all degrees!");
+    return std::array<ReturnType (*)(Functor&), sizeof...(offsets)>{
+      { &invoke_for_degree<Functor, min_degree + offsets>... }
+    };
+  }
+} // namespace internal
+
+/**
+ * @brief Select a compile-time polynomial degree at run time
+ *
+ * FEData, and hence the sum-factorization kernels generated from a Form, take
+ * the polynomial degree as a template argument. This function instantiates
+ * <code>functor(DegreeConstant<k>{})</code> for all
+ * <code>min_degree <= k <= max_degree</code>, stores them in a table of
+ * function pointers and calls the entry for <code>degree</code>. Thus, a
+ * single binary contains fully specialized kernels for the whole range and
+ * the degree can be read from an input file. The functor has to return the
+ * same type for all degrees.
+ *
+ * Every degree in the range instantiates the whole operator, so the compile
+ * time grows linearly with the size of the range. It can be restricted via
+ * the CMake cache variables <code>CFL_MATRIXFREE_MIN_DEGREE</code> and
+ * <code>CFL_MATRIXFREE_MAX_DEGREE</code> which are the defaults for the
+ * template arguments.
+ *
+ * <h3> Usage example </h3>
+ * <code>
+ *   dispatch_degree(degree, [&](auto degree_constant) {
+ *     constexpr unsigned int fe_degree = decltype(degree_constant)::value;
+ *     FEData<FE_Q, fe_degree, 1, 2, 0, fe_degree, double> fedata(fe);
+ *     // set up and run the operator
+ *   });
+ * </code>
+ */
+template <unsigned int min_degree = CFL_MATRIXFREE_MIN_DEGREE,
+          unsigned int max_degree = CFL_MATRIXFREE_MAX_DEGREE, class Functor>
+decltype(auto)
+dispatch_degree(const unsigned int degree, Functor&& functor)
+{
+  static_assert(min_degree <= max_degree, "The range of degrees is empty!");
+  using FunctorType = std::remove_reference_t<Functor>;
+  static constexpr auto table = internal::make_degree_table<min_degree, FunctorType>(
+    std::make_integer_sequence<unsigned int, max_degree - min_degree + 1>{});
+  AssertThrow(degree >= min_degree && degree <= max_degree,
+              ::dealii::ExcMessage("The polynomial degree " + std::to_string(degree) +
+                                   " is not in the compiled range [" + std::to_string(min_degree) +
+                                   ", " + std::to_string(max_degree) + "]!"));
+  return table[degree - min_degree](functor);
+}
+}
+
+#endif // DEALII_MATRIXFREE_DEGREE_DISPATCH_H
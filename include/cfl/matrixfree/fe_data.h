@@ -3,9 +3,14 @@
 
 #include <cfl/base/fefunctions.h>
 #include <cfl/base/traits.h>
+#include <cfl/matrixfree/trace.h>
 #include <deal.II/matrix_free/fe_evaluation.h>
 #include <deal.II/matrix_free/matrix_free.h>
 
+#include <algorithm>
+#include <array>
+#include <optional>
+
 namespace CFL::dealii::MatrixFree
 {
 template <typename... Types>
@@ -29,11 +34,26 @@ class FEDatas;
 * This distinction can be seen in the template parameter
 * <code>FiniteElementType<\code> which implies compile time dependency vs the
 * member variable <code> fe_evaluation <\code> which is initialized at run-time
-* when appropriate.
+* when appropriate. The FEEvaluation object is stored inside the FEData object
+* rather than on the heap, such that it is at a fixed offset in \ref FEDatas
+* and accessing it in the quadrature point loop involves no indirection.
 * It is important to note that every finite element which is added to \ref
 * FEDatas should be uniquely identifiable. For this reason the class
 * definition of \FEData requires <code>fe_no<\code>
 *
+* By default, <code>fe_no<\code> is also the index of the DoFHandler in the
+* MatrixFree object and the quadrature with index 0 and
+* <code>max_fe_degree+1<\code> points is used. The last three template
+* parameters allow to evaluate the same DoFHandler with a different
+* quadrature: a second FEData object with its own <code>fe_no<\code> but the
+* same <code>dof_no<\code> can be used to integrate only some of the Forms,
+* e.g. a nonlinear reaction term, with a higher number of quadrature points
+* <code>n_q_points_1d<\code>. The quadrature with index <code>quad_no<\code>
+* in the MatrixFree object must have that many points.
+* A Form is evaluated at the quadrature points of its test function, thus
+* all FE functions in it must belong to FEData objects with the same
+* <code>quad_no<\code>, which is checked at compile time.
+*
 * For more on usage of this class, refer \ref FEDatas
 *
 * <h3> Usage example </h3>
@@ -41,21 +61,31 @@ class FEDatas;
 * 	  const auto fe_shared = std::make_shared<FE_Q<2>>(2);
       FEData<FE_Q, 2, 1, 2, 0, 2, double> fedata_e_system(fe_shared);
       FEData<FE_Q, 2, 1, 2, 1, 2, double> fedata_u_system(fe_shared);
+      // over-integration of the DoFHandler 1 with the quadrature 1
+      FEData<FE_Q, 2, 1, 2, 2, 2, double, 5, 1, 1> fedata_u_nonlinear(fe_shared);
 * </code>
 *
 *
 */
 template <template <int, int> class FiniteElementType, int fe_degree, int n_components, int dim,
-          unsigned int fe_no, unsigned int max_fe_degree, typename Number = double>
+          unsigned int fe_no, unsigned int max_fe_degree, typename Number = double,
+          unsigned int n_q_points_1d = max_fe_degree + 1, unsigned int quad_no = 0,
+          unsigned int dof_no = fe_no>
 class FEData final
 {
 public:
   using FEEvaluationType =
-    typename ::dealii::FEEvaluation<dim, fe_degree, max_fe_degree + 1, n_components, Number>;
+    typename ::dealii::FEEvaluation<dim, fe_degree, n_q_points_1d, n_components, Number>;
   using NumberType = Number;
   using TensorTraits = CFL::Traits::Tensor<(n_components > 1 ? 1 : 0), dim>;
   static constexpr unsigned int fe_number = fe_no;
+  static constexpr unsigned int dof_number = dof_no;
+  static constexpr unsigned int quad_number = quad_no;
+  static constexpr unsigned int n_q_points_1d_value = n_q_points_1d;
   static constexpr unsigned int max_degree = max_fe_degree;
+  static constexpr unsigned int degree = fe_degree;
+  static constexpr unsigned int n_fe_components = n_components;
+  static constexpr int dimension = dim;
   const std::shared_ptr<const FiniteElementType<dim, dim>> fe;
 
   /**
@@ -94,11 +124,11 @@ public:
   bool
   evaluation_is_initialized() const
   {
-    return fe_evaluation != nullptr;
+    return fe_evaluation.has_value();
   }
 
 private:
-  std::shared_ptr<FEEvaluationType> fe_evaluation = nullptr;
+  std::optional<FEEvaluationType> fe_evaluation;
 
   template <typename... Types>
   friend class FEDatas;
@@ -109,16 +139,24 @@ private:
  * evaluation over faces - whether interior faces or exterior (boundary) faces
  */
 template <template <int, int> class FiniteElementType, int fe_degree, int n_components, int dim,
-          unsigned int fe_no, unsigned int max_fe_degree, typename Number = double>
+          unsigned int fe_no, unsigned int max_fe_degree, typename Number = double,
+          unsigned int n_q_points_1d = max_fe_degree + 1, unsigned int quad_no = 0,
+          unsigned int dof_no = fe_no>
 class FEDataFace final
 {
 public:
   using FEEvaluationType =
-    typename ::dealii::FEFaceEvaluation<dim, fe_degree, max_fe_degree + 1, n_components, Number>;
+    typename ::dealii::FEFaceEvaluation<dim, fe_degree, n_q_points_1d, n_components, Number>;
   using NumberType = Number;
   using TensorTraits = CFL::Traits::Tensor<(n_components > 1 ? 1 : 0), dim>;
   static constexpr unsigned int fe_number = fe_no;
+  static constexpr unsigned int dof_number = dof_no;
+  static constexpr unsigned int quad_number = quad_no;
+  static constexpr unsigned int n_q_points_1d_value = n_q_points_1d;
   static constexpr unsigned int max_degree = max_fe_degree;
+  static constexpr unsigned int degree = fe_degree;
+  static constexpr unsigned int n_fe_components = n_components;
+  static constexpr int dimension = dim;
   const std::shared_ptr<const FiniteElementType<dim, dim>> fe;
 
   /**
@@ -149,13 +187,13 @@ public:
   bool
   evaluation_is_initialized() const
   {
-    return ((interior || fe_evaluation_interior != nullptr) &&
-            (exterior || fe_evaluation_exterior != nullptr));
+    return ((interior || fe_evaluation_interior.has_value()) &&
+            (exterior || fe_evaluation_exterior.has_value()));
   }
 
 private:
-  std::shared_ptr<FEEvaluationType> fe_evaluation_interior = nullptr;
-  std::shared_ptr<FEEvaluationType> fe_evaluation_exterior = nullptr;
+  std::optional<FEEvaluationType> fe_evaluation_interior;
+  std::optional<FEEvaluationType> fe_evaluation_exterior;
 
   template <typename... Types>
   friend class FEDatas;
@@ -170,9 +208,11 @@ namespace CFL::Traits
  *
  */
 template <template <int, int> class FiniteElementType, int fe_degree, int n_components, int dim,
-          unsigned int fe_no, unsigned int max_degree, typename Number>
+          unsigned int fe_no, unsigned int max_degree, typename Number, unsigned int n_q_points_1d,
+          unsigned int quad_no, unsigned int dof_no>
 struct is_fe_data<CFL::dealii::MatrixFree::FEData<FiniteElementType, fe_degree, n_components, dim,
-                                                  fe_no, max_degree, Number>>
+                                                  fe_no, max_degree, Number, n_q_points_1d,
+                                                  quad_no, dof_no>>
 {
   static constexpr bool value = true;
 };
@@ -183,9 +223,11 @@ struct is_fe_data<CFL::dealii::MatrixFree::FEData<FiniteElementType, fe_degree,
  *
  */
 template <template <int, int> class FiniteElementType, int fe_degree, int n_components, int dim,
-          unsigned int fe_no, unsigned int max_degree, typename Number>
-struct is_fe_data_face<CFL::dealii::MatrixFree::FEDataFace<
-  FiniteElementType, fe_degree, n_components, dim, fe_no, max_degree, Number>>
+          unsigned int fe_no, unsigned int max_degree, typename Number, unsigned int n_q_points_1d,
+          unsigned int quad_no, unsigned int dof_no>
+struct is_fe_data_face<CFL::dealii::MatrixFree::FEDataFace<FiniteElementType, fe_degree,
+                                                           n_components, dim, fe_no, max_degree,
+                                                           Number, n_q_points_1d, quad_no, dof_no>>
 {
   static constexpr bool value = true;
 };
@@ -256,6 +298,51 @@ namespace CFL::dealii::MatrixFree
  *		FEDatas<FEData,FEData,FEData> --> holds fedata_x_system
  *   @endverbatim
 */
+namespace internal
+{
+  enum class FEDataKind
+  {
+    cell,
+    face,
+    any
+  };
+
+  template <class FEData>
+  constexpr FEDataKind
+  kind_of()
+  {
+    return CFL::Traits::is_fe_data<FEData>::value ? FEDataKind::cell : FEDataKind::face;
+  }
+
+  /**
+   * The position of the first FEData object in <code>Types</code> of the
+   * given kind with number <code>fe_number</code>, or of any number if
+   * <code>any_number</code> is set. If there is none, this is
+   * <code>sizeof...(Types)</code>.
+   */
+  template <FEDataKind kind, class... Types>
+  constexpr std::size_t
+  find_fe_data(const unsigned int fe_number, const bool any_number = false)
+  {
+    constexpr std::array<unsigned int, sizeof...(Types)> fe_numbers{ { Types::fe_number... } };
+    constexpr std::array<FEDataKind, sizeof...(Types)> kinds{ { kind_of<Types>()... } };
+    for (std::size_t i = 0; i < sizeof...(Types); ++i)
+      if ((kind == FEDataKind::any || kinds[i] == kind) &&
+          (any_number || fe_numbers[i] == fe_number))
+        return i;
+    return sizeof...(Types);
+  }
+
+  /**
+   * Tag type to select the level of the FEDatas hierarchy holding the
+   * FEData object of the given kind with number <code>fe_number</code>.
+   */
+  template <unsigned int fe_number, FEDataKind kind>
+  struct FEDataTag
+  {
+  };
+}
+
 template <>
 class FEDatas<>
 {
@@ -264,6 +351,20 @@ public:
   static constexpr unsigned int max_degree = 0; // unused
   static constexpr unsigned int contains_cell_data = false;
   static constexpr unsigned int contains_face_data = false;
+  static constexpr unsigned int max_n_q_points = 0;
+  static constexpr unsigned int max_n_q_points_face = 0;
+  static constexpr unsigned int n_quadratures = 0;
+
+  static constexpr unsigned int
+  get_n_q_points_1d(const unsigned int /*quad_no*/)
+  {
+    return 0;
+  }
+
+protected:
+  // the end of the overload set FEDatas::get_level()
+  void
+  get_level() const = delete;
 };
 
 /**
@@ -278,8 +379,10 @@ public:
   using FEEvaluationType = typename FEData::FEEvaluationType;
   using TensorTraits = typename FEData::TensorTraits;
   using NumberType = typename FEData::NumberType;
+  using FEDataType = FEData;
   using Base = FEDatas<Types...>;
   static constexpr unsigned int fe_number = FEData::fe_number;
+  static constexpr internal::FEDataKind fe_data_kind = internal::kind_of<FEData>();
   static constexpr unsigned int max_degree =
     sizeof...(Types) == 0 ? FEData::max_degree : Base::max_degree;
   static constexpr unsigned int n = sizeof...(Types) == 0 ? 1 : Base::n + 1;
@@ -287,19 +390,41 @@ public:
     CFL::Traits::is_fe_data_face<FEData>::value || Base::contains_face_data;
   static constexpr bool contains_cell_data =
     CFL::Traits::is_fe_data<FEData>::value || Base::contains_cell_data;
+  /// The largest number of quadrature points of all cell FEData objects
+  static constexpr unsigned int max_n_q_points =
+    CFL::Traits::is_fe_data<FEData>::value
+      ? std::max(FEData::FEEvaluationType::static_n_q_points, Base::max_n_q_points)
+      : Base::max_n_q_points;
+  /// The largest number of quadrature points of all face FEData objects
+  static constexpr unsigned int max_n_q_points_face =
+    CFL::Traits::is_fe_data_face<FEData>::value
+      ? std::max(FEData::FEEvaluationType::static_n_q_points, Base::max_n_q_points_face)
+      : Base::max_n_q_points_face;
+  /// The number of quadrature formulas the MatrixFree object has to provide
+  static constexpr unsigned int n_quadratures =
+    std::max(FEData::quad_number + 1, Base::n_quadratures);
+
+  /**
+   * The number of 1D quadrature points requested for the quadrature with
+   * index <code>quad_no</code>, or zero if no FEData object uses it.
+   */
+  static constexpr unsigned int
+  get_n_q_points_1d(const unsigned int quad_no)
+  {
+    return (FEData::quad_number == quad_no) ? FEData::n_q_points_1d_value
+                                            : Base::get_n_q_points_1d(quad_no);
+  }
 
   FEDatas(FEData fe_data_, FEDatas<Types...> fe_datas_)
     : FEDatas<Types...>(fe_datas_)
     , fe_data(std::move(fe_data_))
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(CFL::Traits::is_fe_data<FEData>::value)
-            Base::template check_uniqueness<fe_number>();
-        else
-          Base::template check_uniqueness_face<fe_number>();
-      }
+    static_assert(internal::find_fe_data<fe_data_kind, Types...>(fe_number) == sizeof...(Types),
+                  "The fe_numbers have to be unique!");
     //    std::cout << "Constructor4" << std::endl;
+    static_assert(Base::get_n_q_points_1d(FEData::quad_number) == 0 ||
+                    Base::get_n_q_points_1d(FEData::quad_number) == FEData::n_q_points_1d_value,
+                  "FEData objects sharing a quadrature index must use the same quadrature!");
     static_assert(FEData::max_degree == FEDatas::max_degree,
                   "The maximum degree must be the same for all FiniteElements!");
     static_assert(CFL::Traits::is_fe_data<FEData>::value ||
@@ -311,14 +436,12 @@ public:
     : Base(fe_datas_...)
     , fe_data(std::move(fe_data_))
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(CFL::Traits::is_fe_data<FEData>::value)
-            Base::template check_uniqueness<fe_number>();
-        else
-          Base::template check_uniqueness_face<fe_number>();
-      }
+    static_assert(internal::find_fe_data<fe_data_kind, Types...>(fe_number) == sizeof...(Types),
+                  "The fe_numbers have to be unique!");
     //    std::cout << "Constructor3" << std::endl;
+    static_assert(Base::get_n_q_points_1d(FEData::quad_number) == 0 ||
+                    Base::get_n_q_points_1d(FEData::quad_number) == FEData::n_q_points_1d_value,
+                  "FEData objects sharing a quadrature index must use the same quadrature!");
     static_assert(FEData::max_degree == FEDatas::max_degree,
                   "The maximum degree must be the same for all FiniteElements!");
     static_assert(CFL::Traits::is_fe_data<FEData>::value ||
@@ -330,17 +453,8 @@ public:
   static constexpr unsigned int
   rank()
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern) return TensorTraits::rank;
-        else
-          return Base::template rank<fe_number_extern>();
-      }
-    else
-    {
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return TensorTraits::rank;
-    }
+    using Level = LevelOf<fe_number_extern, internal::FEDataKind::any>;
+    return Level::TensorTraits::rank;
   }
 
   template <int dim, typename OtherNumber>
@@ -355,17 +469,15 @@ public:
 #ifdef DEBUG_OUTPUT
         std::cout << "Initialize cell FEDatas " << fe_number << std::endl;
 #endif
-        fe_data.fe_evaluation.reset(new typename FEData::FEEvaluationType(mf, fe_number));
+        fe_data.fe_evaluation.emplace(mf, FEData::dof_number, FEData::quad_number);
       }
     else
     {
 #ifdef DEBUG_OUTPUT
       std::cout << "Initialize face FEDatas " << fe_number << std::endl;
 #endif
-      fe_data.fe_evaluation_interior.reset(
-        new typename FEData::FEEvaluationType{ mf, true, fe_number });
-      fe_data.fe_evaluation_exterior.reset(
-        new typename FEData::FEEvaluationType{ mf, false, fe_number });
+      fe_data.fe_evaluation_interior.emplace(mf, true, FEData::dof_number, FEData::quad_number);
+      fe_data.fe_evaluation_exterior.emplace(mf, false, FEData::dof_number, FEData::quad_number);
     }
     initialized = true;
 
@@ -378,9 +490,7 @@ public:
   {
     if constexpr(CFL::Traits::is_fe_data<FEData>::value)
       {
-#ifdef DEBUG_OUTPUT
-        std::cout << "Reinit cell FEDatas " << fe_number << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::reinit_cell, fe_number);
         Assert(fe_data.evaluation_is_initialized(), ::dealii::ExcInternalError());
         fe_data.fe_evaluation->reinit(cell);
       }
@@ -393,9 +503,7 @@ public:
   {
     if constexpr(CFL::Traits::is_fe_data_face<FEData>::value)
       {
-#ifdef DEBUG_OUTPUT
-        std::cout << "Reinit face FEDatas " << fe_number << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::reinit_face, fe_number);
         Assert(fe_data.evaluation_is_initialized(), ::dealii::ExcInternalError());
         fe_data.fe_evaluation_interior->reinit(face);
         fe_data.fe_evaluation_exterior->reinit(face);
@@ -409,9 +517,7 @@ public:
   {
     if constexpr(CFL::Traits::is_fe_data_face<FEData>::value)
       {
-#ifdef DEBUG_OUTPUT
-        std::cout << "Reinit face FEDatas " << fe_number << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::reinit_boundary, fe_number);
         // For boundaries we only consider the interior faces
         Assert((fe_data.template evaluation_is_initialized<true, false>()),
                ::dealii::ExcInternalError());
@@ -426,13 +532,11 @@ public:
   {
     if constexpr(CFL::Traits::is_fe_data<FEData>::value)
       {
-#ifdef DEBUG_OUTPUT
-        std::cout << "Read cell DoF values " << fe_number << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::read_cell, fe_number);
         Assert(fe_data.evaluation_is_initialized(), ::dealii::ExcInternalError());
 
         if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
-            fe_data.fe_evaluation->read_dof_values(vector.block(fe_number));
+            fe_data.fe_evaluation->read_dof_values(vector.block(FEData::dof_number));
         else
           fe_data.fe_evaluation->read_dof_values(vector);
       }
@@ -447,21 +551,18 @@ public:
       {
         Assert((fe_data.template evaluation_is_initialized<interior, exterior>()),
                ::dealii::ExcInternalError());
-#ifdef DEBUG_OUTPUT
-        std::cout << "Read face DoF values " << fe_number << " " << interior << " " << exterior
-                  << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::read_face, fe_number, 0, Trace::flags(interior, exterior));
         if constexpr(interior)
           {
             if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
-                fe_data.fe_evaluation_interior->read_dof_values(vector.block(fe_number));
+                fe_data.fe_evaluation_interior->read_dof_values(vector.block(FEData::dof_number));
             else
               fe_data.fe_evaluation_interior->read_dof_values(vector);
           }
         if constexpr(exterior)
           {
             if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
-                fe_data.fe_evaluation_exterior->read_dof_values(vector.block(fe_number));
+                fe_data.fe_evaluation_exterior->read_dof_values(vector.block(FEData::dof_number));
             else
               fe_data.fe_evaluation_exterior->read_dof_values(vector);
           }
@@ -479,12 +580,10 @@ public:
       {
         if (integrate_values | integrate_gradients)
         {
-#ifdef DEBUG_OUTPUT
-          std::cout << "Distribute cell DoF values " << fe_number << std::endl;
-#endif
+          CFL_TRACE_EVENT(Trace::Phase::distribute_cell, fe_number);
           Assert(fe_data.evaluation_is_initialized(), ::dealii::ExcInternalError());
           if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
-              fe_data.fe_evaluation->distribute_local_to_global(vector.block(fe_number));
+              fe_data.fe_evaluation->distribute_local_to_global(vector.block(FEData::dof_number));
           else
             fe_data.fe_evaluation->distribute_local_to_global(vector);
         }
@@ -501,21 +600,19 @@ public:
 
         Assert((fe_data.template evaluation_is_initialized<interior, exterior>()),
                ::dealii::ExcInternalError());
-#ifdef DEBUG_OUTPUT
-        std::cout << "Distribute face DoF values " << fe_number << " " << interior << " "
-                  << exterior << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::distribute_face, fe_number, 0,
+                        Trace::flags(interior, exterior));
         if constexpr(interior) if (integrate_values | integrate_gradients)
           {
             if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
-                fe_data.fe_evaluation_interior->distribute_local_to_global(vector.block(fe_number));
+                fe_data.fe_evaluation_interior->distribute_local_to_global(vector.block(FEData::dof_number));
             else
               fe_data.fe_evaluation_interior->distribute_local_to_global(vector);
           }
         if constexpr(exterior) if (integrate_values_exterior | integrate_gradients_exterior)
           {
             if constexpr(CFL::Traits::is_block_vector<VectorType>::value)
-                fe_data.fe_evaluation_exterior->distribute_local_to_global(vector.block(fe_number));
+                fe_data.fe_evaluation_exterior->distribute_local_to_global(vector.block(FEData::dof_number));
             else
               fe_data.fe_evaluation_exterior->distribute_local_to_global(vector);
           }
@@ -529,10 +626,8 @@ public:
   {
     if constexpr(CFL::Traits::is_fe_data<FEData>::value)
       {
-#ifdef DEBUG_OUTPUT
-        std::cout << "Evaluate cell FEDatas " << fe_number << " " << evaluate_values << " "
-                  << evaluate_gradients << " " << evaluate_hessians << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::evaluate_cell, fe_number, 0,
+                        Trace::flags(evaluate_values, evaluate_gradients, evaluate_hessians));
         Assert(fe_data.evaluation_is_initialized(), ::dealii::ExcInternalError());
         fe_data.fe_evaluation->evaluate(evaluate_values, evaluate_gradients, evaluate_hessians);
       }
@@ -545,10 +640,8 @@ public:
   {
     if constexpr(CFL::Traits::is_fe_data_face<FEData>::value)
       {
-#ifdef DEBUG_OUTPUT
-        std::cout << "Evaluate face FEDatas " << fe_number << " " << evaluate_values << " "
-                  << evaluate_gradients << " " << evaluate_hessians << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::evaluate_face, fe_number, 0,
+                        Trace::flags(evaluate_values, evaluate_gradients, evaluate_hessians));
         Assert((fe_data.template evaluation_is_initialized<interior, exterior>()),
                ::dealii::ExcInternalError());
 
@@ -568,10 +661,8 @@ public:
       {
         if (integrate_values | integrate_gradients)
         {
-#ifdef DEBUG_OUTPUT
-          std::cout << "integrate cell FEDatas " << fe_number << " " << integrate_values << " "
-                    << integrate_gradients << std::endl;
-#endif
+          CFL_TRACE_EVENT(Trace::Phase::integrate_cell, fe_number, 0,
+                          Trace::flags(integrate_values, integrate_gradients));
           fe_data.fe_evaluation->integrate(integrate_values, integrate_gradients);
         }
       }
@@ -585,19 +676,15 @@ public:
       {
         if (integrate_values | integrate_gradients)
         {
-#ifdef DEBUG_OUTPUT
-          std::cout << "integrate face FEDatas " << fe_number << " " << integrate_values << " "
-                    << integrate_gradients << std::endl;
-#endif
+          CFL_TRACE_EVENT(Trace::Phase::integrate_face, fe_number, 0,
+                          Trace::flags(integrate_values, integrate_gradients));
           fe_data.fe_evaluation_interior->integrate(integrate_values, integrate_gradients);
         }
         if (integrate_values_exterior | integrate_gradients_exterior)
         {
-#ifdef DEBUG_OUTPUT
-          std::cout << "integrate face exterior FEDatas " << fe_number << " "
-                    << integrate_values_exterior << " " << integrate_gradients_exterior
-                    << std::endl;
-#endif
+          CFL_TRACE_EVENT(
+            Trace::Phase::integrate_face_exterior, fe_number, 0,
+            Trace::flags(integrate_values_exterior, integrate_gradients_exterior));
           fe_data.fe_evaluation_exterior->integrate(integrate_values_exterior,
                                                     integrate_gradients_exterior);
         }
@@ -609,36 +696,15 @@ public:
   void
   set_integration_flags(bool integrate_value, bool integrate_gradient)
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-            integrate_values |= integrate_value;
-            integrate_gradients |= integrate_gradient;
-#ifdef DEBUG_OUTPUT
-            std::cout << "integrate cell value: " << fe_number << " " << integrate_values << " "
-                      << integrate_value << std::endl;
-            std::cout << "integrate cell gradients: " << fe_number << " " << integrate_gradients
-                      << " " << integrate_gradient << std::endl;
-#endif
-          }
-        else
-          Base::template set_integration_flags<fe_number_extern>(integrate_value,
-                                                                 integrate_gradient);
-      }
-    else
-    {
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      static_assert(CFL::Traits::is_fe_data<FEData>::value, "Must be cell object!");
-      integrate_values |= integrate_value;
-      integrate_gradients |= integrate_gradient;
+    auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    level.integrate_values |= integrate_value;
+    level.integrate_gradients |= integrate_gradient;
 #ifdef DEBUG_OUTPUT
-      std::cout << "integrate cell value: " << fe_number << " " << integrate_values << " "
-                << integrate_value << std::endl;
-      std::cout << "integrate cell gradients: " << fe_number << " " << integrate_gradients << " "
-                << integrate_gradient << std::endl;
+    std::cout << "integrate cell value: " << fe_number_extern << " " << level.integrate_values
+              << " " << integrate_value << std::endl;
+    std::cout << "integrate cell gradients: " << fe_number_extern << " "
+              << level.integrate_gradients << " " << integrate_gradient << std::endl;
 #endif
-    }
   }
 
   void
@@ -659,708 +725,298 @@ public:
   set_integration_flags_face_and_boundary(bool integrate_value, bool integrate_value_exterior,
                                           bool integrate_gradient, bool integrate_gradient_exterior)
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(CFL::Traits::is_fe_data_face<FEData>::value && fe_number == fe_number_extern)
-          {
-            integrate_values |= integrate_value;
-            integrate_values_exterior |= integrate_value_exterior;
-            integrate_gradients |= integrate_gradient;
-            integrate_gradients_exterior |= integrate_gradient_exterior;
-#ifdef DEBUG_OUTPUT
-            std::cout << "integrate face value: " << fe_number << " " << integrate_values << " "
-                      << integrate_value_exterior << std::endl;
-            std::cout << "integrate face value exterior: " << fe_number << " "
-                      << integrate_values_exterior << " " << integrate_value_exterior << std::endl;
-            std::cout << "integrate face gradients: " << fe_number << " " << integrate_gradients
-                      << " " << integrate_gradient << std::endl;
-            std::cout << "integrate face gradients exterior: " << fe_number << " "
-                      << integrate_gradients_exterior << " " << integrate_gradient_exterior
-                      << std::endl;
-#endif
-          }
-        else
-          Base::template set_integration_flags_face_and_boundary<fe_number_extern>(
-            integrate_value,
-            integrate_value_exterior,
-            integrate_gradient,
-            integrate_gradient_exterior);
-      }
-    else
-    {
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      static_assert(CFL::Traits::is_fe_data_face<FEData>::value, "Must be face object!");
-      integrate_values |= integrate_value;
-      integrate_values_exterior |= integrate_value_exterior;
-      integrate_gradients |= integrate_gradient;
-      integrate_gradients_exterior |= integrate_gradient_exterior;
+    auto& level = find_level<fe_number_extern, internal::FEDataKind::face>();
+    level.integrate_values |= integrate_value;
+    level.integrate_values_exterior |= integrate_value_exterior;
+    level.integrate_gradients |= integrate_gradient;
+    level.integrate_gradients_exterior |= integrate_gradient_exterior;
 #ifdef DEBUG_OUTPUT
-      std::cout << "integrate face value: " << fe_number << " " << integrate_values << " "
-                << integrate_value_exterior << std::endl;
-      std::cout << "integrate face value exterior: " << fe_number << " "
-                << integrate_values_exterior << " " << integrate_value_exterior << std::endl;
-      std::cout << "integrate face gradients: " << fe_number << " " << integrate_gradients << " "
-                << integrate_gradient << std::endl;
-      std::cout << "integrate face gradients exterior: " << fe_number << " "
-                << integrate_gradients_exterior << " " << integrate_gradient_exterior << std::endl;
+    std::cout << "integrate face value: " << fe_number_extern << " " << level.integrate_values
+              << " " << integrate_value_exterior << std::endl;
+    std::cout << "integrate face value exterior: " << fe_number_extern << " "
+              << level.integrate_values_exterior << " " << integrate_value_exterior << std::endl;
+    std::cout << "integrate face gradients: " << fe_number_extern << " "
+              << level.integrate_gradients << " " << integrate_gradient << std::endl;
+    std::cout << "integrate face gradients exterior: " << fe_number_extern << " "
+              << level.integrate_gradients_exterior << " " << integrate_gradient_exterior
+              << std::endl;
 #endif
-    }
   }
 
   template <unsigned int fe_number_extern>
   void
   set_evaluation_flags(bool evaluate_value, bool evaluate_gradient, bool evaluate_hessian)
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(CFL::Traits::is_fe_data<FEData>::value && fe_number == fe_number_extern)
-          {
-            evaluate_values |= evaluate_value;
-            evaluate_gradients |= evaluate_gradient;
-            evaluate_hessians |= evaluate_hessian;
+    auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    level.evaluate_values |= evaluate_value;
+    level.evaluate_gradients |= evaluate_gradient;
+    level.evaluate_hessians |= evaluate_hessian;
 #ifdef DEBUG_OUTPUT
-            std::cout << "evaluate cell value: " << fe_number << " " << evaluate_values << " "
-                      << evaluate_value << std::endl;
-            std::cout << "evaluate cell gradients: " << fe_number << " " << evaluate_gradients
-                      << " " << evaluate_gradient << std::endl;
-            std::cout << "evaluate cell hessian: " << fe_number << " " << evaluate_hessians << " "
-                      << evaluate_hessian << std::endl;
+    std::cout << "evaluate cell value: " << fe_number_extern << " " << level.evaluate_values
+              << " " << evaluate_value << std::endl;
+    std::cout << "evaluate cell gradients: " << fe_number_extern << " "
+              << level.evaluate_gradients << " " << evaluate_gradient << std::endl;
+    std::cout << "evaluate cell hessian: " << fe_number_extern << " " << level.evaluate_hessians
+              << " " << evaluate_hessian << std::endl;
 #endif
-          }
-        else
-        {
-          Base::template set_evaluation_flags<fe_number_extern>(
-            evaluate_value, evaluate_gradient, evaluate_hessian);
-        }
-      }
-    else
-    {
-      static_assert(CFL::Traits::is_fe_data<FEData>::value, "Component not found!");
-      static_assert(fe_number == fe_number_extern, "Must be cell object!");
-      evaluate_values |= evaluate_value;
-      evaluate_gradients |= evaluate_gradient;
-      evaluate_hessians |= evaluate_hessian;
-#ifdef DEBUG_OUTPUT
-      std::cout << "evaluate cell value: " << fe_number << " " << evaluate_values << " "
-                << evaluate_value << std::endl;
-      std::cout << "evaluate cell gradients: " << fe_number << " " << evaluate_gradients << " "
-                << evaluate_gradient << std::endl;
-      std::cout << "evaluate cell hessian: " << fe_number << " " << evaluate_hessians << " "
-                << evaluate_hessian << std::endl;
-#endif
-    }
   }
 
   template <unsigned int fe_number_extern>
   void
   set_evaluation_flags_face(bool evaluate_value, bool evaluate_gradient, bool evaluate_hessian)
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(CFL::Traits::is_fe_data_face<FEData>::value && fe_number == fe_number_extern)
-          {
-            evaluate_values |= evaluate_value;
-            evaluate_gradients |= evaluate_gradient;
-            evaluate_hessians |= evaluate_hessian;
+    auto& level = find_level<fe_number_extern, internal::FEDataKind::face>();
+    level.evaluate_values |= evaluate_value;
+    level.evaluate_gradients |= evaluate_gradient;
+    level.evaluate_hessians |= evaluate_hessian;
 #ifdef DEBUG_OUTPUT
-            std::cout << "evaluate face value: " << fe_number << " " << evaluate_values << " "
-                      << evaluate_value << std::endl;
-            std::cout << "evaluate face gradients: " << fe_number << " " << evaluate_gradients
-                      << " " << evaluate_gradient << std::endl;
-            std::cout << "evaluate face hessian: " << fe_number << " " << evaluate_hessians << " "
-                      << evaluate_hessian << std::endl;
+    std::cout << "evaluate face value: " << fe_number_extern << " " << level.evaluate_values
+              << " " << evaluate_value << std::endl;
+    std::cout << "evaluate face gradients: " << fe_number_extern << " "
+              << level.evaluate_gradients << " " << evaluate_gradient << std::endl;
+    std::cout << "evaluate face hessian: " << fe_number_extern << " " << level.evaluate_hessians
+              << " " << evaluate_hessian << std::endl;
 #endif
-          }
-        else
-        {
-          Base::template set_evaluation_flags_face<fe_number_extern>(
-            evaluate_value, evaluate_gradient, evaluate_hessian);
-        }
-      }
-    else
-    {
-      static_assert(CFL::Traits::is_fe_data_face<FEData>::value, "Must be face object!");
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      evaluate_values |= evaluate_value;
-      evaluate_gradients |= evaluate_gradient;
-      evaluate_hessians |= evaluate_hessian;
-#ifdef DEBUG_OUTPUT
-      std::cout << "evaluate face value: " << fe_number << " " << evaluate_values << " "
-                << evaluate_value << std::endl;
-      std::cout << "evaluate face gradients: " << fe_number << " " << evaluate_gradients << " "
-                << evaluate_gradient << std::endl;
-      std::cout << "evaluate face hessian: " << fe_number << " " << evaluate_hessians << " "
-                << evaluate_hessian << std::endl;
-#endif
-    }
   }
 
+  /**
+   * The number of quadrature points of the cell FEData object with number
+   * <code>fe_number_extern</code>. In contrast to get_n_q_points() this
+   * respects the quadrature of each FEData object.
+   */
+  template <unsigned int fe_number_extern>
+  static constexpr unsigned int
+  get_n_q_points_of()
+  {
+    using Level = LevelOf<fe_number_extern, internal::FEDataKind::cell>;
+    return Level::FEEvaluationType::static_n_q_points;
+  }
+
+  /**
+   * Same as get_n_q_points_of() for FEDataFace objects.
+   */
+  template <unsigned int fe_number_extern>
+  static constexpr unsigned int
+  get_n_q_points_face_of()
+  {
+    using Level = LevelOf<fe_number_extern, internal::FEDataKind::face>;
+    return Level::FEEvaluationType::static_n_q_points;
+  }
+
+  /**
+   * The index of the quadrature of the cell FEData object with number
+   * <code>fe_number_extern</code>.
+   */
+  template <unsigned int fe_number_extern>
+  static constexpr unsigned int
+  get_quad_number_of()
+  {
+    using Level = LevelOf<fe_number_extern, internal::FEDataKind::cell>;
+    return Level::FEDataType::quad_number;
+  }
+
+  /**
+   * Same as get_quad_number_of() for FEDataFace objects.
+   */
+  template <unsigned int fe_number_extern>
+  static constexpr unsigned int
+  get_quad_number_face_of()
+  {
+    using Level = LevelOf<fe_number_extern, internal::FEDataKind::face>;
+    return Level::FEDataType::quad_number;
+  }
+
+  /**
+   * The number of quadrature points of the first cell FEData object.
+   */
   template <unsigned int fe_number_extern = fe_number>
   static constexpr unsigned int
   get_n_q_points()
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(CFL::Traits::is_fe_data<FEData>::value
-                    /*&& fe_number_extern == fe_number*/) return FEData::FEEvaluationType::
-            static_n_q_points;
-        else
-          return Base::template get_n_q_points<fe_number_extern>();
-      }
-    else
-    {
-      static_assert(CFL::Traits::is_fe_data<FEData>::value, "Component not found!");
-      // static_assert(fe_number_extern == fe_number, "Component not found!");
-      return FEData::FEEvaluationType::static_n_q_points;
-    }
+    constexpr std::size_t i =
+      internal::find_fe_data<internal::FEDataKind::cell, FEData, Types...>(0, true);
+    static_assert(i <= sizeof...(Types), "Component not found!");
+    constexpr std::array<unsigned int, sizeof...(Types) + 1> fe_numbers{
+      { fe_number, Types::fe_number... }
+    };
+    using Level = LevelOf<fe_numbers[i], internal::FEDataKind::cell>;
+    return Level::FEEvaluationType::static_n_q_points;
   }
 
   template <unsigned int fe_number_extern = fe_number>
   static constexpr unsigned int
   get_n_q_points_face()
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(CFL::Traits::is_fe_data_face<FEData>::value &&
-                    fe_number_extern ==
-                      fe_number) return FEData::FEEvaluationType::static_n_q_points;
-        else
-          return Base::template get_n_q_points_face<fe_number_extern>();
-      }
-    else
-    {
-      static_assert(CFL::Traits::is_fe_data_face<FEData>::value, "Component not found!");
-      static_assert(fe_number_extern == fe_number, "Component not found!");
-      return FEData::FEEvaluationType::static_n_q_points;
-    }
+    return get_n_q_points_face_of<fe_number_extern>();
   }
 
   template <unsigned int fe_number_extern>
   auto
   get_gradient(unsigned int q) const
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "get gradient FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            return fe_data.fe_evaluation->get_gradient(q);
-          }
-        else
-          return Base::template get_gradient<fe_number_extern>(q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "get gradient FEDatas " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return fe_data.fe_evaluation->get_gradient(q);
-    }
+    const auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::get_gradient, fe_number_extern, q);
+    return level.fe_data.fe_evaluation->get_gradient(q);
   }
 
   template <unsigned int fe_number_extern, bool interior>
   auto
   get_normal_derivative(unsigned int q) const
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data_face<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "get normal gradient FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            if constexpr(interior) return fe_data.fe_evaluation_interior->get_normal_derivative(q);
-            else
-              return -(fe_data.fe_evaluation_exterior->get_normal_derivative(q));
-          }
-        else
-          return Base::template get_normal_derivative<fe_number_extern, interior>(q);
-      }
+    const auto& level = find_level<fe_number_extern, internal::FEDataKind::face>();
+    CFL_TRACE_EVENT(
+      Trace::Phase::get_normal_derivative, fe_number_extern, q, Trace::flags(interior));
+    if constexpr(interior) return level.fe_data.fe_evaluation_interior->get_normal_derivative(q);
     else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "get normal gradient FEDatas " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      if constexpr(interior) return fe_data.fe_evaluation_interior->get_normal_derivative(q);
-      else
-        return -(fe_data.fe_evaluation_exterior->get_normal_derivative(q));
-    }
+      return -(level.fe_data.fe_evaluation_exterior->get_normal_derivative(q));
   }
 
   template <unsigned int fe_number_extern>
   auto
   get_symmetric_gradient(unsigned int q) const
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "get symmetric gradient FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            return fe_data.fe_evaluation->get_symmetric_gradient(q);
-          }
-        else
-          return Base::template get_symmetric_gradient<fe_number_extern>(q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "get symmetric gradient FEDatas " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return fe_data.fe_evaluation->get_symmetric_gradient(q);
-    }
+    const auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::get_symmetric_gradient, fe_number_extern, q);
+    return level.fe_data.fe_evaluation->get_symmetric_gradient(q);
   }
 
   template <unsigned int fe_number_extern>
   auto
   get_divergence(unsigned int q) const
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "get divergence FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            return fe_data.fe_evaluation->get_divergence(q);
-          }
-        else
-          return Base::template get_divergence<fe_number_extern>(q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "get divergence FEDatas " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return fe_data.fe_evaluation->get_divergence(q);
-    }
+    const auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::get_divergence, fe_number_extern, q);
+    return level.fe_data.fe_evaluation->get_divergence(q);
   }
 
   template <unsigned int fe_number_extern>
   auto
   get_laplacian(unsigned int q) const
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "get laplacian FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            return fe_data.fe_evaluation->get_laplacian(q);
-          }
-        else
-          return Base::template get_laplacian<fe_number_extern>(q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "get laplacian FEDatas " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return fe_data.fe_evaluation->get_laplacian(q);
-    }
+    const auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::get_laplacian, fe_number_extern, q);
+    return level.fe_data.fe_evaluation->get_laplacian(q);
   }
 
   template <unsigned int fe_number_extern>
   auto
   get_hessian_diagonal(unsigned int q) const
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "get hessian_diagonal FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            return fe_data.fe_evaluation->get_hessian_diagonal(q);
-          }
-        else
-          return Base::template get_hessian_diagonal<fe_number_extern>(q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "get hessian_diagonal FEDatas " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return fe_data.fe_evaluation->get_hessian_diagonal(q);
-    }
+    const auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::get_hessian_diagonal, fe_number_extern, q);
+    return level.fe_data.fe_evaluation->get_hessian_diagonal(q);
   }
 
   template <unsigned int fe_number_extern>
   auto
   get_hessian(unsigned int q) const
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "get hessian FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            return fe_data.fe_evaluation->get_hessian(q);
-          }
-        else
-          return Base::template get_hessian<fe_number_extern>(q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "get hessian FEDatas " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return fe_data.fe_evaluation->get_hessian(q);
-    }
+    const auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::get_hessian, fe_number_extern, q);
+    return level.fe_data.fe_evaluation->get_hessian(q);
   }
 
   template <unsigned int fe_number_extern>
   auto
   get_value(unsigned int q) const
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "get value FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            return fe_data.fe_evaluation->get_value(q);
-          }
-        else
-          return Base::template get_value<fe_number_extern>(q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "get value FEDatas " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(CFL::Traits::is_fe_data<FEData>::value,
-                    "This function can only be called for FEData objects!");
-      Assert(fe_data.evaluation_is_initialized(), ::dealii::ExcInternalError());
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      Assert(fe_data.evaluation_is_initialized(), ::dealii::ExcInternalError());
-      return fe_data.fe_evaluation->get_value(q);
-    }
+    const auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::get_value, fe_number_extern, q);
+    Assert(level.fe_data.evaluation_is_initialized(), ::dealii::ExcInternalError());
+    return level.fe_data.fe_evaluation->get_value(q);
   }
 
   template <unsigned int fe_number_extern, bool interior>
   auto
   get_face_value(unsigned int q) const
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data_face<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "get face value FEDatas " << fe_number << " " << q << " " << interior
-                      << ": ";
-
-#endif
-            if constexpr(interior)
-              {
-                const auto value = fe_data.fe_evaluation_interior->get_value(q);
-#ifdef DEBUG_OUTPUT
-                std::cout << value[0] << " " << value[1] << std::endl;
-#endif
-                return value;
-              }
-            else
-            {
-              const auto value = fe_data.fe_evaluation_exterior->get_value(q);
-#ifdef DEBUG_OUTPUT
-              std::cout << value[0] << " " << value[1] << std::endl;
-#endif
-              return value;
-            }
-          }
-        else
-          return Base::template get_face_value<fe_number_extern, interior>(q);
-      }
+    const auto& level = find_level<fe_number_extern, internal::FEDataKind::face>();
+    CFL_TRACE_EVENT(Trace::Phase::get_face_value, fe_number_extern, q, Trace::flags(interior));
+    if constexpr(interior) return level.fe_data.fe_evaluation_interior->get_value(q);
     else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "get face value FEDatas " << fe_number << " " << q << " " << interior << ": ";
-#endif
-      static_assert(CFL::Traits::is_fe_data_face<FEData>::value,
-                    "This function can only be called for FEDataFace objects!");
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      if constexpr(interior)
-        {
-          const auto value = fe_data.fe_evaluation_interior->get_value(q);
-#ifdef DEBUG_OUTPUT
-          std::cout << value[0] << " " << value[1] << std::endl;
-#endif
-          return value;
-        }
-      else
-      {
-        const auto value = fe_data.fe_evaluation_exterior->get_value(q);
-#ifdef DEBUG_OUTPUT
-        std::cout << value[0] << " " << value[1] << std::endl;
-#endif
-        return value;
-      }
-    }
+      return level.fe_data.fe_evaluation_exterior->get_value(q);
   }
 
   template <unsigned int fe_number_extern, typename ValueType>
   void
   submit_curl(const ValueType& value, unsigned int q)
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "submit curl FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            fe_data.fe_evaluation->submit_curl(value, q);
-          }
-        else
-          Base::template submit_curl<fe_number_extern, ValueType>(value, q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "submit curl FEDatas " << fe_number << " " << q << std::endl;
-      for (unsigned int i = 0; i < 2; ++i)
-        std::cout << " " << value[i][0];
-      std::cout << std::endl;
-#endif
-      static_assert(CFL::Traits::is_fe_data<FEData>::value,
-                    "This function can only be called for FEData objects!");
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      fe_data.fe_evaluation->submit_curl(value, q);
-    }
+    auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::submit_curl, fe_number_extern, q);
+    level.fe_data.fe_evaluation->submit_curl(value, q);
   }
 
   template <unsigned int fe_number_extern, typename ValueType>
   void
   submit_divergence(const ValueType& value, unsigned int q)
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "submit divergence FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            fe_data.fe_evaluation->submit_divergence(value, q);
-          }
-        else
-          Base::template submit_divergence<fe_number_extern, ValueType>(value, q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "submit divergence FEDatas " << fe_number << " " << q << std::endl;
-      for (unsigned int i = 0; i < 2; ++i)
-        std::cout << " " << value[i][0];
-      std::cout << std::endl;
-#endif
-      static_assert(CFL::Traits::is_fe_data<FEData>::value,
-                    "This function can only be called for FEData objects!");
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      fe_data.fe_evaluation->submit_divergence(value, q);
-    }
+    auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::submit_divergence, fe_number_extern, q);
+    level.fe_data.fe_evaluation->submit_divergence(value, q);
   }
 
   template <unsigned int fe_number_extern, typename ValueType>
   void
   submit_symmetric_gradient(const ValueType& value, unsigned int q)
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "submit symmetric gradient FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            fe_data.fe_evaluation->submit_symmetric_gradient(value, q);
-          }
-        else
-          Base::template submit_symmetric_gradient<fe_number_extern, ValueType>(value, q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "submit symmetric gradient FEDatas " << fe_number << " " << q << std::endl;
-      for (unsigned int i = 0; i < 2; ++i)
-        std::cout << " " << value[i][0];
-      std::cout << std::endl;
-#endif
-      static_assert(CFL::Traits::is_fe_data<FEData>::value,
-                    "This function can only be called for FEData objects!");
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      fe_data.fe_evaluation->submit_symmetric_gradient(value, q);
-    }
+    auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::submit_symmetric_gradient, fe_number_extern, q);
+    level.fe_data.fe_evaluation->submit_symmetric_gradient(value, q);
   }
 
   template <unsigned int fe_number_extern, typename ValueType>
   void
   submit_gradient(const ValueType& value, unsigned int q)
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "submit gradient FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            fe_data.fe_evaluation->submit_gradient(value, q);
-          }
-        else
-          Base::template submit_gradient<fe_number_extern, ValueType>(value, q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "submit gradient FEDatas " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(CFL::Traits::is_fe_data<FEData>::value,
-                    "This function can only be called for FEData objects!");
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      fe_data.fe_evaluation->submit_gradient(value, q);
-    }
+    auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::submit_gradient, fe_number_extern, q);
+    level.fe_data.fe_evaluation->submit_gradient(value, q);
   }
 
   template <unsigned int fe_number_extern, typename ValueType>
   void
   submit_value(const ValueType& value, unsigned int q)
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "submit value FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            fe_data.fe_evaluation->submit_value(value, q);
-          }
-        else
-          Base::template submit_value<fe_number_extern, ValueType>(value, q);
-      }
-    else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "submit value FEDatas " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(CFL::Traits::is_fe_data<FEData>::value,
-                    "This function can only be called for FEData objects!");
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      fe_data.fe_evaluation->submit_value(value, q);
-    }
+    auto& level = find_level<fe_number_extern, internal::FEDataKind::cell>();
+    CFL_TRACE_EVENT(Trace::Phase::submit_value, fe_number_extern, q);
+    level.fe_data.fe_evaluation->submit_value(value, q);
   }
 
   template <unsigned int fe_number_extern, bool interior, typename ValueType>
   void
   submit_face_value(const ValueType& value, unsigned int q)
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data_face<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "submit face value FEDatas " << fe_number << " " << q << std::endl;
-#endif
-            if constexpr(interior) fe_data.fe_evaluation_interior->submit_value(value, q);
-            else
-              fe_data.fe_evaluation_exterior->submit_value(value, q);
-          }
-        else
-          Base::template submit_face_value<fe_number_extern, interior, ValueType>(value, q);
-      }
+    auto& level = find_level<fe_number_extern, internal::FEDataKind::face>();
+    CFL_TRACE_EVENT(Trace::Phase::submit_face_value, fe_number_extern, q, Trace::flags(interior));
+    if constexpr(interior) level.fe_data.fe_evaluation_interior->submit_value(value, q);
     else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "submit face value FEDatas " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(CFL::Traits::is_fe_data_face<FEData>::value,
-                    "This function can only be called for FEDataFace objects!");
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      if constexpr(interior) fe_data.fe_evaluation_interior->submit_value(value, q);
-      else
-        fe_data.fe_evaluation_exterior->submit_value(value, q);
-    }
+      level.fe_data.fe_evaluation_exterior->submit_value(value, q);
   }
 
   template <unsigned int fe_number_extern, bool interior, typename ValueType>
   void
   submit_normal_derivative(const ValueType& value, unsigned int q)
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern && CFL::Traits::is_fe_data_face<FEData>::value)
-          {
-#ifdef DEBUG_OUTPUT
-            std::cout << "submit normal gradient " << fe_number << " " << q << std::endl;
-#endif
-            if constexpr(interior) fe_data.fe_evaluation_interior->submit_normal_derivative(value, q);
-            else
-              fe_data.fe_evaluation_exterior->submit_normal_derivative(-value, q);
-          }
-        else
-          Base::template submit_normal_derivative<fe_number_extern, interior, ValueType>(value, q);
-      }
+    auto& level = find_level<fe_number_extern, internal::FEDataKind::face>();
+    CFL_TRACE_EVENT(
+      Trace::Phase::submit_normal_derivative, fe_number_extern, q, Trace::flags(interior));
+    if constexpr(interior) level.fe_data.fe_evaluation_interior->submit_normal_derivative(value, q);
     else
-    {
-#ifdef DEBUG_OUTPUT
-      std::cout << "submit normal gradient " << fe_number << " " << q << std::endl;
-#endif
-      static_assert(CFL::Traits::is_fe_data_face<FEData>::value,
-                    "This function can only be called for FEDataFace objects!");
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      if constexpr(interior) fe_data.fe_evaluation_interior->submit_normal_derivative(value, q);
-      else
-        fe_data.fe_evaluation_exterior->submit_normal_derivative(-value, q);
-    }
+      level.fe_data.fe_evaluation_exterior->submit_normal_derivative(-value, q);
   }
 
   template <unsigned int fe_number_extern>
   const auto&
   get_fe_data() const
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern) return fe_data;
-        else
-          return Base::template get_fe_data<fe_number_extern>();
-      }
-    else
-    {
-      static_assert(CFL::Traits::is_fe_data<FEData>::value,
-                    "Component not found, not a FEData object!");
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return fe_data;
-    }
+    return find_level<fe_number_extern, internal::FEDataKind::any>().fe_data;
   }
 
   template <unsigned int fe_number_extern>
   const auto&
   get_fe_data_face() const
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number == fe_number_extern &&
-                    CFL::Traits::is_fe_data_face<FEData>::value) return fe_data;
-        else
-          return Base::template get_fe_data_face<fe_number_extern>();
-      }
-    else
-    {
-      static_assert(CFL::Traits::is_fe_data_face<FEData>::value,
-                    "Component not found, not a FEDataFace object");
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return fe_data;
-    }
+    return find_level<fe_number_extern, internal::FEDataKind::face>().fe_data;
   }
 
   auto
@@ -1373,52 +1029,24 @@ public:
   unsigned int
   dofs_per_cell() const
   {
-    if (sizeof...(Types) != 0)
-    {
-      if constexpr(fe_number == fe_number_extern) return fe_data.fe_evaluation->dofs_per_cell;
-      else
-        return Base::template dofs_per_cell<fe_number_extern>();
-    }
-    else
-    {
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return fe_data.fe_evaluation->dofs_per_cell;
-    }
+    return find_level<fe_number_extern, internal::FEDataKind::cell>()
+      .fe_data.fe_evaluation->dofs_per_cell;
   }
 
   template <unsigned int fe_number_extern>
   static constexpr unsigned int
   tensor_dofs_per_cell()
   {
-    if constexpr(sizeof...(Types) != 0)
-      {
-        if constexpr(fe_number ==
-                    fe_number_extern) return FEData::FEEvaluationType::tensor_dofs_per_cell;
-        else
-          return Base::template tensor_dofs_per_cell<fe_number_extern>();
-      }
-    else
-    {
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return FEData::FEEvaluationType::tensor_dofs_per_cell;
-    }
+    using Level = LevelOf<fe_number_extern, internal::FEDataKind::cell>;
+    return Level::FEEvaluationType::tensor_dofs_per_cell;
   }
 
   template <unsigned int fe_number_extern>
   auto
   begin_dof_values() const
   {
-    if (sizeof...(Types) != 0)
-    {
-      if constexpr(fe_number == fe_number_extern) return fe_data.fe_evaluation->begin_dof_values();
-      else
-        return Base::template begin_dof_values<fe_number_extern>();
-    }
-    else
-    {
-      static_assert(fe_number == fe_number_extern, "Component not found!");
-      return fe_data.fe_evaluation->begin_dof_values();
-    }
+    return find_level<fe_number_extern, internal::FEDataKind::cell>()
+      .fe_data.fe_evaluation->begin_dof_values();
   }
 
   template <class FEDataOther>
@@ -1458,25 +1086,66 @@ public:
 protected:
   FEData fe_data;
 
-  template <unsigned int fe_number_extern>
-  void
-  check_uniqueness()
+  /**
+   * The FEDatas object of this hierarchy holding the FEData object with
+   * number <code>fe_number_extern</code> of the given kind. Of each kind,
+   * there is at most one. This is resolved by overload resolution on
+   * get_level() instead of a recursion through the hierarchy.
+   */
+  template <unsigned int fe_number_extern, internal::FEDataKind kind>
+  auto&
+  find_level()
   {
-    static_assert(!CFL::Traits::is_fe_data<FEData>::value || fe_number != fe_number_extern,
-                  "The fe_numbers have to be unique!");
-    if constexpr(sizeof...(Types) != 0) Base::template check_uniqueness<fe_number_extern>();
+    using Tag = internal::FEDataTag<fe_number_extern, kind_of<fe_number_extern, kind>()>;
+    return this->get_level(Tag());
   }
 
-  template <unsigned int fe_number_extern>
-  void
-  check_uniqueness_face()
+  template <unsigned int fe_number_extern, internal::FEDataKind kind>
+  const auto&
+  find_level() const
   {
-    static_assert(!CFL::Traits::is_fe_data_face<FEData>::value || fe_number != fe_number_extern,
-                  "The fe_numbers have to be unique!");
+    using Tag = internal::FEDataTag<fe_number_extern, kind_of<fe_number_extern, kind>()>;
+    return this->get_level(Tag());
+  }
 
-    if constexpr(sizeof...(Types) != 0) Base::template check_uniqueness_face<fe_number_extern>();
+  /**
+   * The kind of the FEData object with number <code>fe_number_extern</code>,
+   * the first one of both if <code>kind</code> is FEDataKind::any.
+   */
+  template <unsigned int fe_number_extern, internal::FEDataKind kind>
+  static constexpr internal::FEDataKind
+  kind_of()
+  {
+    constexpr std::size_t i = internal::find_fe_data<kind, FEData, Types...>(fe_number_extern);
+    static_assert(i <= sizeof...(Types), "Component not found!");
+    constexpr std::array<internal::FEDataKind, sizeof...(Types) + 1> kinds{
+      { fe_data_kind, internal::kind_of<Types>()... }
+    };
+    return i <= sizeof...(Types) ? kinds[i] : kind;
   }
 
+  /// The type returned by find_level()
+  template <unsigned int fe_number_extern, internal::FEDataKind kind>
+  using LevelOf = std::remove_reference_t<
+    decltype(std::declval<FEDatas&>().template find_level<fe_number_extern, kind>())>;
+
+  using Base::get_level;
+
+  FEDatas&
+  get_level(internal::FEDataTag<fe_number, fe_data_kind> /*unused*/)
+  {
+    return *this;
+  }
+
+  const FEDatas&
+  get_level(internal::FEDataTag<fe_number, fe_data_kind> /*unused*/) const
+  {
+    return *this;
+  }
+
+  template <typename... OtherTypes>
+  friend class FEDatas;
+
 private:
   bool integrate_values = false;
   bool integrate_values_exterior = false;
@@ -7,7 +7,10 @@
 #include <cfl/base/fefunctions.h>
 #include <cfl/base/forms.h>
 #include <cfl/base/traits.h>
+#include <cfl/matrixfree/trace.h>
 
+#include <algorithm>
+#include <type_traits>
 #include <utility>
 
 #define AssertIndexInRange(index, range)                                                           \
@@ -242,6 +245,20 @@ namespace dealii
       }
     };
 
+    /**
+     * The data a face integral needs from the cells adjacent to a face.
+     * The enumerators are ordered such that a sum or product of terms needs
+     * the maximum of what its factors need. This is translated into
+     * ::dealii::MatrixFree::DataAccessOnFaces by the integrator in order to
+     * exchange only the required part of the ghost data.
+     */
+    enum class FaceDataAccess : unsigned int
+    {
+      none = 0,
+      values = 1,
+      gradients = 2
+    };
+
     /**
      * Top level base class for Test Functions, should never be constructed
      * Defined for safety reasons
@@ -309,6 +326,7 @@ namespace dealii
     public:
       using Base = TestFunctionFaceBase<TestFunctionInteriorFace<rank, dim, idx>>;
       static constexpr const IntegrationFlags integration_flags{ true, false, false, false };
+      static constexpr FaceDataAccess face_data_access = FaceDataAccess::values;
 
       /**
        * Wrapper around submit_face_value function of FEEvaluation
@@ -324,9 +342,7 @@ namespace dealii
                       "and the TestFunction is vector valued or "
                       "the TestFunction is scalar valued and "
                       "the FiniteElement is vector valued!");
-#ifdef DEBUG_OUTPUT
-        std::cout << "submit TestFunctionInteriorFace " << Base::index << " " << q << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::test_function_interior_face, Base::index, q);
         phi.template submit_face_value<Base::index, true>(value, q);
       }
     };
@@ -343,6 +359,7 @@ namespace dealii
     public:
       using Base = TestFunctionFaceBase<TestFunctionExteriorFace<rank, dim, idx>>;
       static constexpr IntegrationFlags integration_flags{ false, true, false, false };
+      static constexpr FaceDataAccess face_data_access = FaceDataAccess::values;
 
       /**
        * Wrapper around submit_face_value function of FEEvaluation
@@ -358,9 +375,7 @@ namespace dealii
                       "and the TestFunction is vector valued or "
                       "the TestFunction is scalar valued and "
                       "the FiniteElement is vector valued!");
-#ifdef DEBUG_OUTPUT
-        std::cout << "submit TestFunctionExteriorFace " << Base::index << " " << q << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::test_function_exterior_face, Base::index, q);
         phi.template submit_face_value<Base::index, false>(value, q);
       }
     };
@@ -377,6 +392,7 @@ namespace dealii
     public:
       using Base = TestFunctionFaceBase<TestNormalGradientInteriorFace<rank, dim, idx>>;
       static constexpr IntegrationFlags integration_flags{ false, false, true, false };
+      static constexpr FaceDataAccess face_data_access = FaceDataAccess::gradients;
 
       /**
        * Wrapper around submit_normal_derivative function of FEEvaluation
@@ -392,10 +408,7 @@ namespace dealii
                       "and the TestFunction is vector valued or "
                       "the TestFunction is scalar valued and "
                       "the FiniteElement is vector valued!");
-#ifdef DEBUG_OUTPUT
-        std::cout << "submit TestNormalGradientInteriorFace " << Base::index << " " << q
-                  << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::test_normal_gradient_interior_face, Base::index, q);
         phi.template submit_normal_derivative<Base::index, true>(value, q);
       }
     };
@@ -412,6 +425,7 @@ namespace dealii
     public:
       using Base = TestFunctionFaceBase<TestNormalGradientExteriorFace<rank, dim, idx>>;
       static constexpr IntegrationFlags integration_flags{ false, false, false, true };
+      static constexpr FaceDataAccess face_data_access = FaceDataAccess::gradients;
 
       /**
        * Wrapper around submit_normal_derivative function of FEEvaluation
@@ -427,10 +441,7 @@ namespace dealii
                       "and the TestFunction is vector valued or "
                       "the TestFunction is scalar valued and "
                       "the FiniteElement is vector valued!");
-#ifdef DEBUG_OUTPUT
-        std::cout << "submit TestNormalGradientExteriorFace " << Base::index << " " << q
-                  << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::test_normal_gradient_exterior_face, Base::index, q);
         phi.template submit_normal_derivative<Base::index, false>(value, q);
       }
     };
@@ -460,9 +471,7 @@ namespace dealii
                       "and the TestFunction is vector valued or "
                       "the TestFunction is scalar valued and "
                       "the FiniteElement is vector valued!");
-#ifdef DEBUG_OUTPUT
-        std::cout << "submit TestFunction " << Base::index << " " << q << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::test_function, Base::index, q);
         phi.template submit_value<Base::index>(value, q);
       }
     };
@@ -490,9 +499,7 @@ namespace dealii
         static_assert(FEEvaluation::template rank<Base::index>() > 0,
                       "The proposed FiniteElement has to be "
                       "vector valued for using TestDivergence!");
-#ifdef DEBUG_OUTPUT
-        std::cout << "submit TestDivergence " << Base::index << " " << q << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::test_divergence, Base::index, q);
         phi.template submit_divergence<Base::index>(value, q);
       }
     };
@@ -523,9 +530,7 @@ namespace dealii
                       "and the TestGradient is vector valued or "
                       "the TestGradient is scalar valued and "
                       "the FiniteElement is vector valued!");
-#ifdef DEBUG_OUTPUT
-        std::cout << "submit TestSymmetricGradient " << Base::index << " " << q << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::test_symmetric_gradient, Base::index, q);
         phi.template submit_symmetric_gradient<Base::index>(value, q);
       }
     };
@@ -556,9 +561,7 @@ namespace dealii
                       "and the TestCurl is vector valued or "
                       "the TestCurl is scalar valued and "
                       "the FiniteElement is vector valued!");
-#ifdef DEBUG_OUTPUT
-        std::cout << "submit TestCurl " << Base::index << " " << q << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::test_curl, Base::index, q);
         phi.template submit_curl<Base::index>(value, q);
       }
     };
@@ -589,9 +592,7 @@ namespace dealii
                       "and the TestGradient is vector valued or "
                       "the TestGradient is scalar valued and "
                       "the FiniteElement is vector valued!");
-#ifdef DEBUG_OUTPUT
-        std::cout << "submit TestGradient " << Base::index << " " << q << std::endl;
-#endif
+        CFL_TRACE_EVENT(Trace::Phase::test_gradient, Base::index, q);
         phi.template submit_gradient<Base::index>(value, q);
       }
     };
@@ -805,6 +806,7 @@ namespace dealii
       using Base = FEFunctionFaceBase<FEFunctionInteriorFace<rank, dim, idx>>;
       // inherit constructors
       using Base::Base;
+      static constexpr FaceDataAccess face_data_access = FaceDataAccess::values;
 
       template <class FEDatas>
       auto
@@ -846,6 +848,7 @@ namespace dealii
       using Base = FEFunctionFaceBase<FEFunctionExteriorFace<rank, dim, idx>>;
       // inherit constructors
       using Base::Base;
+      static constexpr FaceDataAccess face_data_access = FaceDataAccess::values;
 
       template <class FEDatas>
       auto
@@ -887,6 +890,7 @@ namespace dealii
       using Base = FEFunctionFaceBase<FENormalGradientInteriorFace<rank, dim, idx>>;
       // inherit constructors
       using Base::Base;
+      static constexpr FaceDataAccess face_data_access = FaceDataAccess::gradients;
 
       template <class FEDatas>
       auto
@@ -929,6 +933,7 @@ namespace dealii
       using Base = FEFunctionFaceBase<FENormalGradientExteriorFace<rank, dim, idx>>;
       // inherit constructors
       using Base::Base;
+      static constexpr FaceDataAccess face_data_access = FaceDataAccess::gradients;
 
       template <class FEDatas>
       auto
@@ -1467,6 +1472,49 @@ namespace dealii
     };
   } // namespace MatrixFree
 } // namespace dealii
+
+namespace Traits
+{
+  /**
+   * @brief The data a face term needs from the cells adjacent to the face
+   *
+   * Terminals that are evaluated on faces define a static member
+   * <code>face_data_access</code>, all other objects do not access
+   * any face data.
+   */
+  template <class T, typename Enable = void>
+  struct face_data_access
+  {
+    static constexpr dealii::MatrixFree::FaceDataAccess value =
+      dealii::MatrixFree::FaceDataAccess::none;
+  };
+
+  template <class T>
+  struct face_data_access<T, std::void_t<decltype(T::face_data_access)>>
+  {
+    static constexpr dealii::MatrixFree::FaceDataAccess value = T::face_data_access;
+  };
+
+  /**
+   * A sum needs the maximum of the data needed by its summands.
+   */
+  template <class... Types>
+  struct face_data_access<Base::SumFEFunctions<Types...>>
+  {
+    static constexpr dealii::MatrixFree::FaceDataAccess value =
+      std::max({ dealii::MatrixFree::FaceDataAccess::none, face_data_access<Types>::value... });
+  };
+
+  /**
+   * A product needs the maximum of the data needed by its factors.
+   */
+  template <class... Types>
+  struct face_data_access<Base::ProductFEFunctions<Types...>>
+  {
+    static constexpr dealii::MatrixFree::FaceDataAccess value =
+      std::max({ dealii::MatrixFree::FaceDataAccess::none, face_data_access<Types>::value... });
+  };
+} // namespace Traits
 } // namespace CFL
 
 #endif // CFL_DEALII_FEFUNCTIONS_H
@@ -0,0 +1,76 @@
+#ifndef cfl_dealii_matrixfree_form_profile_labels_h
+#define cfl_dealii_matrixfree_form_profile_labels_h
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cfl/base/forms.h>
+
+#include <cfl/latex/forms.h>
+
+#include <cfl/matrixfree/form_profiler.h>
+#include <cfl/matrixfree/forms.h>
+
+namespace CFL
+{
+namespace dealii::MatrixFree
+{
+  namespace internal
+  {
+    template <typename FormType, typename... Types>
+    void
+    latex_labels(const Base::Forms<FormType, Types...>& f,
+                 const std::vector<std::string>& function_names,
+                 const std::vector<std::string>& test_names, std::vector<std::string>& labels)
+    {
+      labels.push_back(Latex::transform(f.get_form()).print(function_names, test_names));
+      if constexpr(sizeof...(Types) != 0)
+        latex_labels(static_cast<const Base::Forms<Types...>&>(f), function_names, test_names,
+                     labels);
+    }
+
+    inline std::vector<std::string>
+    indexed_names(const std::string& symbol)
+    {
+      std::vector<std::string> names;
+      for (unsigned int i = 0; i < 16; ++i)
+        names.push_back(symbol + "_{" + std::to_string(i) + "}");
+      return names;
+    }
+  }
+
+  /**
+   * Time the Forms <code>f</code> separately in every
+   * <code>sample_interval</code>-th quadrature point, see FormProfile. Each
+   * Form is labelled with its LaTeX representation using the names of the
+   * FE functions and test functions given, or u_i and v_i for the FEData
+   * object with index i.
+   *
+   * The samples are only taken if the library is compiled with
+   * CFL_PROFILE_FORMS, otherwise the profile stays empty and Forms::evaluate()
+   * is not changed at all.
+   *
+   * <h3> Usage example </h3>
+   * <code>
+   *   const auto profile = profile_forms(form(u, v) + form(grad(u), grad(v)));
+   *   // ... apply the MatrixFreeIntegrator
+   *   profile->print(std::cout);
+   * </code>
+   */
+  template <typename... Types>
+  std::shared_ptr<FormProfile>
+  profile_forms(const Base::Forms<Types...>& f, unsigned int sample_interval = 1000,
+                const std::vector<std::string>& function_names = internal::indexed_names("u"),
+                const std::vector<std::string>& test_names = internal::indexed_names("v"))
+  {
+    std::vector<std::string> labels;
+    internal::latex_labels(f, function_names, test_names, labels);
+    auto profile = std::make_shared<FormProfile>(labels, sample_interval);
+    internal::form_profile<decltype(transform(f))>() = profile;
+    return profile;
+  }
+}
+} // namespace CFL
+
+#endif
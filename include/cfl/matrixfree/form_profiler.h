@@ -0,0 +1,197 @@
+#ifndef DEALII_MATRIXFREE_FORM_PROFILER_H
+#define DEALII_MATRIXFREE_FORM_PROFILER_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CFL::dealii::MatrixFree
+{
+/**
+ * @brief The time spent in the terms of one Forms object
+ *
+ * If the library is compiled with CFL_PROFILE_FORMS, Forms::evaluate(),
+ * Forms::evaluate_face() and Forms::evaluate_boundary() time the value()
+ * and the submit() of each Form separately in every
+ * <code>sample_interval</code>-th call, see profile_forms() in
+ * form_profile_labels.h. The other calls are not timed, such that the
+ * overhead stays small. Since a single Form takes only a few nanoseconds in
+ * one quadrature point, the overhead of reading the clock, measured when the
+ * profile is created, is subtracted from every sample.
+ */
+class FormProfile
+{
+public:
+  enum class Part
+  {
+    value,
+    submit
+  };
+
+  FormProfile(std::vector<std::string> labels, unsigned int sample_interval)
+    : labels(std::move(labels))
+    , sample_interval(std::max(sample_interval, 1u))
+    , clock_overhead(measure_clock_overhead())
+    , seconds(this->labels.size(), { 0., 0. })
+    , n_samples(this->labels.size(), 0)
+  {
+  }
+
+  /**
+   * Call <code>f</code> and add the time it took to the <code>part</code>
+   * of the Form <code>form</code>. Returns the result of <code>f</code>.
+   */
+  template <typename F>
+  decltype(auto)
+  measure(std::size_t form, Part part, F&& f)
+  {
+    const auto start = Clock::now();
+    if constexpr(std::is_void_v<decltype(f())>)
+      {
+        f();
+        add(form, part, Clock::now() - start);
+      }
+    else
+    {
+      auto result = f();
+      add(form, part, Clock::now() - start);
+      return result;
+    }
+  }
+
+  /**
+   * Print one line per Form, sorted by the time per quadrature point, with
+   * the share of the time of all Forms, the time per quadrature point for
+   * value() and submit() in nanoseconds, the number of samples and the
+   * label of the Form.
+   */
+  void
+  print(std::ostream& out) const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::size_t> order(labels.size());
+    double total = 0.;
+    for (std::size_t i = 0; i < labels.size(); ++i)
+    {
+      order[i] = i;
+      total += average(i, Part::value) + average(i, Part::submit);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+      return average(a, Part::value) + average(a, Part::submit) >
+             average(b, Part::value) + average(b, Part::submit);
+    });
+
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << "  share   value/ns  submit/ns   samples  form" << std::endl;
+    for (const std::size_t i : order)
+    {
+      const double time = average(i, Part::value) + average(i, Part::submit);
+      out << std::fixed << std::setprecision(1) << std::setw(6)
+          << (total > 0. ? 100. * time / total : 0.) << "% " << std::setw(10)
+          << 1e9 * average(i, Part::value) << " " << std::setw(10)
+          << 1e9 * average(i, Part::submit) << " " << std::setw(9) << n_samples[i] << "  "
+          << labels[i] << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+  }
+
+  /// Discard all samples taken so far
+  void
+  reset()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::fill(seconds.begin(), seconds.end(), std::array<double, 2>{ 0., 0. });
+    std::fill(n_samples.begin(), n_samples.end(), 0);
+  }
+
+  /// The average time in seconds of one call of <code>part</code> of a Form
+  double
+  average(std::size_t form, Part part) const
+  {
+    return n_samples[form] == 0
+      ? 0.
+      : seconds[form][static_cast<unsigned int>(part)] / n_samples[form];
+  }
+
+  const std::vector<std::string> labels;
+  const unsigned int sample_interval;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  static double
+  measure_clock_overhead()
+  {
+    double overhead = 1.;
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+      const auto start = Clock::now();
+      overhead = std::min(overhead, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return overhead;
+  }
+
+  void
+  add(std::size_t form, Part part, Clock::duration duration)
+  {
+    const double time =
+      std::max(std::chrono::duration<double>(duration).count() - clock_overhead, 0.);
+    std::lock_guard<std::mutex> lock(mutex);
+    seconds[form][static_cast<unsigned int>(part)] += time;
+    // submit() follows value(), count every quadrature point once
+    if (part == Part::value)
+      ++n_samples[form];
+  }
+
+  const double clock_overhead;
+  mutable std::mutex mutex;
+  std::vector<std::array<double, 2>> seconds;
+  std::vector<unsigned long long> n_samples;
+};
+
+namespace internal
+{
+  /**
+   * The profile of the Forms type <code>FormsType</code>, nullptr if it is
+   * not profiled.
+   */
+  template <class FormsType>
+  std::shared_ptr<FormProfile>&
+  form_profile()
+  {
+    static std::shared_ptr<FormProfile> profile;
+    return profile;
+  }
+
+  /**
+   * The profile of <code>FormsType</code> if the current call is sampled,
+   * otherwise nullptr. Each thread counts its calls separately.
+   */
+  template <class FormsType>
+  FormProfile*
+  sample_form_profile()
+  {
+    FormProfile* profile = form_profile<FormsType>().get();
+    if (profile == nullptr)
+      return nullptr;
+    thread_local unsigned int n_calls = 0;
+    if (++n_calls < profile->sample_interval)
+      return nullptr;
+    n_calls = 0;
+    return profile;
+  }
+} // namespace internal
+} // namespace CFL::dealii::MatrixFree
+
+#endif // DEALII_MATRIXFREE_FORM_PROFILER_H
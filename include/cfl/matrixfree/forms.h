@@ -1,19 +1,20 @@
 #ifndef cfl_dealii_matrixfree_forms_h
 #define cfl_dealii_matrixfree_forms_h
 
+#include <algorithm>
 #include <array>
 #include <iostream>
 #include <string>
 #include <utility>
 
-#include <tuple>
-
 #include <deal.II/base/exceptions.h>
 
 #include <cfl/base/forms.h>
 #include <cfl/base/traits.h>
 
 #include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/form_profiler.h>
+#include <cfl/matrixfree/trace.h>
 
 namespace CFL
 {
@@ -22,6 +23,53 @@ namespace dealii::MatrixFree
   template <typename... Types>
   class Forms;
 
+  namespace internal
+  {
+    /**
+     * The index of the quadrature of the cell or face FEData object with
+     * number <code>fe_number</code> in <code>FEDatas</code>.
+     */
+    template <class FEDatas, bool face, unsigned int fe_number>
+    constexpr unsigned int
+    quad_number_of()
+    {
+      if constexpr(face) return FEDatas::template get_quad_number_face_of<fe_number>();
+      else
+        return FEDatas::template get_quad_number_of<fe_number>();
+    }
+
+    /**
+     * Whether all FE functions in <code>Expr</code> are evaluated with the
+     * quadrature with index <code>quad_no</code>. Terminals have a static
+     * member <code>index</code>, the number of their FEData object, all
+     * other objects do not evaluate anything.
+     */
+    template <class FEDatas, bool face, unsigned int quad_no, class Expr,
+              typename Enable = void>
+    struct uses_quadrature
+    {
+      static constexpr bool value = true;
+    };
+
+    template <class FEDatas, bool face, unsigned int quad_no, class Expr>
+    struct uses_quadrature<FEDatas, face, quad_no, Expr, std::void_t<decltype(Expr::index)>>
+    {
+      static constexpr bool value = quad_number_of<FEDatas, face, Expr::index>() == quad_no;
+    };
+
+    template <class FEDatas, bool face, unsigned int quad_no, class... Types>
+    struct uses_quadrature<FEDatas, face, quad_no, Base::SumFEFunctions<Types...>>
+    {
+      static constexpr bool value = (uses_quadrature<FEDatas, face, quad_no, Types>::value && ...);
+    };
+
+    template <class FEDatas, bool face, unsigned int quad_no, class... Types>
+    struct uses_quadrature<FEDatas, face, quad_no, Base::ProductFEFunctions<Types...>>
+    {
+      static constexpr bool value = (uses_quadrature<FEDatas, face, quad_no, Types>::value && ...);
+    };
+  }
+
   /**
    * A Form is an expression tested by a test function set.
    */
@@ -43,6 +91,15 @@ namespace dealii::MatrixFree
     static constexpr bool integrate_gradient_exterior =
       (kind_of_form == FormKind::face) ? Test::integration_flags.gradient_exterior : false;
 
+    /// Face data written by the test function, only relevant for face forms
+    static constexpr FaceDataAccess dst_face_data_access = (kind_of_form == FormKind::face)
+      ? CFL::Traits::face_data_access<Test>::value
+      : FaceDataAccess::none;
+    /// Face data read by the FE functions, only relevant for face forms
+    static constexpr FaceDataAccess src_face_data_access = (kind_of_form == FormKind::face)
+      ? CFL::Traits::face_data_access<Expr>::value
+      : FaceDataAccess::none;
+
     template <class OtherTest, class OtherExpr>
     explicit constexpr Form(const Base::Form<OtherTest, OtherExpr, kind_of_form, NumberType> f)
       : test(transform(f.test))
@@ -116,12 +173,35 @@ namespace dealii::MatrixFree
             integrate_gradient_exterior);
     }
 
+    /**
+     * Whether all FE functions of the expression use the quadrature of the
+     * FEData object of the test function in <code>FEDatas</code>. The
+     * quadrature points of a Form are the ones of its test function, thus
+     * FE functions with other quadratures would be read at points they do
+     * not have.
+     */
+    template <class FEDatas>
+    static constexpr bool
+    uses_test_quadrature()
+    {
+      constexpr bool face = form_kind != FormKind::cell;
+      return internal::uses_quadrature<FEDatas,
+                                       face,
+                                       internal::quad_number_of<FEDatas, face, fe_number>(),
+                                       Expr>::value;
+    }
+
     template <class FEEvaluation>
     void
     set_evaluation_flags(FEEvaluation& phi) const
     {
       // only to be used if there is only one form!
-      if constexpr(form_kind == FormKind::cell) expr.set_evaluation_flags(phi);
+      if constexpr(form_kind == FormKind::cell)
+        {
+          static_assert(uses_test_quadrature<FEEvaluation>(),
+                        "All FE functions of a Form must use the quadrature of its test function!");
+          expr.set_evaluation_flags(phi);
+        }
     }
 
     template <class FEEvaluation>
@@ -130,7 +210,11 @@ namespace dealii::MatrixFree
     {
       // only to be used if there is only one form!
       if constexpr(form_kind == FormKind::face || form_kind == FormKind::boundary)
+        {
+          static_assert(uses_test_quadrature<FEEvaluation>(),
+                        "All FE functions of a Form must use the quadrature of its test function!");
           expr.set_evaluation_flags(phi);
+        }
     }
 
     template <class FEEvaluation>
@@ -139,6 +223,8 @@ namespace dealii::MatrixFree
       if constexpr(form_kind == FormKind::cell)
         {
           // only to be used if there is only one form!
+          if (q >= FEEvaluation::template get_n_q_points_of<fe_number>())
+            return;
           const auto value = expr.value(phi, q);
           Test::submit(phi, q, value);
         }
@@ -150,6 +236,8 @@ namespace dealii::MatrixFree
       if constexpr(form_kind == FormKind::face)
         {
           // only to be used if there is only one form!
+          if (q >= FEEvaluation::template get_n_q_points_face_of<fe_number>())
+            return;
           const auto value = expr.value(phi, q);
           Test::submit(phi, q, value);
         }
@@ -162,6 +250,8 @@ namespace dealii::MatrixFree
       if constexpr(form_kind == FormKind::boundary)
         {
           // only to be used if there is only one form!
+          if (q >= FEEvaluation::template get_n_q_points_face_of<fe_number>())
+            return;
           const auto value = expr.value(phi, q);
           Test::submit(phi, q, value);
         }
@@ -182,24 +272,6 @@ namespace dealii::MatrixFree
     }
   };
 
-  namespace internal
-  {
-    // allow for appending an object to an std::array object.
-    template <typename T, std::size_t N, std::size_t... I>
-    constexpr std::array<T, N + 1>
-    append_aux(std::array<T, N> a, T t, std::index_sequence<I...>)
-    {
-      return std::array<T, N + 1>{ { a[I]..., t } };
-    }
-
-    template <typename T, std::size_t N>
-    constexpr std::array<T, N + 1>
-    append(std::array<T, N> a, T t)
-    {
-      return append_aux(a, t, std::make_index_sequence<N>());
-    }
-  }
-
   template <typename... Types>
   class Forms;
 
@@ -208,6 +280,8 @@ namespace dealii::MatrixFree
   {
   public:
     static constexpr unsigned int number = 0; // unused
+    static constexpr FaceDataAccess dst_face_data_access = FaceDataAccess::none;
+    static constexpr FaceDataAccess src_face_data_access = FaceDataAccess::none;
     explicit constexpr Forms(const Base::Forms<>&){};
   };
 
@@ -227,6 +301,12 @@ namespace dealii::MatrixFree
     static constexpr unsigned int fe_number = FormType::fe_number;
     static constexpr unsigned int number = sizeof...(Types) == 0 ? 0 : Forms<Types...>::number + 1;
 
+    /// The face data accessed by any of the face forms, see FaceDataAccess
+    static constexpr FaceDataAccess dst_face_data_access =
+      std::max(FormType::dst_face_data_access, Forms<Types...>::dst_face_data_access);
+    static constexpr FaceDataAccess src_face_data_access =
+      std::max(FormType::src_face_data_access, Forms<Types...>::src_face_data_access);
+
     template <class OtherType, class... OtherTypes,
               typename std::enable_if<sizeof...(OtherTypes) == sizeof...(Types)>::type* = nullptr>
     explicit constexpr Forms(const Base::Forms<OtherType, OtherTypes...>& f)
@@ -302,7 +382,7 @@ namespace dealii::MatrixFree
     void
     set_evaluation_flags(FEEvaluation& phi) const
     {
-      if constexpr(form_kind == FormKind::cell) form.expr.set_evaluation_flags(phi);
+      form.set_evaluation_flags(phi);
 
       if constexpr(sizeof...(Types) != 0) Forms<Types...>::set_evaluation_flags(phi);
     }
@@ -311,8 +391,7 @@ namespace dealii::MatrixFree
     void
     set_evaluation_flags_face(FEEvaluation& phi) const
     {
-      if constexpr(form_kind == FormKind::face || form_kind == FormKind::boundary)
-          form.expr.set_evaluation_flags(phi);
+      form.set_evaluation_flags_face(phi);
 
       if constexpr(sizeof...(Types) != 0) Forms<Types...>::set_evaluation_flags_face(phi);
     }
@@ -321,22 +400,25 @@ namespace dealii::MatrixFree
     void
     evaluate(FEEvaluation& phi, [[maybe_unused]] unsigned int q) const
     {
+#ifdef CFL_PROFILE_FORMS
+      if (FormProfile* profile = internal::sample_form_profile<Forms>())
+      {
+        evaluate_profiled<FormKind::cell>(phi, q, *profile, 0);
+        return;
+      }
+#endif
       if constexpr(form_kind == FormKind::cell)
         {
-#ifdef DEBUG_OUTPUT
-          std::cout << "expecting cell value from fe_number " << fe_number << std::endl;
-#endif
+          // Forms using a quadrature with fewer points are done already
+          if (q >= FEEvaluation::template get_n_q_points_of<fe_number>())
+          {
+            if constexpr(sizeof...(Types) != 0) Forms<Types...>::evaluate(phi, q);
+            return;
+          }
+          CFL_TRACE_EVENT(Trace::Phase::expect_value, fe_number);
           const auto value = form.value(phi, q);
-          if constexpr(sizeof...(Types) != 0)
-            {
-#ifdef DEBUG_OUTPUT
-              std::cout << "descending" << std::endl;
-#endif
-              Forms<Types...>::evaluate(phi, q);
-            }
-#ifdef DEBUG_OUTPUT
-          std::cout << "expecting cell submit from fe_number " << fe_number << std::endl;
-#endif
+          if constexpr(sizeof...(Types) != 0) Forms<Types...>::evaluate(phi, q);
+          CFL_TRACE_EVENT(Trace::Phase::expect_submit, fe_number);
           form.submit(phi, q, value);
         }
       else if constexpr(sizeof...(Types) != 0) Forms<Types...>::evaluate(phi, q);
@@ -346,22 +428,25 @@ namespace dealii::MatrixFree
     void
     evaluate_face(FEEvaluation& phi, unsigned int q) const
     {
+#ifdef CFL_PROFILE_FORMS
+      if (FormProfile* profile = internal::sample_form_profile<Forms>())
+      {
+        evaluate_profiled<FormKind::face>(phi, q, *profile, 0);
+        return;
+      }
+#endif
       if constexpr(form_kind == FormKind::face)
         {
-#ifdef DEBUG_OUTPUT
-          std::cout << "expecting face value from fe_number " << fe_number << std::endl;
-#endif
+          // Forms using a quadrature with fewer points are done already
+          if (q >= FEEvaluation::template get_n_q_points_face_of<fe_number>())
+          {
+            if constexpr(sizeof...(Types) != 0) Forms<Types...>::evaluate_face(phi, q);
+            return;
+          }
+          CFL_TRACE_EVENT(Trace::Phase::expect_value, fe_number);
           const auto value = form.value(phi, q);
-          if constexpr(sizeof...(Types) != 0)
-            {
-#ifdef DEBUG_OUTPUT
-              std::cout << "descending" << std::endl;
-#endif
-              Forms<Types...>::evaluate_face(phi, q);
-            }
-#ifdef DEBUG_OUTPUT
-          std::cout << "expecting face submit from fe_number " << fe_number << std::endl;
-#endif
+          if constexpr(sizeof...(Types) != 0) Forms<Types...>::evaluate_face(phi, q);
+          CFL_TRACE_EVENT(Trace::Phase::expect_submit, fe_number);
           form.submit(phi, q, value);
         }
       else if constexpr(sizeof...(Types) != 0) Forms<Types...>::evaluate_face(phi, q);
@@ -371,27 +456,63 @@ namespace dealii::MatrixFree
     void
     evaluate_boundary(FEEvaluation& phi, [[maybe_unused]] unsigned int q) const
     {
+#ifdef CFL_PROFILE_FORMS
+      if (FormProfile* profile = internal::sample_form_profile<Forms>())
+      {
+        evaluate_profiled<FormKind::boundary>(phi, q, *profile, 0);
+        return;
+      }
+#endif
       if constexpr(form_kind == FormKind::boundary)
         {
-#ifdef DEBUG_OUTPUT
-          std::cout << "expecting face value from fe_number " << fe_number << std::endl;
-#endif
+          // Forms using a quadrature with fewer points are done already
+          if (q >= FEEvaluation::template get_n_q_points_face_of<fe_number>())
+          {
+            if constexpr(sizeof...(Types) != 0) Forms<Types...>::evaluate_boundary(phi, q);
+            return;
+          }
+          CFL_TRACE_EVENT(Trace::Phase::expect_value, fe_number);
           const auto value = form.value(phi, q);
-          if constexpr(sizeof...(Types) != 0)
-            {
-#ifdef DEBUG_OUTPUT
-              std::cout << "descending" << std::endl;
-#endif
-              Forms<Types...>::evaluate_boundary(phi, q);
-            }
-#ifdef DEBUG_OUTPUT
-          std::cout << "expecting face submit from fe_number " << fe_number << std::endl;
-#endif
+          if constexpr(sizeof...(Types) != 0) Forms<Types...>::evaluate_boundary(phi, q);
+          CFL_TRACE_EVENT(Trace::Phase::expect_submit, fe_number);
           form.submit(phi, q, value);
         }
       else if constexpr(sizeof...(Types) != 0) Forms<Types...>::evaluate_boundary(phi, q);
     }
 
+#ifdef CFL_PROFILE_FORMS
+    /**
+     * evaluate(), evaluate_face() or evaluate_boundary() depending on
+     * <code>kind</code>, timing value() and submit() of each Form. The Form
+     * of this object has index <code>i</code> in the profile.
+     */
+    template <FormKind kind, class FEEvaluation>
+    void
+    evaluate_profiled(FEEvaluation& phi, unsigned int q, FormProfile& profile,
+                      std::size_t i) const
+    {
+      if constexpr(form_kind == kind)
+        {
+          unsigned int n_q_points = 0;
+          if constexpr(kind == FormKind::cell)
+              n_q_points = FEEvaluation::template get_n_q_points_of<fe_number>();
+          else
+            n_q_points = FEEvaluation::template get_n_q_points_face_of<fe_number>();
+          if (q < n_q_points)
+          {
+            const auto value =
+              profile.measure(i, FormProfile::Part::value, [&]() { return form.value(phi, q); });
+            if constexpr(sizeof...(Types) != 0)
+              Forms<Types...>::template evaluate_profiled<kind>(phi, q, profile, i + 1);
+            profile.measure(i, FormProfile::Part::submit, [&]() { form.submit(phi, q, value); });
+            return;
+          }
+        }
+      if constexpr(sizeof...(Types) != 0)
+        Forms<Types...>::template evaluate_profiled<kind>(phi, q, profile, i + 1);
+    }
+#endif
+
     template <class FEEvaluation>
     static void
     integrate(FEEvaluation& phi)
@@ -407,35 +528,22 @@ namespace dealii::MatrixFree
     }
 
   protected:
-    template <unsigned int size, typename IntegrationFlags>
+    /**
+     * Whether none of the remaining Forms submits the same information as
+     * this one. Since every Forms object checks its own Form against the
+     * following ones, all pairs are covered without recursing over the
+     * remaining Forms.
+     */
     static constexpr bool
-    check_forms(
-      const std::array<std::tuple<FormKind, unsigned int, std::remove_cv_t<IntegrationFlags>>,
-                       size>& container =
-        std::array<std::tuple<FormKind, unsigned int, std::remove_cv_t<IntegrationFlags>>, size>{})
+    check_forms()
     {
-      constexpr IntegrationFlags integration_flags =
-        decltype(std::declval<FormType>().test)::integration_flags;
-
-      for (unsigned int i = number; i < size; ++i)
-      {
-        const auto& item = container.at(i);
-        if (std::get<0>(item) == form_kind && std::get<1>(item) == fe_number &&
-            ((std::get<2>(item)) & integration_flags))
-          return false;
-      }
-
-      if constexpr(sizeof...(Types) != 0)
-        {
-          constexpr auto new_tuple = std::make_tuple(form_kind, fe_number, integration_flags);
-          const auto new_container = internal::append(container, new_tuple);
-          return Forms<Types...>::template check_forms<size + 1, IntegrationFlags>(new_container);
-        }
-      else
-        return true;
+      constexpr auto integration_flags = FormType::TestType::integration_flags;
+      return (!(Types::form_kind == form_kind && Types::fe_number == fe_number &&
+                (Types::TestType::integration_flags & integration_flags)) &&
+              ...);
     }
 
-    static_assert(check_forms<number, decltype(FormType::TestType::integration_flags)>(),
+    static_assert(check_forms(),
                   "There are multiple forms that try to submit the same information!");
 
   private:
@@ -1,12 +1,18 @@
 #ifndef MATRIX_FREE_INTEGRATOR_H
 #define MATRIX_FREE_INTEGRATOR_H
 
+#include <deal.II/base/thread_local_storage.h>
 #include <deal.II/matrix_free/operators.h>
 
 #include <cfl/base/fefunctions.h> //for BlockVectors
 #include <cfl/base/traits.h>
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/trace.h>
 #include <deal.II/lac/la_parallel_block_vector.h>
 
+#include <optional>
+#include <vector>
+
 template <int dim, typename VectorType, class Enable = void>
 class MatrixFreeIntegratorBaseBase;
 
@@ -50,10 +56,59 @@ public:
     initialize(form_, fe_datas_);
   }
 
+  /**
+   * True if FORM only contains cell terms. For discontinuous elements, the
+   * result on a cell then only depends on the source values of the same cell.
+   */
+  static constexpr bool only_cell_forms =
+    FORM::get_form_kinds()[0] && !FORM::get_form_kinds()[1] && !FORM::get_form_kinds()[2];
+
+  /**
+   * Apply the cell Forms to <code>src</code> on the cells in
+   * <code>cell_range</code>. Instead of adding the integrated values to a
+   * global vector, <code>cell_operation(cell, fe_datas)</code> is called
+   * while they are still in the FEEvaluation objects of the FEDatas of the
+   * calling thread, so that callers can fuse further cell-local work into
+   * the same sweep, see CellwiseInverseMass::apply_operator_and_update_stage().
+   */
+  template <class CellOperation>
+  void
+  apply_on_cells(const VectorType& src, const std::pair<unsigned int, unsigned int>& cell_range,
+                 const CellOperation& cell_operation) const
+  {
+    static_assert(only_cell_forms, "Only Forms without face terms can be applied cell by cell!");
+    CFL_TRACE_EVENT(CFL::dealii::MatrixFree::Trace::Phase::begin_cell_loop);
+    FEDatas& local_fe_datas = thread_fe_datas();
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      CFL_TRACE_BATCH(cell);
+      local_fe_datas.reinit(cell);
+      local_fe_datas.read_dof_values(src);
+      do_operation_on_cell(local_fe_datas, cell);
+      cell_operation(cell, local_fe_datas);
+    }
+    CFL_TRACE_EVENT(CFL::dealii::MatrixFree::Trace::Phase::end_cell_loop);
+  }
+
 protected:
   std::shared_ptr<const FORM> form = nullptr;
+  /// The FEDatas set up by initialize(), copied by thread_fe_datas()
   std::shared_ptr<FEDatas> fe_datas = nullptr;
 
+  /**
+   * The copy of <code>fe_datas</code> of the calling thread. The FEEvaluation
+   * objects hold the values of the cell or face being evaluated, so the
+   * threaded task schemes of ::dealii::MatrixFree must not share them.
+   */
+  FEDatas&
+  thread_fe_datas() const
+  {
+    std::optional<FEDatas>& local_fe_datas = thread_local_fe_datas.get();
+    if (!local_fe_datas)
+      local_fe_datas.emplace(*fe_datas);
+    return *local_fe_datas;
+  }
+
   // convenience function to avoid shared_ptr
   void
   initialize(const FORM& form_, FEDatas& fe_datas_)
@@ -62,7 +117,7 @@ protected:
   }
 
   void
-  initialize(const std::shared_ptr<FORM>& form_, std::shared_ptr<FEDatas>& fe_datas_)
+  initialize(const std::shared_ptr<FORM>& form_, std::shared_ptr<FEDatas> fe_datas_)
   {
     // first retrieve information about integration loops to use from the Forms object
     constexpr std::array<bool, 3> use_objects = FORM::get_form_kinds();
@@ -72,7 +127,7 @@ protected:
 
     // then initialize the objects given appropriately
     form = form_;
-    fe_datas = fe_datas_;
+    fe_datas = std::move(fe_datas_);
 
     // we don't need to share these so initailize them already here.
     if constexpr(use_cell)
@@ -85,31 +140,27 @@ protected:
 
     Assert(this->data != nullptr, dealii::ExcNotInitialized());
     fe_datas->initialize(*(this->data));
+    // the copies of the threads are made from the new FEDatas on first use
+    thread_local_fe_datas.clear();
   }
 
   void
-  apply_add(VectorType& dst, const VectorType& src) const override
-  {
-    static_assert(
-      std::is_same<VectorType, dealii::LinearAlgebra::distributed::Vector<Number>>::value ||
-        std::is_same<VectorType, dealii::LinearAlgebra::distributed::BlockVector<Number>>::value,
-      "This is only implemented for dealii::LinearAlgebra::distributed::Vector<Number> "
-      "and dealii::LinearAlgebra::distributed::BlockVector<Number> objects!");
-    constexpr std::array<bool, 3> use_objects = FORM::get_form_kinds();
-    constexpr bool use_cell = use_objects[0];
-    constexpr bool use_face = use_objects[1];
-    constexpr bool use_boundary = use_objects[2];
+  apply_add(VectorType& dst, const VectorType& src) const override;
 
-    if constexpr(use_cell | use_face | use_boundary)
-      {
-        constexpr auto cell_ptr =
-          use_cell ? &MatrixFreeIntegratorBase::local_apply<FEDatas> : nullptr;
-        constexpr auto face_ptr =
-          use_face ? &MatrixFreeIntegratorBase::local_apply_face<FEDatas> : nullptr;
-        constexpr auto boundary_ptr =
-          use_boundary ? &MatrixFreeIntegratorBase::local_apply_boundary<FEDatas> : nullptr;
-        Base::data->loop(cell_ptr, face_ptr, boundary_ptr, this, dst, src);
-      }
+  static constexpr typename dealii::MatrixFree<dim, Number>::DataAccessOnFaces
+  data_access_on_faces(const CFL::dealii::MatrixFree::FaceDataAccess access)
+  {
+    using DataAccessOnFaces = typename dealii::MatrixFree<dim, Number>::DataAccessOnFaces;
+    switch (access)
+    {
+      case CFL::dealii::MatrixFree::FaceDataAccess::none:
+        return DataAccessOnFaces::none;
+      case CFL::dealii::MatrixFree::FaceDataAccess::values:
+        return DataAccessOnFaces::values;
+      case CFL::dealii::MatrixFree::FaceDataAccess::gradients:
+        return DataAccessOnFaces::gradients;
+    }
+    return DataAccessOnFaces::unspecified;
   }
 
   template <class FEEvaluation>
@@ -117,7 +168,8 @@ protected:
   do_operation_on_cell(FEEvaluation& phi, const unsigned int /*cell*/) const
   {
     phi.evaluate();
-    constexpr unsigned int n_q_points = FEEvaluation::get_n_q_points();
+    // the Forms skip the quadrature points beyond their own quadrature
+    constexpr unsigned int n_q_points = FEEvaluation::max_n_q_points;
     // static_for_old<0, n_q_points>()([&](int q)
     for (unsigned int q = 0; q < n_q_points; ++q)
       form->evaluate(phi, q);
@@ -130,7 +182,7 @@ protected:
   do_operation_on_face(FEEvaluation& phi, const unsigned int /*cell*/) const
   {
     phi.evaluate_face();
-    constexpr unsigned int n_q_points = FEEvaluation::get_n_q_points_face();
+    constexpr unsigned int n_q_points = FEEvaluation::max_n_q_points_face;
     // static_for_old<0, n_q_points>()([&](int q)
     for (unsigned int q = 0; q < n_q_points; ++q)
       form->evaluate_face(phi, q);
@@ -143,7 +195,7 @@ protected:
   do_operation_on_boundary(FEEvaluation& phi, const unsigned int /*cell*/) const
   {
     phi.template evaluate_face<true, false>();
-    constexpr unsigned int n_q_points = FEEvaluation::get_n_q_points_face();
+    constexpr unsigned int n_q_points = FEEvaluation::max_n_q_points_face;
     // static_for_old<0, n_q_points>()([&](int q)
     for (unsigned int q = 0; q < n_q_points; ++q)
       form->evaluate_boundary(phi, q);
@@ -152,81 +204,22 @@ protected:
   }
 
   template <class FEDatasTest = FEDatas>
-  void local_apply([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_, VectorType& dst,
+  void local_apply(const dealii::MatrixFree<dim, Number>& data_, VectorType& dst,
                    const VectorType& src,
-                   const std::pair<unsigned int, unsigned int>& cell_range) const
-  {
-    if constexpr(FEDatasTest::contains_cell_data)
-      {
-#ifdef DEBUG_OUTPUT
-        std::cout << "Begin cell loop" << std::endl;
-#endif
-        Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
-        for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
-        {
-          fe_datas->reinit(cell);
-          fe_datas->read_dof_values(src);
-          do_operation_on_cell(*fe_datas, cell);
-          fe_datas->distribute_local_to_global(dst);
-        }
-#ifdef DEBUG_OUTPUT
-        std::cout << "End cell loop" << std::endl;
-#endif
-      }
-  }
+                   const std::pair<unsigned int, unsigned int>& cell_range) const;
 
   template <class FEDatasTest = FEDatas>
-  void local_apply_face([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
-                        VectorType& dst, const VectorType& src,
-                        const std::pair<unsigned int, unsigned int>& face_range) const
-  {
-    if constexpr(FEDatasTest::contains_face_data)
-      {
-#ifdef DEBUG_OUTPUT
-        std::cout << "Begin face loop" << std::endl;
-#endif
-        Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
-        fe_datas->reset_integration_flags_face_and_boundary();
-        form->set_integration_flags_face(*fe_datas);
-        for (unsigned int face = face_range.first; face < face_range.second; face++)
-        {
-          fe_datas->reinit_face(face);
-          fe_datas->read_dof_values_face(src);
-          do_operation_on_face(*fe_datas, face);
-          fe_datas->distribute_local_to_global_face(dst);
-        }
-#ifdef DEBUG_OUTPUT
-        std::cout << "End face loop" << std::endl;
-#endif
-      }
-  }
+  void local_apply_face(const dealii::MatrixFree<dim, Number>& data_, VectorType& dst,
+                        const VectorType& src,
+                        const std::pair<unsigned int, unsigned int>& face_range) const;
 
   template <class FEDatasTest = FEDatas>
-  void local_apply_boundary([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
-                            VectorType& dst, const VectorType& src,
-                            const std::pair<unsigned int, unsigned int>& face_range) const
-  {
-    if constexpr(FEDatasTest::contains_face_data)
-      {
-#ifdef DEBUG_OUTPUT
-        std::cout << "Begin boundary loop" << std::endl;
-#endif
-        Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
-        fe_datas->reset_integration_flags_face_and_boundary();
-        form->set_integration_flags_boundary(*fe_datas);
-        for (unsigned int face = face_range.first; face < face_range.second; face++)
-        {
-          fe_datas->reinit_boundary(face);
-          // We never need values from the "neighboring" face as there is none.
-          fe_datas->template read_dof_values_face<VectorType, true, false>(src);
-          do_operation_on_boundary(*fe_datas, face);
-          fe_datas->template distribute_local_to_global_face<VectorType, true, false>(dst);
-        }
-#ifdef DEBUG_OUTPUT
-        std::cout << "End boundary loop" << std::endl;
-#endif
-      }
-  }
+  void local_apply_boundary(const dealii::MatrixFree<dim, Number>& data_, VectorType& dst,
+                            const VectorType& src,
+                            const std::pair<unsigned int, unsigned int>& face_range) const;
+
+private:
+  mutable ::dealii::Threads::ThreadLocalStorage<std::optional<FEDatas>> thread_local_fe_datas;
 };
 
 template <int dim, typename VectorType, class FORM, class FEDatas, class Enable = void>
@@ -269,66 +262,37 @@ public:
   }
 
   void
-  compute_diagonal() override
-  {
-    static_assert(FEDatas::n == 1, "This is for one compoennt!");
-    Assert((Base::data != nullptr), dealii::ExcNotInitialized());
-    unsigned int dummy = 0;
-    this->inverse_diagonal_entries.reset(new dealii::DiagonalMatrix<VectorType>());
-    VectorType& inverse_diagonal_vector = this->inverse_diagonal_entries->get_vector();
-    this->initialize_dof_vector(inverse_diagonal_vector);
-    // VectorType ones;
-    // this->initialize_dof_vector(ones);
-    // ones = Number(1.);
-    // apply_add(inverse_diagonal_vector, ones);
-
-    this->data->cell_loop(
-      &MatrixFreeIntegrator::local_diagonal_cell, this, inverse_diagonal_vector, dummy);
-
-    this->set_constrained_entries_to_one(inverse_diagonal_vector);
-
-    const unsigned int local_size = inverse_diagonal_vector.local_size();
-    for (unsigned int i = 0; i < local_size; ++i)
-    {
-      if (std::abs(inverse_diagonal_vector.local_element(i)) >
-          std::sqrt(std::numeric_limits<Number>::epsilon()))
-      {
-        inverse_diagonal_vector.local_element(i) = 1. / inverse_diagonal_vector.local_element(i);
-      }
-      else
-        inverse_diagonal_vector.local_element(i) = 1.;
-    }
-
-    inverse_diagonal_vector.update_ghost_values();
-    // inverse_diagonal_vector.print(std::cout);
-  }
+  compute_diagonal() override;
 
   // TODO(darndt): this is hacky and just tries to get comparable output w.r.t. step-37
+  // a template, such that explicit instantiations for FEDatas with face data compile
+  template <class FEDatasTest = FEDatas>
   void local_diagonal_cell([[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_,
                            VectorType& dst, const unsigned int& /*unused*/,
                            const std::pair<unsigned int, unsigned int>& cell_range) const
   {
     Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+    FEDatas& local_fe_datas = Base::thread_fe_datas();
     for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
     {
-      Base::fe_datas->reinit(cell);
+      local_fe_datas.reinit(cell);
       const /*expr*/ unsigned int tensor_dofs_per_cell =
-        Base::fe_datas->template tensor_dofs_per_cell<0>();
+        local_fe_datas.template tensor_dofs_per_cell<0>();
       std::vector<dealii::VectorizedArray<Number>> local_diagonal_vector(tensor_dofs_per_cell);
 
       AssertThrow(data_.n_components() == 1, dealii::ExcNotImplemented());
 
-      for (unsigned int i = 0; i < Base::fe_datas->template dofs_per_cell<0>(); ++i)
+      for (unsigned int i = 0; i < local_fe_datas.template dofs_per_cell<0>(); ++i)
       {
-        for (unsigned int j = 0; j < Base::fe_datas->template dofs_per_cell<0>(); ++j)
-          Base::fe_datas->template begin_dof_values<0>()[j] = dealii::VectorizedArray<Number>();
-        Base::fe_datas->template begin_dof_values<0>()[i] = 1.;
-        Base::do_operation_on_cell(*Base::fe_datas, cell);
-        local_diagonal_vector[i] = Base::fe_datas->template begin_dof_values<0>()[i];
+        for (unsigned int j = 0; j < local_fe_datas.template dofs_per_cell<0>(); ++j)
+          local_fe_datas.template begin_dof_values<0>()[j] = dealii::VectorizedArray<Number>();
+        local_fe_datas.template begin_dof_values<0>()[i] = 1.;
+        Base::do_operation_on_cell(local_fe_datas, cell);
+        local_diagonal_vector[i] = local_fe_datas.template begin_dof_values<0>()[i];
       }
-      for (unsigned int i = 0; i < Base::fe_datas->template tensor_dofs_per_cell<0>(); ++i)
-        Base::fe_datas->template begin_dof_values<0>()[i] = local_diagonal_vector[i];
-      Base::fe_datas->distribute_local_to_global(dst);
+      for (unsigned int i = 0; i < local_fe_datas.template tensor_dofs_per_cell<0>(); ++i)
+        local_fe_datas.template begin_dof_values<0>()[i] = local_diagonal_vector[i];
+      local_fe_datas.distribute_local_to_global(dst);
     }
   }
 };
@@ -411,4 +375,161 @@ private:
   mutable VectorType safed_vectors;
 };
 
+// The operator application is defined outside of the classes, such that it
+// is not implicitly inline and the extern template declarations of
+// standard_forms.h actually suppress its instantiation in user code.
+template <int dim, typename VectorType, class FORM, class FEDatas>
+void
+MatrixFreeIntegratorBase<dim, VectorType, FORM, FEDatas>::apply_add(VectorType& dst,
+                                                                    const VectorType& src) const
+{
+  static_assert(
+    std::is_same<VectorType, dealii::LinearAlgebra::distributed::Vector<Number>>::value ||
+      std::is_same<VectorType, dealii::LinearAlgebra::distributed::BlockVector<Number>>::value,
+    "This is only implemented for dealii::LinearAlgebra::distributed::Vector<Number> "
+    "and dealii::LinearAlgebra::distributed::BlockVector<Number> objects!");
+  constexpr std::array<bool, 3> use_objects = FORM::get_form_kinds();
+  constexpr bool use_cell = use_objects[0];
+  constexpr bool use_face = use_objects[1];
+  constexpr bool use_boundary = use_objects[2];
+
+  if constexpr(use_cell | use_face | use_boundary)
+    {
+      constexpr auto cell_ptr =
+        use_cell ? &MatrixFreeIntegratorBase::local_apply<FEDatas> : nullptr;
+      constexpr auto face_ptr =
+        use_face ? &MatrixFreeIntegratorBase::local_apply_face<FEDatas> : nullptr;
+      constexpr auto boundary_ptr =
+        use_boundary ? &MatrixFreeIntegratorBase::local_apply_boundary<FEDatas> : nullptr;
+      // only exchange the ghost data the face forms actually access
+      Base::data->loop(cell_ptr, face_ptr, boundary_ptr, this, dst, src, false,
+                       data_access_on_faces(FORM::dst_face_data_access),
+                       data_access_on_faces(FORM::src_face_data_access));
+    }
+}
+
+template <int dim, typename VectorType, class FORM, class FEDatas>
+template <class FEDatasTest>
+void
+MatrixFreeIntegratorBase<dim, VectorType, FORM, FEDatas>::local_apply(
+  [[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_, VectorType& dst,
+  const VectorType& src, const std::pair<unsigned int, unsigned int>& cell_range) const
+{
+  if constexpr(FEDatasTest::contains_cell_data)
+    {
+      CFL_TRACE_EVENT(CFL::dealii::MatrixFree::Trace::Phase::begin_cell_loop);
+      Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+      FEDatas& local_fe_datas = thread_fe_datas();
+      for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+      {
+        CFL_TRACE_BATCH(cell);
+        local_fe_datas.reinit(cell);
+        local_fe_datas.read_dof_values(src);
+        do_operation_on_cell(local_fe_datas, cell);
+        local_fe_datas.distribute_local_to_global(dst);
+      }
+      CFL_TRACE_EVENT(CFL::dealii::MatrixFree::Trace::Phase::end_cell_loop);
+    }
+}
+
+template <int dim, typename VectorType, class FORM, class FEDatas>
+template <class FEDatasTest>
+void
+MatrixFreeIntegratorBase<dim, VectorType, FORM, FEDatas>::local_apply_face(
+  [[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_, VectorType& dst,
+  const VectorType& src, const std::pair<unsigned int, unsigned int>& face_range) const
+{
+  if constexpr(FEDatasTest::contains_face_data)
+    {
+      CFL_TRACE_EVENT(CFL::dealii::MatrixFree::Trace::Phase::begin_face_loop);
+      Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+      FEDatas& local_fe_datas = thread_fe_datas();
+      local_fe_datas.reset_integration_flags_face_and_boundary();
+      form->set_integration_flags_face(local_fe_datas);
+      for (unsigned int face = face_range.first; face < face_range.second; face++)
+      {
+        CFL_TRACE_BATCH(face);
+        local_fe_datas.reinit_face(face);
+        local_fe_datas.read_dof_values_face(src);
+        do_operation_on_face(local_fe_datas, face);
+        local_fe_datas.distribute_local_to_global_face(dst);
+      }
+      CFL_TRACE_EVENT(CFL::dealii::MatrixFree::Trace::Phase::end_face_loop);
+    }
+}
+
+template <int dim, typename VectorType, class FORM, class FEDatas>
+template <class FEDatasTest>
+void
+MatrixFreeIntegratorBase<dim, VectorType, FORM, FEDatas>::local_apply_boundary(
+  [[maybe_unused]] const dealii::MatrixFree<dim, Number>& data_, VectorType& dst,
+  const VectorType& src, const std::pair<unsigned int, unsigned int>& face_range) const
+{
+  if constexpr(FEDatasTest::contains_face_data)
+    {
+      CFL_TRACE_EVENT(CFL::dealii::MatrixFree::Trace::Phase::begin_boundary_loop);
+      Assert(&data_ == (this->get_matrix_free()).get(), dealii::ExcInternalError());
+      FEDatas& local_fe_datas = thread_fe_datas();
+      local_fe_datas.reset_integration_flags_face_and_boundary();
+      form->set_integration_flags_boundary(local_fe_datas);
+      for (unsigned int face = face_range.first; face < face_range.second; face++)
+      {
+        CFL_TRACE_BATCH(face);
+        local_fe_datas.reinit_boundary(face);
+        // We never need values from the "neighboring" face as there is none.
+        local_fe_datas.template read_dof_values_face<VectorType, true, false>(src);
+        do_operation_on_boundary(local_fe_datas, face);
+        local_fe_datas.template distribute_local_to_global_face<VectorType, true, false>(dst);
+      }
+      CFL_TRACE_EVENT(CFL::dealii::MatrixFree::Trace::Phase::end_boundary_loop);
+    }
+}
+
+template <int dim, typename VectorType, class FORM, class FEDatas>
+void
+MatrixFreeIntegrator<dim, VectorType, FORM, FEDatas,
+                     typename std::enable_if_t<!CFL::Traits::is_block_vector<VectorType>::value>>::
+  compute_diagonal()
+{
+  // compute_diagonal() is virtual and hence instantiated for any FEDatas,
+  // so only fail at runtime for the unsupported cases
+  if constexpr(FEDatas::n != 1 || !FEDatas::contains_cell_data)
+    {
+      AssertThrow(false, dealii::ExcMessage("The diagonal is only implemented for a single cell "
+                                            "FEData object!"));
+    }
+  else
+  {
+    Assert((Base::data != nullptr), dealii::ExcNotInitialized());
+    unsigned int dummy = 0;
+    this->inverse_diagonal_entries.reset(new dealii::DiagonalMatrix<VectorType>());
+    VectorType& inverse_diagonal_vector = this->inverse_diagonal_entries->get_vector();
+    this->initialize_dof_vector(inverse_diagonal_vector);
+    // VectorType ones;
+    // this->initialize_dof_vector(ones);
+    // ones = Number(1.);
+    // apply_add(inverse_diagonal_vector, ones);
+
+    this->data->cell_loop(
+      &MatrixFreeIntegrator::local_diagonal_cell<FEDatas>, this, inverse_diagonal_vector, dummy);
+
+    this->set_constrained_entries_to_one(inverse_diagonal_vector);
+
+    const unsigned int local_size = inverse_diagonal_vector.local_size();
+    for (unsigned int i = 0; i < local_size; ++i)
+    {
+      if (std::abs(inverse_diagonal_vector.local_element(i)) >
+          std::sqrt(std::numeric_limits<Number>::epsilon()))
+      {
+        inverse_diagonal_vector.local_element(i) = 1. / inverse_diagonal_vector.local_element(i);
+      }
+      else
+        inverse_diagonal_vector.local_element(i) = 1.;
+    }
+
+    inverse_diagonal_vector.update_ghost_values();
+    // inverse_diagonal_vector.print(std::cout);
+  }
+}
+
 #endif // MATRIX_FREE_INTEGRATOR_H
@@ -0,0 +1,536 @@
+#ifndef DEALII_MATRIXFREE_PMG_TRANSFER_H
+#define DEALII_MATRIXFREE_PMG_TRANSFER_H
+
+#include <cfl/base/traits.h>
+#include <cfl/matrixfree/fe_data.h>
+#include <cfl/matrixfree/fefunctions.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/mg_level_object.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/multigrid/mg_base.h>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CFL::dealii::MatrixFree
+{
+namespace internal
+{
+  constexpr unsigned int
+  pow(const unsigned int base, const int exponent)
+  {
+    return exponent == 0 ? 1 : base * pow(base, exponent - 1);
+  }
+
+  /**
+   * Apply the one-dimensional <code>n_rows</code> x <code>n_columns</code>
+   * matrix (row-major) along the coordinate direction <code>direction</code> of
+   * the tensor-product array <code>in</code>. The directions below
+   * <code>direction</code> already have <code>n_out</code> entries, the
+   * ones above still have <code>n_in</code> entries. With
+   * <code>transpose</code> the transpose of the matrix is applied.
+   */
+  template <int dim, int n_rows, int n_columns, bool transpose, typename Number, typename Number2>
+  void
+  apply_matrix_1d(const int direction, const Number2* matrix, const Number* in, Number* out)
+  {
+    constexpr int n_out = transpose ? n_columns : n_rows;
+    constexpr int n_in = transpose ? n_rows : n_columns;
+    const int stride = pow(n_out, direction);
+    const int n_blocks = pow(n_in, dim - 1 - direction);
+    for (int b = 0; b < n_blocks; ++b)
+      for (int s = 0; s < stride; ++s)
+        for (int i = 0; i < n_out; ++i)
+        {
+          Number sum = Number();
+          for (int j = 0; j < n_in; ++j)
+            sum += (transpose ? matrix[j * n_columns + i] : matrix[i * n_columns + j]) *
+                   in[s + stride * (j + n_in * b)];
+          out[s + stride * (i + n_out * b)] = sum;
+        }
+  }
+
+  /**
+   * Sum-factorized application of the tensor product of the 1D matrix in all
+   * coordinate directions, i.e., dim successive 1D sweeps instead of one dense
+   * (n_rows^dim x n_columns^dim) matrix.
+   */
+  template <int dim, int n_rows, int n_columns, bool transpose, typename Number, typename Number2>
+  void
+  apply_tensor_product(const Number2* matrix, const Number* in, Number* out)
+  {
+    constexpr unsigned int n_max = pow(std::max(n_rows, n_columns), dim);
+    std::array<Number, n_max> tmp0;
+    std::array<Number, n_max> tmp1;
+    const Number* src = in;
+    for (int d = 0; d < dim; ++d)
+    {
+      Number* dst = (d == dim - 1) ? out : (d % 2 == 0 ? tmp0.data() : tmp1.data());
+      apply_matrix_1d<dim, n_rows, n_columns, transpose>(d, matrix, src, dst);
+      src = dst;
+    }
+  }
+
+  /**
+   * The support points of <code>fe</code> on the first coordinate axis,
+   * sorted by their position. For tensor-product Lagrange elements these are
+   * the 1D nodes in lexicographic order.
+   */
+  template <int dim>
+  std::vector<std::pair<double, unsigned int>>
+  support_points_on_axis(const ::dealii::FiniteElement<dim>& fe)
+  {
+    AssertThrow(fe.has_support_points(),
+                ::dealii::ExcMessage("The p-transfer needs Lagrange elements with support points!"));
+    std::vector<std::pair<double, unsigned int>> points;
+    const auto& unit_points = fe.get_unit_support_points();
+    for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+    {
+      if (fe.system_to_component_index(i).first != 0)
+        continue;
+      bool on_axis = true;
+      for (unsigned int d = 1; d < dim; ++d)
+        on_axis = on_axis && std::abs(unit_points[i][d]) < 1e-12;
+      if (on_axis)
+        points.emplace_back(unit_points[i][0], i);
+    }
+    std::sort(points.begin(), points.end());
+    AssertDimension(points.size(), fe.degree + 1);
+    return points;
+  }
+} // namespace internal
+
+/**
+ * Interface of a transfer between two levels of a polynomial (p-)multigrid
+ * hierarchy, such that transfers between different FEData types can be
+ * stored together, see MGTransferPH.
+ */
+template <typename VectorType>
+class PMGTransferBase
+{
+public:
+  virtual ~PMGTransferBase() = default;
+
+  /**
+   * Interpolate the coarse-degree function <code>src</code> into the
+   * fine-degree space, overwriting <code>dst</code>.
+   */
+  virtual void
+  prolongate(VectorType& dst, const VectorType& src) const = 0;
+
+  /**
+   * Add the transpose of prolongate() applied to <code>src</code> to
+   * <code>dst</code>.
+   */
+  virtual void
+  restrict_and_add(VectorType& dst, const VectorType& src) const = 0;
+};
+
+/**
+ * @brief Polynomial transfer between two FEData objects on the same mesh
+ *
+ * Both FEData objects have to refer to DoFHandlers of the same MatrixFree
+ * object that only differ in the polynomial degree of their tensor-product
+ * Lagrange element (FE_Q or FE_DGQ with the same number of components).
+ * The embedding of the coarse into the fine space is the interpolation at the
+ * fine support points. On each cell, it is applied by sum factorization with
+ * the 1D embedding matrix, the restriction uses its transpose.
+ *
+ * For continuous elements, the degrees of freedom shared by several cells
+ * receive the same value from every cell. The prolongation therefore weights
+ * the cell contributions by the inverse valence of each fine degree of
+ * freedom, and the restriction uses the same weights to stay its transpose.
+ *
+ * <h3> Usage example </h3>
+ * <code>
+ *   FEData<FE_Q, 4, 1, 2, 0, 4, double> fedata_fine(fe_4);
+ *   FEData<FE_Q, 2, 1, 2, 1, 4, double> fedata_coarse(fe_2);
+ *   PMGTransfer<decltype(fedata_fine), decltype(fedata_coarse)> transfer(fedata_fine,
+ *                                                                        fedata_coarse);
+ *   transfer.initialize(matrix_free);
+ *   transfer.prolongate(fine_vector, coarse_vector);
+ * </code>
+ */
+template <class FEDataFine, class FEDataCoarse,
+          typename VectorType =
+            ::dealii::LinearAlgebra::distributed::Vector<typename FEDataFine::NumberType>>
+class PMGTransfer final : public PMGTransferBase<VectorType>
+{
+public:
+  using NumberType = typename FEDataFine::NumberType;
+  static constexpr int dim = FEDataFine::dimension;
+  static constexpr unsigned int n_components = FEDataFine::n_fe_components;
+  static constexpr int n_fine = FEDataFine::degree + 1;
+  static constexpr int n_coarse = FEDataCoarse::degree + 1;
+  static constexpr unsigned int dofs_per_component_fine = internal::pow(n_fine, dim);
+  static constexpr unsigned int dofs_per_component_coarse = internal::pow(n_coarse, dim);
+
+  PMGTransfer(const FEDataFine& fe_data_fine_, const FEDataCoarse& fe_data_coarse_)
+    : fe_fine(fe_data_fine_.fe)
+    , fe_coarse(fe_data_coarse_.fe)
+  {
+    static_assert(CFL::Traits::is_fe_data<FEDataFine>::value &&
+                    CFL::Traits::is_fe_data<FEDataCoarse>::value,
+                  "The p-transfer is only available for cell FEData objects!");
+    static_assert(FEDataFine::dimension == FEDataCoarse::dimension, "Dimensions do not match!");
+    static_assert(FEDataFine::n_fe_components == FEDataCoarse::n_fe_components,
+                  "The number of components must be the same on both levels!");
+    static_assert(std::is_same<NumberType, typename FEDataCoarse::NumberType>::value,
+                  "The number types must be the same on both levels!");
+    static_assert(FEDataFine::degree > FEDataCoarse::degree,
+                  "The fine FEData must have the higher polynomial degree!");
+  }
+
+  /**
+   * Compute the 1D embedding matrix and the valence weights for the given
+   * MatrixFree object which has to outlive this object.
+   */
+  void
+  initialize(const ::dealii::MatrixFree<dim, NumberType>& mf)
+  {
+    data = &mf;
+
+    const auto fine_points = internal::support_points_on_axis(*fe_fine);
+    const auto coarse_points = internal::support_points_on_axis(*fe_coarse);
+    for (int i = 0; i < n_fine; ++i)
+    {
+      ::dealii::Point<dim> point;
+      point[0] = fine_points[i].first;
+      for (int j = 0; j < n_coarse; ++j)
+        embedding_matrix[i * n_coarse + j] = fe_coarse->shape_value(coarse_points[j].second, point);
+    }
+
+    // valence of each fine degree of freedom
+    data->initialize_dof_vector(weights, FEDataFine::dof_number);
+    FEEvaluationFine phi_fine(*data, FEDataFine::dof_number, FEDataFine::quad_number);
+    for (unsigned int cell = 0; cell < data->n_macro_cells(); ++cell)
+    {
+      phi_fine.reinit(cell);
+      for (unsigned int i = 0; i < phi_fine.dofs_per_cell; ++i)
+        phi_fine.begin_dof_values()[i] = ::dealii::make_vectorized_array<NumberType>(1.);
+      phi_fine.distribute_local_to_global(weights);
+    }
+    weights.compress(::dealii::VectorOperation::add);
+    for (unsigned int i = 0; i < weights.local_size(); ++i)
+      if (weights.local_element(i) != NumberType())
+        weights.local_element(i) = NumberType(1.) / weights.local_element(i);
+    weights.update_ghost_values();
+  }
+
+  void
+  prolongate(VectorType& dst, const VectorType& src) const override
+  {
+    Assert(data != nullptr, ::dealii::ExcNotInitialized());
+    get_block(dst, FEDataFine::dof_number) = NumberType();
+    get_block(src, FEDataCoarse::dof_number).update_ghost_values();
+
+    FEEvaluationFine phi_fine(*data, FEDataFine::dof_number, FEDataFine::quad_number);
+    FEEvaluationFine phi_weights(*data, FEDataFine::dof_number, FEDataFine::quad_number);
+    FEEvaluationCoarse phi_coarse(*data, FEDataCoarse::dof_number, FEDataCoarse::quad_number);
+    for (unsigned int cell = 0; cell < data->n_macro_cells(); ++cell)
+    {
+      phi_coarse.reinit(cell);
+      phi_fine.reinit(cell);
+      phi_weights.reinit(cell);
+      phi_coarse.read_dof_values(get_block(src, FEDataCoarse::dof_number));
+      phi_weights.read_dof_values(weights);
+      for (unsigned int c = 0; c < n_components; ++c)
+        internal::apply_tensor_product<dim, n_fine, n_coarse, false>(
+          embedding_matrix.data(),
+          phi_coarse.begin_dof_values() + c * dofs_per_component_coarse,
+          phi_fine.begin_dof_values() + c * dofs_per_component_fine);
+      for (unsigned int i = 0; i < phi_fine.dofs_per_cell; ++i)
+        phi_fine.begin_dof_values()[i] *= phi_weights.begin_dof_values()[i];
+      phi_fine.distribute_local_to_global(get_block(dst, FEDataFine::dof_number));
+    }
+    get_block(dst, FEDataFine::dof_number).compress(::dealii::VectorOperation::add);
+    get_block(src, FEDataCoarse::dof_number).zero_out_ghosts();
+  }
+
+  void
+  restrict_and_add(VectorType& dst, const VectorType& src) const override
+  {
+    Assert(data != nullptr, ::dealii::ExcNotInitialized());
+    get_block(src, FEDataFine::dof_number).update_ghost_values();
+
+    FEEvaluationFine phi_fine(*data, FEDataFine::dof_number, FEDataFine::quad_number);
+    FEEvaluationFine phi_weights(*data, FEDataFine::dof_number, FEDataFine::quad_number);
+    FEEvaluationCoarse phi_coarse(*data, FEDataCoarse::dof_number, FEDataCoarse::quad_number);
+    for (unsigned int cell = 0; cell < data->n_macro_cells(); ++cell)
+    {
+      phi_fine.reinit(cell);
+      phi_weights.reinit(cell);
+      phi_coarse.reinit(cell);
+      phi_fine.read_dof_values(get_block(src, FEDataFine::dof_number));
+      phi_weights.read_dof_values(weights);
+      for (unsigned int i = 0; i < phi_fine.dofs_per_cell; ++i)
+        phi_fine.begin_dof_values()[i] *= phi_weights.begin_dof_values()[i];
+      for (unsigned int c = 0; c < n_components; ++c)
+        internal::apply_tensor_product<dim, n_fine, n_coarse, true>(
+          embedding_matrix.data(),
+          phi_fine.begin_dof_values() + c * dofs_per_component_fine,
+          phi_coarse.begin_dof_values() + c * dofs_per_component_coarse);
+      phi_coarse.distribute_local_to_global(get_block(dst, FEDataCoarse::dof_number));
+    }
+    get_block(dst, FEDataCoarse::dof_number).compress(::dealii::VectorOperation::add);
+    get_block(src, FEDataFine::dof_number).zero_out_ghosts();
+  }
+
+private:
+  using FEEvaluationFine = typename FEDataFine::FEEvaluationType;
+  using FEEvaluationCoarse = typename FEDataCoarse::FEEvaluationType;
+
+  const std::shared_ptr<const ::dealii::FiniteElement<dim>> fe_fine;
+  const std::shared_ptr<const ::dealii::FiniteElement<dim>> fe_coarse;
+  const ::dealii::MatrixFree<dim, NumberType>* data = nullptr;
+  std::array<NumberType, n_fine * n_coarse> embedding_matrix{};
+  ::dealii::LinearAlgebra::distributed::Vector<NumberType> weights;
+
+  template <typename Vector>
+  static auto&
+  get_block(Vector& vector, [[maybe_unused]] const unsigned int block)
+  {
+    if constexpr(CFL::Traits::is_block_vector<std::remove_const_t<Vector>>::value)
+        return vector.block(block);
+    else
+      return vector;
+  }
+};
+
+/**
+ * How the polynomial degree is reduced from one p-level to the next coarser one.
+ */
+enum class PMGCoarsening
+{
+  /// p -> max(1, p/2)
+  bisect,
+  /// p -> p-1
+  decrease_by_one
+};
+
+/**
+ * The polynomial degree of the next coarser p-level.
+ */
+constexpr unsigned int
+pmg_coarse_degree(const unsigned int degree,
+                  const PMGCoarsening coarsening = PMGCoarsening::bisect)
+{
+  return (degree <= 1) ? 1 : (coarsening == PMGCoarsening::bisect ? std::max(1u, degree / 2)
+                                                                   : degree - 1);
+}
+
+/**
+ * The polynomial degrees of all p-levels from degree 1 up to
+ * <code>fine_degree</code>, ordered from coarse to fine.
+ */
+inline std::vector<unsigned int>
+pmg_degree_sequence(const unsigned int fine_degree,
+                    const PMGCoarsening coarsening = PMGCoarsening::bisect)
+{
+  std::vector<unsigned int> degrees{ fine_degree };
+  while (degrees.back() > 1)
+    degrees.push_back(pmg_coarse_degree(degrees.back(), coarsening));
+  std::reverse(degrees.begin(), degrees.end());
+  return degrees;
+}
+
+/**
+ * The mesh level and the polynomial degree of one level of a combined
+ * h- and p-multigrid hierarchy.
+ */
+struct MGLevelDescription
+{
+  unsigned int h_level;
+  unsigned int degree;
+};
+
+/**
+ * Describe a multigrid hierarchy which first coarsens the polynomial degree
+ * on the finest mesh and then coarsens the mesh with linear elements. The
+ * levels are ordered from coarse to fine, i.e., the levels
+ * <code>0,...,n_h_levels-1</code> are geometric levels with degree 1 and the
+ * remaining ones are p-levels on the mesh level <code>n_h_levels-1</code>.
+ */
+inline std::vector<MGLevelDescription>
+build_mg_level_hierarchy(const unsigned int n_h_levels, const unsigned int fine_degree,
+                         const PMGCoarsening coarsening = PMGCoarsening::bisect)
+{
+  AssertThrow(n_h_levels > 0, ::dealii::ExcMessage("At least one mesh level is needed!"));
+  std::vector<MGLevelDescription> levels;
+  for (unsigned int level = 0; level < n_h_levels; ++level)
+    levels.push_back(MGLevelDescription{ level, 1 });
+  const std::vector<unsigned int> degrees = pmg_degree_sequence(fine_degree, coarsening);
+  for (unsigned int i = 1; i < degrees.size(); ++i)
+    levels.push_back(MGLevelDescription{ n_h_levels - 1, degrees[i] });
+  return levels;
+}
+
+/**
+ * @brief Combined transfer for a hierarchy from build_mg_level_hierarchy()
+ *
+ * The transfers between the geometric levels are done by any
+ * ::dealii::MGTransferBase object for the linear element, typically a
+ * ::dealii::MGTransferMatrixFree, and the ones between the p-levels by
+ * PMGTransferBase objects, ordered from coarse to fine. The first one
+ * transfers from the finest geometric level to the first p-level.
+ *
+ * All p-levels live on the finest mesh level and use the level numbering
+ * of their DoFHandlers, i.e., their MatrixFree objects are set up with
+ * <code>level_mg_handler</code> equal to the finest level. This requires a
+ * globally refined mesh. copy_to_mg() and copy_from_mg() then only need to
+ * renumber between the active and the level numbering of the fine DoFHandler.
+ * This renumbering is done locally, so each degree of freedom must be owned by
+ * the same process in the active and in the finest level numbering, which
+ * build() checks.
+ */
+template <int dim, typename Number>
+class MGTransferPH final
+  : public ::dealii::MGTransferBase<::dealii::LinearAlgebra::distributed::Vector<Number>>
+{
+public:
+  using VectorType = ::dealii::LinearAlgebra::distributed::Vector<Number>;
+
+  /**
+   * @p initialize_level_vector has to set up a vector with the layout of the
+   * given level, e.g. by calling initialize_dof_vector() of the level operator.
+   */
+  MGTransferPH(const ::dealii::MGTransferBase<VectorType>& h_transfer_,
+               std::vector<std::shared_ptr<const PMGTransferBase<VectorType>>> p_transfers_,
+               std::function<void(const unsigned int, VectorType&)> initialize_level_vector_)
+    : h_transfer(h_transfer_)
+    , p_transfers(std::move(p_transfers_))
+    , initialize_level_vector(std::move(initialize_level_vector_))
+  {
+  }
+
+  /**
+   * Build the renumbering between the locally owned active and level degrees
+   * of freedom of the DoFHandler with the finest polynomial degree.
+   */
+  void
+  build(const ::dealii::DoFHandler<dim>& fine_dof_handler)
+  {
+    n_h_levels = fine_dof_handler.get_triangulation().n_global_levels();
+    const unsigned int top_h_level = n_h_levels - 1;
+    const ::dealii::IndexSet& owned_active = fine_dof_handler.locally_owned_dofs();
+    const ::dealii::IndexSet& owned_level = fine_dof_handler.locally_owned_mg_dofs(top_h_level);
+    active_to_level.clear();
+    std::vector<::dealii::types::global_dof_index> active_indices(
+      fine_dof_handler.get_fe().dofs_per_cell);
+    std::vector<::dealii::types::global_dof_index> level_indices(active_indices.size());
+    for (const auto& cell : fine_dof_handler.active_cell_iterators())
+    {
+      if (!cell->is_locally_owned())
+        continue;
+      AssertThrow(static_cast<unsigned int>(cell->level()) == top_h_level,
+                  ::dealii::ExcMessage("The p-levels require a globally refined mesh!"));
+      cell->get_dof_indices(active_indices);
+      cell->get_mg_dof_indices(level_indices);
+      for (unsigned int i = 0; i < active_indices.size(); ++i)
+      {
+        const bool owns_active = owned_active.is_element(active_indices[i]);
+        AssertThrow(owns_active == owned_level.is_element(level_indices[i]),
+                    ::dealii::ExcMessage("The active and the finest level partitions of the "
+                                         "degrees of freedom have to coincide!"));
+        if (owns_active)
+          active_to_level.emplace_back(active_indices[i], level_indices[i]);
+      }
+    }
+    std::sort(active_to_level.begin(), active_to_level.end());
+    active_to_level.erase(std::unique(active_to_level.begin(), active_to_level.end()),
+                          active_to_level.end());
+  }
+
+  unsigned int
+  n_levels() const
+  {
+    return n_h_levels + p_transfers.size();
+  }
+
+  void
+  prolongate(const unsigned int to_level, VectorType& dst, const VectorType& src) const override
+  {
+    if (to_level < n_h_levels)
+      h_transfer.prolongate(to_level, dst, src);
+    else
+      p_transfers[to_level - n_h_levels]->prolongate(dst, src);
+  }
+
+  void
+  restrict_and_add(const unsigned int from_level, VectorType& dst,
+                   const VectorType& src) const override
+  {
+    if (from_level < n_h_levels)
+      h_transfer.restrict_and_add(from_level, dst, src);
+    else
+      p_transfers[from_level - n_h_levels]->restrict_and_add(dst, src);
+  }
+
+  template <class InVector>
+  void
+  copy_to_mg(const ::dealii::DoFHandler<dim>& /*dof_handler*/,
+             ::dealii::MGLevelObject<VectorType>& dst, const InVector& src) const
+  {
+    for (unsigned int level = dst.min_level(); level <= dst.max_level(); ++level)
+      initialize_level_vector(level, dst[level]);
+    VectorType& top = dst[dst.max_level()];
+    for (const auto& indices : active_to_level)
+    {
+      Assert(top.in_local_range(indices.second) && src.in_local_range(indices.first),
+             ::dealii::ExcMessage("The vectors do not match the partition used in build()!"));
+      top(indices.second) = src(indices.first);
+    }
+  }
+
+  template <class OutVector>
+  void
+  copy_from_mg(const ::dealii::DoFHandler<dim>& dof_handler, OutVector& dst,
+               const ::dealii::MGLevelObject<VectorType>& src) const
+  {
+    dst = 0;
+    copy_from_mg_add(dof_handler, dst, src);
+  }
+
+  template <class OutVector>
+  void
+  copy_from_mg_add(const ::dealii::DoFHandler<dim>& /*dof_handler*/, OutVector& dst,
+                   const ::dealii::MGLevelObject<VectorType>& src) const
+  {
+    const VectorType& top = src[src.max_level()];
+    for (const auto& indices : active_to_level)
+    {
+      Assert(top.in_local_range(indices.second) && dst.in_local_range(indices.first),
+             ::dealii::ExcMessage("The vectors do not match the partition used in build()!"));
+      dst(indices.first) += top(indices.second);
+    }
+  }
+
+  std::size_t
+  memory_consumption() const
+  {
+    return active_to_level.size() * sizeof(active_to_level[0]);
+  }
+
+private:
+  const ::dealii::MGTransferBase<VectorType>& h_transfer;
+  const std::vector<std::shared_ptr<const PMGTransferBase<VectorType>>> p_transfers;
+  const std::function<void(const unsigned int, VectorType&)> initialize_level_vector;
+  unsigned int n_h_levels = 0;
+  std::vector<std::pair<::dealii::types::global_dof_index, ::dealii::types::global_dof_index>>
+    active_to_level;
+};
+}
+
+#endif // DEALII_MATRIXFREE_PMG_TRANSFER_H
@@ -0,0 +1,222 @@
+#ifndef DEALII_MATRIXFREE_STANDARD_FORMS_H
+#define DEALII_MATRIXFREE_STANDARD_FORMS_H
+
+#include <cfl/base/fefunctions.h>
+#include <cfl/base/forms.h>
+#include <cfl/matrixfree/fe_data.h>
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+#include <cfl/matrixfree/matrix_free_integrator.h>
+
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+/**
+ * @brief Frequently used Forms with integrators precompiled in libcfl
+ *
+ * Instantiating a MatrixFreeIntegrator instantiates the whole variadic
+ * FEDatas and Forms hierarchy which is expensive in compile time and memory.
+ * For the Forms in this namespace, the integrators are explicitly
+ * instantiated in libcfl for
+ * - dim = 2, 3,
+ * - fe_degree = 1,...,6 (the velocity degree for Stokes),
+ * - double and float.
+ *
+ * The corresponding extern template declarations at the end of this file
+ * suppress the implicit instantiation in every translation unit including
+ * it, so applications using these Forms only need to link against libcfl.
+ * This only covers the member functions which are not inline, which is why
+ * apply_add(), the local_apply*() loops and compute_diagonal() of the
+ * integrators are defined outside of their classes.
+ * A MatrixFreeIntegrator (or MatrixFreeData) benefits as long as its Forms,
+ * FEDatas and vector type are the ones defined here, i.e. the Forms have to
+ * be created by the functions below.
+ */
+namespace CFL::dealii::MatrixFree::StandardForms
+{
+/**
+ * (u, v) on the cells.
+ */
+template <int dim>
+auto
+mass_form()
+{
+  constexpr Base::TestFunction<0, dim, 0> v;
+  constexpr Base::FEFunction<0, dim, 0> u;
+  return transform(Base::form(u, v));
+}
+
+/**
+ * (grad u, grad v) on the cells.
+ */
+template <int dim>
+auto
+laplace_form()
+{
+  constexpr Base::TestFunction<0, dim, 0> v;
+  constexpr Base::FEFunction<0, dim, 0> u;
+  return transform(Base::form(grad(u), grad(v)));
+}
+
+/**
+ * The symmetric interior penalty discretization of the Laplacian with
+ * weakly imposed homogeneous Dirichlet boundary conditions and penalty
+ * parameter 1, as in matrixfree_laplace_dg.
+ */
+template <int dim>
+auto
+sipg_laplace_form()
+{
+  constexpr Base::TestFunction<0, dim, 0> v;
+  constexpr Base::TestFunctionInteriorFace<0, dim, 0> v_p;
+  constexpr Base::TestFunctionExteriorFace<0, dim, 0> v_m;
+  constexpr Base::TestNormalGradientInteriorFace<0, dim, 0> Dnv_p;
+  constexpr Base::TestNormalGradientExteriorFace<0, dim, 0> Dnv_m;
+
+  constexpr Base::FEFunction<0, dim, 0> u;
+  constexpr Base::FEFunctionInteriorFace<0, dim, 0> u_p;
+  constexpr Base::FEFunctionExteriorFace<0, dim, 0> u_m;
+  constexpr Base::FENormalGradientInteriorFace<0, dim, 0> Dnu_p;
+  constexpr Base::FENormalGradientExteriorFace<0, dim, 0> Dnu_m;
+
+  constexpr auto flux = u_p - u_m;
+  constexpr auto flux_grad = Dnu_p - Dnu_m;
+  constexpr auto flux1 = -Base::face_form(flux, Dnv_p) + Base::face_form(flux, Dnv_m);
+  constexpr auto flux2 =
+    Base::face_form(-flux + .5 * flux_grad, v_p) - Base::face_form(-flux + .5 * flux_grad, v_m);
+
+  constexpr auto boundary1 = Base::boundary_form(2. * u_p - Dnu_p, v_p);
+  constexpr auto boundary2 = -Base::boundary_form(u_p, Dnv_p);
+
+  return transform(Base::form(grad(u), grad(v)) + (-flux2 + .5 * flux1) + boundary1 + boundary2);
+}
+
+/**
+ * The Stokes operator with the symmetric gradient of the velocity (block 0)
+ * and the pressure (block 1), as in matrixfree_stokes.
+ */
+template <int dim>
+auto
+stokes_form()
+{
+  constexpr Base::TestFunction<1, dim, 0> v;
+  constexpr Base::TestFunction<0, dim, 1> q;
+  constexpr Base::FEFunction<1, dim, 0> u;
+  constexpr Base::FEFunction<0, dim, 1> p;
+  const Base::FELiftDivergence<decltype(p)> Liftp(p);
+  const Base::FESymmetricGradient<2, dim, 0> Du;
+  return transform(Base::form(Du + Liftp, grad(v)) + Base::form(div(u), q));
+}
+
+template <int dim>
+using MassForm = decltype(mass_form<dim>());
+template <int dim>
+using LaplaceForm = decltype(laplace_form<dim>());
+template <int dim>
+using SIPGLaplaceForm = decltype(sipg_laplace_form<dim>());
+template <int dim>
+using StokesForm = decltype(stokes_form<dim>());
+
+/**
+ * Continuous Q_k elements with the mass matrix.
+ */
+template <int dim, unsigned int degree, typename Number>
+struct Mass
+{
+  using FEDatasType = FEDatas<FEData<::dealii::FE_Q, degree, 1, dim, 0, degree, Number>>;
+  using FormType = MassForm<dim>;
+  using VectorType = ::dealii::LinearAlgebra::distributed::Vector<Number>;
+  using Integrator = MatrixFreeIntegrator<dim, VectorType, FormType, FEDatasType>;
+};
+
+/**
+ * Continuous Q_k elements with the Laplace operator.
+ */
+template <int dim, unsigned int degree, typename Number>
+struct Laplace
+{
+  using FEDatasType = FEDatas<FEData<::dealii::FE_Q, degree, 1, dim, 0, degree, Number>>;
+  using FormType = LaplaceForm<dim>;
+  using VectorType = ::dealii::LinearAlgebra::distributed::Vector<Number>;
+  using Integrator = MatrixFreeIntegrator<dim, VectorType, FormType, FEDatasType>;
+};
+
+/**
+ * Discontinuous Q_k elements with the symmetric interior penalty operator.
+ * The face FEData precedes the cell FEData as for
+ * <code>(fedata_face, fedata)</code>.
+ */
+template <int dim, unsigned int degree, typename Number>
+struct SIPGLaplace
+{
+  using FEDatasType = FEDatas<FEDataFace<::dealii::FE_DGQ, degree, 1, dim, 0, degree, Number>,
+                              FEData<::dealii::FE_DGQ, degree, 1, dim, 0, degree, Number>>;
+  using FormType = SIPGLaplaceForm<dim>;
+  using VectorType = ::dealii::LinearAlgebra::distributed::Vector<Number>;
+  using Integrator = MatrixFreeIntegrator<dim, VectorType, FormType, FEDatasType>;
+};
+
+/**
+ * Taylor-Hood elements Q_k^dim x Q_{k-1} with the Stokes operator. Here,
+ * <code>degree</code> is the velocity degree k >= 2.
+ */
+template <int dim, unsigned int degree, typename Number>
+struct Stokes
+{
+  static_assert(degree >= 2, "The pressure degree has to be at least one!");
+  using FEDatasType = FEDatas<FEData<::dealii::FESystem, degree, dim, dim, 0, degree, Number>,
+                              FEData<::dealii::FE_Q, degree - 1, 1, dim, 1, degree, Number>>;
+  using FormType = StokesForm<dim>;
+  using VectorType = ::dealii::LinearAlgebra::distributed::BlockVector<Number>;
+  using Integrator = MatrixFreeIntegrator<dim, VectorType, FormType, FEDatasType>;
+};
+} // namespace CFL::dealii::MatrixFree::StandardForms
+
+/**
+ * Explicit instantiation (<code>prefix</code> empty) or explicit
+ * instantiation declaration (<code>prefix</code> = extern) of the integrator
+ * for the standard form <code>Name</code>.
+ */
+#define CFL_STANDARD_FORM_INSTANTIATION(prefix, Name, dim, degree, Number)                        \
+  prefix template class MatrixFreeIntegratorBase<                                                  \
+    dim,                                                                                           \
+    CFL::dealii::MatrixFree::StandardForms::Name<dim, degree, Number>::VectorType,                 \
+    CFL::dealii::MatrixFree::StandardForms::Name<dim, degree, Number>::FormType,                   \
+    CFL::dealii::MatrixFree::StandardForms::Name<dim, degree, Number>::FEDatasType>;               \
+  prefix template class MatrixFreeIntegrator<                                                      \
+    dim,                                                                                           \
+    CFL::dealii::MatrixFree::StandardForms::Name<dim, degree, Number>::VectorType,                 \
+    CFL::dealii::MatrixFree::StandardForms::Name<dim, degree, Number>::FormType,                   \
+    CFL::dealii::MatrixFree::StandardForms::Name<dim, degree, Number>::FEDatasType>;
+
+#define CFL_STANDARD_FORM_INSTANTIATION_NUMBERS(prefix, Name, dim, degree)                        \
+  CFL_STANDARD_FORM_INSTANTIATION(prefix, Name, dim, degree, double)                               \
+  CFL_STANDARD_FORM_INSTANTIATION(prefix, Name, dim, degree, float)
+
+#define CFL_STANDARD_FORM_INSTANTIATION_DIMS(prefix, Name, degree)                                \
+  CFL_STANDARD_FORM_INSTANTIATION_NUMBERS(prefix, Name, 2, degree)                                 \
+  CFL_STANDARD_FORM_INSTANTIATION_NUMBERS(prefix, Name, 3, degree)
+
+/**
+ * All instantiations of the standard form <code>Name</code> for the degrees
+ * 1,...,6 (2,...,6 for Stokes).
+ */
+#define CFL_STANDARD_FORM_INSTANTIATIONS(prefix, Name)                                            \
+  CFL_STANDARD_FORM_INSTANTIATION_DIMS(prefix, Name, 2)                                            \
+  CFL_STANDARD_FORM_INSTANTIATION_DIMS(prefix, Name, 3)                                            \
+  CFL_STANDARD_FORM_INSTANTIATION_DIMS(prefix, Name, 4)                                            \
+  CFL_STANDARD_FORM_INSTANTIATION_DIMS(prefix, Name, 5)                                            \
+  CFL_STANDARD_FORM_INSTANTIATION_DIMS(prefix, Name, 6)
+
+CFL_STANDARD_FORM_INSTANTIATION_DIMS(extern, Mass, 1)
+CFL_STANDARD_FORM_INSTANTIATIONS(extern, Mass)
+CFL_STANDARD_FORM_INSTANTIATION_DIMS(extern, Laplace, 1)
+CFL_STANDARD_FORM_INSTANTIATIONS(extern, Laplace)
+CFL_STANDARD_FORM_INSTANTIATION_DIMS(extern, SIPGLaplace, 1)
+CFL_STANDARD_FORM_INSTANTIATIONS(extern, SIPGLaplace)
+CFL_STANDARD_FORM_INSTANTIATIONS(extern, Stokes)
+
+#endif // DEALII_MATRIXFREE_STANDARD_FORMS_H
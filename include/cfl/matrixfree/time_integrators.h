@@ -0,0 +1,401 @@
+#ifndef DEALII_MATRIXFREE_TIME_INTEGRATORS_H
+#define DEALII_MATRIXFREE_TIME_INTEGRATORS_H
+
+#include <cfl/base/traits.h>
+#include <cfl/matrixfree/fe_data.h>
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+
+#include <array>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace CFL::dealii::MatrixFree
+{
+/**
+ * @brief Cell-wise inverse of the mass matrix for discontinuous elements
+ *
+ * For discontinuous Galerkin discretizations the mass matrix is block-diagonal
+ * with one block per cell. With a collocation of the quadrature points and the
+ * nodes of the shape functions (n_q_points_1d = fe_degree + 1) the inverse of
+ * each block can be applied by sum factorization, see
+ * ::dealii::MatrixFreeOperators::CellwiseInverseMassMatrix. This class wraps
+ * that functionality for a \ref FEData object so that explicit time integrators
+ * can be written entirely in terms of CFL objects.
+ *
+ * The FEEvaluation type is taken from the FEData object, hence the quadrature
+ * with index FEData::quad_number in the MatrixFree object must be
+ * QGauss<1>(fe_degree+1). For block vectors only the block FEData::dof_number
+ * is touched, as in \ref FEDatas.
+ *
+ * <h3> Usage example </h3>
+ * <code>
+ *   FEData<FE_DGQ, 2, 1, 2, 0, 2, double> fedata(fe);
+ *   CellwiseInverseMass<decltype(fedata)> inverse_mass(fedata);
+ *   inverse_mass.initialize(matrix_free);
+ *   inverse_mass.apply(dst, src);
+ * </code>
+ */
+template <class FEData,
+          typename VectorType =
+            ::dealii::LinearAlgebra::distributed::Vector<typename FEData::NumberType>>
+class CellwiseInverseMass
+{
+public:
+  using NumberType = typename FEData::NumberType;
+  using FEEvaluationType = typename FEData::FEEvaluationType;
+  static constexpr int dim = FEData::dimension;
+  static constexpr unsigned int dof_number = FEData::dof_number;
+  static constexpr unsigned int quad_number = FEData::quad_number;
+  using InverseMassType =
+    ::dealii::MatrixFreeOperators::CellwiseInverseMassMatrix<dim, FEData::degree,
+                                                             FEData::n_fe_components, NumberType>;
+
+  explicit CellwiseInverseMass(const FEData& fe_data)
+  {
+    static_assert(CFL::Traits::is_fe_data<FEData>::value,
+                  "The inverse mass matrix is only available for cell FEData objects!");
+    static_assert(FEData::n_q_points_1d_value == FEData::degree + 1,
+                  "The cell-wise inverse mass matrix requires n_q_points_1d == fe_degree+1!");
+    AssertThrow(fe_data.fe->dofs_per_vertex == 0,
+                ::dealii::ExcMessage("The mass matrix is only block-diagonal for "
+                                     "discontinuous elements!"));
+  }
+
+  /**
+   * Store the MatrixFree object on which all subsequent loops are run.
+   * The caller has to make sure that it outlives this object.
+   */
+  void
+  initialize(const ::dealii::MatrixFree<dim, NumberType>& mf)
+  {
+    data = &mf;
+  }
+
+  const ::dealii::MatrixFree<dim, NumberType>&
+  get_matrix_free() const
+  {
+    Assert(data != nullptr, ::dealii::ExcNotInitialized());
+    return *data;
+  }
+
+  /**
+   * Compute dst = M^{-1} src.
+   */
+  void
+  apply(VectorType& dst, const VectorType& src) const
+  {
+    Assert(data != nullptr, ::dealii::ExcNotInitialized());
+    data->cell_loop(&CellwiseInverseMass::local_apply, this, dst, src);
+  }
+
+  /**
+   * Perform one stage of a low-storage Runge-Kutta scheme in a single sweep
+   * over the cells. Given the result of the spatial operator in
+   * <code>rhs</code>, this computes
+   * @f[
+   *   k \leftarrow a\,k + \Delta t\,M^{-1} \mathrm{rhs}, \qquad
+   *   u \leftarrow u + b\,k
+   * @f]
+   * cell by cell, i.e. the inverse mass matrix and both vector updates are
+   * fused into one pass over memory.
+   */
+  void
+  apply_and_update_stage(const VectorType& rhs, const NumberType a, const NumberType b,
+                         const NumberType time_step, VectorType& stage,
+                         VectorType& solution) const
+  {
+    Assert(data != nullptr, ::dealii::ExcNotInitialized());
+    const std::function<void(const ::dealii::MatrixFree<dim, NumberType>&, VectorType&,
+                             const VectorType&, const std::pair<unsigned int, unsigned int>&)>
+      kernel = [&](const ::dealii::MatrixFree<dim, NumberType>& mf, VectorType& dst,
+                   const VectorType& src, const std::pair<unsigned int, unsigned int>& cell_range) {
+        FEEvaluationType phi(mf, dof_number, quad_number);
+        FEEvaluationType phi_stage(mf, dof_number, quad_number);
+        InverseMassType inverse(phi);
+        ::dealii::AlignedVector<::dealii::VectorizedArray<NumberType>> inverse_JxW(
+          phi.n_q_points);
+        for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+        {
+          phi.reinit(cell);
+          phi.read_dof_values(get_block(src));
+          inverse.fill_inverse_JxW_values(inverse_JxW);
+          inverse.apply(
+            inverse_JxW, FEData::n_fe_components, phi.begin_dof_values(), phi.begin_dof_values());
+
+          phi_stage.reinit(cell);
+          phi_stage.read_dof_values(get_block(stage));
+          for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+            phi_stage.begin_dof_values()[i] =
+              a * phi_stage.begin_dof_values()[i] + time_step * phi.begin_dof_values()[i];
+          phi_stage.set_dof_values(get_block(stage));
+
+          // reuse phi for the solution update
+          phi.read_dof_values(get_block(dst));
+          for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+            phi.begin_dof_values()[i] += b * phi_stage.begin_dof_values()[i];
+          phi.set_dof_values(get_block(dst));
+        }
+      };
+    data->cell_loop(kernel, solution, rhs);
+  }
+
+  /**
+   * Same as apply_and_update_stage(), but the spatial operator is applied
+   * inside the same cell loop: on each cell, <code>op</code> integrates its
+   * Forms on the current solution values, the inverse mass matrix is applied
+   * to the result while it is still in the FEEvaluation object and the stage
+   * and solution vectors are updated. Compared to calling
+   * <code>op.vmult(rhs, solution)</code> first, this saves writing and
+   * reading the full <code>rhs</code> vector in every stage.
+   *
+   * This is only valid if the result of <code>op</code> on a cell only
+   * depends on the solution values of the same cell, i.e., if
+   * <code>Operator::only_cell_forms</code> is true, and if <code>op</code>
+   * works on the MatrixFree object given to initialize(). The
+   * integrated values are taken from the FEEvaluation object with
+   * FEData::fe_number in the FEDatas of <code>op</code>.
+   */
+  template <class Operator>
+  void
+  apply_operator_and_update_stage(const Operator& op, const NumberType a, const NumberType b,
+                                  const NumberType time_step, VectorType& stage,
+                                  VectorType& solution) const
+  {
+    static_assert(Operator::only_cell_forms,
+                  "The operator can only be fused into the cell loop without face terms!");
+    Assert(data != nullptr, ::dealii::ExcNotInitialized());
+    const std::function<void(const ::dealii::MatrixFree<dim, NumberType>&, VectorType&,
+                             const VectorType&, const std::pair<unsigned int, unsigned int>&)>
+      kernel = [&](const ::dealii::MatrixFree<dim, NumberType>& mf, VectorType& dst,
+                   const VectorType& src, const std::pair<unsigned int, unsigned int>& cell_range) {
+        FEEvaluationType phi(mf, dof_number, quad_number);
+        FEEvaluationType phi_stage(mf, dof_number, quad_number);
+        InverseMassType inverse(phi_stage);
+        ::dealii::AlignedVector<::dealii::VectorizedArray<NumberType>> inverse_JxW(
+          phi_stage.n_q_points);
+        op.apply_on_cells(src, cell_range, [&](const unsigned int cell, auto& fe_datas) {
+          auto rhs_values = fe_datas.template begin_dof_values<FEData::fe_number>();
+          phi_stage.reinit(cell);
+          inverse.fill_inverse_JxW_values(inverse_JxW);
+          inverse.apply(inverse_JxW, FEData::n_fe_components, rhs_values, rhs_values);
+
+          phi_stage.read_dof_values(get_block(dst));
+          for (unsigned int i = 0; i < phi_stage.dofs_per_cell; ++i)
+            phi_stage.begin_dof_values()[i] =
+              a * phi_stage.begin_dof_values()[i] + time_step * rhs_values[i];
+          phi_stage.set_dof_values(get_block(dst));
+
+          // the operator has already read the values of this cell, so the
+          // solution can be overwritten in place
+          phi.reinit(cell);
+          phi.read_dof_values(get_block(solution));
+          for (unsigned int i = 0; i < phi.dofs_per_cell; ++i)
+            phi.begin_dof_values()[i] += b * phi_stage.begin_dof_values()[i];
+          phi.set_dof_values(get_block(solution));
+        });
+      };
+    // The stage vector is the destination, so that the ghost values of the
+    // solution imported for reading are not added to their owners afterwards.
+    data->cell_loop(kernel, stage, solution);
+  }
+
+private:
+  const ::dealii::MatrixFree<dim, NumberType>* data = nullptr;
+
+  template <typename Vector>
+  static auto&
+  get_block(Vector& vector)
+  {
+    if constexpr(CFL::Traits::is_block_vector<std::remove_const_t<Vector>>::value)
+        return vector.block(dof_number);
+    else
+      return vector;
+  }
+
+  void
+  local_apply(const ::dealii::MatrixFree<dim, NumberType>& mf, VectorType& dst,
+              const VectorType& src, const std::pair<unsigned int, unsigned int>& cell_range) const
+  {
+    FEEvaluationType phi(mf, dof_number, quad_number);
+    InverseMassType inverse(phi);
+    ::dealii::AlignedVector<::dealii::VectorizedArray<NumberType>> inverse_JxW(phi.n_q_points);
+    for (unsigned int cell = cell_range.first; cell < cell_range.second; ++cell)
+    {
+      phi.reinit(cell);
+      phi.read_dof_values(get_block(src));
+      inverse.fill_inverse_JxW_values(inverse_JxW);
+      inverse.apply(
+        inverse_JxW, FEData::n_fe_components, phi.begin_dof_values(), phi.begin_dof_values());
+      phi.set_dof_values(get_block(dst));
+    }
+  }
+};
+
+namespace internal
+{
+// true if Operator::only_cell_forms exists and is true
+template <class Operator, class Enable = void>
+struct only_cell_forms : std::false_type
+{
+};
+
+template <class Operator>
+struct only_cell_forms<Operator, std::enable_if_t<Operator::only_cell_forms>> : std::true_type
+{
+};
+}
+
+/**
+ * The available low-storage explicit Runge-Kutta schemes. All of them only need
+ * two registers per solution vector (Williamson's 2N form), plus one vector
+ * for the result of the spatial operator if it contains face terms.
+ */
+enum class LowStorageRungeKuttaScheme
+{
+  /// Three stages, third order (Williamson 1980)
+  williamson_33,
+  /// Five stages, fourth order (Carpenter and Kennedy 1994)
+  carpenter_kennedy_54
+};
+
+/**
+ * @brief Low-storage explicit Runge-Kutta time integrator
+ *
+ * Integrates M du/dt = L(u) where M is the block-diagonal DG mass matrix and
+ * the operator L is given by any object providing
+ * <code>vmult(VectorType& dst, const VectorType& src)</code>, typically a
+ * MatrixFreeIntegrator built from CFL Forms. If the operator only contains
+ * cell Forms (<code>Operator::only_cell_forms</code>, available for
+ * MatrixFreeIntegrator), each stage is a single cell loop that applies the
+ * operator and the inverse mass matrix and updates the stage and solution
+ * vectors, see CellwiseInverseMass::apply_operator_and_update_stage(). This
+ * reads the solution and stage vectors and writes them back once per stage.
+ *
+ * Operators with face or boundary Forms need all faces of a cell before its
+ * result is complete and read the neighbors' solution values, so the solution
+ * cannot be updated inside their loop. Then each stage consists of
+ * - one application of the operator (a single MatrixFree::loop over cells and faces)
+ * - one cell loop applying the inverse mass matrix and updating the stage and
+ *   solution vectors, see CellwiseInverseMass::apply_and_update_stage().
+ *
+ * which costs one more write and read of a full vector (the operator result)
+ * per stage, plus the storage for it.
+ *
+ * The operator has to be autonomous, i.e., it may not depend on time
+ * explicitly, since Forms do not carry a notion of time.
+ */
+template <class FEData,
+          typename VectorType =
+            ::dealii::LinearAlgebra::distributed::Vector<typename FEData::NumberType>>
+class LowStorageRungeKutta
+{
+public:
+  using NumberType = typename FEData::NumberType;
+
+  explicit LowStorageRungeKutta(const LowStorageRungeKuttaScheme scheme =
+                                  LowStorageRungeKuttaScheme::carpenter_kennedy_54)
+  {
+    switch (scheme)
+    {
+      case LowStorageRungeKuttaScheme::williamson_33:
+        a = { 0., -5. / 9., -153. / 128. };
+        b = { 1. / 3., 15. / 16., 8. / 15. };
+        c = { 0., 1. / 3., 3. / 4. };
+        break;
+      case LowStorageRungeKuttaScheme::carpenter_kennedy_54:
+        a = { 0.,
+              -567301805773. / 1357537059087.,
+              -2404267990393. / 2016746695238.,
+              -3550918686646. / 2091501179385.,
+              -1275806237668. / 842570457699. };
+        b = { 1432997174477. / 9575080441755.,
+              5161836677717. / 13612068292357.,
+              1720146321549. / 2090206949498.,
+              3134564353537. / 4481467310338.,
+              2277821191437. / 14882151754819. };
+        c = { 0.,
+              1432997174477. / 9575080441755.,
+              2526269341429. / 6820363962896.,
+              2006345519317. / 3224310063776.,
+              2802321613138. / 2924317926251. };
+        break;
+      default:
+        AssertThrow(false, ::dealii::ExcNotImplemented());
+    }
+  }
+
+  unsigned int
+  n_stages() const
+  {
+    return a.size();
+  }
+
+  /**
+   * Allocate the stage vector with the layout of <code>solution</code>. The
+   * vector for the operator result is only allocated by perform_time_step()
+   * if the operator contains face terms.
+   */
+  void
+  reinit(const VectorType& solution)
+  {
+    stage.reinit(solution);
+  }
+
+  /**
+   * Advance <code>solution</code> by one time step of size
+   * <code>time_step</code> and return the new time.
+   */
+  template <class Operator>
+  double
+  perform_time_step(const Operator& op,
+                    const CellwiseInverseMass<FEData, VectorType>& inverse_mass,
+                    const double current_time, const double time_step,
+                    VectorType& solution) const
+  {
+    AssertDimension(stage.size(), solution.size());
+    stage = NumberType(0.);
+    if constexpr(internal::only_cell_forms<Operator>::value)
+      {
+        for (unsigned int s = 0; s < n_stages(); ++s)
+          inverse_mass.apply_operator_and_update_stage(op, a[s], b[s], time_step, stage,
+                                                       solution);
+      }
+    else
+    {
+      if (rhs.size() != solution.size())
+        rhs.reinit(solution);
+      for (unsigned int s = 0; s < n_stages(); ++s)
+      {
+        op.vmult(rhs, solution);
+        inverse_mass.apply_and_update_stage(rhs, a[s], b[s], time_step, stage, solution);
+      }
+    }
+    return current_time + time_step;
+  }
+
+  /**
+   * The intermediate stage times c_s for the given scheme.
+   */
+  const std::vector<double>&
+  get_stage_times() const
+  {
+    return c;
+  }
+
+private:
+  std::vector<double> a;
+  std::vector<double> b;
+  std::vector<double> c;
+  mutable VectorType stage;
+  mutable VectorType rhs;
+};
+}
+
+#endif // DEALII_MATRIXFREE_TIME_INTEGRATORS_H
@@ -0,0 +1,462 @@
+#ifndef DEALII_MATRIXFREE_TRACE_H
+#define DEALII_MATRIXFREE_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef CFL_TRACE_BUFFER_SIZE
+#define CFL_TRACE_BUFFER_SIZE 65536
+#endif
+
+/**
+ * @brief Tracing of the operations in the cell, face and quadrature point loops
+ *
+ * FEDatas, the test functions, Forms and MatrixFreeIntegrator report what
+ * they do with CFL_TRACE_EVENT(phase, fe_number, q, flags), where phase is
+ * a Trace::Phase. What happens with the events is chosen when compiling:
+ * - by default, CFL_TRACE_EVENT expands to nothing and its arguments are
+ *   not evaluated,
+ * - with DEBUG_OUTPUT defined, every event is printed to std::cout at once,
+ * - with CFL_TRACE defined, every event is stored in a ring buffer of the
+ *   calling thread which keeps the last CFL_TRACE_BUFFER_SIZE events. The
+ *   buffers are written with Trace::Recorder::write() and printed with the
+ *   trace_decoder application.
+ *
+ * CFL_TRACE is best set for the whole project with the CMake option of the
+ * same name, such that all translation units record events.
+ *
+ * Buffered events take 12 bytes and contain the phase, the fe_number, the
+ * quadrature point, the cell or face batch set by CFL_TRACE_BATCH(batch)
+ * and up to three flags, e.g. which of values, gradients and hessians are
+ * evaluated. Recording an event costs a few stores, no locks and no
+ * output, such that large runs can be traced.
+ */
+namespace CFL::dealii::MatrixFree::Trace
+{
+enum class Phase : std::uint8_t
+{
+  begin_cell_loop,
+  end_cell_loop,
+  begin_face_loop,
+  end_face_loop,
+  begin_boundary_loop,
+  end_boundary_loop,
+  reinit_cell,
+  reinit_face,
+  reinit_boundary,
+  read_cell,
+  read_face,
+  distribute_cell,
+  distribute_face,
+  evaluate_cell,
+  evaluate_face,
+  integrate_cell,
+  integrate_face,
+  integrate_face_exterior,
+  get_value,
+  get_face_value,
+  get_gradient,
+  get_normal_derivative,
+  get_symmetric_gradient,
+  get_divergence,
+  get_laplacian,
+  get_hessian_diagonal,
+  get_hessian,
+  submit_value,
+  submit_face_value,
+  submit_gradient,
+  submit_normal_derivative,
+  submit_symmetric_gradient,
+  submit_divergence,
+  submit_curl,
+  test_function,
+  test_gradient,
+  test_divergence,
+  test_symmetric_gradient,
+  test_curl,
+  test_function_interior_face,
+  test_function_exterior_face,
+  test_normal_gradient_interior_face,
+  test_normal_gradient_exterior_face,
+  expect_value,
+  expect_submit,
+  n_phases
+};
+
+struct Event
+{
+  std::uint32_t batch;
+  std::uint16_t q;
+  std::uint16_t thread;
+  Phase phase;
+  std::uint8_t fe_number;
+  std::uint8_t flags;
+  std::uint8_t padding;
+};
+
+static_assert(sizeof(Event) == 12, "Trace events should be compact!");
+
+namespace internal
+{
+  /// Which fields of an Event are printed after the name of its phase
+  enum class Fields
+  {
+    none,
+    fe_number,
+    fe_number_q,
+    fe_number_q_flag,
+    fe_number_two_flags,
+    fe_number_three_flags
+  };
+
+  struct PhaseDescription
+  {
+    const char* name;
+    Fields fields;
+  };
+
+  inline const PhaseDescription&
+  describe(Phase phase)
+  {
+    static const PhaseDescription descriptions[] = {
+      { "Begin cell loop", Fields::none },
+      { "End cell loop", Fields::none },
+      { "Begin face loop", Fields::none },
+      { "End face loop", Fields::none },
+      { "Begin boundary loop", Fields::none },
+      { "End boundary loop", Fields::none },
+      { "Reinit cell FEDatas", Fields::fe_number },
+      { "Reinit face FEDatas", Fields::fe_number },
+      { "Reinit boundary FEDatas", Fields::fe_number },
+      { "Read cell DoF values", Fields::fe_number },
+      { "Read face DoF values", Fields::fe_number_two_flags },
+      { "Distribute cell DoF values", Fields::fe_number },
+      { "Distribute face DoF values", Fields::fe_number_two_flags },
+      { "Evaluate cell FEDatas", Fields::fe_number_three_flags },
+      { "Evaluate face FEDatas", Fields::fe_number_three_flags },
+      { "integrate cell FEDatas", Fields::fe_number_two_flags },
+      { "integrate face FEDatas", Fields::fe_number_two_flags },
+      { "integrate face exterior FEDatas", Fields::fe_number_two_flags },
+      { "get value FEDatas", Fields::fe_number_q },
+      { "get face value FEDatas", Fields::fe_number_q_flag },
+      { "get gradient FEDatas", Fields::fe_number_q },
+      { "get normal gradient FEDatas", Fields::fe_number_q_flag },
+      { "get symmetric gradient FEDatas", Fields::fe_number_q },
+      { "get divergence FEDatas", Fields::fe_number_q },
+      { "get laplacian FEDatas", Fields::fe_number_q },
+      { "get hessian_diagonal FEDatas", Fields::fe_number_q },
+      { "get hessian FEDatas", Fields::fe_number_q },
+      { "submit value FEDatas", Fields::fe_number_q },
+      { "submit face value FEDatas", Fields::fe_number_q_flag },
+      { "submit gradient FEDatas", Fields::fe_number_q },
+      { "submit normal gradient FEDatas", Fields::fe_number_q_flag },
+      { "submit symmetric gradient FEDatas", Fields::fe_number_q },
+      { "submit divergence FEDatas", Fields::fe_number_q },
+      { "submit curl FEDatas", Fields::fe_number_q },
+      { "submit TestFunction", Fields::fe_number_q },
+      { "submit TestGradient", Fields::fe_number_q },
+      { "submit TestDivergence", Fields::fe_number_q },
+      { "submit TestSymmetricGradient", Fields::fe_number_q },
+      { "submit TestCurl", Fields::fe_number_q },
+      { "submit TestFunctionInteriorFace", Fields::fe_number_q },
+      { "submit TestFunctionExteriorFace", Fields::fe_number_q },
+      { "submit TestNormalGradientInteriorFace", Fields::fe_number_q },
+      { "submit TestNormalGradientExteriorFace", Fields::fe_number_q },
+      { "expecting value from fe_number", Fields::fe_number },
+      { "expecting submit from fe_number", Fields::fe_number }
+    };
+    static_assert(sizeof(descriptions) / sizeof(descriptions[0]) ==
+                    static_cast<std::size_t>(Phase::n_phases),
+                  "Every phase needs a description!");
+    if (phase >= Phase::n_phases)
+      throw std::invalid_argument("Unknown trace phase " + std::to_string(int(phase)));
+    return descriptions[static_cast<std::size_t>(phase)];
+  }
+} // namespace internal
+
+/**
+ * Print the event without its batch and thread, in the format used with
+ * DEBUG_OUTPUT.
+ */
+inline void
+print(std::ostream& out, const Event& event)
+{
+  const internal::PhaseDescription& description = internal::describe(event.phase);
+  out << description.name;
+  const auto flag = [&](unsigned int i) { return (event.flags >> i) & 1u; };
+  switch (description.fields)
+  {
+    case internal::Fields::none:
+      break;
+    case internal::Fields::fe_number:
+      out << " " << unsigned(event.fe_number);
+      break;
+    case internal::Fields::fe_number_q:
+      out << " " << unsigned(event.fe_number) << " " << event.q;
+      break;
+    case internal::Fields::fe_number_q_flag:
+      out << " " << unsigned(event.fe_number) << " " << event.q << " " << flag(0);
+      break;
+    case internal::Fields::fe_number_two_flags:
+      out << " " << unsigned(event.fe_number) << " " << flag(0) << " " << flag(1);
+      break;
+    case internal::Fields::fe_number_three_flags:
+      out << " " << unsigned(event.fe_number) << " " << flag(0) << " " << flag(1) << " "
+          << flag(2);
+      break;
+  }
+}
+
+/**
+ * The flags of an event from up to three booleans.
+ */
+constexpr std::uint8_t
+flags(bool first, bool second = false, bool third = false)
+{
+  return std::uint8_t(first) | (std::uint8_t(second) << 1) | (std::uint8_t(third) << 2);
+}
+
+/**
+ * The last <code>capacity</code> events of one thread.
+ */
+class RingBuffer
+{
+public:
+  RingBuffer(std::uint16_t thread, std::size_t capacity)
+    : thread(thread)
+    , events(capacity)
+  {
+  }
+
+  void
+  push(Phase phase, unsigned int fe_number, unsigned int q, std::uint8_t flags)
+  {
+    events[position] = { batch,
+                         static_cast<std::uint16_t>(q),
+                         thread,
+                         phase,
+                         static_cast<std::uint8_t>(fe_number),
+                         flags,
+                         0 };
+    if (++position == events.size())
+      position = 0;
+    ++n_recorded;
+  }
+
+  /// The events still in the buffer, the oldest first
+  std::vector<Event>
+  chronological() const
+  {
+    if (n_recorded < events.size())
+      return std::vector<Event>(events.begin(), events.begin() + position);
+    std::vector<Event> result(events.begin() + position, events.end());
+    result.insert(result.end(), events.begin(), events.begin() + position);
+    return result;
+  }
+
+  void
+  clear()
+  {
+    position = 0;
+    n_recorded = 0;
+  }
+
+  const std::uint16_t thread;
+  /// The batch of the following events, see CFL_TRACE_BATCH
+  std::uint32_t batch = 0;
+  /// The number of events recorded, including the ones overwritten
+  std::uint64_t n_recorded = 0;
+
+private:
+  std::vector<Event> events;
+  std::size_t position = 0;
+};
+
+/**
+ * The events of one thread read from a trace file.
+ */
+struct ThreadTrace
+{
+  std::uint16_t thread;
+  std::uint64_t n_recorded;
+  std::vector<Event> events;
+};
+
+/**
+ * Owns the ring buffers of all threads. Each thread registers its buffer
+ * with its first event, which is the only time a lock is taken.
+ */
+class Recorder
+{
+public:
+  static Recorder&
+  instance()
+  {
+    static Recorder recorder;
+    return recorder;
+  }
+
+  RingBuffer&
+  buffer()
+  {
+    thread_local RingBuffer* local = nullptr;
+    if (local == nullptr)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      buffers.push_back(std::make_unique<RingBuffer>(static_cast<std::uint16_t>(buffers.size()),
+                                                     CFL_TRACE_BUFFER_SIZE));
+      local = buffers.back().get();
+    }
+    return *local;
+  }
+
+  /**
+   * Write the buffers of all threads to <code>filename</code>. No thread
+   * may record events meanwhile. The file starts with "CFLTRACE" and the
+   * version, followed by the number of threads and, for every thread, its
+   * index, the number of recorded events, the number of events in the
+   * file and the events in the byte order of the machine.
+   */
+  void
+  write(const std::string& filename) const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ofstream file(filename, std::ios::binary);
+    file.write(magic, sizeof(magic));
+    write_value(file, version);
+    write_value(file, static_cast<std::uint32_t>(buffers.size()));
+    for (const auto& buffer : buffers)
+    {
+      const std::vector<Event> events = buffer->chronological();
+      write_value(file, buffer->thread);
+      write_value(file, buffer->n_recorded);
+      write_value(file, static_cast<std::uint64_t>(events.size()));
+      file.write(reinterpret_cast<const char*>(events.data()), events.size() * sizeof(Event));
+    }
+    if (!file)
+      throw std::runtime_error("Cannot write the trace file " + filename);
+  }
+
+  /**
+   * Read a file written by write().
+   */
+  static std::vector<ThreadTrace>
+  read(const std::string& filename)
+  {
+    std::ifstream file(filename, std::ios::binary);
+    char header[sizeof(magic)];
+    file.read(header, sizeof(header));
+    std::uint32_t file_version = 0, n_threads = 0;
+    read_value(file, file_version);
+    read_value(file, n_threads);
+    if (!file || std::string(header, sizeof(header)) != std::string(magic, sizeof(magic)) ||
+        file_version != version)
+      throw std::runtime_error(filename + " is not a trace file of this version!");
+
+    std::vector<ThreadTrace> threads(n_threads);
+    for (auto& thread : threads)
+    {
+      std::uint64_t n_events = 0;
+      read_value(file, thread.thread);
+      read_value(file, thread.n_recorded);
+      read_value(file, n_events);
+      thread.events.resize(n_events);
+      file.read(reinterpret_cast<char*>(thread.events.data()), n_events * sizeof(Event));
+    }
+    if (!file)
+      throw std::runtime_error("The trace file " + filename + " is truncated!");
+    return threads;
+  }
+
+  /// Discard the events of all threads
+  void
+  clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& buffer : buffers)
+      buffer->clear();
+  }
+
+private:
+  Recorder() = default;
+
+  template <typename T>
+  static void
+  write_value(std::ostream& out, const T& value)
+  {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  static void
+  read_value(std::istream& in, T& value)
+  {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+
+  static constexpr char magic[8] = { 'C', 'F', 'L', 'T', 'R', 'A', 'C', 'E' };
+  static constexpr std::uint32_t version = 1;
+
+  mutable std::mutex mutex;
+  std::vector<std::unique_ptr<RingBuffer>> buffers;
+};
+
+/**
+ * Print every event to std::cout at once, used with DEBUG_OUTPUT.
+ */
+struct PrintPolicy
+{
+  static void
+  record(Phase phase, unsigned int fe_number = 0, unsigned int q = 0, std::uint8_t flags = 0)
+  {
+    print(std::cout, { 0, static_cast<std::uint16_t>(q), 0, phase,
+                       static_cast<std::uint8_t>(fe_number), flags, 0 });
+    std::cout << std::endl;
+  }
+
+  static void
+  set_batch(unsigned int)
+  {
+  }
+};
+
+/**
+ * Store every event in the ring buffer of the calling thread, used with
+ * CFL_TRACE.
+ */
+struct BufferPolicy
+{
+  static void
+  record(Phase phase, unsigned int fe_number = 0, unsigned int q = 0, std::uint8_t flags = 0)
+  {
+    Recorder::instance().buffer().push(phase, fe_number, q, flags);
+  }
+
+  static void
+  set_batch(unsigned int batch)
+  {
+    Recorder::instance().buffer().batch = batch;
+  }
+};
+} // namespace CFL::dealii::MatrixFree::Trace
+
+#if defined(CFL_TRACE)
+#define CFL_TRACE_EVENT(...) ::CFL::dealii::MatrixFree::Trace::BufferPolicy::record(__VA_ARGS__)
+#define CFL_TRACE_BATCH(batch) ::CFL::dealii::MatrixFree::Trace::BufferPolicy::set_batch(batch)
+#elif defined(DEBUG_OUTPUT)
+#define CFL_TRACE_EVENT(...) ::CFL::dealii::MatrixFree::Trace::PrintPolicy::record(__VA_ARGS__)
+#define CFL_TRACE_BATCH(batch) ::CFL::dealii::MatrixFree::Trace::PrintPolicy::set_batch(batch)
+#else
+#define CFL_TRACE_EVENT(...) static_cast<void>(0)
+#define CFL_TRACE_BATCH(batch) static_cast<void>(0)
+#endif
+
+#endif // DEALII_MATRIXFREE_TRACE_H
@@ -0,0 +1,127 @@
+#ifndef MESHWORKER_COLORED_LOOP_H
+#define MESHWORKER_COLORED_LOOP_H
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/graph_coloring.h>
+#include <deal.II/base/work_stream.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/affine_constraints.h>
+#include <deal.II/meshworker/dof_info.h>
+#include <deal.II/meshworker/integration_info.h>
+#include <deal.II/meshworker/local_integrator.h>
+#include <deal.II/meshworker/loop.h>
+
+#include <functional>
+#include <vector>
+
+namespace CFL::dealii::MeshWorker
+{
+/**
+ * Partition the active cells of <code>dof_handler</code> into colors such
+ * that no two cells of one color share a degree of freedom. If
+ * <code>include_neighbors</code> is true, the degrees of freedom of the
+ * neighbors across faces count as well, which is needed when face terms are
+ * integrated, since a face writes to the cells on both sides.
+ *
+ * If the assembler distributes the local results with
+ * <code>constraints</code>, e.g. hanging node constraints, it also writes to
+ * the degrees of freedom these are constrained to. Pass the constraints in
+ * this case, so that they count as well.
+ */
+template <int dim>
+std::vector<std::vector<typename ::dealii::DoFHandler<dim>::active_cell_iterator>>
+make_coloring(const ::dealii::DoFHandler<dim>& dof_handler, bool include_neighbors,
+              const ::dealii::AffineConstraints<double>* constraints = nullptr)
+{
+  using Iterator = typename ::dealii::DoFHandler<dim>::active_cell_iterator;
+
+  const auto add_dof_indices = [](const auto& cell,
+                                  std::vector<::dealii::types::global_dof_index>& indices) {
+    std::vector<::dealii::types::global_dof_index> cell_indices(cell->get_fe().dofs_per_cell);
+    cell->get_dof_indices(cell_indices);
+    indices.insert(indices.end(), cell_indices.begin(), cell_indices.end());
+  };
+
+  const std::function<std::vector<::dealii::types::global_dof_index>(const Iterator&)>
+    conflict_indices = [include_neighbors, constraints, &add_dof_indices](const Iterator& cell) {
+      std::vector<::dealii::types::global_dof_index> indices;
+      add_dof_indices(cell, indices);
+      if (include_neighbors)
+        for (unsigned int f = 0; f < ::dealii::GeometryInfo<dim>::faces_per_cell; ++f)
+        {
+          if (cell->at_boundary(f))
+            continue;
+          if (cell->neighbor(f)->has_children())
+            for (unsigned int s = 0; s < cell->face(f)->n_children(); ++s)
+              add_dof_indices(cell->neighbor_child_on_subface(f, s), indices);
+          else
+            add_dof_indices(cell->neighbor(f), indices);
+        }
+      if (constraints != nullptr)
+        constraints->resolve_indices(indices);
+      return indices;
+    };
+
+  return ::dealii::GraphColoring::make_graph_coloring(
+    dof_handler.begin_active(), Iterator(dof_handler.end()), conflict_indices);
+}
+
+/**
+ * Same as ::dealii::MeshWorker::integration_loop(), but the cells are
+ * processed color by color as computed by make_coloring().
+ *
+ * Every thread works on its own copy of <code>info_box</code> and of the
+ * local data built from <code>dof_info</code>, and the integrators only read
+ * their Forms, so the local integration is thread-safe. Since cells of one
+ * color do not share degrees of freedom, the local results are also added
+ * to the global vector or matrix in parallel without locks.
+ */
+template <int dim, class Iterator, class Assembler>
+void
+colored_integration_loop(const std::vector<std::vector<Iterator>>& colored_cells,
+                         ::dealii::MeshWorker::DoFInfo<dim>& dof_info,
+                         ::dealii::MeshWorker::IntegrationInfoBox<dim>& info_box,
+                         const ::dealii::MeshWorker::LocalIntegrator<dim>& integrator,
+                         Assembler& assembler,
+                         const ::dealii::MeshWorker::LoopControl& loop_control =
+                           ::dealii::MeshWorker::LoopControl())
+{
+  using DoFInfo = ::dealii::MeshWorker::DoFInfo<dim>;
+  using DoFInfoBox = ::dealii::MeshWorker::DoFInfoBox<dim, DoFInfo>;
+  using InfoBox = ::dealii::MeshWorker::IntegrationInfoBox<dim>;
+  using CellInfo = typename InfoBox::CellInfo;
+
+  std::function<void(DoFInfo&, CellInfo&)> cell_worker;
+  std::function<void(DoFInfo&, CellInfo&)> boundary_worker;
+  std::function<void(DoFInfo&, DoFInfo&, CellInfo&, CellInfo&)> face_worker;
+  if (integrator.use_cell)
+    cell_worker = [&integrator](DoFInfo& dinfo, CellInfo& info) { integrator.cell(dinfo, info); };
+  if (integrator.use_boundary)
+    boundary_worker = [&integrator](DoFInfo& dinfo, CellInfo& info) {
+      integrator.boundary(dinfo, info);
+    };
+  if (integrator.use_face)
+    face_worker = [&integrator](DoFInfo& dinfo1, DoFInfo& dinfo2, CellInfo& info1,
+                                CellInfo& info2) { integrator.face(dinfo1, dinfo2, info1, info2); };
+
+  DoFInfoBox dof_info_box(dof_info);
+  assembler.initialize_info(dof_info_box.cell, false);
+  for (unsigned int f = 0; f < ::dealii::GeometryInfo<dim>::faces_per_cell; ++f)
+  {
+    assembler.initialize_info(dof_info_box.interior[f], true);
+    assembler.initialize_info(dof_info_box.exterior[f], true);
+  }
+
+  ::dealii::WorkStream::run(
+    colored_cells,
+    [&](const Iterator& cell, InfoBox& info, DoFInfoBox& dinfo) {
+      ::dealii::MeshWorker::cell_action<InfoBox, DoFInfo, dim, dim>(
+        cell, dinfo, info, cell_worker, boundary_worker, face_worker, loop_control);
+    },
+    [&assembler](const DoFInfoBox& dinfo) { dinfo.assemble(assembler); },
+    info_box,
+    dof_info_box);
+}
+} // namespace CFL::dealii::MeshWorker
+
+#endif
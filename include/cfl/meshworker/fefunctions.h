@@ -2,6 +2,8 @@
 #define cfl_dealii_meshworker_h
 
 #include <cfl/meshworker/forms.h>
+#include <cfl/meshworker/quadrature_data.h>
+#include <cfl/base/fefunctions.h>
 #include <cfl/base/traits.h>
 
 #include <deal.II/meshworker/dof_info.h>
@@ -50,12 +52,39 @@ namespace dealii
       unsigned int block_index;
     };
 
+    /**
+     * The trial functions of a finite element function are characterized
+     * in the same way as test functions.
+     */
+    using TrialFunctionIdentifier = TestFunctionIdentifier;
+
+    /**
+     * A shape function of the trial space in a cell matrix, identified by
+     * its index and the block of the matrix column it belongs to.
+     *
+     * Passing this object to the <code>value()</code> function of an
+     * expression which is linear in finite element functions yields the
+     * expression with the finite element function replaced by this shape
+     * function. Finite element functions in other blocks are zero.
+     */
+    struct TrialShapeFunction
+    {
+      /// The index of the shape function in the block
+      unsigned int index;
+      /// The block in the finite element system the shape function belongs to
+      unsigned int block_index;
+      /// Whether the shape function belongs to the exterior cell of a face
+      bool exterior = false;
+    };
+
     template <int order, int dim>
     class TestFunction;
     template <int order, int dim>
     class TestGradient;
     template <int order, int dim>
     class TestHessian;
+    template <int order, int dim>
+    class TestSymmetricGradient;
 
     template <int order, int dim>
     class FEFunction;
@@ -63,6 +92,13 @@ namespace dealii
     class FEGradient;
     template <int order, int dim>
     class FEHessian;
+    template <int order, int dim>
+    class FESymmetricGradient;
+
+    template <int order, int dim, bool exterior, bool normal_gradient>
+    class TestFunctionFace;
+    template <int order, int dim, bool exterior, bool normal_gradient>
+    class FEFunctionFace;
   }
 }
 
@@ -86,6 +122,18 @@ namespace Traits
     static const ObjectType value = ObjectType::cell;
   };
 
+  template <int order, int dim>
+  struct test_function_set_type<dealii::MeshWorker::TestSymmetricGradient<order, dim>>
+  {
+    static const ObjectType value = ObjectType::cell;
+  };
+
+  template <int order, int dim>
+  struct is_symmetric<dealii::MeshWorker::TestSymmetricGradient<order, dim>>
+  {
+    static constexpr bool value = true;
+  };
+
   template <int order, int dim>
   struct fe_function_set_type<dealii::MeshWorker::FEFunction<order, dim>>
   {
@@ -103,6 +151,32 @@ namespace Traits
   {
     static const ObjectType value = ObjectType::cell;
   };
+
+  template <int order, int dim>
+  struct fe_function_set_type<dealii::MeshWorker::FESymmetricGradient<order, dim>>
+  {
+    static const ObjectType value = ObjectType::cell;
+  };
+
+  template <int order, int dim>
+  struct is_symmetric<dealii::MeshWorker::FESymmetricGradient<order, dim>>
+  {
+    static constexpr bool value = true;
+  };
+
+  template <int order, int dim, bool exterior, bool normal_gradient>
+  struct test_function_set_type<
+    dealii::MeshWorker::TestFunctionFace<order, dim, exterior, normal_gradient>>
+  {
+    static const ObjectType value = ObjectType::face;
+  };
+
+  template <int order, int dim, bool exterior, bool normal_gradient>
+  struct fe_function_set_type<
+    dealii::MeshWorker::FEFunctionFace<order, dim, exterior, normal_gradient>>
+  {
+    static const ObjectType value = ObjectType::face;
+  };
 }
 
 namespace dealii
@@ -117,6 +191,7 @@ namespace dealii
 
       friend class TestGradient<order, dim>;
       friend class TestHessian<order, dim>;
+      friend class TestSymmetricGradient<order, dim>;
 
     public:
       /// Remove after reducing Forms
@@ -135,7 +210,7 @@ namespace dealii
       }
 
       double
-      value(unsigned int test_index, const ::dealii::MeshWorker::IntegrationInfo<dim, dim>& ii,
+      value(unsigned int test_index, const QuadratureData<dim>& ii,
             unsigned int quadrature_index) const
       {
         static_assert(order == 0, "Tensor test function used without tensor coordinate");
@@ -144,7 +219,7 @@ namespace dealii
 
       double
       value(unsigned int d, unsigned int test_index,
-            const ::dealii::MeshWorker::IntegrationInfo<dim, dim>& ii,
+            const QuadratureData<dim>& ii,
             unsigned int quadrature_index) const
       {
         static_assert(order == 1, "Tensor order and number of tensor coordinates do not match");
@@ -176,7 +251,7 @@ namespace dealii
 
       double
       value(int d, unsigned int test_index,
-            const ::dealii::MeshWorker::IntegrationInfo<dim, dim>& ii,
+            const QuadratureData<dim>& ii,
             unsigned int quadrature_index) const
       {
         static_assert(order == 0, "Tensor order and number of tensor coordinates do not match");
@@ -185,7 +260,7 @@ namespace dealii
 
       double
       value(int d1, int d2, unsigned int test_index,
-            const ::dealii::MeshWorker::IntegrationInfo<dim, dim>& ii,
+            const QuadratureData<dim>& ii,
             unsigned int quadrature_index) const
       {
         static_assert(order == 1, "Tensor order and number of tensor coordinates do not match");
@@ -222,7 +297,7 @@ namespace dealii
 
       double
       value(int d1, int d2, unsigned int test_index,
-            const ::dealii::MeshWorker::IntegrationInfo<dim, dim>& ii,
+            const QuadratureData<dim>& ii,
             unsigned int quadrature_index) const
       {
         static_assert(order == 0, "Tensor order and number of tensor coordinates do not match");
@@ -244,39 +319,133 @@ namespace dealii
       return TestHessian<order, dim>(func);
     }
 
+    /**
+     * The symmetric part of the gradient of a vector valued test function,
+     * \f$ \tfrac12(\partial_i v_j + \partial_j v_i) \f$. Forms with this test
+     * function are evaluated only for the independent components.
+     */
+    template <int order, int dim>
+    class TestSymmetricGradient
+    {
+      const TestFunction<order, dim>& base;
+
+    public:
+      /// Remove after reducing Forms
+      static const bool integration_flags = false;
+      typedef Traits::Tensor<order + 1, dim> TensorTraits;
+
+      TestSymmetricGradient(const TestFunction<order, dim>& base)
+        : base{ base }
+      {
+        static_assert(order == 1, "The symmetric gradient is only defined for vector fields");
+      }
+
+      constexpr TestFunctionIdentifier
+      id() const
+      {
+        return base.ident;
+      }
+
+      double
+      value(int d1, int d2, unsigned int test_index, const QuadratureData<dim>& ii,
+            unsigned int quadrature_index) const
+      {
+        const auto& fe_values = ii.fe_values(id().fe_index);
+        return .5 * (fe_values.shape_grad_component(test_index, quadrature_index, d2)[d1] +
+                     fe_values.shape_grad_component(test_index, quadrature_index, d1)[d2]);
+      }
+    };
+
+    template <int order, int dim>
+    TestSymmetricGradient<order, dim>
+    symmetric_grad(const TestFunction<order, dim>& func)
+    {
+      return TestSymmetricGradient<order, dim>(func);
+    }
+
     template <int order, int dim>
     class FEFunction
     {
       const unsigned int data_index;
       const unsigned int first_component;
+      /// The trial functions used when assembling matrices
+      const TrialFunctionIdentifier trial;
 
       friend class FEGradient<order, dim>;
       friend class FEHessian<order, dim>;
+      friend class FESymmetricGradient<order, dim>;
+
+      /**
+       * The FEValues object providing the trial functions if
+       * <code>shape_function</code> belongs to the block of this function
+       * and nullptr otherwise.
+       */
+      const ::dealii::FEValuesBase<dim>*
+      trial_fe_values(const TrialShapeFunction& shape_function,
+                      const QuadratureData<dim>& info) const
+      {
+        if (shape_function.block_index != trial.block_index)
+          return nullptr;
+        return &info.fe_values(trial.fe_index);
+      }
 
     public:
       typedef Traits::Tensor<order, dim> TensorTraits;
 
-      FEFunction(const unsigned int data_index, const unsigned int first)
+      /**
+       * The finite element function with the components starting at
+       * <code>first</code> of the input vector <code>data_index</code>. For
+       * matrix assembly, the trial functions are the shape functions of the
+       * FEValues object <code>fe_index</code>, associated with the block
+       * <code>block_index</code>.
+       */
+      FEFunction(const unsigned int data_index, const unsigned int first,
+                 const unsigned int fe_index = 0, const unsigned int block_index = 0)
         : data_index(data_index)
         , first_component(first)
+        , trial{ fe_index, block_index }
       {
       }
 
       double
-      value(const IntegrationInfo<dim, dim>& info, unsigned int quadrature_index) const
+      value(const QuadratureData<dim>& info, unsigned int quadrature_index) const
       {
         static_assert(order == 0, "Scalar used with tensor coordinate");
         Assert(data_index != ::dealii::numbers::invalid_unsigned_int, ::dealii::ExcInternalError());
-        return info.values[data_index][first_component][quadrature_index];
+        return info.value(data_index, first_component, quadrature_index);
       }
 
       double
-      value(unsigned int d, const IntegrationInfo<dim, dim>& info,
+      value(unsigned int d, const QuadratureData<dim>& info,
             unsigned int quadrature_index) const
       {
         static_assert(order == 1, "Wrong number of tensor coordinates");
         Assert(data_index != ::dealii::numbers::invalid_unsigned_int, ::dealii::ExcInternalError());
-        return info.values[data_index][first_component + d][quadrature_index];
+        return info.value(data_index, first_component + d, quadrature_index);
+      }
+
+      double
+      value(const TrialShapeFunction& shape_function, const QuadratureData<dim>& info,
+            unsigned int quadrature_index) const
+      {
+        static_assert(order == 0, "Scalar used with tensor coordinate");
+        const auto fe_values = trial_fe_values(shape_function, info);
+        if (fe_values == nullptr)
+          return 0.;
+        return fe_values->shape_value_component(shape_function.index, quadrature_index,
+                                                first_component);
+      }
+
+      double
+      value(unsigned int d, const TrialShapeFunction& shape_function,
+            const QuadratureData<dim>& info, unsigned int quadrature_index) const
+      {
+        static_assert(order == 1, "Wrong number of tensor coordinates");
+        const auto fe_values = trial_fe_values(shape_function, info);
+        if (fe_values == nullptr)
+          return 0.;
+        return fe_values->shape_value_component(shape_function.index, quadrature_index,
+                                                first_component + d);
       }
     };
 
@@ -302,32 +471,45 @@ namespace dealii
       }
 
       double
-      value(unsigned int d, const IntegrationInfo<dim, dim>& info,
+      value(unsigned int d, const QuadratureData<dim>& info,
             unsigned int quadrature_index) const
       {
         static_assert(order == 0, "Wrong number of tensor coordinates");
-
-        AssertIndexRange(base.data_index, info.gradients.size());
-
-        AssertIndexRange(base.first_component, info.gradients[base.data_index].size());
-        AssertIndexRange(quadrature_index,
-                         info.gradients[base.data_index][base.first_component].size());
         AssertIndexRange(d, dim);
-        return info.gradients[base.data_index][base.first_component][quadrature_index][d];
+        return info.gradient(base.data_index, base.first_component, d, quadrature_index);
       }
 
       double
-      value(unsigned int d1, unsigned int d2, const IntegrationInfo<dim, dim>& info,
+      value(unsigned int d1, unsigned int d2, const QuadratureData<dim>& info,
             unsigned int quadrature_index) const
       {
         static_assert(order == 1, "Wrong number of tensor coordinates");
-        AssertIndexRange(base.data_index, info.gradients.size());
-
-        AssertIndexRange(base.first_component, info.gradients[base.data_index].size());
-        AssertIndexRange(quadrature_index,
-                         info.gradients[base.data_index][base.first_component].size());
         AssertIndexRange(d1, dim);
-        return info.gradients[base.data_index][base.first_component + d2][quadrature_index][d1];
+        return info.gradient(base.data_index, base.first_component + d2, d1, quadrature_index);
+      }
+
+      double
+      value(unsigned int d, const TrialShapeFunction& shape_function,
+            const QuadratureData<dim>& info, unsigned int quadrature_index) const
+      {
+        static_assert(order == 0, "Wrong number of tensor coordinates");
+        const auto fe_values = base.trial_fe_values(shape_function, info);
+        if (fe_values == nullptr)
+          return 0.;
+        return fe_values->shape_grad_component(shape_function.index, quadrature_index,
+                                               base.first_component)[d];
+      }
+
+      double
+      value(unsigned int d1, unsigned int d2, const TrialShapeFunction& shape_function,
+            const QuadratureData<dim>& info, unsigned int quadrature_index) const
+      {
+        static_assert(order == 1, "Wrong number of tensor coordinates");
+        const auto fe_values = base.trial_fe_values(shape_function, info);
+        if (fe_values == nullptr)
+          return 0.;
+        return fe_values->shape_grad_component(shape_function.index, quadrature_index,
+                                               base.first_component + d2)[d1];
       }
     };
 
@@ -350,10 +532,21 @@ namespace dealii
       }
 
       typename std::enable_if<order == 0, double>::type
-      value(unsigned int d1, unsigned int d2, const IntegrationInfo<dim, dim>& info,
+      value(unsigned int d1, unsigned int d2, const QuadratureData<dim>& info,
             unsigned int quadrature_index) const
       {
-        return info.hessians[base.data_index][base.first_component][quadrature_index][d1][d2];
+        return info.hessian(base.data_index, base.first_component, d1, d2, quadrature_index);
+      }
+
+      typename std::enable_if<order == 0, double>::type
+      value(unsigned int d1, unsigned int d2, const TrialShapeFunction& shape_function,
+            const QuadratureData<dim>& info, unsigned int quadrature_index) const
+      {
+        const auto fe_values = base.trial_fe_values(shape_function, info);
+        if (fe_values == nullptr)
+          return 0.;
+        return fe_values->shape_hessian_component(shape_function.index, quadrature_index,
+                                                  base.first_component)[d1][d2];
       }
     };
 
@@ -370,6 +563,269 @@ namespace dealii
     {
       return FEHessian<order, dim>(f);
     }
+
+    /**
+     * The symmetric part of the gradient of a vector valued finite element
+     * function, see TestSymmetricGradient.
+     */
+    template <int order, int dim>
+    class FESymmetricGradient
+    {
+      const FEFunction<order, dim>& base;
+
+    public:
+      typedef Traits::Tensor<order + 1, dim> TensorTraits;
+
+      constexpr FESymmetricGradient(const FEFunction<order, dim>& base)
+        : base(base)
+      {
+        static_assert(order == 1, "The symmetric gradient is only defined for vector fields");
+      }
+
+      double
+      value(unsigned int d1, unsigned int d2, const QuadratureData<dim>& info,
+            unsigned int quadrature_index) const
+      {
+        return .5 *
+               (info.gradient(base.data_index, base.first_component + d2, d1, quadrature_index) +
+                info.gradient(base.data_index, base.first_component + d1, d2, quadrature_index));
+      }
+
+      double
+      value(unsigned int d1, unsigned int d2, const TrialShapeFunction& shape_function,
+            const QuadratureData<dim>& info, unsigned int quadrature_index) const
+      {
+        const auto fe_values = base.trial_fe_values(shape_function, info);
+        if (fe_values == nullptr)
+          return 0.;
+        return .5 * (fe_values->shape_grad_component(shape_function.index, quadrature_index,
+                                                     base.first_component + d2)[d1] +
+                     fe_values->shape_grad_component(shape_function.index, quadrature_index,
+                                                     base.first_component + d1)[d2]);
+      }
+    };
+
+    template <int order, int dim>
+    FESymmetricGradient<order, dim>
+    symmetric_grad(const FEFunction<order, dim>& f)
+    {
+      return FESymmetricGradient<order, dim>(f);
+    }
+
+    /**
+     * The outward normal vector of the interior cell at a quadrature point
+     * of a face, negated for the exterior cell. As in the MatrixFree
+     * backend, normal derivatives on either side of a face are taken in the
+     * direction of the outward normal of the own cell.
+     */
+    template <bool exterior, int dim>
+    ::dealii::Tensor<1, dim>
+    outward_normal(const QuadratureData<dim>& info1, unsigned int quadrature_index)
+    {
+      const ::dealii::Tensor<1, dim> normal = info1.fe_values(0).normal_vector(quadrature_index);
+      return exterior ? -normal : normal;
+    }
+
+    /**
+     * A test function on a face. It is evaluated on the interior or the
+     * exterior cell of the face and is either the shape function itself or
+     * its derivative in the direction of the outward normal of that cell,
+     * see outward_normal(). Face terms are evaluated with the QuadratureData
+     * objects of both cells, boundary terms with the one of the interior
+     * cell twice.
+     */
+    template <int order, int dim, bool exterior, bool normal_gradient>
+    class TestFunctionFace
+    {
+      /// The constant index data used in local integration
+      const TestFunctionIdentifier ident;
+
+      const ::dealii::FEValuesBase<dim>&
+      fe_values(const QuadratureData<dim>& info1, const QuadratureData<dim>& info2) const
+      {
+        return (exterior ? info2 : info1).fe_values(ident.fe_index);
+      }
+
+    public:
+      static constexpr bool is_exterior = exterior;
+      static constexpr Base::IntegrationFlags integration_flags{ !exterior && !normal_gradient,
+                                                                 exterior && !normal_gradient,
+                                                                 !exterior && normal_gradient,
+                                                                 exterior && normal_gradient };
+      typedef Traits::Tensor<order, dim> TensorTraits;
+
+      constexpr TestFunctionFace(unsigned int fe_index, unsigned int block_index)
+        : ident{ fe_index, block_index }
+      {
+      }
+
+      constexpr TestFunctionIdentifier
+      id() const
+      {
+        return ident;
+      }
+
+      double
+      value(unsigned int test_index, const QuadratureData<dim>& info1,
+            const QuadratureData<dim>& info2, unsigned int quadrature_index) const
+      {
+        static_assert(order == 0, "Tensor test function used without tensor coordinate");
+        if constexpr (normal_gradient)
+          return fe_values(info1, info2).shape_grad(test_index, quadrature_index) *
+                 outward_normal<exterior>(info1, quadrature_index);
+        else
+          return fe_values(info1, info2).shape_value(test_index, quadrature_index);
+      }
+
+      double
+      value(unsigned int d, unsigned int test_index, const QuadratureData<dim>& info1,
+            const QuadratureData<dim>& info2, unsigned int quadrature_index) const
+      {
+        static_assert(order == 1, "Tensor order and number of tensor coordinates do not match");
+        if constexpr (normal_gradient)
+          return fe_values(info1, info2).shape_grad_component(test_index, quadrature_index, d) *
+                 outward_normal<exterior>(info1, quadrature_index);
+        else
+          return fe_values(info1, info2).shape_value_component(test_index, quadrature_index, d);
+      }
+    };
+
+    template <int order, int dim>
+    using TestFunctionInteriorFace = TestFunctionFace<order, dim, false, false>;
+    template <int order, int dim>
+    using TestFunctionExteriorFace = TestFunctionFace<order, dim, true, false>;
+    template <int order, int dim>
+    using TestNormalGradientInteriorFace = TestFunctionFace<order, dim, false, true>;
+    template <int order, int dim>
+    using TestNormalGradientExteriorFace = TestFunctionFace<order, dim, true, true>;
+
+    /**
+     * A finite element function on a face, see TestFunctionFace.
+     *
+     * Contrary to the functions on cells, these objects store a scalar
+     * factor, so they can be combined in Base::SumFEFunctions like the
+     * fluxes of DG methods. Exterior functions are not defined on the
+     * boundary.
+     */
+    template <int order, int dim, bool exterior, bool normal_gradient>
+    class FEFunctionFace
+    {
+      const unsigned int data_index;
+      const unsigned int first_component;
+      /// The trial functions used when assembling matrices
+      const TrialFunctionIdentifier trial;
+      const double scalar_factor;
+
+      double
+      trial_value(const TrialShapeFunction& shape_function, unsigned int component,
+                  const QuadratureData<dim>& info1, const QuadratureData<dim>& info2,
+                  unsigned int quadrature_index) const
+      {
+        if (shape_function.block_index != trial.block_index || shape_function.exterior != exterior)
+          return 0.;
+        const auto& fe_values = (exterior ? info2 : info1).fe_values(trial.fe_index);
+        if constexpr (normal_gradient)
+          return scalar_factor *
+                 (fe_values.shape_grad_component(shape_function.index, quadrature_index, component) *
+                  outward_normal<exterior>(info1, quadrature_index));
+        else
+          return scalar_factor *
+                 fe_values.shape_value_component(shape_function.index, quadrature_index, component);
+      }
+
+      double
+      function_value(unsigned int component, const QuadratureData<dim>& info1,
+                     const QuadratureData<dim>& info2, unsigned int quadrature_index) const
+      {
+        const auto& info = exterior ? info2 : info1;
+        if constexpr (normal_gradient)
+        {
+          const auto normal = outward_normal<exterior>(info1, quadrature_index);
+          double result = 0.;
+          for (unsigned int d = 0; d < dim; ++d)
+            result += info.gradient(data_index, component, d, quadrature_index) * normal[d];
+          return scalar_factor * result;
+        }
+        else
+          return scalar_factor * info.value(data_index, component, quadrature_index);
+      }
+
+    public:
+      typedef Traits::Tensor<order, dim> TensorTraits;
+
+      /**
+       * See FEFunction for the meaning of the indices.
+       */
+      FEFunctionFace(const unsigned int data_index, const unsigned int first,
+                     const unsigned int fe_index = 0, const unsigned int block_index = 0,
+                     const double scalar_factor = 1.)
+        : data_index(data_index)
+        , first_component(first)
+        , trial{ fe_index, block_index }
+        , scalar_factor(scalar_factor)
+      {
+      }
+
+      FEFunctionFace
+      operator*(const double factor) const
+      {
+        return FEFunctionFace(
+          data_index, first_component, trial.fe_index, trial.block_index, scalar_factor * factor);
+      }
+
+      FEFunctionFace
+      operator-() const
+      {
+        return (*this) * -1.;
+      }
+
+      double
+      value(const QuadratureData<dim>& info1, const QuadratureData<dim>& info2,
+            unsigned int quadrature_index) const
+      {
+        static_assert(order == 0, "Scalar used with tensor coordinate");
+        return function_value(first_component, info1, info2, quadrature_index);
+      }
+
+      double
+      value(unsigned int d, const QuadratureData<dim>& info1,
+            const QuadratureData<dim>& info2, unsigned int quadrature_index) const
+      {
+        static_assert(order == 1, "Wrong number of tensor coordinates");
+        return function_value(first_component + d, info1, info2, quadrature_index);
+      }
+
+      double
+      value(const TrialShapeFunction& shape_function, const QuadratureData<dim>& info1,
+            const QuadratureData<dim>& info2, unsigned int quadrature_index) const
+      {
+        static_assert(order == 0, "Scalar used with tensor coordinate");
+        return trial_value(shape_function, first_component, info1, info2, quadrature_index);
+      }
+
+      double
+      value(unsigned int d, const TrialShapeFunction& shape_function,
+            const QuadratureData<dim>& info1, const QuadratureData<dim>& info2,
+            unsigned int quadrature_index) const
+      {
+        static_assert(order == 1, "Wrong number of tensor coordinates");
+        return trial_value(shape_function, first_component + d, info1, info2, quadrature_index);
+      }
+    };
+
+    template <int order, int dim>
+    using FEFunctionInteriorFace = FEFunctionFace<order, dim, false, false>;
+    template <int order, int dim>
+    using FEFunctionExteriorFace = FEFunctionFace<order, dim, true, false>;
+    template <int order, int dim>
+    using FENormalGradientInteriorFace = FEFunctionFace<order, dim, false, true>;
+    template <int order, int dim>
+    using FENormalGradientExteriorFace = FEFunctionFace<order, dim, true, true>;
+
+    // Linear combinations of face functions are Base::SumFEFunctions
+    using Base::operator+;
+    using Base::operator-;
+    using Base::operator*;
   }
 }
 }
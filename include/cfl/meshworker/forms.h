@@ -1,5 +1,5 @@
-#ifndef cfl_forms_h
-#define cfl_forms_h
+#ifndef cfl_meshworker_forms_h
+#define cfl_meshworker_forms_h
 
 #include <array>
 #include <iostream>
@@ -32,12 +32,11 @@ namespace CFL{
     std::string operator()(const Test &test, const Expr &expr) {
       std::string output;
       for (unsigned int i = 0; i < Test::TensorTraits::dim; ++i) {
-        if (i > 0) {
+        if (i > 0)
           output += " + ";
-          output += R"(\left()" + expr.latex(i) + "," + test.latex(i) + R"(\right))";
-        }
-        return output;
+        output += R"(\left()" + expr.latex(i) + "," + test.latex(i) + R"(\right))";
       }
+      return output;
     }
   };
 
@@ -56,32 +55,6 @@ namespace CFL{
     }
   };
 
-  template<int rank, class Test, class Expr>
-  struct form_evaluate_aux {
-    double operator()(unsigned int /*k*/, unsigned int /*i*/, const Test & /*test*/, const Expr & /*expr*/) {
-      static_assert(rank < 2, "Not implemented for this rank");
-      return 0.;
-    }
-  };
-
-  template<class Test, class Expr>
-  struct form_evaluate_aux<0, Test, Expr> {
-    double operator()(unsigned int k, unsigned int i, const Test &test, const Expr &expr) {
-      return test.evaluate(k, i) * expr.evaluate(k);
-    }
-  };
-
-  template<class Test, class Expr>
-  struct form_evaluate_aux<1, Test, Expr> {
-    double operator()(unsigned int k, unsigned int i, const Test &test, const Expr &expr) {
-      double sum = 0.;
-      for (unsigned int d = 0; d < Test::TensorTraits::dim; ++d) {
-        sum += test.evaluate(k, i, d) * expr.evaluate(k, d);
-      }
-      return sum;
-    }
-  };
-
   namespace {
     enum class FormKind {
       cell, face, boundary
@@ -322,6 +295,20 @@ namespace dealii::MeshWorker {
       return form;
     }
 
+    template<class Test, class Expr, FormKind kind_of_form>
+    Forms<Form<Test, Expr, kind_of_form>, FormType>
+    operator+(const Form<Test, Expr, kind_of_form> &new_form) const {
+      return Forms<Form<Test, Expr, kind_of_form>, FormType>(new_form, *this);
+    }
+
+    auto operator*(const double scalar) const {
+      return Forms<decltype(form * scalar)>(form * scalar);
+    }
+
+    auto operator-() const {
+      return (*this) * -1.;
+    }
+
     private:
     const FormType form;
   };
@@ -386,10 +373,12 @@ namespace dealii::MeshWorker {
       return form;
     }
 
+    /**
+     * Scaling a Form changes its type, so the scaled Forms object is built
+     * by prepending the scaled Form to the scaled remaining ones.
+     */
     auto operator*(const double scalar) const {
-      const typename std::remove_reference<decltype(*this)>::type newform(form * scalar,
-                                                                          Forms<Types...>::get_form() * scalar);
-      return newform;
+      return Forms<Types...>::operator*(scalar) + form * scalar;
     }
 
     auto operator-() const {
@@ -0,0 +1,785 @@
+#ifndef MESHWORKER_INTEGRATOR_H
+#define MESHWORKER_INTEGRATOR_H
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/numbers.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/meshworker/dof_info.h>
+#include <deal.II/meshworker/integration_info.h>
+#include <deal.II/meshworker/local_integrator.h>
+
+#include <cfl/base/constants.h>
+#include <cfl/base/fefunctions.h>
+#include <cfl/meshworker/fefunctions.h>
+#include <cfl/meshworker/forms.h>
+#include <cfl/meshworker/quadrature_data.h>
+
+#include <array>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace CFL::dealii::MeshWorker
+{
+using ::dealii::MeshWorker::DoFInfo;
+using ::dealii::MeshWorker::IntegrationInfo;
+
+/**
+ * The values of a test function and of an expression at all quadrature
+ * points of a cell, stored contiguously such that testing the expression
+ * with all test functions is a single matrix-vector product
+ * \f$ B^T (JxW \cdot e) \f$. Likewise, a cell matrix is the matrix product
+ * \f$ B^T D B \f$ with the expression evaluated for all trial functions.
+ *
+ * The integrators keep one object per thread and reuse it for all Forms and
+ * cells to avoid allocating memory for each of them.
+ */
+struct ContractionData
+{
+  /**
+   * The values of one test function, one row per test function and one
+   * column per tensor component and quadrature point. They are computed
+   * once per cell or face and shared by all Forms with this test function.
+   */
+  struct TestValues
+  {
+    const std::type_info* test_type = nullptr;
+    TestFunctionIdentifier id{ 0, 0 };
+    ::dealii::FullMatrix<double> values;
+  };
+
+  /**
+   * Forget the test values of the previous cell or face. The memory is
+   * kept for the next one.
+   */
+  void
+  new_cell()
+  {
+    n_test_values = 0;
+  }
+
+  /// The test values of the current cell or face, the first n_test_values
+  /// are valid
+  std::vector<TestValues> test_values;
+  unsigned int n_test_values = 0;
+  /// Values of the expression multiplied by JxW, ordered like the columns of
+  /// test_values
+  ::dealii::Vector<double> expr_values;
+  /// Values of the expression for each trial function multiplied by JxW,
+  /// one row per trial function and ordered like the columns of test_values
+  ::dealii::FullMatrix<double> trial_values;
+};
+
+namespace internal
+{
+  constexpr unsigned int
+  n_tensor_components(unsigned int rank, unsigned int dim)
+  {
+    return rank == 0 ? 1 : dim * n_tensor_components(rank - 1, dim);
+  }
+
+  /**
+   * The tensor components a Form with test function <code>Test</code> is
+   * evaluated for, numbered such that the component <code>c</code> has the
+   * tensor indices <code>first(c)</code> and <code>second(c)</code>.
+   *
+   * If the test function is a symmetric tensor of rank 2, only the
+   * diagonal and the upper triangle are evaluated. Since the contraction of
+   * any tensor with a symmetric one only sees the symmetric part of the
+   * former, the off-diagonal components are weighted twice.
+   */
+  template <class Test>
+  struct Components
+  {
+    static constexpr unsigned int rank = Test::TensorTraits::rank;
+    static constexpr unsigned int dim = Test::TensorTraits::dim;
+    static constexpr bool symmetric = rank == 2 && Traits::is_symmetric<Test>::value;
+    static constexpr unsigned int n =
+      symmetric ? dim * (dim + 1) / 2 : n_tensor_components(rank, dim);
+
+    static constexpr unsigned int
+    first(unsigned int c)
+    {
+      if (!symmetric)
+        return rank == 2 ? c / dim : c;
+      if (c < dim)
+        return c;
+      for (unsigned int i = 0, k = dim; i < dim; ++i)
+        for (unsigned int j = i + 1; j < dim; ++j, ++k)
+          if (k == c)
+            return i;
+      return 0;
+    }
+
+    static constexpr unsigned int
+    second(unsigned int c)
+    {
+      if (!symmetric)
+        return rank == 2 ? c % dim : 0;
+      if (c < dim)
+        return c;
+      for (unsigned int i = 0, k = dim; i < dim; ++i)
+        for (unsigned int j = i + 1; j < dim; ++j, ++k)
+          if (k == c)
+            return j;
+      return 0;
+    }
+
+    static constexpr double
+    weight(unsigned int c)
+    {
+      return (symmetric && c >= dim) ? 2. : 1.;
+    }
+  };
+
+  /**
+   * Call <code>function(std::integral_constant<unsigned int, c>())</code>
+   * for all components <code>c</code> in <code>Comp</code>, such that the
+   * tensor indices are compile-time constants in the loops over quadrature
+   * points.
+   */
+  template <class Comp, class Function, unsigned int... c>
+  void
+  for_each_component(const Function& function, std::integer_sequence<unsigned int, c...>)
+  {
+    (function(std::integral_constant<unsigned int, c>()), ...);
+  }
+
+  template <class Comp, class Function>
+  void
+  for_each_component(const Function& function)
+  {
+    for_each_component<Comp>(function, std::make_integer_sequence<unsigned int, Comp::n>());
+  }
+
+  /**
+   * The value of the component <code>c</code> of the expression. If the
+   * arguments start with a TrialShapeFunction, the finite element functions
+   * in the expression are replaced by this shape function.
+   *
+   * For a symmetric test function, the symmetric part of an expression not
+   * known to be symmetric is used.
+   */
+  template <class Comp, unsigned int c, class Expr, typename... Args>
+  double
+  expr_value(const Expr& expr, unsigned int q, const Args&... args)
+  {
+    static_assert(Expr::TensorTraits::rank == Comp::rank,
+                  "Expression and test function must have equal rank");
+    if constexpr (Comp::rank == 0)
+      return expr.value(args..., q);
+    else if constexpr (Comp::rank == 1)
+      return expr.value(c, args..., q);
+    else
+    {
+      static_assert(Comp::rank == 2, "Not implemented for this rank");
+      constexpr unsigned int i = Comp::first(c);
+      constexpr unsigned int j = Comp::second(c);
+      if constexpr (Comp::symmetric && i != j && !Traits::is_symmetric<Expr>::value)
+        return .5 * (expr.value(i, j, args..., q) + expr.value(j, i, args..., q));
+      else
+        return expr.value(i, j, args..., q);
+    }
+  }
+
+  /**
+   * The vector component in which the shape function <code>i</code> is
+   * nonzero, or ::dealii::numbers::invalid_unsigned_int if the finite
+   * element is not primitive and the components have to be queried one by
+   * one.
+   */
+  template <int dim>
+  unsigned int
+  nonzero_component(const ::dealii::FEValuesBase<dim>& fe_values, unsigned int i)
+  {
+    const auto& fe = fe_values.get_fe();
+    return fe.is_primitive(i) ? fe.system_to_component_index(i).first
+                              : ::dealii::numbers::invalid_unsigned_int;
+  }
+
+  /**
+   * Fill <code>values</code> with the values of all test functions, see
+   * ContractionData::TestValues. The shape functions are read directly from
+   * the FEValues object and for primitive elements only the component in
+   * which a shape function is nonzero is set, the matrix has to be zero
+   * before.
+   */
+  template <class Comp, int order, int dim>
+  void
+  fill_shape_values(const TestFunction<order, dim>& test, ::dealii::FullMatrix<double>& values,
+                    const QuadratureData<dim>& info)
+  {
+    const auto& fe_values = info.fe_values(test.id().fe_index);
+    const unsigned int n_q_points = fe_values.n_quadrature_points;
+    for (unsigned int i = 0; i < values.m(); ++i)
+    {
+      if constexpr (order == 0)
+        for (unsigned int q = 0; q < n_q_points; ++q)
+          values(i, q) = fe_values.shape_value(i, q);
+      else
+      {
+        const unsigned int component = nonzero_component(fe_values, i);
+        for (unsigned int c = 0; c < Comp::n; ++c)
+          if (component == c)
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              values(i, c * n_q_points + q) = fe_values.shape_value(i, q);
+          else if (component == ::dealii::numbers::invalid_unsigned_int)
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              values(i, c * n_q_points + q) = fe_values.shape_value_component(i, q, c);
+      }
+    }
+  }
+
+  template <class Comp, int order, int dim>
+  void
+  fill_shape_values(const TestGradient<order, dim>& test, ::dealii::FullMatrix<double>& values,
+                    const QuadratureData<dim>& info)
+  {
+    const auto& fe_values = info.fe_values(test.id().fe_index);
+    const unsigned int n_q_points = fe_values.n_quadrature_points;
+    for (unsigned int i = 0; i < values.m(); ++i)
+    {
+      if constexpr (order == 0)
+        for (unsigned int q = 0; q < n_q_points; ++q)
+        {
+          const auto& gradient = fe_values.shape_grad(i, q);
+          for (unsigned int d = 0; d < dim; ++d)
+            values(i, d * n_q_points + q) = gradient[d];
+        }
+      else
+      {
+        // the column c holds the derivative in direction c / dim of the
+        // vector component c % dim
+        const unsigned int component = nonzero_component(fe_values, i);
+        for (unsigned int c = 0; c < Comp::n; ++c)
+          if (component == Comp::second(c))
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              values(i, c * n_q_points + q) = fe_values.shape_grad(i, q)[Comp::first(c)];
+          else if (component == ::dealii::numbers::invalid_unsigned_int)
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              values(i, c * n_q_points + q) =
+                fe_values.shape_grad_component(i, q, Comp::second(c))[Comp::first(c)];
+      }
+    }
+  }
+
+  template <class Comp, int order, int dim>
+  void
+  fill_shape_values(const TestHessian<order, dim>& test, ::dealii::FullMatrix<double>& values,
+                    const QuadratureData<dim>& info)
+  {
+    static_assert(order == 0, "Tensor order and number of tensor coordinates do not match");
+    const auto& fe_values = info.fe_values(test.id().fe_index);
+    const unsigned int n_q_points = fe_values.n_quadrature_points;
+    for (unsigned int i = 0; i < values.m(); ++i)
+      for (unsigned int q = 0; q < n_q_points; ++q)
+      {
+        const auto& hessian = fe_values.shape_hessian(i, q);
+        for (unsigned int c = 0; c < Comp::n; ++c)
+          values(i, c * n_q_points + q) = hessian[Comp::first(c)][Comp::second(c)];
+      }
+  }
+
+  template <class Comp, int order, int dim>
+  void
+  fill_shape_values(const TestSymmetricGradient<order, dim>& test,
+                    ::dealii::FullMatrix<double>& values, const QuadratureData<dim>& info)
+  {
+    const auto& fe_values = info.fe_values(test.id().fe_index);
+    const unsigned int n_q_points = fe_values.n_quadrature_points;
+    for (unsigned int i = 0; i < values.m(); ++i)
+    {
+      const unsigned int component = nonzero_component(fe_values, i);
+      for (unsigned int c = 0; c < Comp::n; ++c)
+      {
+        const unsigned int d1 = Comp::first(c);
+        const unsigned int d2 = Comp::second(c);
+        if (component == ::dealii::numbers::invalid_unsigned_int)
+          for (unsigned int q = 0; q < n_q_points; ++q)
+            values(i, c * n_q_points + q) =
+              .5 * (fe_values.shape_grad_component(i, q, d2)[d1] +
+                    fe_values.shape_grad_component(i, q, d1)[d2]);
+        else if (component == d1 || component == d2)
+          for (unsigned int q = 0; q < n_q_points; ++q)
+          {
+            const auto& gradient = fe_values.shape_grad(i, q);
+            values(i, c * n_q_points + q) =
+              .5 * ((component == d2 ? gradient[d1] : 0.) + (component == d1 ? gradient[d2] : 0.));
+          }
+      }
+    }
+  }
+
+  template <class Comp, int order, int dim, bool exterior, bool normal_gradient>
+  void
+  fill_shape_values(const TestFunctionFace<order, dim, exterior, normal_gradient>& test,
+                    ::dealii::FullMatrix<double>& values, const QuadratureData<dim>& info1,
+                    const QuadratureData<dim>& info2)
+  {
+    const auto& fe_values = (exterior ? info2 : info1).fe_values(test.id().fe_index);
+    const unsigned int n_q_points = fe_values.n_quadrature_points;
+    const auto shape_value = [&](unsigned int i, unsigned int q) {
+      if constexpr (normal_gradient)
+        return fe_values.shape_grad(i, q) * outward_normal<exterior>(info1, q);
+      else
+        return fe_values.shape_value(i, q);
+    };
+    for (unsigned int i = 0; i < values.m(); ++i)
+    {
+      if constexpr (order == 0)
+        for (unsigned int q = 0; q < n_q_points; ++q)
+          values(i, q) = shape_value(i, q);
+      else
+      {
+        const unsigned int component = nonzero_component(fe_values, i);
+        for (unsigned int c = 0; c < Comp::n; ++c)
+          if (component == c)
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              values(i, c * n_q_points + q) = shape_value(i, q);
+          else if (component == ::dealii::numbers::invalid_unsigned_int)
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              values(i, c * n_q_points + q) = test.value(c, i, info1, info2, q);
+      }
+    }
+  }
+
+  /**
+   * The values of the first <code>dofs_per_cell</code> test functions at
+   * all quadrature points. They are computed for the first Form with this
+   * test function on the current cell or face and reused for the others.
+   */
+  template <class Test, typename... Infos>
+  const ::dealii::FullMatrix<double>&
+  test_values(const Test& test, unsigned int dofs_per_cell, unsigned int n_q_points,
+              ContractionData& data, const Infos&... infos)
+  {
+    using Comp = Components<Test>;
+    const TestFunctionIdentifier id = test.id();
+
+    for (unsigned int k = 0; k < data.n_test_values; ++k)
+    {
+      const auto& cached = data.test_values[k];
+      if (*cached.test_type == typeid(Test) && cached.id.fe_index == id.fe_index &&
+          cached.id.block_index == id.block_index)
+        return cached.values;
+    }
+
+    if (data.n_test_values == data.test_values.size())
+      data.test_values.emplace_back();
+    auto& cached = data.test_values[data.n_test_values++];
+    cached.test_type = &typeid(Test);
+    cached.id = id;
+    cached.values.reinit(dofs_per_cell, Comp::n * n_q_points);
+    fill_shape_values<Comp>(test, cached.values, infos...);
+    return cached.values;
+  }
+
+  /**
+   * Store the values of the expression multiplied by JxW at all quadrature
+   * points in data.expr_values, for the components of the test function.
+   */
+  template <class Test, class Expr, class FEValues, typename... Infos>
+  void
+  fill_expr_values(const Expr& expr, const FEValues& fe_values, ContractionData& data,
+                   const Infos&... infos)
+  {
+    using Comp = Components<Test>;
+    const unsigned int n_q_points = fe_values.n_quadrature_points;
+
+    data.expr_values.reinit(Comp::n * n_q_points, true);
+    for_each_component<Comp>([&](auto component) {
+      constexpr unsigned int c = decltype(component)::value;
+      for (unsigned int q = 0; q < n_q_points; ++q)
+        data.expr_values(c * n_q_points + q) =
+          Comp::weight(c) * expr_value<Comp, c>(expr, q, infos...) * fe_values.JxW(q);
+    });
+  }
+
+  /**
+   * Whether an expression is linear in the finite element functions. Only
+   * for such expressions, replacing the finite element functions by a
+   * trial function yields the entries of a matrix.
+   */
+  template <class Expr>
+  struct is_linear : std::true_type
+  {
+  };
+
+  template <typename... Types>
+  struct is_linear<Base::ProductFEFunctions<Types...>>
+    : std::bool_constant<(sizeof...(Types) <= 1)>
+  {
+  };
+
+  template <typename... Types>
+  struct is_linear<Base::SumFEFunctions<Types...>> : std::conjunction<is_linear<Types>...>
+  {
+  };
+
+  template <class T, typename number>
+  struct is_linear<ConstantScaled<T, number>> : is_linear<T>
+  {
+  };
+
+  /**
+   * Add the matrix of the linear expression tested with the test functions
+   * in <code>test_values</code> to all local matrices of <code>dinfo</code> in the
+   * row block of the test function.
+   *
+   * For each matrix, the expression is evaluated for all trial functions of
+   * its column block and all quadrature points. The local matrix is then
+   * the matrix product of the test function values and these values.
+   * <code>external</code> selects the matrices coupling to the other cell
+   * at a face and <code>trial_exterior</code> the side of the face the
+   * trial functions belong to.
+   *
+   * Products of finite element functions are rejected at compile time. An
+   * affine expression would add its constant part to every column, so the
+   * expression has to vanish for a trial function outside of all blocks.
+   */
+  template <int dim, class Test, class Expr, typename... Infos>
+  void
+  add_matrices(DoFInfo<dim, dim>& dinfo, bool external, bool trial_exterior, const Test& test,
+               const ::dealii::FullMatrix<double>& test_values, const Expr& expr,
+               const ::dealii::FEValuesBase<dim>& fe_values, ContractionData& data,
+               const Infos&... infos)
+  {
+    static_assert(is_linear<Expr>::value, "Matrices require a linear expression");
+    using Comp = Components<Test>;
+    const unsigned int n_q_points = fe_values.n_quadrature_points;
+
+    const TrialShapeFunction no_shape_function{ 0,
+                                                ::dealii::numbers::invalid_unsigned_int,
+                                                trial_exterior };
+    for_each_component<Comp>([&](auto component) {
+      constexpr unsigned int c = decltype(component)::value;
+      for (unsigned int q = 0; q < n_q_points; ++q)
+        AssertThrow(expr_value<Comp, c>(expr, q, no_shape_function, infos...) == 0.,
+                    ::dealii::ExcMessage("Matrices require an expression without a "
+                                         "constant part"));
+    });
+
+    for (unsigned int k = 0; k < dinfo.n_matrices(); ++k)
+    {
+      auto& local_matrix = dinfo.matrix(k, external);
+      if (local_matrix.row != test.id().block_index)
+        continue;
+
+      const unsigned int n_trial_functions = local_matrix.matrix.n();
+      data.trial_values.reinit(n_trial_functions, Comp::n * n_q_points, true);
+      for (unsigned int j = 0; j < n_trial_functions; ++j)
+      {
+        const TrialShapeFunction shape_function{ j,
+                                                 static_cast<unsigned int>(local_matrix.column),
+                                                 trial_exterior };
+        for_each_component<Comp>([&](auto component) {
+          constexpr unsigned int c = decltype(component)::value;
+          for (unsigned int q = 0; q < n_q_points; ++q)
+            data.trial_values(j, c * n_q_points + q) =
+              Comp::weight(c) * expr_value<Comp, c>(expr, q, shape_function, infos...) *
+              fe_values.JxW(q);
+        });
+      }
+
+      test_values.mTmult(local_matrix.matrix, data.trial_values, true);
+    }
+  }
+} // namespace internal
+
+/**
+ * Call <code>function(test, expr)</code> for all Forms of the given kind.
+ */
+template <FormKind kind, class FORMS, class Function>
+void
+for_each_form(const FORMS& forms, const Function& function)
+{
+  if constexpr (FORMS::number != 0)
+    for_each_form<kind>(forms.get_other(), function);
+  if constexpr (FORMS::form_kind == kind)
+    function(forms.get_form().test(), forms.get_form().expr());
+}
+
+/**
+ * Test the expression with all test functions of a cell and add the result
+ * to the local vector.
+ *
+ * First, the expression is evaluated at all quadrature points and the
+ * values of the test functions are gathered into a dense matrix. The
+ * integration is then a single matrix-vector product instead of a loop over
+ * test functions for each quadrature point and tensor component.
+ */
+template <int dim, class Expr, class Test>
+void
+evaluate(DoFInfo<dim, dim>& dinfo, const QuadratureData<dim>& info, const Test& test,
+         const Expr& expr, ContractionData& data)
+{
+  static_assert(Expr::TensorTraits::rank == Test::TensorTraits::rank,
+                "Expression and test function must have equal rank");
+  const auto& fe_values = info.fe_values(0);
+
+  internal::fill_expr_values<Test>(expr, fe_values, data, info);
+  const auto& test_values = internal::test_values(test,
+                                                   info.fe_values(test.id().fe_index).dofs_per_cell,
+                                                   fe_values.n_quadrature_points,
+                                                   data,
+                                                   info);
+  test_values.vmult_add(dinfo.vector(0).block(test.id().block_index), data.expr_values);
+}
+
+/**
+ * Same as above for a face. The result is added to the local vector of
+ * the cell the test function belongs to. On the boundary, both DoFInfo and
+ * QuadratureData objects are those of the cell.
+ */
+template <int dim, class Expr, class Test>
+void
+evaluate(DoFInfo<dim, dim>& dinfo1, DoFInfo<dim, dim>& dinfo2, const QuadratureData<dim>& info1,
+         const QuadratureData<dim>& info2, const Test& test, const Expr& expr,
+         ContractionData& data)
+{
+  static_assert(Expr::TensorTraits::rank == Test::TensorTraits::rank,
+                "Expression and test function must have equal rank");
+  const auto& fe_values = info1.fe_values(0);
+  const auto& test_info = Test::is_exterior ? info2 : info1;
+  auto& test_dinfo = Test::is_exterior ? dinfo2 : dinfo1;
+
+  internal::fill_expr_values<Test>(expr, fe_values, data, info1, info2);
+  const auto& test_values =
+    internal::test_values(test,
+                          test_info.fe_values(test.id().fe_index).dofs_per_cell,
+                          fe_values.n_quadrature_points,
+                          data,
+                          info1,
+                          info2);
+  test_values.vmult_add(test_dinfo.vector(0).block(test.id().block_index), data.expr_values);
+}
+
+/**
+ * Add the cell matrix of the linear expression tested with all test
+ * functions to the local matrices of the cell.
+ */
+template <int dim, class Expr, class Test>
+void
+evaluate_matrix(DoFInfo<dim, dim>& dinfo, const QuadratureData<dim>& info, const Test& test,
+                const Expr& expr, ContractionData& data)
+{
+  static_assert(Expr::TensorTraits::rank == Test::TensorTraits::rank,
+                "Expression and test function must have equal rank");
+  const auto& fe_values = info.fe_values(0);
+
+  const auto& test_values = internal::test_values(test,
+                                                   info.fe_values(test.id().fe_index).dofs_per_cell,
+                                                   fe_values.n_quadrature_points,
+                                                   data,
+                                                   info);
+  internal::add_matrices(dinfo, false, false, test, test_values, expr, fe_values, data, info);
+}
+
+/**
+ * Add the face matrices of the linear expression tested with all test
+ * functions. The test functions determine the cell whose local matrices
+ * are filled. Trial functions on the same side of the face contribute to
+ * its own matrices, those on the other side to the external ones.
+ */
+template <int dim, class Expr, class Test>
+void
+evaluate_matrix(DoFInfo<dim, dim>& dinfo1, DoFInfo<dim, dim>& dinfo2,
+                const QuadratureData<dim>& info1, const QuadratureData<dim>& info2,
+                const Test& test, const Expr& expr, ContractionData& data)
+{
+  static_assert(Expr::TensorTraits::rank == Test::TensorTraits::rank,
+                "Expression and test function must have equal rank");
+  const auto& fe_values = info1.fe_values(0);
+  const auto& test_info = Test::is_exterior ? info2 : info1;
+  auto& test_dinfo = Test::is_exterior ? dinfo2 : dinfo1;
+
+  const auto& test_values =
+    internal::test_values(test,
+                          test_info.fe_values(test.id().fe_index).dofs_per_cell,
+                          fe_values.n_quadrature_points,
+                          data,
+                          info1,
+                          info2);
+  for (const bool trial_exterior : { false, true })
+    internal::add_matrices(test_dinfo,
+                           trial_exterior != Test::is_exterior,
+                           trial_exterior,
+                           test,
+                           test_values,
+                           expr,
+                           fe_values,
+                           data,
+                           info1,
+                           info2);
+}
+
+/**
+ * Add the boundary matrix of the linear expression tested with all test
+ * functions to the local matrices of the cell.
+ */
+template <int dim, class Expr, class Test>
+void
+evaluate_boundary_matrix(DoFInfo<dim, dim>& dinfo, const QuadratureData<dim>& info,
+                         const Test& test, const Expr& expr, ContractionData& data)
+{
+  static_assert(Expr::TensorTraits::rank == Test::TensorTraits::rank,
+                "Expression and test function must have equal rank");
+  const auto& fe_values = info.fe_values(0);
+
+  const auto& test_values = internal::test_values(test,
+                                                   info.fe_values(test.id().fe_index).dofs_per_cell,
+                                                   fe_values.n_quadrature_points,
+                                                   data,
+                                                   info,
+                                                   info);
+  internal::add_matrices(dinfo, false, false, test, test_values, expr, fe_values, data, info,
+                         info);
+}
+
+/**
+ * Set the integration loops a ::dealii::MeshWorker::LocalIntegrator is
+ * used for from the kinds of the Forms.
+ */
+template <int dim, class FORM>
+void
+set_use_objects(::dealii::MeshWorker::LocalIntegrator<dim>& integrator)
+{
+  std::array<bool, 3> use_objects{ { false, false, false } };
+  FORM::get_form_kinds(use_objects);
+  integrator.use_cell = use_objects[0];
+  integrator.use_face = use_objects[1];
+  integrator.use_boundary = use_objects[2];
+}
+
+/**
+ * A ::dealii::MeshWorker::LocalIntegrator computing the residual of a
+ * Forms object.
+ *
+ * The Forms are only read and each thread uses its own buffers, so the
+ * integrator can be used by multithreaded loops like
+ * colored_integration_loop().
+ */
+template <int dim, class FORM>
+class MeshWorkerIntegrator : public ::dealii::MeshWorker::LocalIntegrator<dim>
+{
+  const FORM& form;
+  /// Buffers for the local integration, one per thread
+  mutable ::dealii::Threads::ThreadLocalStorage<ContractionData> contraction_data;
+  /// The data on the cell or on both sides of a face, one per thread
+  mutable ::dealii::Threads::ThreadLocalStorage<std::array<QuadratureData<dim>, 2>>
+    quadrature_data;
+
+public:
+  explicit MeshWorkerIntegrator(const FORM& form)
+    : form(form)
+  {
+    set_use_objects<dim, FORM>(*this);
+    // TODO(darndt): Determine from form.
+    this->input_vector_names.push_back("u");
+  }
+
+  void
+  cell(DoFInfo<dim>& dinfo, IntegrationInfo<dim>& info) const override
+  {
+    ContractionData& data = contraction_data.get();
+    auto& values = quadrature_data.get()[0];
+    values.reinit(info);
+    data.new_cell();
+    for_each_form<FormKind::cell>(form, [&](const auto& test, const auto& expr) {
+      evaluate(dinfo, values, test, expr, data);
+    });
+  }
+
+  void
+  boundary(DoFInfo<dim>& dinfo, IntegrationInfo<dim>& info) const override
+  {
+    ContractionData& data = contraction_data.get();
+    auto& values = quadrature_data.get()[0];
+    values.reinit(info);
+    data.new_cell();
+    for_each_form<FormKind::boundary>(form, [&](const auto& test, const auto& expr) {
+      evaluate(dinfo, dinfo, values, values, test, expr, data);
+    });
+  }
+
+  void
+  face(DoFInfo<dim>& dinfo1, DoFInfo<dim>& dinfo2, IntegrationInfo<dim>& info1,
+       IntegrationInfo<dim>& info2) const override
+  {
+    ContractionData& data = contraction_data.get();
+    auto& values = quadrature_data.get();
+    values[0].reinit(info1);
+    values[1].reinit(info2);
+    data.new_cell();
+    for_each_form<FormKind::face>(form, [&](const auto& test, const auto& expr) {
+      evaluate(dinfo1, dinfo2, values[0], values[1], test, expr, data);
+    });
+  }
+};
+
+/**
+ * A ::dealii::MeshWorker::LocalIntegrator computing the local matrices of a
+ * Forms object which is linear in the finite element functions. Contrary
+ * to MeshWorkerIntegrator, no input vectors are needed.
+ */
+template <int dim, class FORM>
+class MeshWorkerMatrixIntegrator : public ::dealii::MeshWorker::LocalIntegrator<dim>
+{
+  const FORM& form;
+  /// Buffers for the local integration, one per thread
+  mutable ::dealii::Threads::ThreadLocalStorage<ContractionData> contraction_data;
+  /// The data on the cell or on both sides of a face, one per thread
+  mutable ::dealii::Threads::ThreadLocalStorage<std::array<QuadratureData<dim>, 2>>
+    quadrature_data;
+
+public:
+  explicit MeshWorkerMatrixIntegrator(const FORM& form)
+    : form(form)
+  {
+    set_use_objects<dim, FORM>(*this);
+  }
+
+  void
+  cell(DoFInfo<dim>& dinfo, IntegrationInfo<dim>& info) const override
+  {
+    ContractionData& data = contraction_data.get();
+    auto& values = quadrature_data.get()[0];
+    values.reinit(info);
+    data.new_cell();
+    for_each_form<FormKind::cell>(form, [&](const auto& test, const auto& expr) {
+      evaluate_matrix(dinfo, values, test, expr, data);
+    });
+  }
+
+  void
+  boundary(DoFInfo<dim>& dinfo, IntegrationInfo<dim>& info) const override
+  {
+    ContractionData& data = contraction_data.get();
+    auto& values = quadrature_data.get()[0];
+    values.reinit(info);
+    data.new_cell();
+    for_each_form<FormKind::boundary>(form, [&](const auto& test, const auto& expr) {
+      evaluate_boundary_matrix(dinfo, values, test, expr, data);
+    });
+  }
+
+  void
+  face(DoFInfo<dim>& dinfo1, DoFInfo<dim>& dinfo2, IntegrationInfo<dim>& info1,
+       IntegrationInfo<dim>& info2) const override
+  {
+    ContractionData& data = contraction_data.get();
+    auto& values = quadrature_data.get();
+    values[0].reinit(info1);
+    values[1].reinit(info2);
+    data.new_cell();
+    for_each_form<FormKind::face>(form, [&](const auto& test, const auto& expr) {
+      evaluate_matrix(dinfo1, dinfo2, values[0], values[1], test, expr, data);
+    });
+  }
+};
+} // namespace CFL::dealii::MeshWorker
+
+#endif
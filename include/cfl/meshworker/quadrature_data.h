@@ -0,0 +1,115 @@
+#ifndef MESHWORKER_QUADRATURE_DATA_H
+#define MESHWORKER_QUADRATURE_DATA_H
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/meshworker/integration_info.h>
+
+#include <vector>
+
+namespace CFL::dealii::MeshWorker
+{
+/**
+ * The values, gradients and Hessians of the finite element functions at the
+ * quadrature points of a cell or of one side of a face.
+ *
+ * ::dealii::MeshWorker::IntegrationInfo stores them in nested vectors
+ * indexed by input vector, component and quadrature point, with a Tensor
+ * for each derivative. reinit() copies them once per cell into one
+ * contiguous buffer per input vector, in which the quadrature point is the
+ * fastest running index. The terminals then read the values for
+ * consecutive quadrature points from consecutive memory locations.
+ *
+ * The FEValues objects providing the shape functions are still taken from
+ * the IntegrationInfo object.
+ */
+template <int dim>
+class QuadratureData
+{
+public:
+  /**
+   * Copy the data of <code>info</code>. The IntegrationInfo object must
+   * remain valid while this object is used.
+   */
+  void
+  reinit(const ::dealii::MeshWorker::IntegrationInfo<dim>& info)
+  {
+    integration_info = &info;
+    n_q_points = info.fe_values(0).n_quadrature_points;
+
+    values.resize(info.values.size());
+    for (unsigned int i = 0; i < info.values.size(); ++i)
+    {
+      const auto& source = info.values[i];
+      values[i].resize_fast(source.size() * n_q_points);
+      for (unsigned int c = 0; c < source.size(); ++c)
+        for (unsigned int q = 0; q < n_q_points; ++q)
+          values[i][c * n_q_points + q] = source[c][q];
+    }
+
+    gradients.resize(info.gradients.size());
+    for (unsigned int i = 0; i < info.gradients.size(); ++i)
+    {
+      const auto& source = info.gradients[i];
+      gradients[i].resize_fast(source.size() * dim * n_q_points);
+      for (unsigned int c = 0; c < source.size(); ++c)
+        for (unsigned int d = 0; d < dim; ++d)
+          for (unsigned int q = 0; q < n_q_points; ++q)
+            gradients[i][(c * dim + d) * n_q_points + q] = source[c][q][d];
+    }
+
+    hessians.resize(info.hessians.size());
+    for (unsigned int i = 0; i < info.hessians.size(); ++i)
+    {
+      const auto& source = info.hessians[i];
+      hessians[i].resize_fast(source.size() * dim * dim * n_q_points);
+      for (unsigned int c = 0; c < source.size(); ++c)
+        for (unsigned int d1 = 0; d1 < dim; ++d1)
+          for (unsigned int d2 = 0; d2 < dim; ++d2)
+            for (unsigned int q = 0; q < n_q_points; ++q)
+              hessians[i][((c * dim + d1) * dim + d2) * n_q_points + q] = source[c][q][d1][d2];
+    }
+  }
+
+  const ::dealii::FEValuesBase<dim>&
+  fe_values(unsigned int i) const
+  {
+    Assert(integration_info != nullptr, ::dealii::ExcInternalError());
+    return integration_info->fe_values(i);
+  }
+
+  double
+  value(unsigned int data_index, unsigned int component, unsigned int q) const
+  {
+    Assert(data_index < values.size(), ::dealii::ExcInternalError());
+    return values[data_index][component * n_q_points + q];
+  }
+
+  double
+  gradient(unsigned int data_index, unsigned int component, unsigned int d, unsigned int q) const
+  {
+    Assert(data_index < gradients.size(), ::dealii::ExcInternalError());
+    return gradients[data_index][(component * dim + d) * n_q_points + q];
+  }
+
+  double
+  hessian(unsigned int data_index, unsigned int component, unsigned int d1, unsigned int d2,
+          unsigned int q) const
+  {
+    Assert(data_index < hessians.size(), ::dealii::ExcInternalError());
+    return hessians[data_index][((component * dim + d1) * dim + d2) * n_q_points + q];
+  }
+
+private:
+  const ::dealii::MeshWorker::IntegrationInfo<dim>* integration_info = nullptr;
+  unsigned int n_q_points = 0;
+  /// For each input vector, the values indexed by (component, q)
+  std::vector<::dealii::AlignedVector<double>> values;
+  /// For each input vector, the gradients indexed by (component, d, q)
+  std::vector<::dealii::AlignedVector<double>> gradients;
+  /// For each input vector, the Hessians indexed by (component, d1, d2, q)
+  std::vector<::dealii::AlignedVector<double>> hessians;
+};
+} // namespace CFL::dealii::MeshWorker
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef REFERENCE_CARTESIAN_GRID_H
+#define REFERENCE_CARTESIAN_GRID_H
+
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+namespace CFL::Reference
+{
+/**
+ * A uniform grid of the unit hypercube with <code>n_cells_1d</code> cells
+ * in each direction and the degrees of freedom of a continuous Lagrange
+ * element of degree <code>degree</code>.
+ *
+ * Cells and degrees of freedom are numbered lexicographically with the
+ * first coordinate running fastest. Since all cells have the same size
+ * <code>h</code>, the Jacobian of the mapping from the reference cell is
+ * <code>h</code> times the identity on every cell.
+ */
+template <int dim>
+class CartesianGrid
+{
+public:
+  CartesianGrid(unsigned int n_cells_1d, unsigned int degree)
+    : n_cells_1d(n_cells_1d)
+    , degree(degree)
+    , n_dofs_1d(n_cells_1d * degree + 1)
+    , h(1. / n_cells_1d)
+  {
+    if (n_cells_1d == 0 || degree == 0)
+      throw std::invalid_argument("The grid needs at least one cell and degree one!");
+  }
+
+  unsigned int
+  n_cells() const
+  {
+    unsigned int n = 1;
+    for (unsigned int d = 0; d < dim; ++d)
+      n *= n_cells_1d;
+    return n;
+  }
+
+  unsigned int
+  n_dofs() const
+  {
+    unsigned int n = 1;
+    for (unsigned int d = 0; d < dim; ++d)
+      n *= n_dofs_1d;
+    return n;
+  }
+
+  unsigned int
+  dofs_per_cell() const
+  {
+    unsigned int n = 1;
+    for (unsigned int d = 0; d < dim; ++d)
+      n *= degree + 1;
+    return n;
+  }
+
+  /**
+   * The global indices of the degrees of freedom of <code>cell</code> in
+   * the lexicographic order of the tensor product basis.
+   */
+  void
+  get_dof_indices(unsigned int cell, std::vector<unsigned int>& indices) const
+  {
+    std::array<unsigned int, dim> first{};
+    for (unsigned int d = 0; d < dim; ++d, cell /= n_cells_1d)
+      first[d] = (cell % n_cells_1d) * degree;
+
+    indices.resize(dofs_per_cell());
+    for (unsigned int i = 0; i < indices.size(); ++i)
+    {
+      unsigned int index = 0, stride = 1, local = i;
+      for (unsigned int d = 0; d < dim; ++d, local /= degree + 1, stride *= n_dofs_1d)
+        index += (first[d] + local % (degree + 1)) * stride;
+      indices[i] = index;
+    }
+  }
+
+  /**
+   * The coordinates of the support point of the global degree of freedom
+   * <code>index</code>, given the one-dimensional support points on the
+   * reference cell.
+   */
+  std::array<double, dim>
+  support_point(unsigned int index, const std::vector<double>& support_points_1d) const
+  {
+    std::array<double, dim> point;
+    for (unsigned int d = 0; d < dim; ++d, index /= n_dofs_1d)
+    {
+      const unsigned int i = index % n_dofs_1d;
+      const unsigned int cell = (i == n_dofs_1d - 1) ? n_cells_1d - 1 : i / degree;
+      point[d] = h * (cell + support_points_1d[i - cell * degree]);
+    }
+    return point;
+  }
+
+  /**
+   * The degrees of freedom on the boundary of the hypercube, in increasing
+   * order.
+   */
+  std::vector<unsigned int>
+  boundary_dofs() const
+  {
+    std::vector<unsigned int> dofs;
+    for (unsigned int index = 0; index < n_dofs(); ++index)
+    {
+      bool at_boundary = false;
+      for (unsigned int d = 0, i = index; d < dim; ++d, i /= n_dofs_1d)
+        at_boundary |= (i % n_dofs_1d == 0 || i % n_dofs_1d == n_dofs_1d - 1);
+      if (at_boundary)
+        dofs.push_back(index);
+    }
+    return dofs;
+  }
+
+  const unsigned int n_cells_1d;
+  const unsigned int degree;
+  const unsigned int n_dofs_1d;
+  /// The edge length of the cells
+  const double h;
+};
+} // namespace CFL::Reference
+
+#endif // REFERENCE_CARTESIAN_GRID_H
@@ -0,0 +1,211 @@
+#ifndef REFERENCE_FE_EVALUATION_H
+#define REFERENCE_FE_EVALUATION_H
+
+#include <cfl/reference/cartesian_grid.h>
+#include <cfl/reference/shape_info.h>
+#include <cfl/reference/tensor.h>
+#include <cfl/reference/tensor_product_kernels.h>
+#include <cfl/reference/vectorized_array.h>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+namespace CFL::Reference
+{
+/**
+ * The evaluation of a scalar continuous Lagrange element of degree
+ * <code>fe_degree</code> on a batch of cells of a CartesianGrid, modelled
+ * after ::dealii::FEEvaluation.
+ *
+ * A batch consists of VectorizedArray::n_array_elements consecutive cells,
+ * which are processed together with one lane of each VectorizedArray per
+ * cell. The last batch may be partially filled, the unused lanes are not
+ * read from or written to global vectors.
+ *
+ * The values submitted in the quadrature points are added up, such that
+ * several Forms may submit values for the same test function.
+ */
+template <int dim, int fe_degree, int n_q_points_1d = fe_degree + 1, typename Number = double>
+class FEEvaluation
+{
+public:
+  using VectorizedArrayType = VectorizedArray<Number>;
+  using value_type = VectorizedArrayType;
+  using gradient_type = Tensor<dim, VectorizedArrayType>;
+  using Kernels = SumFactorization<dim, fe_degree + 1, n_q_points_1d, VectorizedArrayType>;
+
+  static constexpr unsigned int n_lanes = VectorizedArrayType::n_array_elements;
+  static constexpr unsigned int dofs_per_cell = Kernels::n_dofs;
+  static constexpr unsigned int n_q_points = Kernels::n_q_points;
+
+  FEEvaluation(const CartesianGrid<dim>& grid, const ShapeInfo& shape_info)
+    : grid(grid)
+    , shape_info(shape_info)
+    , inverse_h(1. / grid.h)
+  {
+    if (shape_info.degree != fe_degree || shape_info.n_q_points_1d != n_q_points_1d ||
+        grid.degree != fe_degree)
+      throw std::invalid_argument("The degree and the quadrature of the FEEvaluation object "
+                                  "must match the ShapeInfo and the grid!");
+
+    double measure = 1.;
+    for (unsigned int d = 0; d < dim; ++d)
+      measure *= grid.h;
+    for (unsigned int q = 0; q < n_q_points; ++q)
+    {
+      double weight = measure;
+      for (unsigned int d = 0, i = q; d < dim; ++d, i /= n_q_points_1d)
+        weight *= shape_info.quadrature_weights[i % n_q_points_1d];
+      JxW_values[q] = weight;
+    }
+  }
+
+  /**
+   * Request the evaluation of values or gradients in evaluate(). The
+   * flags of several calls are combined.
+   */
+  void
+  set_evaluation_flags(bool values, bool gradients)
+  {
+    evaluate_values |= values;
+    evaluate_gradients |= gradients;
+  }
+
+  /**
+   * Announce the submission of values or gradients for integrate(). The
+   * flags of several calls are combined.
+   */
+  void
+  set_integration_flags(bool values, bool gradients)
+  {
+    integrate_values |= values;
+    integrate_gradients |= gradients;
+  }
+
+  /**
+   * Work on the cells <code>first_cell</code>, <code>first_cell</code>+1,
+   * ... of the grid.
+   */
+  void
+  reinit(unsigned int first_cell)
+  {
+    n_filled_lanes = std::min(n_lanes, grid.n_cells() - first_cell);
+    for (unsigned int v = 0; v < n_filled_lanes; ++v)
+      grid.get_dof_indices(first_cell + v, dof_indices[v]);
+  }
+
+  unsigned int
+  n_active_lanes() const
+  {
+    return n_filled_lanes;
+  }
+
+  void
+  read_dof_values(const std::vector<Number>& src)
+  {
+    for (unsigned int i = 0; i < dofs_per_cell; ++i)
+    {
+      dof_values[i] = VectorizedArrayType();
+      for (unsigned int v = 0; v < n_filled_lanes; ++v)
+        dof_values[i][v] = src[dof_indices[v][i]];
+    }
+  }
+
+  void
+  distribute_local_to_global(std::vector<Number>& dst) const
+  {
+    for (unsigned int v = 0; v < n_filled_lanes; ++v)
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        dst[dof_indices[v][i]] += dof_values[i][v];
+  }
+
+  /**
+   * Compute the values and gradients requested by set_evaluation_flags()
+   * from the coefficients read by read_dof_values().
+   */
+  void
+  evaluate()
+  {
+    Kernels::evaluate(shape_info.shape_values.data(),
+                      shape_info.shape_gradients.data(),
+                      dof_values.data(),
+                      values_quad.data(),
+                      gradients_quad.data(),
+                      evaluate_values,
+                      evaluate_gradients);
+  }
+
+  /**
+   * Multiply the submitted values and gradients with the test functions
+   * announced by set_integration_flags() and sum over all quadrature
+   * points. The result replaces the coefficients of the cells and the
+   * submitted data is reset.
+   */
+  void
+  integrate()
+  {
+    Kernels::integrate(shape_info.shape_values.data(),
+                       shape_info.shape_gradients.data(),
+                       submitted_values.data(),
+                       submitted_gradients.data(),
+                       dof_values.data(),
+                       integrate_values,
+                       integrate_gradients);
+    std::fill(submitted_values.begin(), submitted_values.end(), VectorizedArrayType());
+    std::fill(submitted_gradients.begin(), submitted_gradients.end(), VectorizedArrayType());
+  }
+
+  value_type
+  get_value(unsigned int q) const
+  {
+    return values_quad[q];
+  }
+
+  gradient_type
+  get_gradient(unsigned int q) const
+  {
+    gradient_type gradient;
+    for (unsigned int d = 0; d < dim; ++d)
+      gradient[d] = gradients_quad[d * n_q_points + q] * inverse_h;
+    return gradient;
+  }
+
+  void
+  submit_value(const value_type& value, unsigned int q)
+  {
+    submitted_values[q] += value * JxW_values[q];
+  }
+
+  void
+  submit_gradient(const gradient_type& gradient, unsigned int q)
+  {
+    const double factor = JxW_values[q] * inverse_h;
+    for (unsigned int d = 0; d < dim; ++d)
+      submitted_gradients[d * n_q_points + q] += gradient[d] * factor;
+  }
+
+private:
+  const CartesianGrid<dim>& grid;
+  const ShapeInfo& shape_info;
+  const double inverse_h;
+
+  bool evaluate_values = false;
+  bool evaluate_gradients = false;
+  bool integrate_values = false;
+  bool integrate_gradients = false;
+
+  unsigned int n_filled_lanes = 0;
+  std::array<std::vector<unsigned int>, n_lanes> dof_indices;
+
+  std::array<double, n_q_points> JxW_values;
+  std::array<VectorizedArrayType, dofs_per_cell> dof_values;
+  std::array<VectorizedArrayType, n_q_points> values_quad;
+  std::array<VectorizedArrayType, dim * n_q_points> gradients_quad;
+  std::array<VectorizedArrayType, n_q_points> submitted_values{};
+  std::array<VectorizedArrayType, dim * n_q_points> submitted_gradients{};
+};
+} // namespace CFL::Reference
+
+#endif // REFERENCE_FE_EVALUATION_H
@@ -0,0 +1,322 @@
+#ifndef REFERENCE_FEFUNCTIONS_H
+#define REFERENCE_FEFUNCTIONS_H
+
+#include <cfl/base/fefunctions.h>
+#include <cfl/base/traits.h>
+
+#include <type_traits>
+#include <utility>
+
+namespace CFL
+{
+/**
+ * @brief A backend without external dependencies
+ *
+ * The reference backend evaluates Forms with scalar continuous Lagrange
+ * elements on a CartesianGrid using sum factorization. It is meant as a
+ * lightweight testbed for the expression layer and for micro-benchmarks of
+ * the kernels, not as a replacement for the deal.II backends.
+ */
+namespace Reference
+{
+  template <class Derived>
+  class TestFunctionBaseBase;
+  template <class Derived>
+  class FEFunctionBaseBase;
+} // namespace Reference
+
+namespace Traits
+{
+  template <template <int, int, unsigned int> class T, int rank, int dim, unsigned int idx>
+  struct is_cfl_object<
+    T<rank, dim, idx>,
+    std::enable_if_t<std::is_base_of<Reference::TestFunctionBaseBase<T<rank, dim, idx>>,
+                                     T<rank, dim, idx>>::value>>
+  {
+    static constexpr bool value = true;
+  };
+
+  template <template <int, int, unsigned int> class T, int rank, int dim, unsigned int idx>
+  struct is_cfl_object<
+    T<rank, dim, idx>,
+    std::enable_if_t<std::is_base_of<Reference::FEFunctionBaseBase<T<rank, dim, idx>>,
+                                     T<rank, dim, idx>>::value>>
+  {
+    static constexpr bool value = true;
+  };
+
+  /**
+   * All test functions of the reference backend live on cells.
+   */
+  template <template <int, int, unsigned int> class T, int rank, int dim, unsigned int idx>
+  struct test_function_set_type<
+    T<rank, dim, idx>,
+    std::enable_if_t<std::is_base_of<Reference::TestFunctionBaseBase<T<rank, dim, idx>>,
+                                     T<rank, dim, idx>>::value>>
+  {
+    static constexpr ObjectType value = ObjectType::cell;
+  };
+
+  /**
+   * All FE functions of the reference backend live on cells.
+   */
+  template <template <int, int, unsigned int> class T, int rank, int dim, unsigned int idx>
+  struct fe_function_set_type<
+    T<rank, dim, idx>,
+    std::enable_if_t<std::is_base_of<Reference::FEFunctionBaseBase<T<rank, dim, idx>>,
+                                     T<rank, dim, idx>>::value>>
+  {
+    static constexpr ObjectType value = ObjectType::cell;
+  };
+} // namespace Traits
+
+namespace Reference
+{
+  /**
+   * Top level base class for Test Functions, should never be constructed
+   * Defined for safety reasons
+   *
+   */
+  template <class T>
+  class TestFunctionBaseBase;
+
+  /**
+   * Top level base class for Test Functions. The reference backend only
+   * supports a single scalar finite element, thus the index must be zero.
+   */
+  template <template <int, int, unsigned int> class T, int rank, int dim, unsigned int idx>
+  class TestFunctionBaseBase<T<rank, dim, idx>>
+  {
+  public:
+    using TensorTraits = Traits::Tensor<rank, dim>;
+
+    static constexpr unsigned int index = idx;
+
+    static_assert(idx == 0, "The reference backend only supports a single finite element!");
+  };
+
+  /**
+   * Test Function which provides evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class TestFunction final : public TestFunctionBaseBase<TestFunction<rank, dim, idx>>
+  {
+  public:
+    static constexpr bool integrate_value = true;
+    static constexpr bool integrate_gradient = false;
+
+    static_assert(rank == 0, "The reference backend only supports scalar finite elements!");
+
+    /**
+     * Wrapper around submit_value function of FEEvaluation
+     *
+     */
+    template <class FEEvaluation, typename ValueType>
+    static void
+    submit(FEEvaluation& phi, unsigned int q, const ValueType& value)
+    {
+      phi.submit_value(value, q);
+    }
+  };
+
+  /**
+   * Test Function which provides gradient evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class TestGradient final : public TestFunctionBaseBase<TestGradient<rank, dim, idx>>
+  {
+  public:
+    static constexpr bool integrate_value = false;
+    static constexpr bool integrate_gradient = true;
+
+    static_assert(rank == 1, "The reference backend only supports scalar finite elements!");
+
+    /**
+     * Wrapper around submit_gradient function of FEEvaluation
+     *
+     */
+    template <class FEEvaluation, typename ValueType>
+    static void
+    submit(FEEvaluation& phi, unsigned int q, const ValueType& value)
+    {
+      phi.submit_gradient(value, q);
+    }
+  };
+
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::TestFunction<ints...>&)
+  {
+    return TestFunction<ints...>();
+  }
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::TestGradient<ints...>&)
+  {
+    return TestGradient<ints...>();
+  }
+
+  /**
+   * Top level base class for FE Functions, should never be constructed
+   * Defined for safety reasons
+   *
+   */
+  template <class Derived>
+  class FEFunctionBaseBase
+  {
+  public:
+    // This class should never be constructed
+    FEFunctionBaseBase() = delete;
+  };
+
+  /**
+   * Top level base class for FE Functions
+   *
+   */
+  template <template <int, int, unsigned int> class Derived, int rank, int dim, unsigned int idx>
+  class FEFunctionBaseBase<Derived<rank, dim, idx>>
+  {
+  public:
+    using TensorTraits = Traits::Tensor<rank, dim>;
+    static constexpr unsigned int index = idx;
+    const double scalar_factor = 1.;
+
+    static_assert(idx == 0, "The reference backend only supports a single finite element!");
+
+    constexpr explicit FEFunctionBaseBase(double new_factor = 1.)
+      : scalar_factor(new_factor)
+    {
+    }
+
+    template <template <int, int, unsigned int> class OtherFunction>
+    constexpr explicit FEFunctionBaseBase(const OtherFunction<rank, dim, idx>& other_function)
+      : scalar_factor(other_function.scalar_factor)
+    {
+    }
+
+    /**
+     * Allows to scale an FE function with a arithmetic value
+     *
+     */
+    template <typename Number>
+    constexpr typename std::enable_if_t<std::is_arithmetic<Number>::value, Derived<rank, dim, idx>>
+    operator*(const Number scalar_factor_) const
+    {
+      return Derived<rank, dim, idx>(scalar_factor * scalar_factor_);
+    }
+
+    /**
+     * Allows to negate an FE function
+     *
+     */
+    constexpr Derived<rank, dim, idx>
+    operator-() const
+    {
+      return Derived<rank, dim, idx>(-scalar_factor);
+    }
+  };
+
+  /**
+   * FE Function which provides evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class FEFunction final : public FEFunctionBaseBase<FEFunction<rank, dim, idx>>
+  {
+  public:
+    using Base = FEFunctionBaseBase<FEFunction<rank, dim, idx>>;
+    // inherit constructors
+    using Base::Base;
+
+    static_assert(rank == 0, "The reference backend only supports scalar finite elements!");
+
+    template <class FEEvaluation>
+    auto
+    value(const FEEvaluation& phi, unsigned int q) const
+    {
+      return Base::scalar_factor * phi.get_value(q);
+    }
+
+    /**
+     * Wrapper around set_evaluation_flags function of FEEvaluation
+     *
+     */
+    template <class FEEvaluation>
+    static void
+    set_evaluation_flags(FEEvaluation& phi)
+    {
+      phi.set_evaluation_flags(true, false);
+    }
+  };
+
+  /**
+   * FE Function which provides gradient evaluation on cells
+   *
+   */
+  template <int rank, int dim, unsigned int idx>
+  class FEGradient final : public FEFunctionBaseBase<FEGradient<rank, dim, idx>>
+  {
+  public:
+    using Base = FEFunctionBaseBase<FEGradient<rank, dim, idx>>;
+    // inherit constructors
+    using Base::Base;
+
+    static_assert(rank == 1, "The reference backend only supports scalar finite elements!");
+
+    template <class FEEvaluation>
+    auto
+    value(const FEEvaluation& phi, unsigned int q) const
+    {
+      return Base::scalar_factor * phi.get_gradient(q);
+    }
+
+    /**
+     * Wrapper around set_evaluation_flags function of FEEvaluation
+     *
+     */
+    template <class FEEvaluation>
+    static void
+    set_evaluation_flags(FEEvaluation& phi)
+    {
+      phi.set_evaluation_flags(false, true);
+    }
+  };
+
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::FEFunction<ints...>& f)
+  {
+    return FEFunction<ints...>(f.scalar_factor);
+  }
+  template <auto... ints>
+  constexpr auto
+  transform(const Base::FEGradient<ints...>& f)
+  {
+    return FEGradient<ints...>(f.scalar_factor);
+  }
+
+  template <class... Types>
+  constexpr auto transform(const Base::SumFEFunctions<Types...>& f);
+
+  template <class... Types>
+  constexpr auto transform(const Base::ProductFEFunctions<Types...>& f);
+
+  template <class... Types>
+  constexpr auto
+  transform(const Base::SumFEFunctions<Types...>& f)
+  {
+    return Base::SumFEFunctions<decltype(transform(std::declval<Types>()))...>(f);
+  }
+
+  template <class... Types>
+  constexpr auto
+  transform(const Base::ProductFEFunctions<Types...>& f)
+  {
+    return Base::ProductFEFunctions<decltype(transform(std::declval<Types>()))...>(f);
+  }
+} // namespace Reference
+} // namespace CFL
+
+#endif // REFERENCE_FEFUNCTIONS_H
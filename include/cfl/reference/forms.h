@@ -0,0 +1,134 @@
+#ifndef REFERENCE_FORMS_H
+#define REFERENCE_FORMS_H
+
+#include <cfl/base/forms.h>
+#include <cfl/reference/fefunctions.h>
+
+#include <utility>
+
+namespace CFL::Reference
+{
+/**
+ * A Form is an expression tested by a test function set. The reference
+ * backend only integrates over cells.
+ */
+template <class Test, class Expr, FormKind kind_of_form, typename NumberType = double>
+class Form final
+{
+public:
+  using TestType = Test;
+  const Test test;
+  const Expr expr;
+
+  static constexpr FormKind form_kind = kind_of_form;
+
+  static_assert(kind_of_form == FormKind::cell,
+                "The reference backend only supports integrals over cells!");
+
+  template <class OtherTest, class OtherExpr>
+  explicit constexpr Form(const Base::Form<OtherTest, OtherExpr, kind_of_form, NumberType> f)
+    : test(transform(f.test))
+    , expr(transform(f.expr))
+  {
+  }
+
+  template <class FEEvaluation>
+  void
+  set_evaluation_flags(FEEvaluation& phi) const
+  {
+    expr.set_evaluation_flags(phi);
+  }
+
+  template <class FEEvaluation>
+  static void
+  set_integration_flags(FEEvaluation& phi)
+  {
+    phi.set_integration_flags(Test::integrate_value, Test::integrate_gradient);
+  }
+
+  /**
+   * Evaluate the expression in the quadrature point <code>q</code> and
+   * submit it for the test function.
+   */
+  template <class FEEvaluation>
+  void
+  evaluate(FEEvaluation& phi, unsigned int q) const
+  {
+    Test::submit(phi, q, expr.value(phi, q));
+  }
+};
+
+template <typename... Types>
+class Forms;
+
+template <>
+class Forms<>
+{
+public:
+  explicit constexpr Forms(const Base::Forms<>& /*f*/)
+  {
+  }
+};
+
+/**
+ * The reference counterpart of Base::Forms. Since FEEvaluation adds up the
+ * submitted values, the Forms are evaluated one after the other.
+ */
+template <typename FormType, typename... Types>
+class Forms<FormType, Types...> : public Forms<Types...>
+{
+public:
+  template <class OtherType, class... OtherTypes,
+            typename std::enable_if<sizeof...(OtherTypes) == sizeof...(Types)>::type* = nullptr>
+  explicit constexpr Forms(const Base::Forms<OtherType, OtherTypes...>& f)
+    : Forms<Types...>(static_cast<const Base::Forms<OtherTypes...>&>(f))
+    , form(f.get_form())
+  {
+  }
+
+  template <class FEEvaluation>
+  void
+  set_evaluation_flags(FEEvaluation& phi) const
+  {
+    form.set_evaluation_flags(phi);
+    if constexpr(sizeof...(Types) != 0) Forms<Types...>::set_evaluation_flags(phi);
+  }
+
+  template <class FEEvaluation>
+  static void
+  set_integration_flags(FEEvaluation& phi)
+  {
+    FormType::set_integration_flags(phi);
+    if constexpr(sizeof...(Types) != 0) Forms<Types...>::set_integration_flags(phi);
+  }
+
+  template <class FEEvaluation>
+  void
+  evaluate(FEEvaluation& phi, unsigned int q) const
+  {
+    form.evaluate(phi, q);
+    if constexpr(sizeof...(Types) != 0) Forms<Types...>::evaluate(phi, q);
+  }
+
+private:
+  const FormType form;
+};
+
+template <class Test, class Expr, FormKind kind_of_form, typename NumberType>
+constexpr auto
+transform(const Base::Form<Test, Expr, kind_of_form, NumberType>& f)
+{
+  return Form<decltype(transform(std::declval<Test>())),
+              decltype(transform(std::declval<Expr>())),
+              kind_of_form>(f);
+}
+
+template <typename... Types>
+constexpr auto
+transform(const Base::Forms<Types...>& f)
+{
+  return Forms<decltype(transform(std::declval<Types>()))...>(f);
+}
+} // namespace CFL::Reference
+
+#endif // REFERENCE_FORMS_H
@@ -0,0 +1,117 @@
+#ifndef REFERENCE_INTEGRATOR_H
+#define REFERENCE_INTEGRATOR_H
+
+#include <cfl/reference/cartesian_grid.h>
+#include <cfl/reference/fe_evaluation.h>
+#include <cfl/reference/shape_info.h>
+
+#include <vector>
+
+namespace CFL::Reference
+{
+/**
+ * Evaluate a Form of the reference backend, obtained by
+ * Reference::transform() of a Base::Form or Base::Forms object, on all
+ * cells of a CartesianGrid.
+ *
+ * vmult() computes the residual of the Form for a finite element function.
+ * If the Form is linear in this function, it is the product with the
+ * matrix of the Form. Constrained degrees of freedom, usually the ones on
+ * the boundary, are treated like deal.II's MatrixFreeOperators do: their
+ * values are ignored on the cells and the operator acts as the identity on
+ * them. Thus, the operator stays symmetric and can be used in SolverCG for
+ * problems with homogeneous Dirichlet boundary conditions.
+ */
+template <int dim, int fe_degree, int n_q_points_1d, class FormType, typename Number = double>
+class ReferenceIntegrator
+{
+public:
+  using VectorType = std::vector<Number>;
+
+  ReferenceIntegrator(const CartesianGrid<dim>& grid, const FormType& form)
+    : grid(grid)
+    , shape_info(fe_degree, n_q_points_1d)
+    , form(form)
+  {
+  }
+
+  /**
+   * The degrees of freedom on which the operator is the identity.
+   */
+  void
+  set_constrained_dofs(const std::vector<unsigned int>& dofs)
+  {
+    constrained_dofs = dofs;
+  }
+
+  unsigned int
+  m() const
+  {
+    return grid.n_dofs();
+  }
+
+  void
+  initialize_vector(VectorType& v) const
+  {
+    v.assign(grid.n_dofs(), Number());
+  }
+
+  void
+  vmult(VectorType& dst, const VectorType& src) const
+  {
+    dst.assign(grid.n_dofs(), Number());
+    vmult_add(dst, src);
+  }
+
+  void
+  vmult_add(VectorType& dst, const VectorType& src) const
+  {
+    const VectorType* input = &src;
+    VectorType src_without_constraints;
+    std::vector<Number> dst_constrained(constrained_dofs.size());
+    if (!constrained_dofs.empty())
+    {
+      src_without_constraints = src;
+      for (unsigned int k = 0; k < constrained_dofs.size(); ++k)
+      {
+        src_without_constraints[constrained_dofs[k]] = Number();
+        dst_constrained[k] = dst[constrained_dofs[k]];
+      }
+      input = &src_without_constraints;
+    }
+
+    FEEvaluation<dim, fe_degree, n_q_points_1d, Number> phi(grid, shape_info);
+    form.set_evaluation_flags(phi);
+    form.set_integration_flags(phi);
+
+    for (unsigned int cell = 0; cell < grid.n_cells(); cell += phi.n_lanes)
+    {
+      phi.reinit(cell);
+      phi.read_dof_values(*input);
+      phi.evaluate();
+      for (unsigned int q = 0; q < phi.n_q_points; ++q)
+        form.evaluate(phi, q);
+      phi.integrate();
+      phi.distribute_local_to_global(dst);
+    }
+
+    // the cell contributions to constrained rows are discarded
+    for (unsigned int k = 0; k < constrained_dofs.size(); ++k)
+      dst[constrained_dofs[k]] = dst_constrained[k] + src[constrained_dofs[k]];
+  }
+
+  const ShapeInfo&
+  get_shape_info() const
+  {
+    return shape_info;
+  }
+
+private:
+  const CartesianGrid<dim>& grid;
+  const ShapeInfo shape_info;
+  const FormType form;
+  std::vector<unsigned int> constrained_dofs;
+};
+} // namespace CFL::Reference
+
+#endif // REFERENCE_INTEGRATOR_H
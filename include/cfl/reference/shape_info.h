@@ -0,0 +1,169 @@
+#ifndef REFERENCE_SHAPE_INFO_H
+#define REFERENCE_SHAPE_INFO_H
+
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace CFL::Reference
+{
+/**
+ * The <code>n_points</code> point Gauss-Legendre quadrature on [0,1] as a
+ * pair of points and weights. It integrates polynomials of degree
+ * 2 <code>n_points</code> - 1 exactly.
+ */
+inline std::pair<std::vector<double>, std::vector<double>>
+gauss_quadrature(unsigned int n_points)
+{
+  if (n_points == 0)
+    throw std::invalid_argument("A Gauss quadrature needs at least one point!");
+
+  std::vector<double> points(n_points), weights(n_points);
+  const double pi = std::acos(-1.);
+  for (unsigned int i = 0; i < n_points; ++i)
+  {
+    // Newton's method for the roots of the Legendre polynomial on [-1,1],
+    // starting from the Chebyshev points
+    double x = std::cos(pi * (i + .75) / (n_points + .5));
+    double derivative = 1.;
+    for (unsigned int it = 0; it < 100; ++it)
+    {
+      double p_old = 1., p = x;
+      for (unsigned int k = 2; k <= n_points; ++k)
+      {
+        const double p_new = ((2. * k - 1.) * x * p - (k - 1.) * p_old) / k;
+        p_old = p;
+        p = p_new;
+      }
+      derivative = n_points * (x * p - p_old) / (x * x - 1.);
+      const double dx = p / derivative;
+      x -= dx;
+      if (std::abs(dx) < 1.e-16)
+        break;
+    }
+    points[n_points - 1 - i] = .5 * (x + 1.);
+    weights[n_points - 1 - i] = 1. / ((1. - x * x) * derivative * derivative);
+  }
+  return { points, weights };
+}
+
+/**
+ * The <code>n_points</code> Gauss-Lobatto points on [0,1], the support
+ * points of the Lagrange bases. They include both end points, such that
+ * the bases are continuous across cells.
+ */
+inline std::vector<double>
+gauss_lobatto_points(unsigned int n_points)
+{
+  if (n_points < 2)
+    throw std::invalid_argument("Gauss-Lobatto points need at least two points!");
+
+  const unsigned int n = n_points - 1;
+  const double pi = std::acos(-1.);
+  std::vector<double> points(n_points);
+  for (unsigned int i = 0; i < n_points; ++i)
+  {
+    // Newton's method for the roots of (1-x^2) P_n'(x)
+    double x = -std::cos(pi * i / n);
+    for (unsigned int it = 0; it < 100; ++it)
+    {
+      double p_old = 1., p = x;
+      for (unsigned int k = 2; k <= n; ++k)
+      {
+        const double p_new = ((2. * k - 1.) * x * p - (k - 1.) * p_old) / k;
+        p_old = p;
+        p = p_new;
+      }
+      const double dx = (x * p - p_old) / (n_points * p);
+      x -= dx;
+      if (std::abs(dx) < 1.e-16)
+        break;
+    }
+    points[i] = .5 * (x + 1.);
+  }
+  points.front() = 0.;
+  points.back() = 1.;
+  return points;
+}
+
+/**
+ * The one-dimensional data of a tensor product Lagrange element of degree
+ * <code>degree</code> with support points in the Gauss-Lobatto points,
+ * evaluated in a Gauss quadrature with <code>n_q_points_1d</code> points.
+ *
+ * The matrices are stored row-wise with the quadrature point as the row
+ * index, i.e., <code>shape_values[q * n_dofs_1d + i]</code> is the value of
+ * the basis function <code>i</code> in the quadrature point <code>q</code>.
+ */
+class ShapeInfo
+{
+public:
+  ShapeInfo(unsigned int degree, unsigned int n_q_points_1d)
+    : degree(degree)
+    , n_dofs_1d(degree + 1)
+    , n_q_points_1d(n_q_points_1d)
+    , support_points(gauss_lobatto_points(degree + 1))
+  {
+    if (degree == 0)
+      throw std::invalid_argument("The reference backend needs continuous elements, "
+                                  "the degree must be at least 1!");
+    std::tie(quadrature_points, quadrature_weights) = gauss_quadrature(n_q_points_1d);
+
+    shape_values.resize(n_q_points_1d * n_dofs_1d);
+    shape_gradients.resize(n_q_points_1d * n_dofs_1d);
+    for (unsigned int q = 0; q < n_q_points_1d; ++q)
+      for (unsigned int i = 0; i < n_dofs_1d; ++i)
+      {
+        shape_values[q * n_dofs_1d + i] = value(i, quadrature_points[q]);
+        shape_gradients[q * n_dofs_1d + i] = derivative(i, quadrature_points[q]);
+      }
+  }
+
+  /**
+   * The Lagrange basis function <code>i</code> in <code>x</code>.
+   */
+  double
+  value(unsigned int i, double x) const
+  {
+    double result = 1.;
+    for (unsigned int j = 0; j < n_dofs_1d; ++j)
+      if (j != i)
+        result *= (x - support_points[j]) / (support_points[i] - support_points[j]);
+    return result;
+  }
+
+  /**
+   * The derivative of the Lagrange basis function <code>i</code> in
+   * <code>x</code>.
+   */
+  double
+  derivative(unsigned int i, double x) const
+  {
+    double result = 0.;
+    for (unsigned int m = 0; m < n_dofs_1d; ++m)
+    {
+      if (m == i)
+        continue;
+      double term = 1. / (support_points[i] - support_points[m]);
+      for (unsigned int j = 0; j < n_dofs_1d; ++j)
+        if (j != i && j != m)
+          term *= (x - support_points[j]) / (support_points[i] - support_points[j]);
+      result += term;
+    }
+    return result;
+  }
+
+  const unsigned int degree;
+  const unsigned int n_dofs_1d;
+  const unsigned int n_q_points_1d;
+  const std::vector<double> support_points;
+  std::vector<double> quadrature_points;
+  std::vector<double> quadrature_weights;
+  std::vector<double> shape_values;
+  std::vector<double> shape_gradients;
+};
+} // namespace CFL::Reference
+
+#endif // REFERENCE_SHAPE_INFO_H
@@ -0,0 +1,102 @@
+#ifndef REFERENCE_SOLVER_CG_H
+#define REFERENCE_SOLVER_CG_H
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace CFL::Reference
+{
+/**
+ * The unpreconditioned conjugate gradient method for a symmetric positive
+ * definite operator with a member function <code>vmult(dst, src)</code>
+ * acting on std::vector objects.
+ *
+ * The iteration stops when the residual is reduced by the factor
+ * <code>reduction</code> relative to the initial residual. If this does
+ * not happen within <code>max_iterations</code> steps, solve() throws an
+ * exception.
+ */
+class SolverCG
+{
+public:
+  SolverCG(unsigned int max_iterations, double reduction)
+    : max_iterations(max_iterations)
+    , reduction(reduction)
+  {
+  }
+
+  template <class Operator, typename Number>
+  void
+  solve(const Operator& A, std::vector<Number>& x, const std::vector<Number>& b)
+  {
+    const std::size_t n = b.size();
+    x.resize(n);
+    std::vector<Number> r(n), p(n), Ap(n);
+
+    A.vmult(Ap, x);
+    for (std::size_t i = 0; i < n; ++i)
+      r[i] = b[i] - Ap[i];
+    p = r;
+
+    Number r_norm_square = dot(r, r);
+    const double tolerance = reduction * std::sqrt(r_norm_square);
+    residual = std::sqrt(r_norm_square);
+    for (iterations = 0; iterations < max_iterations; ++iterations)
+    {
+      if (residual <= tolerance || r_norm_square == Number())
+        return;
+
+      A.vmult(Ap, p);
+      const Number alpha = r_norm_square / dot(p, Ap);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        x[i] += alpha * p[i];
+        r[i] -= alpha * Ap[i];
+      }
+      const Number r_norm_square_new = dot(r, r);
+      const Number beta = r_norm_square_new / r_norm_square;
+      r_norm_square = r_norm_square_new;
+      residual = std::sqrt(r_norm_square);
+      for (std::size_t i = 0; i < n; ++i)
+        p[i] = r[i] + beta * p[i];
+    }
+    if (residual > tolerance)
+      throw std::runtime_error("SolverCG did not converge in " + std::to_string(max_iterations) +
+                               " iterations, the last residual is " + std::to_string(residual));
+  }
+
+  /// The number of iterations of the last call to solve()
+  unsigned int
+  last_step() const
+  {
+    return iterations;
+  }
+
+  /// The norm of the residual at the end of the last call to solve()
+  double
+  last_residual() const
+  {
+    return residual;
+  }
+
+private:
+  template <typename Number>
+  static Number
+  dot(const std::vector<Number>& a, const std::vector<Number>& b)
+  {
+    Number result = Number();
+    for (std::size_t i = 0; i < a.size(); ++i)
+      result += a[i] * b[i];
+    return result;
+  }
+
+  const unsigned int max_iterations;
+  const double reduction;
+  unsigned int iterations = 0;
+  double residual = 0.;
+};
+} // namespace CFL::Reference
+
+#endif // REFERENCE_SOLVER_CG_H
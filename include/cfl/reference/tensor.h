@@ -0,0 +1,116 @@
+#ifndef REFERENCE_TENSOR_H
+#define REFERENCE_TENSOR_H
+
+#include <array>
+#include <type_traits>
+
+namespace CFL::Reference
+{
+/**
+ * A vector with <code>dim</code> entries, the value type of gradients in
+ * the reference backend. The entries are usually VectorizedArray objects.
+ *
+ * The operators follow ::dealii::Tensor<1,dim>, in particular the product
+ * of two tensors is the scalar product.
+ */
+template <int dim, typename Number>
+class Tensor
+{
+public:
+  constexpr Tensor() = default;
+
+  Number& operator[](unsigned int d)
+  {
+    return data[d];
+  }
+
+  const Number& operator[](unsigned int d) const
+  {
+    return data[d];
+  }
+
+  Tensor&
+  operator+=(const Tensor& other)
+  {
+    for (unsigned int d = 0; d < dim; ++d)
+      data[d] += other.data[d];
+    return *this;
+  }
+
+  Tensor&
+  operator-=(const Tensor& other)
+  {
+    for (unsigned int d = 0; d < dim; ++d)
+      data[d] -= other.data[d];
+    return *this;
+  }
+
+  template <typename Factor>
+  Tensor&
+  operator*=(const Factor& factor)
+  {
+    for (unsigned int d = 0; d < dim; ++d)
+      data[d] = data[d] * factor;
+    return *this;
+  }
+
+  Tensor
+  operator-() const
+  {
+    Tensor result;
+    for (unsigned int d = 0; d < dim; ++d)
+      result.data[d] = -data[d];
+    return result;
+  }
+
+private:
+  std::array<Number, dim> data{};
+};
+
+template <int dim, typename Number>
+inline Tensor<dim, Number>
+operator+(Tensor<dim, Number> a, const Tensor<dim, Number>& b)
+{
+  return a += b;
+}
+
+template <int dim, typename Number>
+inline Tensor<dim, Number>
+operator-(Tensor<dim, Number> a, const Tensor<dim, Number>& b)
+{
+  return a -= b;
+}
+
+/**
+ * The scalar product of two tensors.
+ */
+template <int dim, typename Number>
+inline Number operator*(const Tensor<dim, Number>& a, const Tensor<dim, Number>& b)
+{
+  Number result = a[0] * b[0];
+  for (unsigned int d = 1; d < dim; ++d)
+    result += a[d] * b[d];
+  return result;
+}
+
+/**
+ * Scaling with an arithmetic value or with a value of the entry type.
+ */
+template <int dim, typename Number, typename Factor,
+          typename std::enable_if_t<std::is_arithmetic<Factor>::value ||
+                                    std::is_same<Factor, Number>::value>* = nullptr>
+inline Tensor<dim, Number> operator*(Tensor<dim, Number> a, const Factor& factor)
+{
+  return a *= factor;
+}
+
+template <int dim, typename Number, typename Factor,
+          typename std::enable_if_t<std::is_arithmetic<Factor>::value ||
+                                    std::is_same<Factor, Number>::value>* = nullptr>
+inline Tensor<dim, Number> operator*(const Factor& factor, Tensor<dim, Number> a)
+{
+  return a *= factor;
+}
+} // namespace CFL::Reference
+
+#endif // REFERENCE_TENSOR_H
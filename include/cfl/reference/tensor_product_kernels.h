@@ -0,0 +1,204 @@
+#ifndef REFERENCE_TENSOR_PRODUCT_KERNELS_H
+#define REFERENCE_TENSOR_PRODUCT_KERNELS_H
+
+#include <array>
+
+namespace CFL::Reference
+{
+namespace internal
+{
+  /**
+   * Apply a one-dimensional matrix to the middle index of a tensor with
+   * the index ranges (<code>n_pre</code>, <code>n_in</code>,
+   * <code>n_post</code>), where the first index runs fastest, and write the
+   * result with index ranges (<code>n_pre</code>, <code>n_out</code>,
+   * <code>n_post</code>) to <code>out</code>.
+   *
+   * The matrix is stored row-wise with <code>n_in</code> columns, or with
+   * <code>n_out</code> columns if <code>transpose</code> is set. If
+   * <code>add</code> is set, the result is added to <code>out</code>.
+   */
+  template <int n_pre, int n_in, int n_out, int n_post, bool transpose, bool add,
+            typename Number>
+  inline void
+  apply_1d(const double* matrix, const Number* in, Number* out)
+  {
+    for (int i_post = 0; i_post < n_post; ++i_post)
+      for (int i_pre = 0; i_pre < n_pre; ++i_pre)
+      {
+        const Number* in_line = in + i_pre + n_pre * n_in * i_post;
+        Number* out_line = out + i_pre + n_pre * n_out * i_post;
+        for (int o = 0; o < n_out; ++o)
+        {
+          Number sum = in_line[0] * (transpose ? matrix[o] : matrix[o * n_in]);
+          for (int k = 1; k < n_in; ++k)
+            sum += in_line[n_pre * k] * (transpose ? matrix[k * n_out + o] : matrix[o * n_in + k]);
+          if (add)
+            out_line[n_pre * o] += sum;
+          else
+            out_line[n_pre * o] = sum;
+        }
+      }
+  }
+
+  /**
+   * Helper computing n^dim at compile time.
+   */
+  constexpr int
+  power(int n, int dim)
+  {
+    return dim == 0 ? 1 : n * power(n, dim - 1);
+  }
+}
+
+/**
+ * Sum factorization for the tensor product Lagrange elements of the
+ * reference backend: the values and gradients in the
+ * <code>n_q_points_1d</code>^dim quadrature points are computed from the
+ * <code>n_dofs_1d</code>^dim coefficients of a cell by applying the
+ * one-dimensional shape function matrices of a ShapeInfo object direction by
+ * direction, and integrate() applies the transposed operation. This costs
+ * O(dim n^(dim+1)) instead of O(n^(2 dim)) operations per cell.
+ *
+ * The gradients are with respect to the reference coordinates and are
+ * stored as <code>dim</code> consecutive blocks of quadrature point values.
+ * All arrays are indexed lexicographically with the first coordinate
+ * running fastest.
+ */
+template <int dim, int n_dofs_1d, int n_q_points_1d, typename Number>
+struct SumFactorization
+{
+  static_assert(dim >= 1 && dim <= 3, "Only dimensions 1, 2 and 3 are implemented!");
+
+  static constexpr int n = n_dofs_1d;
+  static constexpr int nq = n_q_points_1d;
+  static constexpr int n_dofs = internal::power(n, dim);
+  static constexpr int n_q_points = internal::power(nq, dim);
+  /// The size of intermediate results in which some directions are transformed already
+  static constexpr int n_max = internal::power(n > nq ? n : nq, dim);
+
+  using Scratch = std::array<Number, n_max>;
+
+  static void
+  evaluate(const double* shape_values, const double* shape_gradients, const Number* dofs,
+           Number* values, Number* gradients, bool evaluate_values, bool evaluate_gradients)
+  {
+    const double* V = shape_values;
+    const double* G = shape_gradients;
+    using internal::apply_1d;
+
+    if constexpr(dim == 1)
+      {
+        if (evaluate_values)
+          apply_1d<1, n, nq, 1, false, false>(V, dofs, values);
+        if (evaluate_gradients)
+          apply_1d<1, n, nq, 1, false, false>(G, dofs, gradients);
+      }
+    else if constexpr(dim == 2)
+      {
+        Scratch t0, t1;
+        apply_1d<1, n, nq, n, false, false>(V, dofs, t0.data());
+        if (evaluate_values)
+          apply_1d<nq, n, nq, 1, false, false>(V, t0.data(), values);
+        if (evaluate_gradients)
+        {
+          apply_1d<1, n, nq, n, false, false>(G, dofs, t1.data());
+          apply_1d<nq, n, nq, 1, false, false>(V, t1.data(), gradients);
+          apply_1d<nq, n, nq, 1, false, false>(G, t0.data(), gradients + n_q_points);
+        }
+      }
+    else
+      {
+        Scratch t0, t1, s00, s01, s10;
+        apply_1d<1, n, nq, n * n, false, false>(V, dofs, t0.data());
+        apply_1d<nq, n, nq, n, false, false>(V, t0.data(), s00.data());
+        if (evaluate_values)
+          apply_1d<nq * nq, n, nq, 1, false, false>(V, s00.data(), values);
+        if (evaluate_gradients)
+        {
+          apply_1d<1, n, nq, n * n, false, false>(G, dofs, t1.data());
+          apply_1d<nq, n, nq, n, false, false>(V, t1.data(), s10.data());
+          apply_1d<nq, n, nq, n, false, false>(G, t0.data(), s01.data());
+          apply_1d<nq * nq, n, nq, 1, false, false>(V, s10.data(), gradients);
+          apply_1d<nq * nq, n, nq, 1, false, false>(V, s01.data(), gradients + n_q_points);
+          apply_1d<nq * nq, n, nq, 1, false, false>(G, s00.data(), gradients + 2 * n_q_points);
+        }
+      }
+  }
+
+  /**
+   * The transpose of evaluate(), overwriting <code>dofs</code>.
+   */
+  static void
+  integrate(const double* shape_values, const double* shape_gradients, const Number* values,
+            const Number* gradients, Number* dofs, bool integrate_values, bool integrate_gradients)
+  {
+    const double* V = shape_values;
+    const double* G = shape_gradients;
+    using internal::apply_1d;
+
+    if (!integrate_values && !integrate_gradients)
+    {
+      for (int i = 0; i < n_dofs; ++i)
+        dofs[i] = Number();
+      return;
+    }
+
+    if constexpr(dim == 1)
+      {
+        if (integrate_values)
+          apply_1d<1, nq, n, 1, true, false>(V, values, dofs);
+        if (integrate_gradients)
+        {
+          if (integrate_values)
+            apply_1d<1, nq, n, 1, true, true>(G, gradients, dofs);
+          else
+            apply_1d<1, nq, n, 1, true, false>(G, gradients, dofs);
+        }
+      }
+    else if constexpr(dim == 2)
+      {
+        Scratch t0, t1;
+        if (integrate_values)
+          apply_1d<nq, nq, n, 1, true, false>(V, values, t0.data());
+        if (integrate_gradients)
+        {
+          if (integrate_values)
+            apply_1d<nq, nq, n, 1, true, true>(G, gradients + n_q_points, t0.data());
+          else
+            apply_1d<nq, nq, n, 1, true, false>(G, gradients + n_q_points, t0.data());
+          apply_1d<nq, nq, n, 1, true, false>(V, gradients, t1.data());
+        }
+        apply_1d<1, nq, n, n, true, false>(V, t0.data(), dofs);
+        if (integrate_gradients)
+          apply_1d<1, nq, n, n, true, true>(G, t1.data(), dofs);
+      }
+    else
+      {
+        Scratch t0, t1, s00, s01, s10;
+        if (integrate_values)
+          apply_1d<nq * nq, nq, n, 1, true, false>(V, values, s00.data());
+        if (integrate_gradients)
+        {
+          if (integrate_values)
+            apply_1d<nq * nq, nq, n, 1, true, true>(G, gradients + 2 * n_q_points, s00.data());
+          else
+            apply_1d<nq * nq, nq, n, 1, true, false>(G, gradients + 2 * n_q_points, s00.data());
+          apply_1d<nq * nq, nq, n, 1, true, false>(V, gradients + n_q_points, s01.data());
+          apply_1d<nq * nq, nq, n, 1, true, false>(V, gradients, s10.data());
+        }
+        apply_1d<nq, nq, n, n, true, false>(V, s00.data(), t0.data());
+        if (integrate_gradients)
+        {
+          apply_1d<nq, nq, n, n, true, true>(G, s01.data(), t0.data());
+          apply_1d<nq, nq, n, n, true, false>(V, s10.data(), t1.data());
+        }
+        apply_1d<1, nq, n, n * n, true, false>(V, t0.data(), dofs);
+        if (integrate_gradients)
+          apply_1d<1, nq, n, n * n, true, true>(G, t1.data(), dofs);
+      }
+  }
+};
+} // namespace CFL::Reference
+
+#endif // REFERENCE_TENSOR_PRODUCT_KERNELS_H
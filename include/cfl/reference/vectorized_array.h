@@ -0,0 +1,160 @@
+#ifndef REFERENCE_VECTORIZED_ARRAY_H
+#define REFERENCE_VECTORIZED_ARRAY_H
+
+#include <array>
+#include <cmath>
+#include <type_traits>
+
+#ifndef CFL_REFERENCE_VECTORIZATION_WIDTH
+/**
+ * The number of cells processed together by the reference backend. It
+ * should be chosen such that VectorizedArray<double> fills a SIMD register,
+ * i.e., 2 for SSE2, 4 for AVX and 8 for AVX-512.
+ */
+#define CFL_REFERENCE_VECTORIZATION_WIDTH 4
+#endif
+
+namespace CFL::Reference
+{
+/**
+ * A batch of <code>width</code> numbers, one for each cell of a batch of
+ * cells, with the arithmetic operations applied lane by lane.
+ *
+ * This is the counterpart of ::dealii::VectorizedArray. Instead of
+ * intrinsics, all operations are written as fixed length loops over
+ * std::array, which compilers turn into SIMD instructions for the target
+ * architecture when optimizing.
+ */
+template <typename Number, unsigned int width = CFL_REFERENCE_VECTORIZATION_WIDTH>
+class VectorizedArray
+{
+public:
+  static constexpr unsigned int n_array_elements = width;
+
+  constexpr VectorizedArray() = default;
+
+  /**
+   * Broadcast <code>scalar</code> to all lanes.
+   */
+  constexpr VectorizedArray(const Number scalar)
+  {
+    for (unsigned int v = 0; v < width; ++v)
+      data[v] = scalar;
+  }
+
+  Number&
+  operator[](unsigned int v)
+  {
+    return data[v];
+  }
+
+  const Number&
+  operator[](unsigned int v) const
+  {
+    return data[v];
+  }
+
+  VectorizedArray&
+  operator+=(const VectorizedArray& other)
+  {
+    for (unsigned int v = 0; v < width; ++v)
+      data[v] += other.data[v];
+    return *this;
+  }
+
+  VectorizedArray&
+  operator-=(const VectorizedArray& other)
+  {
+    for (unsigned int v = 0; v < width; ++v)
+      data[v] -= other.data[v];
+    return *this;
+  }
+
+  VectorizedArray&
+  operator*=(const VectorizedArray& other)
+  {
+    for (unsigned int v = 0; v < width; ++v)
+      data[v] *= other.data[v];
+    return *this;
+  }
+
+  VectorizedArray&
+  operator/=(const VectorizedArray& other)
+  {
+    for (unsigned int v = 0; v < width; ++v)
+      data[v] /= other.data[v];
+    return *this;
+  }
+
+  VectorizedArray
+  operator-() const
+  {
+    VectorizedArray result;
+    for (unsigned int v = 0; v < width; ++v)
+      result.data[v] = -data[v];
+    return result;
+  }
+
+private:
+  std::array<Number, width> data{};
+};
+
+template <typename Number, unsigned int width>
+inline VectorizedArray<Number, width>
+operator+(VectorizedArray<Number, width> a, const VectorizedArray<Number, width>& b)
+{
+  return a += b;
+}
+
+template <typename Number, unsigned int width>
+inline VectorizedArray<Number, width>
+operator-(VectorizedArray<Number, width> a, const VectorizedArray<Number, width>& b)
+{
+  return a -= b;
+}
+
+template <typename Number, unsigned int width>
+inline VectorizedArray<Number, width> operator*(VectorizedArray<Number, width> a,
+                                                const VectorizedArray<Number, width>& b)
+{
+  return a *= b;
+}
+
+template <typename Number, unsigned int width>
+inline VectorizedArray<Number, width>
+operator/(VectorizedArray<Number, width> a, const VectorizedArray<Number, width>& b)
+{
+  return a /= b;
+}
+
+/**
+ * Scaling with an arithmetic value, as used for the scalar factors of the
+ * CFL terminals.
+ */
+template <typename Number, unsigned int width, typename Scalar,
+          typename std::enable_if_t<std::is_arithmetic<Scalar>::value>* = nullptr>
+inline VectorizedArray<Number, width> operator*(const Scalar a,
+                                                VectorizedArray<Number, width> b)
+{
+  return b *= VectorizedArray<Number, width>(a);
+}
+
+template <typename Number, unsigned int width, typename Scalar,
+          typename std::enable_if_t<std::is_arithmetic<Scalar>::value>* = nullptr>
+inline VectorizedArray<Number, width> operator*(VectorizedArray<Number, width> a,
+                                                const Scalar b)
+{
+  return a *= VectorizedArray<Number, width>(b);
+}
+
+template <typename Number, unsigned int width>
+inline VectorizedArray<Number, width>
+abs(VectorizedArray<Number, width> a)
+{
+  for (unsigned int v = 0; v < width; ++v)
+    a[v] = std::abs(a[v]);
+  return a;
+}
+} // namespace CFL::Reference
+
+#endif // REFERENCE_VECTORIZED_ARRAY_H
@@ -0,0 +1,345 @@
+#ifndef RUNTIME_KERNEL_CACHE_H
+#define RUNTIME_KERNEL_CACHE_H
+
+#include <cfl/runtime/operator.h>
+#include <cfl/runtime/parser.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+#ifndef CFL_RUNTIME_CXX_COMPILER
+#define CFL_RUNTIME_CXX_COMPILER "c++"
+#endif
+
+#ifndef CFL_RUNTIME_CXX_FLAGS
+#define CFL_RUNTIME_CXX_FLAGS "-O3"
+#endif
+
+#ifndef CFL_RUNTIME_INCLUDE_DIR
+#define CFL_RUNTIME_INCLUDE_DIR "."
+#endif
+
+namespace CFL::Runtime
+{
+/**
+ * Write the C++ source of a shared library that evaluates the Form
+ * <code>form</code> with the reference backend. The library exports the
+ * function
+ * @code
+ * extern "C" CFL::Runtime::Operator* cfl_create_operator(unsigned int n_cells_1d);
+ * @endcode
+ * which creates the operator on a CartesianGrid with <code>n_cells_1d</code>
+ * cells per direction.
+ */
+inline std::string
+generate_operator_source(const FormExpression& form, int dim, int degree)
+{
+  std::ostringstream source;
+  source << "#include <cfl/base/fefunctions.h>\n"
+         << "#include <cfl/base/forms.h>\n"
+         << "#include <cfl/reference/forms.h>\n"
+         << "#include <cfl/reference/reference_integrator.h>\n"
+         << "#include <cfl/runtime/operator.h>\n\n"
+         << "namespace\n{\n"
+         << "using namespace CFL;\n\n"
+         << "constexpr int dim = " << dim << ";\n"
+         << "constexpr int degree = " << degree << ";\n\n"
+         << "auto\nmake_form()\n{\n"
+         << "  constexpr Base::FEFunction<0, dim, 0> u;\n"
+         << "  constexpr Base::TestFunction<0, dim, 0> v;\n"
+         << "  return Reference::transform(" << form.print() << ");\n}\n\n"
+         << "using FormType = decltype(make_form());\n\n"
+         << "class Operator final : public Runtime::Operator\n{\n"
+         << "public:\n"
+         << "  explicit Operator(unsigned int n_cells_1d)\n"
+         << "    : grid(n_cells_1d, degree)\n"
+         << "    , integrator(grid, make_form())\n  {\n  }\n\n"
+         << "  unsigned int\n  m() const override\n  {\n    return integrator.m();\n  }\n\n"
+         << "  void\n  vmult(std::vector<double>& dst, const std::vector<double>& src) const "
+            "override\n  {\n    integrator.vmult(dst, src);\n  }\n\n"
+         << "  void\n  set_constrained_dofs(const std::vector<unsigned int>& dofs) override\n"
+         << "  {\n    integrator.set_constrained_dofs(dofs);\n  }\n\n"
+         << "  std::vector<unsigned int>\n  boundary_dofs() const override\n  {\n"
+         << "    return grid.boundary_dofs();\n  }\n\n"
+         << "private:\n"
+         << "  const Reference::CartesianGrid<dim> grid;\n"
+         << "  Reference::ReferenceIntegrator<dim, degree, degree + 1, FormType> integrator;\n"
+         << "};\n"
+         << "} // namespace\n\n"
+         << "extern \"C\" CFL::Runtime::Operator*\n"
+         << "cfl_create_operator(unsigned int n_cells_1d)\n{\n"
+         << "  return new Operator(n_cells_1d);\n}\n";
+  return source.str();
+}
+
+namespace internal
+{
+  /**
+   * The 64 bit FNV-1a hash, which unlike std::hash is the same for every
+   * run of every program. Passing the hash of a previous text continues it.
+   */
+  inline std::uint64_t
+  fnv1a(const std::string& text, std::uint64_t hash = 14695981039346656037ull)
+  {
+    for (const char c : text)
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  /**
+   * A hash of the names and contents of all headers of the library below
+   * <code>include_dir</code>, which identifies the version of the templates
+   * the generated sources are compiled against.
+   */
+  inline std::uint64_t
+  header_hash(const std::string& include_dir)
+  {
+    const std::filesystem::path cfl_dir = std::filesystem::path(include_dir) / "cfl";
+    std::vector<std::filesystem::path> headers;
+    if (std::filesystem::is_directory(cfl_dir))
+      for (const auto& entry : std::filesystem::recursive_directory_iterator(cfl_dir))
+        if (entry.is_regular_file())
+          headers.push_back(entry.path());
+    // the order of the directory iteration is unspecified
+    std::sort(headers.begin(), headers.end());
+
+    std::uint64_t hash = fnv1a("");
+    for (const auto& header : headers)
+    {
+      std::ifstream file(header, std::ios::binary);
+      std::stringstream content;
+      content << file.rdbuf();
+      hash = fnv1a(std::filesystem::relative(header, cfl_dir).string(), hash);
+      hash = fnv1a(content.str(), hash);
+    }
+    return hash;
+  }
+
+  /**
+   * A shared library opened with dlopen(), which is closed on destruction.
+   */
+  class SharedLibrary
+  {
+  public:
+    explicit SharedLibrary(const std::string& path)
+      : handle(dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL))
+    {
+      if (handle == nullptr)
+        throw std::runtime_error("Cannot load " + path + ": " + dlerror());
+    }
+
+    SharedLibrary(const SharedLibrary&) = delete;
+    SharedLibrary&
+    operator=(const SharedLibrary&) = delete;
+
+    ~SharedLibrary()
+    {
+      dlclose(handle);
+    }
+
+    void*
+    symbol(const std::string& name) const
+    {
+      void* address = dlsym(handle, name.c_str());
+      if (address == nullptr)
+        throw std::runtime_error("Cannot find the symbol " + name + ": " + dlerror());
+      return address;
+    }
+
+  private:
+    void* handle;
+  };
+} // namespace internal
+
+/**
+ * Compile Forms given as text, see parse_form(), into shared libraries and
+ * create Operator objects from them.
+ *
+ * The libraries are stored in <code>directory</code> and named after a hash
+ * of the normalized Form, the dimension, the degree, the compiler and its
+ * flags and the headers of the library, such that later runs and other
+ * programs using the same directory load them without compiling, but
+ * libraries compiled against other versions of the headers are not reused.
+ * The sources, the compiler output and the library are first written to
+ * files with the process id in their names and the library is then renamed,
+ * thus concurrent runs never load incomplete files. The sources and the
+ * compiler output are removed afterwards. If the compilation fails, the
+ * compiler output is part of the exception.
+ */
+class KernelCache
+{
+public:
+  explicit KernelCache(std::string directory = default_directory(),
+                       std::string compiler = CFL_RUNTIME_CXX_COMPILER,
+                       std::string flags = CFL_RUNTIME_CXX_FLAGS)
+    : directory(std::move(directory))
+    , compiler(std::move(compiler))
+    , flags(std::move(flags))
+    , build_id(internal::header_hash(CFL_RUNTIME_INCLUDE_DIR))
+  {
+    std::filesystem::create_directories(this->directory);
+  }
+
+  /**
+   * The directory given by the environment variable CFL_KERNEL_CACHE, or
+   * <code>cfl</code> in the user's cache directory.
+   */
+  static std::string
+  default_directory()
+  {
+    if (const char* directory = std::getenv("CFL_KERNEL_CACHE"))
+      return directory;
+    if (const char* cache = std::getenv("XDG_CACHE_HOME"))
+      return std::string(cache) + "/cfl";
+    if (const char* home = std::getenv("HOME"))
+      return std::string(home) + "/.cache/cfl";
+    return (std::filesystem::temp_directory_path() / "cfl").string();
+  }
+
+  /**
+   * Create the operator of the Form <code>text</code> for elements of
+   * degree <code>degree</code> on a grid of the unit hypercube in
+   * <code>dim</code> dimensions with <code>n_cells_1d</code> cells per
+   * direction. The library is compiled if it is not in the cache.
+   */
+  std::shared_ptr<Operator>
+  create_operator(const std::string& text, int dim, int degree, unsigned int n_cells_1d)
+  {
+    const std::shared_ptr<internal::SharedLibrary> library = load(text, dim, degree);
+    using Factory = Operator* (*)(unsigned int);
+    const auto factory = reinterpret_cast<Factory>(library->symbol("cfl_create_operator"));
+    // the library must stay loaded as long as the operator exists
+    return std::shared_ptr<Operator>(factory(n_cells_1d),
+                                     [library](Operator* op) { delete op; });
+  }
+
+  /**
+   * The path of the library for the given Form, degree and dimension,
+   * which exists after the first call to create_operator() with them.
+   */
+  std::string
+  library_path(const std::string& text, int dim, int degree) const
+  {
+    return library_path(parse_form(text), dim, degree);
+  }
+
+  /// The number of libraries compiled by this object
+  unsigned int
+  n_compilations() const
+  {
+    return compilations;
+  }
+
+private:
+  std::string
+  library_path(const FormExpression& form, int dim, int degree) const
+  {
+    // the version changes when generate_operator_source() changes
+    std::ostringstream key;
+    key << "version=1;headers=" << std::hex << build_id << ";dim=" << std::dec << dim
+        << ";degree=" << degree << ";compiler=" << compiler << ";flags=" << flags
+        << ";form=" << form.print();
+    std::ostringstream name;
+    name << std::hex << internal::fnv1a(key.str());
+    return directory + "/cfl_" + name.str() + ".so";
+  }
+
+  static bool
+  only_cell_forms(const FormExpression& form)
+  {
+    if (form.kind == FormExpression::Kind::call &&
+        (form.name == "face_form" || form.name == "boundary_form"))
+      return false;
+    for (const auto& argument : form.arguments)
+      if (!only_cell_forms(argument))
+        return false;
+    return true;
+  }
+
+  std::shared_ptr<internal::SharedLibrary>
+  load(const std::string& text, int dim, int degree)
+  {
+    if (dim < 1 || dim > 3 || degree < 1)
+      throw std::invalid_argument("The reference backend needs 1 <= dim <= 3 and degree >= 1!");
+    const FormExpression form = parse_form(text);
+    if (!only_cell_forms(form))
+      throw std::invalid_argument("The reference backend only supports integrals over cells!");
+
+    const std::string path = library_path(form, dim, degree);
+    const auto loaded = libraries.find(path);
+    if (loaded != libraries.end())
+      return loaded->second;
+    if (!std::filesystem::exists(path))
+      compile(generate_operator_source(form, dim, degree), path);
+    return libraries[path] = std::make_shared<internal::SharedLibrary>(path);
+  }
+
+  void
+  compile(const std::string& source, const std::string& path)
+  {
+    // concurrent runs compiling the same library must not share any files
+    const std::string pid = std::to_string(getpid());
+    const std::string base = path.substr(0, path.size() - 3) + "." + pid;
+    const std::string temporary = path + "." + pid;
+    {
+      std::ofstream file(base + ".cc");
+      file << source;
+      if (!file)
+        throw std::runtime_error("Cannot write " + base + ".cc");
+    }
+
+    const std::string command = compiler + " -std=c++17 " + flags + " -fPIC -shared -I\"" +
+                                CFL_RUNTIME_INCLUDE_DIR + "\" \"" + base + ".cc\" -o \"" +
+                                temporary + "\" > \"" + base + ".log\" 2>&1";
+    if (std::system(command.c_str()) != 0)
+    {
+      std::stringstream output;
+      {
+        std::ifstream log(base + ".log");
+        output << log.rdbuf();
+      }
+      remove_build_files(base, temporary);
+      throw std::runtime_error("Compiling the kernel " + path + " failed:\n" + output.str());
+    }
+    std::filesystem::rename(temporary, path);
+    remove_build_files(base, temporary);
+    ++compilations;
+  }
+
+  /// Remove the files compile() writes besides the library
+  static void
+  remove_build_files(const std::string& base, const std::string& temporary)
+  {
+    std::remove((base + ".cc").c_str());
+    std::remove((base + ".log").c_str());
+    std::remove(temporary.c_str());
+  }
+
+  const std::string directory;
+  const std::string compiler;
+  const std::string flags;
+  /// The hash of the headers the libraries are compiled against
+  const std::uint64_t build_id;
+  std::map<std::string, std::shared_ptr<internal::SharedLibrary>> libraries;
+  unsigned int compilations = 0;
+};
+} // namespace CFL::Runtime
+
+#endif // RUNTIME_KERNEL_CACHE_H
@@ -0,0 +1,33 @@
+#ifndef RUNTIME_OPERATOR_H
+#define RUNTIME_OPERATOR_H
+
+#include <vector>
+
+namespace CFL::Runtime
+{
+/**
+ * The interface of the operators compiled at run time by KernelCache. It
+ * provides the functions of Reference::ReferenceIntegrator needed by
+ * Reference::SolverCG.
+ */
+class Operator
+{
+public:
+  virtual ~Operator() = default;
+
+  virtual unsigned int
+  m() const = 0;
+
+  virtual void
+  vmult(std::vector<double>& dst, const std::vector<double>& src) const = 0;
+
+  virtual void
+  set_constrained_dofs(const std::vector<unsigned int>& dofs) = 0;
+
+  /// The degrees of freedom on the boundary of the grid
+  virtual std::vector<unsigned int>
+  boundary_dofs() const = 0;
+};
+} // namespace CFL::Runtime
+
+#endif // RUNTIME_OPERATOR_H
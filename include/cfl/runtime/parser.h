@@ -0,0 +1,334 @@
+#ifndef RUNTIME_PARSER_H
+#define RUNTIME_PARSER_H
+
+#include <cctype>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace CFL::Runtime
+{
+/**
+ * The node of a Form parsed at run time. The language mirrors the C++
+ * syntax of the base layer: the finite element function is called
+ * <code>u</code>, the test function <code>v</code> and the expressions
+ * are combined with <code>form</code>, <code>face_form</code>,
+ * <code>boundary_form</code>, <code>grad</code>, <code>div</code>,
+ * <code>+</code>, <code>-</code> and <code>*</code>, e.g.
+ * @code
+ * form(grad(u), grad(v)) + 2 * form(u * u, v)
+ * @endcode
+ */
+struct FormExpression
+{
+  enum class Kind
+  {
+    number,
+    fe_function,
+    test_function,
+    call,
+    sum,
+    difference,
+    product,
+    negation
+  };
+
+  /**
+   * What an expression evaluates to, used for checking the arguments of
+   * the operations.
+   */
+  enum class Type
+  {
+    number,
+    fe_function,
+    test_function,
+    form
+  };
+
+  Kind kind;
+  Type type;
+  std::string name;
+  std::vector<FormExpression> arguments;
+
+  /**
+   * Print the expression as C++ code for the base layer. Since all
+   * operations are put in parentheses and numbers are printed as double
+   * literals, the result does not depend on the formatting of the input
+   * and can be used to identify the Form.
+   */
+  std::string
+  print() const
+  {
+    switch (kind)
+    {
+      case Kind::number:
+      case Kind::fe_function:
+      case Kind::test_function:
+        return name;
+      case Kind::call:
+      {
+        std::string result = name + "(";
+        for (unsigned int i = 0; i < arguments.size(); ++i)
+          result += (i == 0 ? "" : ", ") + arguments[i].print();
+        return result + ")";
+      }
+      case Kind::sum:
+        return "(" + arguments[0].print() + " + " + arguments[1].print() + ")";
+      case Kind::difference:
+        return "(" + arguments[0].print() + " - " + arguments[1].print() + ")";
+      case Kind::product:
+        return "(" + arguments[0].print() + " * " + arguments[1].print() + ")";
+      default:
+        return "(-" + arguments[0].print() + ")";
+    }
+  }
+};
+
+namespace internal
+{
+  /**
+   * A recursive descent parser for the grammar
+   * @code
+   * sum     := product (('+' | '-') product)*
+   * product := unary ('*' unary)*
+   * unary   := '-' unary | primary
+   * primary := number | name | name '(' sum (',' sum)* ')' | '(' sum ')'
+   * @endcode
+   * which checks the types of the operands while parsing.
+   */
+  class FormParser
+  {
+  public:
+    using Kind = FormExpression::Kind;
+    using Type = FormExpression::Type;
+
+    explicit FormParser(const std::string& text)
+      : text(text)
+    {
+    }
+
+    FormExpression
+    parse()
+    {
+      FormExpression result = parse_sum();
+      skip_whitespace();
+      if (position != text.size())
+        error("unexpected character '" + std::string(1, text[position]) + "'");
+      if (result.type != Type::form)
+        error("the expression is not a form");
+      return result;
+    }
+
+  private:
+    FormExpression
+    parse_sum()
+    {
+      FormExpression result = parse_product();
+      while (true)
+      {
+        skip_whitespace();
+        if (!(peek('+') || peek('-')))
+          return result;
+        const bool plus = text[position++] == '+';
+        FormExpression summand = parse_product();
+        if (result.type != summand.type ||
+            (result.type != Type::fe_function && result.type != Type::form) ||
+            (result.type == Type::form && !plus))
+          error(std::string("cannot ") + (plus ? "add " : "subtract ") + name(summand.type) +
+                (plus ? " to " : " from ") + name(result.type));
+        result = { plus ? Kind::sum : Kind::difference, result.type, "", { result, summand } };
+      }
+    }
+
+    FormExpression
+    parse_product()
+    {
+      FormExpression result = parse_unary();
+      while (true)
+      {
+        skip_whitespace();
+        if (!peek('*'))
+          return result;
+        ++position;
+        FormExpression factor = parse_unary();
+        Type type = Type::form;
+        if (result.type == Type::number && factor.type == Type::number)
+          type = Type::number;
+        else if ((result.type == Type::fe_function || result.type == Type::number) &&
+                 (factor.type == Type::fe_function || factor.type == Type::number))
+          type = Type::fe_function;
+        else if (!((result.type == Type::form && factor.type == Type::number) ||
+                   (result.type == Type::number && factor.type == Type::form)))
+          error("cannot multiply " + name(result.type) + " and " + name(factor.type));
+        result = { Kind::product, type, "", { result, factor } };
+      }
+    }
+
+    FormExpression
+    parse_unary()
+    {
+      skip_whitespace();
+      if (!peek('-'))
+        return parse_primary();
+      ++position;
+      FormExpression operand = parse_unary();
+      if (operand.type != Type::number && operand.type != Type::fe_function)
+        error("cannot negate " + name(operand.type));
+      return { Kind::negation, operand.type, "", { operand } };
+    }
+
+    FormExpression
+    parse_primary()
+    {
+      skip_whitespace();
+      if (peek('('))
+      {
+        ++position;
+        FormExpression result = parse_sum();
+        expect(')');
+        return result;
+      }
+      if (position < text.size() &&
+          (std::isdigit(static_cast<unsigned char>(text[position])) || peek('.')))
+        return parse_number();
+
+      const std::string identifier = parse_identifier();
+      skip_whitespace();
+      if (!peek('('))
+      {
+        if (identifier == "u")
+          return { Kind::fe_function, Type::fe_function, identifier, {} };
+        if (identifier == "v")
+          return { Kind::test_function, Type::test_function, identifier, {} };
+        error("unknown function '" + identifier + "'");
+      }
+
+      ++position;
+      std::vector<FormExpression> arguments{ parse_sum() };
+      skip_whitespace();
+      while (peek(','))
+      {
+        ++position;
+        arguments.push_back(parse_sum());
+        skip_whitespace();
+      }
+      expect(')');
+
+      if (identifier == "grad" || identifier == "div")
+      {
+        if (arguments.size() != 1 || (arguments[0].type != Type::fe_function &&
+                                      arguments[0].type != Type::test_function))
+          error(identifier + " needs a finite element or test function as only argument");
+        return { Kind::call, arguments[0].type, identifier, arguments };
+      }
+      if (identifier == "form" || identifier == "face_form" || identifier == "boundary_form")
+      {
+        if (arguments.size() != 2 ||
+            !((arguments[0].type == Type::test_function &&
+               arguments[1].type == Type::fe_function) ||
+              (arguments[0].type == Type::fe_function &&
+               arguments[1].type == Type::test_function)))
+          error(identifier + " needs a finite element function and a test function");
+        return { Kind::call, Type::form, identifier, arguments };
+      }
+      error("unknown operation '" + identifier + "'");
+    }
+
+    FormExpression
+    parse_number()
+    {
+      const char* begin = text.c_str() + position;
+      char* end = nullptr;
+      const double value = std::strtod(begin, &end);
+      if (end == begin)
+        error("invalid number");
+      position += end - begin;
+
+      std::ostringstream stream;
+      stream << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+      std::string literal = stream.str();
+      if (literal.find_first_of(".e") == std::string::npos)
+        literal += ".";
+      return { Kind::number, Type::number, literal, {} };
+    }
+
+    std::string
+    parse_identifier()
+    {
+      const std::size_t begin = position;
+      while (position < text.size() &&
+             (std::isalnum(static_cast<unsigned char>(text[position])) || text[position] == '_'))
+        ++position;
+      if (begin == position)
+        error(position < text.size() ? "unexpected character '" + std::string(1, text[position]) +
+                                         "'"
+                                     : "unexpected end of input");
+      return text.substr(begin, position - begin);
+    }
+
+    void
+    expect(char c)
+    {
+      skip_whitespace();
+      if (!peek(c))
+        error("expected '" + std::string(1, c) + "'");
+      ++position;
+    }
+
+    bool
+    peek(char c) const
+    {
+      return position < text.size() && text[position] == c;
+    }
+
+    void
+    skip_whitespace()
+    {
+      while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position])))
+        ++position;
+    }
+
+    static std::string
+    name(Type type)
+    {
+      switch (type)
+      {
+        case Type::number:
+          return "a number";
+        case Type::fe_function:
+          return "a finite element function";
+        case Type::test_function:
+          return "a test function";
+        default:
+          return "a form";
+      }
+    }
+
+    [[noreturn]] void
+    error(const std::string& message) const
+    {
+      throw std::invalid_argument("Cannot parse \"" + text + "\" at position " +
+                                  std::to_string(position) + ": " + message);
+    }
+
+    const std::string& text;
+    std::size_t position = 0;
+  };
+} // namespace internal
+
+/**
+ * Parse a Form given as text, see FormExpression for the syntax. Throws
+ * std::invalid_argument if the text is not a valid Form.
+ */
+inline FormExpression
+parse_form(const std::string& text)
+{
+  return internal::FormParser(text).parse();
+}
+} // namespace CFL::Runtime
+
+#endif // RUNTIME_PARSER_H
@@ -0,0 +1 @@
+#include <cfl/codegen/expression.h>
@@ -0,0 +1 @@
+#include <cfl/codegen/fefunctions.h>
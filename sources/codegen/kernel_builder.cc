@@ -0,0 +1 @@
+#include <cfl/codegen/kernel_builder.h>
@@ -0,0 +1 @@
+#include <cfl/codegen/kernel_generator.h>
@@ -0,0 +1 @@
+#include <cfl/matrixfree/async_output.h>
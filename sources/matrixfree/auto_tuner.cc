@@ -0,0 +1 @@
+#include <cfl/matrixfree/auto_tuner.h>
@@ -0,0 +1 @@
+#include <cfl/matrixfree/capture.h>
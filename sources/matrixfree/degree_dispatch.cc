@@ -0,0 +1 @@
+#include <cfl/matrixfree/degree_dispatch.h>
@@ -0,0 +1 @@
+#include <cfl/matrixfree/form_profiler.h>
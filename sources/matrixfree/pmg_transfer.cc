@@ -0,0 +1 @@
+#include <cfl/matrixfree/pmg_transfer.h>
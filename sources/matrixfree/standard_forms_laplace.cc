@@ -0,0 +1,4 @@
+#include <cfl/matrixfree/standard_forms.h>
+
+CFL_STANDARD_FORM_INSTANTIATION_DIMS(, Laplace, 1)
+CFL_STANDARD_FORM_INSTANTIATIONS(, Laplace)
@@ -0,0 +1,3 @@
+#include <cfl/matrixfree/standard_forms.h>
+
+CFL_STANDARD_FORM_INSTANTIATIONS(, Stokes)
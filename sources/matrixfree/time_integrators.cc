@@ -0,0 +1 @@
+#include <cfl/matrixfree/time_integrators.h>
@@ -0,0 +1 @@
+#include <cfl/matrixfree/trace.h>
@@ -0,0 +1 @@
+#include <cfl/meshworker/colored_loop.h>
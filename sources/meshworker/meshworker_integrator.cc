@@ -0,0 +1 @@
+#include <cfl/meshworker/meshworker_integrator.h>
@@ -0,0 +1 @@
+#include <cfl/meshworker/quadrature_data.h>
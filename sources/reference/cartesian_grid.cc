@@ -0,0 +1 @@
+#include <cfl/reference/cartesian_grid.h>
@@ -0,0 +1 @@
+#include <cfl/reference/fe_evaluation.h>
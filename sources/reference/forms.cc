@@ -0,0 +1 @@
+#include <cfl/reference/forms.h>
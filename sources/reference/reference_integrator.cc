@@ -0,0 +1 @@
+#include <cfl/reference/reference_integrator.h>
@@ -0,0 +1 @@
+#include <cfl/reference/shape_info.h>
@@ -0,0 +1 @@
+#include <cfl/reference/solver_cg.h>
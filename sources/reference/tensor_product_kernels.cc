@@ -0,0 +1 @@
+#include <cfl/reference/tensor_product_kernels.h>
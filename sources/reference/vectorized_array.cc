@@ -0,0 +1 @@
+#include <cfl/reference/vectorized_array.h>
@@ -0,0 +1 @@
+#include <cfl/runtime/kernel_cache.h>
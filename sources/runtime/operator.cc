@@ -0,0 +1 @@
+#include <cfl/runtime/operator.h>
@@ -0,0 +1 @@
+#include <cfl/runtime/parser.h>
@@ -0,0 +1,39 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <iostream>
+#include <cfl/codegen/forms.h>
+#include <cfl/codegen/kernel_generator.h>
+
+using namespace CFL;
+
+template <class FormType>
+void
+print(const FormType& form, const std::string& name)
+{
+  Codegen::KernelGenerator<FormType>(form, name).print(std::cout);
+  std::cout << std::endl;
+}
+
+int
+main()
+{
+  constexpr Base::FEFunction<0, 2, 0> p;
+  constexpr Base::TestFunction<0, 2, 0> q;
+  constexpr Base::FEFunction<1, 2, 1> u;
+  constexpr Base::TestFunction<1, 2, 1> v;
+
+  // constant folding: the scalar factors cancel and u - u vanishes
+  print(Codegen::transform(form(p * 2. * 0.5, q) + form(u - u, v)), "folding");
+
+  // p * p is computed once for both Forms
+  print(Codegen::transform(form(p * p, q) + form(p * p * p, q)), "common_subexpressions");
+
+  print(Codegen::transform(form(grad(p), grad(q)) + form(p, q) * 2.), "laplace");
+
+  print(Codegen::transform(form(p * div(u), q) + form(-p, div(v)) +
+                           form(Base::FESymmetricGradient<2, 2, 1>(), grad(v))),
+        "two_elements");
+
+  return 0;
+}
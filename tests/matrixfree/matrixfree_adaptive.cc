@@ -0,0 +1,153 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+
+#include <cstdio>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// Assemble the Laplace matrix condensed with the hanging node constraints
+// and compare its action to the matrix-free operator in all unconstrained rows.
+template <int dim, class Data>
+bool
+matches_sparse_matrix(const Data& data)
+{
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  const DoFHandler<dim>& dof = data.get_dof_handler();
+  const AffineConstraints<double>& constraints = data.get_constraints();
+  const unsigned int n_dofs = dof.n_dofs();
+
+  SparsityPattern sparsity;
+  {
+    DynamicSparsityPattern csp(n_dofs, n_dofs);
+    DoFTools::make_sparsity_pattern(dof, csp, constraints, true);
+    sparsity.copy_from(csp);
+  }
+  SparseMatrix<double> sparse_matrix(sparsity);
+  {
+    QGauss<dim> quadrature_formula(dof.get_fe().degree + 1);
+    FEValues<dim> fe_values(dof.get_fe(), quadrature_formula, update_gradients | update_JxW_values);
+
+    const unsigned int dofs_per_cell = dof.get_fe().dofs_per_cell;
+    FullMatrix<double> cell_matrix(dofs_per_cell, dofs_per_cell);
+    std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+    for (const auto& cell : dof.active_cell_iterators())
+    {
+      cell_matrix = 0;
+      fe_values.reinit(cell);
+      for (unsigned int q = 0; q < quadrature_formula.size(); ++q)
+        for (unsigned int i = 0; i < dofs_per_cell; ++i)
+          for (unsigned int j = 0; j < dofs_per_cell; ++j)
+            cell_matrix(i, j) +=
+              fe_values.shape_grad(i, q) * fe_values.shape_grad(j, q) * fe_values.JxW(q);
+      cell->get_dof_indices(local_dof_indices);
+      constraints.distribute_local_to_global(cell_matrix, local_dof_indices, sparse_matrix);
+    }
+  }
+
+  VectorType src, dst, ref;
+  data.get_matrix_free().initialize_dof_vector(src);
+  data.get_matrix_free().initialize_dof_vector(dst);
+  data.get_matrix_free().initialize_dof_vector(ref);
+  for (types::global_dof_index j = 0; j < n_dofs; ++j)
+    src[j] = constraints.is_constrained(j) ? 0. : 1. + std::sin(static_cast<double>(j));
+
+  data.vmult(dst, src);
+  sparse_matrix.vmult(ref, src);
+  for (types::global_dof_index j = 0; j < n_dofs; ++j)
+    if (constraints.is_constrained(j))
+      ref[j] = dst[j];
+  ref -= dst;
+  return ref.l2_norm() < 1.e-10 * dst.l2_norm();
+}
+
+template <int dim>
+void
+run(unsigned int refine, unsigned int degree)
+{
+  FE_Q<dim> fe_u(degree);
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe_u);
+
+  FEData<FE_Q, 2, 1, dim, 0, 2> fedata(fe_u);
+  FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+  Base::TestFunction<0, dim, 0> v;
+  Base::FEFunction<0, dim, 0> u;
+  auto f = transform(Base::form(grad(u), grad(v)));
+
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  MatrixFreeData<dim, decltype(fe_datas), decltype(f), VectorType> data(
+    2, refine, fes, fe_datas, f);
+
+  std::cout << "Hanging nodes: " << (matches_sparse_matrix<dim>(data) ? "OK" : "FAILED")
+            << std::endl;
+
+  // refine where a steep solution varies most, then check again on the new mesh
+  VectorType solution;
+  data.resize_vector(solution);
+  for (types::global_dof_index j = 0; j < solution.size(); ++j)
+    solution[j] = (j % 7 == 0) ? 1. : 0.;
+  const unsigned int n_cells = data.get_triangulation().n_active_cells();
+  data.refine_adaptive(solution);
+  std::cout << "Adaptive refinement: "
+            << (data.get_triangulation().n_active_cells() > n_cells &&
+                    matches_sparse_matrix<dim>(data)
+                  ? "OK"
+                  : "FAILED")
+            << std::endl;
+
+  // on the locally refined mesh, the tuner also tries the cells grouped by level
+  const std::string cache_file = "adaptive_tuning_cache.txt";
+  std::remove(cache_file.c_str());
+  AutoTuner tuner(cache_file);
+  data.tune(tuner);
+  std::cout << "Tuned on the adaptive mesh: "
+            << (tuner.n_trials() > 0 && matches_sparse_matrix<dim>(data) ? "OK" : "FAILED")
+            << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2>(2, 2);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,140 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <deal.II/base/function_lib.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/numerics/data_out.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <cfl/matrixfree/async_output.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// the VTU header contains the time of writing, skip comment lines
+std::string
+without_comments(std::istream& stream)
+{
+  std::string result;
+  std::string line;
+  while (std::getline(stream, line))
+    if (line.rfind("<!--", 0) != 0)
+      result += line + "\n";
+  return result;
+}
+
+std::string
+read_file(const std::string& name)
+{
+  std::ifstream file(name);
+  return without_comments(file);
+}
+
+// The files written in the background must be the same as those written
+// directly, also if the vector changes after write() returned.
+template <int dim>
+void
+run()
+{
+  Triangulation<dim> triangulation;
+  GridGenerator::hyper_cube(triangulation);
+  triangulation.refine_global(3);
+  FE_Q<dim> fe(2);
+  DoFHandler<dim> dof_handler(triangulation);
+  dof_handler.distribute_dofs(fe);
+
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  VectorType solution(dof_handler.n_dofs());
+
+  const unsigned int n_cycles = 4;
+  std::vector<std::string> expected(n_cycles);
+  {
+    AsyncDataOut<dim, VectorType> output(dof_handler, fe.degree, 1);
+    for (unsigned int cycle = 0; cycle < n_cycles; ++cycle)
+    {
+      VectorTools::interpolate(dof_handler, Functions::SquareFunction<dim>(), solution);
+      solution *= 1. + cycle;
+      output.write("async", cycle, { { &solution, "solution" } });
+
+      DataOut<dim> data_out;
+      data_out.attach_dof_handler(dof_handler);
+      data_out.add_data_vector(solution, "solution");
+      data_out.build_patches(fe.degree);
+      DataOutBase::VtkFlags flags;
+      flags.compression_level = DataOutBase::VtkFlags::best_speed;
+      data_out.set_flags(flags);
+      std::stringstream stream;
+      data_out.write_vtu(stream);
+      expected[cycle] = without_comments(stream);
+
+      // overwritten before the output might be written
+      solution = 0.;
+    }
+    output.flush();
+  }
+
+  bool same = true;
+  for (unsigned int cycle = 0; cycle < n_cycles; ++cycle)
+    same &= read_file("async-" + std::to_string(cycle) + ".0.vtu") == expected[cycle] &&
+            !read_file("async-" + std::to_string(cycle) + ".pvtu").empty();
+  std::cout << "Background output in " << dim << "D: " << (same ? "OK" : "FAILED") << std::endl;
+
+  // errors of the worker are reported to the caller
+  bool thrown = false;
+  try
+  {
+    AsyncDataOut<dim, VectorType> output(dof_handler, 1);
+    output.write("missing_directory/async", 0, { { &solution, "solution" } });
+    output.flush();
+  }
+  catch (const std::exception&)
+  {
+    thrown = true;
+  }
+  std::cout << "Error rethrown: " << (thrown ? "OK" : "FAILED") << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2>();
+    run<3>();
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
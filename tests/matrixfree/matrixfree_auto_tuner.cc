@@ -0,0 +1,103 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/matrixfree/auto_tuner.h>
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// The first tuner runs the trials and stores the parameters, a second tuner
+// reading the same file must use them without trials. Tuning must not change
+// the result of the operator.
+template <int dim, unsigned int degree>
+void
+run(unsigned int refine)
+{
+  FE_Q<dim> fe(degree);
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+  FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+  Base::TestFunction<0, dim, 0> v;
+  Base::FEFunction<0, dim, 0> u;
+  auto f = transform(Base::form(u, v) + Base::form(grad(u), grad(v)));
+
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  MatrixFreeData<dim, decltype(fe_datas), decltype(f), VectorType> data(
+    0, refine, fes, fe_datas, f);
+
+  VectorType src, dst, reference;
+  data.resize_vector(src);
+  data.resize_vector(dst);
+  data.resize_vector(reference);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = std::sin(1. + i);
+  data.vmult(reference, src);
+
+  const std::string cache_file = "auto_tuner_cache.txt";
+  std::remove(cache_file.c_str());
+
+  AutoTuner tuner(cache_file);
+  const ExecutionParameters tuned = data.tune(tuner);
+  const std::vector<ExecutionParameters> candidates = AutoTuner::candidates();
+  const bool candidate =
+    std::find(candidates.begin(), candidates.end(), tuned) != candidates.end();
+  std::cout << "Tuned parameters are a candidate: " << (candidate ? "OK" : "FAILED")
+            << std::endl;
+
+  AutoTuner cached_tuner(cache_file);
+  const std::string key = AutoTuner::key<decltype(f)>(degree, dim, 1u << (dim * refine));
+  const bool cached = cached_tuner.lookup(key) && *cached_tuner.lookup(key) == tuned &&
+                      data.tune(cached_tuner) == tuned && cached_tuner.n_trials() == 0;
+  std::cout << "Cached parameters reused: " << (cached ? "OK" : "FAILED") << std::endl;
+
+  data.vmult(dst, src);
+  dst -= reference;
+  std::cout << "Result unchanged: "
+            << (dst.l2_norm() < 1.e-12 * reference.l2_norm() ? "OK" : "FAILED") << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2, 2>(3);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,112 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/matrixfree/auto_tuner.h>
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+
+#include <cmath>
+#include <cstdio>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// Each thread evaluates the Forms with its own copy of the FEDatas, so every
+// parameter the AutoTuner may choose, including the threaded task schemes,
+// must give the serial result when the program runs with several threads.
+template <int dim, unsigned int degree>
+void
+run(unsigned int refine)
+{
+  FE_Q<dim> fe(degree);
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+  FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+  Base::TestFunction<0, dim, 0> v;
+  Base::FEFunction<0, dim, 0> u;
+  auto f = transform(Base::form(u, v) + Base::form(grad(u), grad(v)));
+
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  MatrixFreeData<dim, decltype(fe_datas), decltype(f), VectorType> data(
+    0, refine, fes, fe_datas, f);
+
+  VectorType src, dst, reference;
+  data.resize_vector(src);
+  data.resize_vector(dst);
+  data.resize_vector(reference);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = std::sin(1. + i);
+
+  MultithreadInfo::set_thread_limit(1);
+  data.vmult(reference, src);
+
+  MultithreadInfo::set_thread_limit(4);
+  // the candidates of runs with several processes and threads include all others
+  for (const auto& candidate : AutoTuner::candidates(2, 4))
+  {
+    data.set_execution_parameters(candidate);
+    // repeat the application to give a race a chance to show up
+    bool equal = true;
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+      data.vmult(dst, src);
+      dst -= reference;
+      equal = equal && dst.l2_norm() < 1.e-12 * reference.l2_norm();
+    }
+    std::cout << "Scheme " << candidate.tasks_parallel_scheme << " block size "
+              << candidate.tasks_block_size << " overlap "
+              << candidate.overlap_communication_computation
+              << " with 4 threads equals serial result: "
+              << (equal ? "OK" : "FAILED") << std::endl;
+  }
+
+  const std::string cache_file = "auto_tuner_threads_cache.txt";
+  std::remove(cache_file.c_str());
+  AutoTuner tuner(cache_file);
+  data.tune(tuner);
+  data.vmult(dst, src);
+  dst -= reference;
+  std::cout << "Tuned with 4 threads equals serial result: "
+            << (dst.l2_norm() < 1.e-12 * reference.l2_norm() ? "OK" : "FAILED") << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2, 2>(3);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
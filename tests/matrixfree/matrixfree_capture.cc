@@ -0,0 +1,115 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/matrixfree/capture.h>
+#include <cfl/matrixfree/standard_forms.h>
+
+#include <cmath>
+#include <memory>
+#include <typeinfo>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// Capture the Laplace operator on a mesh with hanging nodes, rebuild it from
+// the file like the matrixfree_replay application and compare the results.
+template <int dim, unsigned int degree>
+void
+run(unsigned int refine)
+{
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  using Standard = StandardForms::Laplace<dim, degree, double>;
+
+  FE_Q<dim> fe_q(degree);
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe_q);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe_q);
+  typename Standard::FEDatasType fe_datas{ fedata };
+  const auto laplace = StandardForms::laplace_form<dim>();
+  MatrixFreeData<dim, decltype(fe_datas), decltype(laplace), VectorType> data(
+    2, refine, fes, fe_datas, laplace);
+
+  VectorType src, dst;
+  data.resize_vector(src);
+  data.get_matrix_free().initialize_dof_vector(dst);
+  for (unsigned int i = 0; i < src.local_size(); ++i)
+    src.local_element(i) = data.get_constraints().is_constrained(i) ? 0. : std::sin(1. + i);
+  data.vmult(dst, src);
+  data.capture("matrixfree_capture.bin", src);
+
+  const auto capture = Capture<dim>::read("matrixfree_capture.bin");
+  Triangulation<dim> tr;
+  capture.create_triangulation(tr);
+  const auto fe = capture.create_fe(0);
+  DoFHandler<dim> dof(tr);
+  dof.distribute_dofs(*fe);
+  capture.renumber_dofs(0, dof);
+  AffineConstraints<double> constraints;
+  capture.make_constraints(0, constraints);
+  std::cout << "Capture: "
+            << (Capture<dim>::dimension("matrixfree_capture.bin") == dim &&
+                    capture.form == typeid(laplace).name() &&
+                    tr.n_active_cells() == data.get_triangulation().n_active_cells() &&
+                    dof.n_dofs() == data.get_dof_handler().n_dofs() &&
+                    constraints.n_constraints() == data.get_constraints().n_constraints()
+                  ? "OK"
+                  : "FAILED")
+            << std::endl;
+
+  const auto mapping = capture.create_mapping();
+  auto mf = std::make_shared<MatrixFree<dim, double>>();
+  mf->reinit(*mapping,
+             std::vector<const DoFHandler<dim>*>{ &dof },
+             std::vector<const AffineConstraints<double>*>{ &constraints },
+             capture.create_quadratures(),
+             capture.template create_additional_data<double>());
+  typename Standard::Integrator integrator;
+  integrator.initialize(*mf, laplace, fe_datas);
+
+  VectorType replayed_src, replayed_dst;
+  mf->initialize_dof_vector(replayed_src);
+  mf->initialize_dof_vector(replayed_dst);
+  capture.fill_src(replayed_src);
+  integrator.vmult(replayed_dst, replayed_src);
+  replayed_dst -= dst;
+  std::cout << "Replay: " << (replayed_dst.l2_norm() < 1.e-12 * dst.l2_norm() ? "OK" : "FAILED")
+            << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2, 2>(2);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/matrixfree/degree_dispatch.h>
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// The Laplace operator instantiated for the degree selected at run time has
+// to annihilate constant functions.
+template <int dim, unsigned int degree>
+bool
+run(unsigned int refine)
+{
+  FE_Q<dim> fe_u(degree);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe_u);
+  FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe_u);
+
+  Base::TestFunction<0, dim, 0> v;
+  Base::FEFunction<0, dim, 0> u;
+  auto f = transform(Base::form(grad(u), grad(v)));
+
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  MatrixFreeData<dim, decltype(fe_datas), decltype(f), VectorType> data(0, refine, fes, fe_datas, f);
+
+  VectorType in, out;
+  data.resize_vector(in);
+  data.resize_vector(out);
+  in = 1.;
+  data.vmult(out, in);
+  return out.l2_norm() < 1.e-12;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    for (unsigned int degree = 1; degree <= 3; ++degree)
+    {
+      const bool ok = dispatch_degree<1, 3>(
+        degree, [](auto degree_constant) { return run<2, decltype(degree_constant)::value>(1); });
+      std::cout << "Degree " << degree << ": " << (ok ? "OK" : "FAILED") << std::endl;
+    }
+
+    try
+    {
+      dispatch_degree<1, 3>(4, [](auto degree_constant) { return degree_constant(); });
+      std::cout << "Degree 4: not rejected" << std::endl;
+    }
+    catch (ExceptionBase&)
+    {
+      std::cout << "Degree 4: rejected" << std::endl;
+    }
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#ifndef CFL_PROFILE_FORMS
+#  define CFL_PROFILE_FORMS
+#endif
+
+#include "matrixfree_data.h"
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/form_profile_labels.h>
+#include <cfl/matrixfree/forms.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// Every Form is sampled and labelled with its LaTeX representation, and
+// profiling does not change the result of the operator.
+template <int dim, unsigned int degree>
+void
+run(unsigned int refine)
+{
+  FE_Q<dim> fe(degree);
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+  FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+  Base::TestFunction<0, dim, 0> v;
+  Base::FEFunction<0, dim, 0> u;
+  const auto base_forms = Base::form(u, v) + Base::form(grad(u), grad(v));
+  const auto profile = profile_forms(base_forms, 1, { "u" }, { "v" });
+  auto f = transform(base_forms);
+
+  using VectorType = LinearAlgebra::distributed::BlockVector<double>;
+  MatrixFreeData<dim, decltype(fe_datas), decltype(f), VectorType> data(
+    0, refine, fes, fe_datas, f);
+
+  VectorType src(1), dst(1), reference(1);
+  data.resize_vector(src);
+  data.resize_vector(dst);
+  data.resize_vector(reference);
+  for (unsigned int i = 0; i < src.block(0).local_size(); ++i)
+    src.block(0).local_element(i) = std::sin(1. + i);
+
+  data.vmult(dst, src);
+  internal::form_profile<decltype(f)>() = nullptr;
+  data.vmult(reference, src);
+
+  std::vector<std::string> labels = profile->labels;
+  std::sort(labels.begin(), labels.end());
+  for (const auto& label : labels)
+    std::cout << label << std::endl;
+
+  bool sampled = true;
+  for (unsigned int i = 0; i < profile->labels.size(); ++i)
+    sampled &= profile->average(i, FormProfile::Part::value) > 0. ||
+               profile->average(i, FormProfile::Part::submit) > 0.;
+  std::cout << "Forms sampled: " << (sampled ? "OK" : "FAILED") << std::endl;
+
+  dst -= reference;
+  std::cout << "Result unchanged: " << (dst.l2_norm() == 0. ? "OK" : "FAILED") << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2, 2>(3);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,68 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <iostream>
+#include <utility>
+
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/matrixfree/fe_data.h>
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// A reaction network with n_species species, each of which is coupled to all
+// others, with one FEData object per species. This checks that the MatrixFree
+// Forms and FEDatas neither hit the template instantiation depth limit nor
+// take overly long to compile for many Forms.
+// tools/benchmark_forms.sh compiles this for different numbers of species.
+#ifndef CFL_N_SPECIES
+#  define CFL_N_SPECIES 40
+#endif
+constexpr unsigned int n_species = CFL_N_SPECIES;
+constexpr int dim = 2;
+constexpr int degree = 1;
+
+template <std::size_t... I>
+auto
+fe_datas_of_species(const FE_Q<dim>& fe, std::index_sequence<I...>)
+{
+  return (FEData<FE_Q, degree, 1, dim, I, degree>(fe), ...);
+}
+
+template <std::size_t... I>
+auto
+reaction_forms(std::index_sequence<I...>)
+{
+  const auto concentrations = (Base::FEFunction<0, dim, I>() + ...);
+  return (Base::form(concentrations, Base::TestFunction<0, dim, I>()) + ...);
+}
+
+int
+main()
+{
+  static_assert(n_species > 1, "The FEDatas need at least two FEData objects!");
+
+  const FE_Q<dim> fe(degree);
+  auto fe_datas = fe_datas_of_species(fe, std::make_index_sequence<n_species>());
+  const auto forms = transform(reaction_forms(std::make_index_sequence<n_species>()));
+  using FEDatasType = decltype(fe_datas);
+
+  forms.set_evaluation_flags(fe_datas);
+  forms.set_integration_flags(fe_datas);
+
+  // Running the quadrature loop needs an initialized MatrixFree object, this
+  // only instantiates it.
+  [[maybe_unused]] const auto quadrature_loop = [&](const unsigned int q) {
+    forms.evaluate(fe_datas, q);
+  };
+
+  std::cout << FEDatasType::n << " FEData objects, " << FEDatasType::max_n_q_points
+            << " quadrature points, rank of the last one "
+            << FEDatasType::rank<n_species - 1>() << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// Integrate the diffusion term with the standard Gauss rule and only the cubic
+// reaction term with the 3/2-rule. On affine meshes the standard rule is exact
+// for the diffusion term, so the result must match the operator which uses the
+// over-integration for all terms.
+template <int dim, unsigned int degree>
+void
+run(unsigned int refine)
+{
+  constexpr unsigned int n_q_points_1d = degree + 1;
+  constexpr unsigned int n_q_points_1d_over = (3 * degree) / 2 + 1;
+
+  FE_Q<dim> fe(degree);
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe);
+
+  // fe_no 1 evaluates the DoFHandler 0 with the quadrature 1
+  FEData<FE_Q, degree, 1, dim, 0, degree, double, n_q_points_1d, 0, 0> fedata_u(fe);
+  FEData<FE_Q, degree, 1, dim, 1, degree, double, n_q_points_1d_over, 1, 0> fedata_u_over(fe);
+  auto fe_datas_split = (fedata_u, fedata_u_over);
+
+  FEData<FE_Q, degree, 1, dim, 0, degree, double, n_q_points_1d_over, 0, 0> fedata_all_over(fe);
+  FEDatas<decltype(fedata_all_over)> fe_datas_over{ fedata_all_over };
+
+  std::cout << "Quadratures: " << decltype(fe_datas_split)::n_quadratures << " ("
+            << decltype(fe_datas_split)::get_n_q_points_1d(0) << ", "
+            << decltype(fe_datas_split)::get_n_q_points_1d(1) << " points)" << std::endl;
+
+  Base::TestFunction<0, dim, 0> v;
+  Base::FEFunction<0, dim, 0> u;
+  Base::TestFunction<0, dim, 1> v_over;
+  Base::FEFunction<0, dim, 1> u_over;
+
+  auto f_split = transform(Base::form(grad(u), grad(v)) +
+                           Base::form(u_over * u_over * u_over, v_over));
+  auto f_over = transform(Base::form(grad(u), grad(v)) + Base::form(u * u * u, v));
+
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  MatrixFreeData<dim, decltype(fe_datas_split), decltype(f_split), VectorType> data_split(
+    0, refine, fes, fe_datas_split, f_split);
+  MatrixFreeData<dim, decltype(fe_datas_over), decltype(f_over), VectorType> data_over(
+    0, refine, fes, fe_datas_over, f_over);
+
+  VectorType in, out, ref;
+  data_split.resize_vector(in);
+  data_split.resize_vector(out);
+  data_over.resize_vector(ref);
+  for (types::global_dof_index j = 0; j < in.size(); ++j)
+    in[j] = std::sin(static_cast<double>(j));
+
+  data_split.vmult(out, in);
+  data_over.vmult(ref, in);
+  ref -= out;
+  std::cout << "Split quadrature: " << (ref.l2_norm() < 1.e-12 * out.l2_norm() ? "OK" : "FAILED")
+            << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2, 2>(2);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
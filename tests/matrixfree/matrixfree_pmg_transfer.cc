@@ -0,0 +1,146 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/base/function.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+#include <cfl/matrixfree/pmg_transfer.h>
+
+#include <cmath>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// f(x) = prod_d (1 + x_d) lies in every Q_k space with k >= 1
+template <int dim>
+class MultiLinear : public Function<dim>
+{
+public:
+  double
+  value(const Point<dim>& p, const unsigned int /*component*/ = 0) const override
+  {
+    double value = 1.;
+    for (unsigned int d = 0; d < dim; ++d)
+      value *= 1. + p[d];
+    return value;
+  }
+};
+
+// A multilinear function is contained in both spaces, so prolongating its
+// interpolation into the linear space must give its interpolation into the
+// quadratic space. The restriction has to be the transpose of the prolongation.
+template <int dim, unsigned int fine_degree, unsigned int coarse_degree>
+void
+run(unsigned int refine)
+{
+  FE_Q<dim> fe_fine(fine_degree);
+  FE_Q<dim> fe_coarse(coarse_degree);
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe_fine);
+  fes.push_back(&fe_coarse);
+
+  FEData<FE_Q, fine_degree, 1, dim, 0, fine_degree> fedata_fine(fe_fine);
+  FEData<FE_Q, coarse_degree, 1, dim, 1, fine_degree> fedata_coarse(fe_coarse);
+  auto fe_datas = (fedata_fine, fedata_coarse);
+
+  Base::TestFunction<0, dim, 0> v_fine;
+  Base::FEFunction<0, dim, 0> u_fine;
+  Base::TestFunction<0, dim, 1> v_coarse;
+  Base::FEFunction<0, dim, 1> u_coarse;
+  auto f = transform(Base::form(u_fine, v_fine) + Base::form(u_coarse, v_coarse));
+
+  using VectorType = LinearAlgebra::distributed::BlockVector<double>;
+  MatrixFreeData<dim, decltype(fe_datas), decltype(f), VectorType> data(
+    0, refine, fes, fe_datas, f);
+
+  PMGTransfer<decltype(fedata_fine), decltype(fedata_coarse), VectorType> transfer(fedata_fine,
+                                                                                   fedata_coarse);
+  transfer.initialize(data.get_matrix_free());
+
+  VectorType coarse(2), fine(2), reference(2);
+  data.resize_vector(coarse);
+  data.resize_vector(fine);
+  data.resize_vector(reference);
+
+  VectorTools::interpolate(data.get_dof_handler(1), MultiLinear<dim>(), coarse.block(1));
+  VectorTools::interpolate(data.get_dof_handler(0), MultiLinear<dim>(), reference.block(0));
+
+  transfer.prolongate(fine, coarse);
+  fine.block(0) -= reference.block(0);
+  std::cout << "Prolongation: "
+            << (fine.block(0).l2_norm() < 1.e-12 * reference.block(0).l2_norm() ? "OK" : "FAILED")
+            << std::endl;
+
+  // (P x, y) == (x, R y)
+  for (unsigned int i = 0; i < coarse.block(1).local_size(); ++i)
+    coarse.block(1).local_element(i) = std::sin(1. + i);
+  for (unsigned int i = 0; i < reference.block(0).local_size(); ++i)
+    reference.block(0).local_element(i) = std::cos(1. + i);
+  transfer.prolongate(fine, coarse);
+  VectorType restricted(2);
+  data.resize_vector(restricted);
+  transfer.restrict_and_add(restricted, reference);
+  const double fine_product = fine.block(0) * reference.block(0);
+  const double coarse_product = coarse.block(1) * restricted.block(1);
+  std::cout << "Restriction is transpose: "
+            << (std::abs(fine_product - coarse_product) <
+                    1.e-12 * fine.block(0).l2_norm() * reference.block(0).l2_norm()
+                  ? "OK"
+                  : "FAILED")
+            << std::endl;
+}
+
+void
+print_hierarchy(const unsigned int n_h_levels, const unsigned int fine_degree,
+                const PMGCoarsening coarsening)
+{
+  std::cout << "Degrees";
+  for (const unsigned int degree : pmg_degree_sequence(fine_degree, coarsening))
+    std::cout << " " << degree;
+  std::cout << std::endl << "Levels";
+  for (const auto& level : build_mg_level_hierarchy(n_h_levels, fine_degree, coarsening))
+    std::cout << " (" << level.h_level << ", " << level.degree << ")";
+  std::cout << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2, 2, 1>(2);
+    run<2, 4, 2>(1);
+    print_hierarchy(3, 5, PMGCoarsening::bisect);
+    print_hierarchy(2, 3, PMGCoarsening::decrease_by_one);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,158 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/multigrid/mg_constrained_dofs.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+
+#include <cfl/matrixfree/pmg_transfer.h>
+
+#include <cmath>
+#include <memory>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// The combined transfer of a hierarchy with three linear h-levels followed
+// by the p-levels of degree 2 and 4 on the finest mesh.
+template <int dim>
+void
+run()
+{
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+  Triangulation<dim> tr(Triangulation<dim>::limit_level_difference_at_vertices);
+  GridGenerator::hyper_cube(tr);
+  tr.refine_global(2);
+  const unsigned int top_level = tr.n_global_levels() - 1;
+
+  FE_Q<dim> fe_4(4), fe_2(2), fe_1(1);
+  DoFHandler<dim> dof_4(tr), dof_2(tr), dof_1(tr);
+  for (auto* dof : { &dof_4, &dof_2, &dof_1 })
+  {
+    dof->distribute_dofs(dof == &dof_4 ? fe_4 : (dof == &dof_2 ? fe_2 : fe_1));
+    dof->distribute_mg_dofs();
+  }
+
+  // the p-levels on the finest mesh level
+  AffineConstraints<double> constraints;
+  constraints.close();
+  typename MatrixFree<dim, double>::AdditionalData additional_data;
+  additional_data.level_mg_handler = top_level;
+  MatrixFree<dim, double> mf;
+  mf.reinit(MappingQGeneric<dim>(1),
+            std::vector<const DoFHandler<dim>*>{ &dof_4, &dof_2, &dof_1 },
+            std::vector<const AffineConstraints<double>*>{
+              &constraints, &constraints, &constraints },
+            std::vector<Quadrature<1>>{ QGauss<1>(5) },
+            additional_data);
+
+  // all levels use the quadrature of the finest degree
+  FEData<FE_Q, 4, 1, dim, 0, 4> fedata_4(fe_4);
+  FEData<FE_Q, 2, 1, dim, 1, 4> fedata_2(fe_2);
+  FEData<FE_Q, 1, 1, dim, 2, 4> fedata_1(fe_1);
+  auto transfer_4 =
+    std::make_shared<PMGTransfer<decltype(fedata_4), decltype(fedata_2)>>(fedata_4, fedata_2);
+  auto transfer_2 =
+    std::make_shared<PMGTransfer<decltype(fedata_2), decltype(fedata_1)>>(fedata_2, fedata_1);
+  transfer_4->initialize(mf);
+  transfer_2->initialize(mf);
+
+  MGConstrainedDoFs mg_constrained_dofs;
+  mg_constrained_dofs.initialize(dof_1);
+  MGTransferMatrixFree<dim, double> h_transfer(mg_constrained_dofs);
+  h_transfer.build(dof_1);
+
+  const auto hierarchy = build_mg_level_hierarchy(top_level + 1, 4);
+  MGTransferPH<dim, double> transfer(
+    h_transfer,
+    { transfer_2, transfer_4 },
+    [&](const unsigned int level, VectorType& vector) {
+      // the finest linear level is shared with the p-transfer
+      if (level < top_level)
+        vector.reinit(dof_1.n_dofs(level));
+      else
+      {
+        const unsigned int degree = hierarchy[level].degree;
+        mf.initialize_dof_vector(vector, degree == 4 ? 0 : (degree == 2 ? 1 : 2));
+      }
+    });
+  transfer.build(dof_4);
+  AssertDimension(transfer.n_levels(), hierarchy.size());
+
+  MGLevelObject<VectorType> levels(0, transfer.n_levels() - 1);
+  VectorType active(dof_4.n_dofs()), result(dof_4.n_dofs());
+
+  // the constant function is contained in every level space
+  active = 1.;
+  transfer.copy_to_mg(dof_4, levels, active);
+  levels[0] = 1.;
+  for (unsigned int level = 1; level < transfer.n_levels(); ++level)
+    transfer.prolongate(level, levels[level], levels[level - 1]);
+  transfer.copy_from_mg(dof_4, result, levels);
+  result -= active;
+  std::cout << "Constants: " << (result.l2_norm() < 1.e-12 * active.l2_norm() ? "OK" : "FAILED")
+            << std::endl;
+
+  // (P x, y) == (x, R y) between all pairs of neighboring levels
+  bool transpose = true;
+  for (unsigned int level = 1; level < transfer.n_levels(); ++level)
+  {
+    VectorType x = levels[level - 1], y = levels[level], prolongated = levels[level],
+               restricted = levels[level - 1];
+    for (unsigned int i = 0; i < x.local_size(); ++i)
+      x.local_element(i) = std::sin(1. + i);
+    for (unsigned int i = 0; i < y.local_size(); ++i)
+      y.local_element(i) = std::cos(1. + i);
+    transfer.prolongate(level, prolongated, x);
+    restricted = 0.;
+    transfer.restrict_and_add(level, restricted, y);
+    transpose = transpose && std::abs(prolongated * y - x * restricted) <
+                               1.e-12 * prolongated.l2_norm() * y.l2_norm();
+  }
+  std::cout << "Restriction is transpose: " << (transpose ? "OK" : "FAILED") << std::endl;
+
+  for (unsigned int i = 0; i < active.local_size(); ++i)
+    active.local_element(i) = std::sin(1. + i);
+  transfer.copy_to_mg(dof_4, levels, active);
+  transfer.copy_from_mg(dof_4, result, levels);
+  result -= active;
+  std::cout << "Copy to and from the levels: " << (result.l2_norm() == 0. ? "OK" : "FAILED")
+            << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2>();
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
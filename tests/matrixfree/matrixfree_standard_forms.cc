@@ -0,0 +1,122 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/matrixfree/standard_forms.h>
+
+#include <cmath>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// The integrators of the standard forms are taken from libcfl. Check some
+// properties of the operators and the direct initialization of an integrator
+// from a MatrixFree, a Form and a FEDatas object.
+template <int dim, unsigned int degree>
+void
+run(unsigned int refine)
+{
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+
+  FE_Q<dim> fe_q(degree);
+  std::vector<FiniteElement<dim>*> fes_q;
+  fes_q.push_back(&fe_q);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata_q(fe_q);
+  typename StandardForms::Mass<dim, degree, double>::FEDatasType fe_datas_q{ fedata_q };
+
+  const auto mass = StandardForms::mass_form<dim>();
+  MatrixFreeData<dim, decltype(fe_datas_q), decltype(mass), VectorType> mass_data(
+    0, refine, fes_q, fe_datas_q, mass);
+  VectorType ones, out;
+  mass_data.resize_vector(ones);
+  mass_data.resize_vector(out);
+  ones = 1.;
+  mass_data.vmult(out, ones);
+  double volume = 0.;
+  for (unsigned int i = 0; i < out.local_size(); ++i)
+    volume += out.local_element(i);
+  std::cout << "Mass: " << (std::abs(volume - 1.) < 1.e-12 ? "OK" : "FAILED") << std::endl;
+
+  typename StandardForms::Mass<dim, degree, double>::Integrator integrator;
+  integrator.initialize(mass_data.get_matrix_free(), mass, fe_datas_q);
+  VectorType direct;
+  mass_data.resize_vector(direct);
+  integrator.vmult(direct, ones);
+  direct -= out;
+  std::cout << "Direct initialization: " << (direct.l2_norm() < 1.e-12 ? "OK" : "FAILED")
+            << std::endl;
+
+  const auto laplace = StandardForms::laplace_form<dim>();
+  MatrixFreeData<dim, decltype(fe_datas_q), decltype(laplace), VectorType> laplace_data(
+    0, refine, fes_q, fe_datas_q, laplace);
+  laplace_data.vmult(out, ones);
+  std::cout << "Laplace: " << (out.l2_norm() < 1.e-12 ? "OK" : "FAILED") << std::endl;
+
+  FE_DGQ<dim> fe_dg(degree);
+  std::vector<FiniteElement<dim>*> fes_dg;
+  fes_dg.push_back(&fe_dg);
+  FEDataFace<FE_DGQ, degree, 1, dim, 0, degree> fedata_dg_face(fe_dg);
+  FEData<FE_DGQ, degree, 1, dim, 0, degree> fedata_dg(fe_dg);
+  auto fe_datas_dg = (fedata_dg_face, fedata_dg);
+  static_assert(std::is_same<decltype(fe_datas_dg), typename StandardForms::SIPGLaplace<
+                                                      dim, degree, double>::FEDatasType>::value,
+                "The FEDatas type has to match the precompiled one!");
+
+  const auto sipg = StandardForms::sipg_laplace_form<dim>();
+  MatrixFreeData<dim, decltype(fe_datas_dg), decltype(sipg), VectorType> sipg_data(
+    0, refine, fes_dg, fe_datas_dg, sipg);
+  VectorType x, y, Ax, Ay;
+  sipg_data.resize_vector(x);
+  sipg_data.resize_vector(y);
+  sipg_data.resize_vector(Ax);
+  sipg_data.resize_vector(Ay);
+  for (unsigned int i = 0; i < x.local_size(); ++i)
+  {
+    x.local_element(i) = std::sin(1. + i);
+    y.local_element(i) = std::cos(1. + i);
+  }
+  sipg_data.vmult(Ax, x);
+  sipg_data.vmult(Ay, y);
+  const double xAy = x * Ay;
+  const double yAx = y * Ax;
+  std::cout << "SIPG symmetric: " << (std::abs(xAy - yAx) < 1.e-10 * Ax.l2_norm() ? "OK" : "FAILED")
+            << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2, 2>(1);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
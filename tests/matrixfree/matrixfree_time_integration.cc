@@ -0,0 +1,137 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "matrixfree_data.h"
+#include <deal.II/fe/fe_dgq.h>
+
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+#include <cfl/matrixfree/time_integrators.h>
+
+#include <cmath>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// Check that the cell-wise inverse mass matrix inverts the mass operator,
+// that the low-storage Runge-Kutta schemes integrate du/dt = -u with
+// their formal order of accuracy and that fusing the operator into the
+// stage update does not change the result.
+template <int dim, unsigned int degree>
+void
+run(unsigned int refine)
+{
+  FE_DGQ<dim> fe_u(degree);
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe_u);
+
+  FEData<FE_DGQ, degree, 1, dim, 0, degree> fedata(fe_u);
+  FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+  Base::TestFunction<0, dim, 0> v;
+  Base::FEFunction<0, dim, 0> u;
+  auto mass = transform(Base::form(u, v));
+  auto negative_mass = transform(-Base::form(u, v));
+
+  using VectorType = LinearAlgebra::distributed::Vector<double>;
+  MatrixFreeData<dim, decltype(fe_datas), decltype(mass), VectorType> mass_data{
+    0, refine, fes, fe_datas, mass
+  };
+  MatrixFreeData<dim, decltype(fe_datas), decltype(negative_mass), VectorType> operator_data{
+    0, refine, fes, fe_datas, negative_mass
+  };
+
+  CellwiseInverseMass<decltype(fedata)> inverse_mass(fedata);
+  inverse_mass.initialize(mass_data.get_matrix_free());
+
+  VectorType x, y, z;
+  mass_data.resize_vector(x);
+  mass_data.resize_vector(y);
+  mass_data.resize_vector(z);
+  for (types::global_dof_index j = 0; j < x.size(); ++j)
+    x[j] = 1. + j;
+
+  mass_data.vmult(y, x);
+  inverse_mass.apply(z, y);
+  z -= x;
+  std::cout << "Inverse mass: " << (z.l2_norm() < 1.e-10 * x.l2_norm() ? "OK" : "FAILED")
+            << std::endl;
+
+  CellwiseInverseMass<decltype(fedata)> operator_inverse_mass(fedata);
+  operator_inverse_mass.initialize(operator_data.get_matrix_free());
+
+  const std::array<LowStorageRungeKuttaScheme, 2> schemes = {
+    { LowStorageRungeKuttaScheme::williamson_33, LowStorageRungeKuttaScheme::carpenter_kennedy_54 }
+  };
+  const std::array<unsigned int, 2> orders = { { 3, 4 } };
+  for (unsigned int s = 0; s < schemes.size(); ++s)
+  {
+    LowStorageRungeKutta<decltype(fedata)> time_integrator(schemes[s]);
+    std::array<double, 2> errors;
+    for (unsigned int r = 0; r < errors.size(); ++r)
+    {
+      const unsigned int n_steps = 10 << r;
+      const double time_step = 1. / n_steps;
+      VectorType solution(x);
+      time_integrator.reinit(solution);
+      double time = 0.;
+      for (unsigned int step = 0; step < n_steps; ++step)
+        time = time_integrator.perform_time_step(
+          operator_data, operator_inverse_mass, time, time_step, solution);
+      solution.add(-std::exp(-time), x);
+      errors[r] = solution.l2_norm() / x.l2_norm();
+    }
+    const double rate = std::log2(errors[0] / errors[1]);
+    std::cout << "Scheme with " << time_integrator.n_stages() << " stages: "
+              << (rate > orders[s] - 0.2 ? "OK" : "FAILED") << std::endl;
+  }
+
+  // the operator only has cell terms, so perform_time_step() applies it inside
+  // the update loop; compare one stage against the separate application
+  VectorType fused_stage(x), fused_solution(x), stage(x), solution(x), rhs(x);
+  operator_inverse_mass.apply_operator_and_update_stage(
+    operator_data, 0.5, 0.25, 0.1, fused_stage, fused_solution);
+  operator_data.vmult(rhs, x);
+  operator_inverse_mass.apply_and_update_stage(rhs, 0.5, 0.25, 0.1, stage, solution);
+  fused_stage -= stage;
+  fused_solution -= solution;
+  std::cout << "Fused operator application: "
+            << (fused_stage.l2_norm() + fused_solution.l2_norm() < 1.e-12 * x.l2_norm() ? "OK"
+                                                                                        : "FAILED")
+            << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2, 2>(1);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
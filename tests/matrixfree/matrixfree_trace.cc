@@ -0,0 +1,161 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#ifndef CFL_TRACE
+#  define CFL_TRACE
+#endif
+
+#include "matrixfree_data.h"
+#include <deal.II/fe/fe_q.h>
+
+#include <cfl/matrixfree/fefunctions.h>
+#include <cfl/matrixfree/forms.h>
+#include <cfl/matrixfree/trace.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+using namespace dealii;
+using namespace CFL;
+using namespace CFL::dealii::MatrixFree;
+
+// The events of one application of a mass operator are recorded, written,
+// read back and checked.
+template <int dim, unsigned int degree>
+void
+run(unsigned int refine)
+{
+  FE_Q<dim> fe(degree);
+  std::vector<FiniteElement<dim>*> fes;
+  fes.push_back(&fe);
+  FEData<FE_Q, degree, 1, dim, 0, degree> fedata(fe);
+  FEDatas<decltype(fedata)> fe_datas{ fedata };
+
+  Base::TestFunction<0, dim, 0> v;
+  Base::FEFunction<0, dim, 0> u;
+  auto f = transform(Base::form(u, v));
+
+  using VectorType = LinearAlgebra::distributed::BlockVector<double>;
+  MatrixFreeData<dim, decltype(fe_datas), decltype(f), VectorType> data(
+    0, refine, fes, fe_datas, f);
+
+  VectorType src(1), dst(1);
+  data.resize_vector(src);
+  data.resize_vector(dst);
+  for (unsigned int i = 0; i < src.block(0).local_size(); ++i)
+    src.block(0).local_element(i) = std::sin(1. + i);
+
+  Trace::Recorder::instance().clear();
+  data.vmult(dst, src);
+
+  const std::string filename = "matrixfree_trace.bin";
+  Trace::Recorder::instance().write(filename);
+  const auto threads = Trace::Recorder::read(filename);
+  std::remove(filename.c_str());
+
+  std::map<Trace::Phase, unsigned int> counts;
+  bool complete = true;
+  bool batches_increase = true;
+  for (const auto& thread : threads)
+  {
+    complete &= thread.n_recorded == thread.events.size();
+    unsigned int last_batch = 0;
+    bool first = true;
+    for (const auto& event : thread.events)
+    {
+      ++counts[event.phase];
+      if (event.phase == Trace::Phase::begin_cell_loop)
+        first = true;
+      if (event.phase == Trace::Phase::reinit_cell)
+      {
+        batches_increase &= first || event.batch > last_batch;
+        last_batch = event.batch;
+        first = false;
+      }
+    }
+  }
+  std::cout << "All events kept: " << (complete ? "OK" : "FAILED") << std::endl;
+  std::cout << "Loops balanced: "
+            << (counts[Trace::Phase::begin_cell_loop] > 0 &&
+                    counts[Trace::Phase::begin_cell_loop] == counts[Trace::Phase::end_cell_loop]
+                  ? "OK"
+                  : "FAILED")
+            << std::endl;
+  std::cout << "Cell batches in order: " << (batches_increase ? "OK" : "FAILED") << std::endl;
+
+  const unsigned int n_batches = counts[Trace::Phase::reinit_cell];
+  const unsigned int n_q_points = Utilities::pow(degree + 1, dim);
+  std::cout << "One read, evaluate, integrate and distribute per batch: "
+            << (n_batches > 0 && counts[Trace::Phase::read_cell] == n_batches &&
+                    counts[Trace::Phase::evaluate_cell] == n_batches &&
+                    counts[Trace::Phase::integrate_cell] == n_batches &&
+                    counts[Trace::Phase::distribute_cell] == n_batches
+                  ? "OK"
+                  : "FAILED")
+            << std::endl;
+  std::cout << "One value and submit per quadrature point: "
+            << (counts[Trace::Phase::get_value] == n_batches * n_q_points &&
+                    counts[Trace::Phase::test_function] == n_batches * n_q_points &&
+                    counts[Trace::Phase::submit_value] == n_batches * n_q_points
+                  ? "OK"
+                  : "FAILED")
+            << std::endl;
+
+  // the first events of the calling thread print as with DEBUG_OUTPUT
+  for (unsigned int i = 0; i < threads[0].events.size() && i < 8; ++i)
+  {
+    Trace::print(std::cout, threads[0].events[i]);
+    std::cout << std::endl;
+  }
+}
+
+// Only the last events are kept when the buffer is full.
+void
+ring_buffer()
+{
+  Trace::RingBuffer buffer(0, 4);
+  for (unsigned int q = 0; q < 10; ++q)
+    buffer.push(Trace::Phase::get_value, 0, q, 0);
+  const auto events = buffer.chronological();
+  bool last = events.size() == 4 && buffer.n_recorded == 10;
+  for (unsigned int i = 0; i < events.size(); ++i)
+    last &= events[i].q == 6 + i;
+  std::cout << "Ring buffer keeps the last events: " << (last ? "OK" : "FAILED") << std::endl;
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2, 1>(3);
+    ring_buffer();
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
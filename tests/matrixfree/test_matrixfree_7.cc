@@ -0,0 +1,80 @@
+///////
+#define BOOST_TEST_MODULE TMOD_MATRIXFREE_7_H
+#define BOOST_TEST_DYN_LINK
+#include "test_matrixfree.h"
+#include <cfl/matrixfree/forms.h>
+//////////
+
+//// Test case FaceDataAccessTerminals
+// Type: Positive test case
+// Coverage: Traits::face_data_access
+// Checks for:
+// 1. Face terminals report the face data they access, all other terminals report none
+// 2. Sums and products access the maximum of what their operands access
+BOOST_AUTO_TEST_CASE(FaceDataAccessTerminals)
+{
+  constexpr int dim = 2;
+  using TestValue = TestFunctionInteriorFace<0, dim, 0>;
+  using TestGradient = TestNormalGradientExteriorFace<0, dim, 0>;
+  using Value = FEFunctionExteriorFace<0, dim, 0>;
+  using Gradient = FENormalGradientInteriorFace<0, dim, 0>;
+
+  BOOST_TEST((Traits::face_data_access<TestValue>::value == FaceDataAccess::values));
+  BOOST_TEST((Traits::face_data_access<TestGradient>::value == FaceDataAccess::gradients));
+  BOOST_TEST((Traits::face_data_access<Value>::value == FaceDataAccess::values));
+  BOOST_TEST((Traits::face_data_access<Gradient>::value == FaceDataAccess::gradients));
+  BOOST_TEST((Traits::face_data_access<FEFunction<0, dim, 0>>::value == FaceDataAccess::none));
+  BOOST_TEST((Traits::face_data_access<TestFunction<0, dim, 0>>::value == FaceDataAccess::none));
+
+  Base::FEFunctionInteriorFace<0, dim, 0> u_in;
+  Base::FEFunctionExteriorFace<0, dim, 0> u_out;
+  Base::FENormalGradientInteriorFace<0, dim, 0> grad_u_in;
+
+  using ValueSum = decltype(transform(u_in - u_out));
+  using MixedSum = decltype(transform(u_in - u_out + grad_u_in));
+  using MixedProduct = decltype(transform((u_in - u_out) * grad_u_in));
+  BOOST_TEST((Traits::face_data_access<ValueSum>::value == FaceDataAccess::values));
+  BOOST_TEST((Traits::face_data_access<MixedSum>::value == FaceDataAccess::gradients));
+  BOOST_TEST((Traits::face_data_access<MixedProduct>::value == FaceDataAccess::gradients));
+}
+
+//// Test case FaceDataAccessForms
+// Type: Positive test case
+// Coverage: Form, Forms
+// Checks for:
+// 1. Only face forms contribute to the face data access of Forms
+// 2. The access for the test functions (dst) and FE functions (src) is derived independently
+BOOST_AUTO_TEST_CASE(FaceDataAccessForms)
+{
+  constexpr int dim = 2;
+  Base::TestFunction<0, dim, 0> v;
+  Base::FEFunction<0, dim, 0> u;
+  Base::TestGradient<0, dim, 0> grad_v;
+  Base::FEGradient<0, dim, 0> grad_u;
+  Base::TestFunctionInteriorFace<0, dim, 0> v_in;
+  Base::TestNormalGradientInteriorFace<0, dim, 0> grad_v_in;
+  Base::FEFunctionInteriorFace<0, dim, 0> u_in;
+  Base::FEFunctionExteriorFace<0, dim, 0> u_out;
+  Base::FENormalGradientExteriorFace<0, dim, 0> grad_u_out;
+  Base::FEFunctionInteriorFace<0, dim, 0> u_bd;
+  Base::TestNormalGradientInteriorFace<0, dim, 0> grad_v_bd;
+
+  using CellForms = decltype(transform(Base::form(u, v) + Base::form(grad_u, grad_v)));
+  BOOST_TEST((CellForms::dst_face_data_access == FaceDataAccess::none));
+  BOOST_TEST((CellForms::src_face_data_access == FaceDataAccess::none));
+
+  // boundary forms never touch the exterior side
+  using BoundaryForm = decltype(transform(Base::boundary_form(u_bd, grad_v_bd)));
+  BOOST_TEST((BoundaryForm::dst_face_data_access == FaceDataAccess::none));
+  BOOST_TEST((BoundaryForm::src_face_data_access == FaceDataAccess::none));
+
+  using ValueForms =
+    decltype(transform(Base::form(u, v) + Base::face_form(u_in - u_out, v_in)));
+  BOOST_TEST((ValueForms::dst_face_data_access == FaceDataAccess::values));
+  BOOST_TEST((ValueForms::src_face_data_access == FaceDataAccess::values));
+
+  using MixedForms = decltype(transform(Base::face_form(u_in - u_out, grad_v_in) +
+                                        Base::face_form(grad_u_out, v_in)));
+  BOOST_TEST((MixedForms::dst_face_data_access == FaceDataAccess::gradients));
+  BOOST_TEST((MixedForms::src_face_data_access == FaceDataAccess::gradients));
+}
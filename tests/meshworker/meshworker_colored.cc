@@ -0,0 +1,153 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "meshworker_data.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <cfl/meshworker/forms.h>
+#include <cfl/meshworker/fefunctions.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MeshWorker;
+using namespace ::dealii;
+
+// Evaluate and assemble a form serially and then with the cells processed
+// color by color on n_threads threads, and check that the results are the
+// same. The continuous element colors cells sharing vertices, the
+// discontinuous one cells sharing faces.
+template <int dim, class Form>
+void
+compare(MeshworkerData<dim>& data, Form& f, bool include_neighbors, unsigned int n_threads)
+{
+  Vector<double> b, residual, product;
+  data.resize_vector(b);
+  data.resize_vector(residual);
+  data.resize_vector(product);
+
+  for (unsigned int i = 0; i < b.size(); ++i)
+    b[i] = i;
+
+  SparseMatrix<double> matrix;
+  MultithreadInfo::set_thread_limit(1);
+  data.disable_coloring();
+  data.vmult(residual, b, f);
+  data.assemble_matrix(matrix, f);
+  matrix.vmult(product, b);
+  // The matrix uses the sparsity pattern of data, which is rebuilt below
+  matrix.clear();
+
+  Vector<double> colored_residual, colored_product;
+  data.resize_vector(colored_residual);
+  data.resize_vector(colored_product);
+
+  MultithreadInfo::set_thread_limit(n_threads);
+  data.use_coloring(include_neighbors);
+  data.vmult(colored_residual, b, f);
+  colored_residual -= residual;
+  std::cout << "Threads " << n_threads << std::endl;
+  std::cout << "Colored residual equals serial: "
+            << (colored_residual.linfty_norm() <= 1.e-12 * residual.linfty_norm() ? "OK" : "FAILED")
+            << std::endl;
+
+  data.assemble_matrix(matrix, f);
+  matrix.vmult(colored_product, b);
+  colored_product -= product;
+  std::cout << "Colored matrix equals serial: "
+            << (colored_product.linfty_norm() <= 1.e-12 * product.linfty_norm() ? "OK" : "FAILED")
+            << std::endl;
+}
+
+template <int dim>
+void
+run_continuous(unsigned int grid_index, unsigned int refine, unsigned int degree)
+{
+  FE_Q<dim> fe(degree);
+  MeshworkerData<dim> data(grid_index, refine, fe);
+
+  TestFunction<0, dim> v(0, 0);
+  FEFunction<0, dim> u(0, 0);
+  auto Dv = grad(v);
+  auto Du = grad(u);
+  auto f = 3. * CFL::dealii::MeshWorker::form(Du, Dv) - CFL::dealii::MeshWorker::form(u, v);
+
+  compare(data, f, false, 4);
+}
+
+template <int dim>
+void
+run_discontinuous(unsigned int grid_index, unsigned int refine, unsigned int degree)
+{
+  FE_DGQ<dim> fe(degree);
+  MeshworkerData<dim> data(grid_index, refine, fe);
+
+  TestFunction<0, dim> v(0, 0);
+  auto Dv = grad(v);
+  TestFunctionInteriorFace<0, dim> v_p(0, 0);
+  TestFunctionExteriorFace<0, dim> v_m(0, 0);
+  TestNormalGradientInteriorFace<0, dim> Dnv_p(0, 0);
+  TestNormalGradientExteriorFace<0, dim> Dnv_m(0, 0);
+
+  FEFunction<0, dim> u(0, 0);
+  auto Du = grad(u);
+  FEFunctionInteriorFace<0, dim> u_p(0, 0);
+  FEFunctionExteriorFace<0, dim> u_m(0, 0);
+  FENormalGradientInteriorFace<0, dim> Dnu_p(0, 0);
+  FENormalGradientExteriorFace<0, dim> Dnu_m(0, 0);
+
+  auto cell = CFL::dealii::MeshWorker::form(Du, Dv);
+
+  auto flux = u_p - u_m;
+  auto flux_grad = Dnu_p - Dnu_m;
+
+  auto flux1 = -CFL::dealii::MeshWorker::face_form(flux, Dnv_p) +
+               CFL::dealii::MeshWorker::face_form(flux, Dnv_m);
+  auto flux2 = CFL::dealii::MeshWorker::face_form(-flux + .5 * flux_grad, v_p) -
+               CFL::dealii::MeshWorker::face_form(-flux + .5 * flux_grad, v_m);
+
+  auto boundary1 = CFL::dealii::MeshWorker::boundary_form(2. * u_p - Dnu_p, v_p);
+  auto boundary3 = -CFL::dealii::MeshWorker::boundary_form(u_p, Dnv_p);
+
+  auto face = -flux2 + .5 * flux1;
+  auto f = cell + face + boundary1 + boundary3;
+
+  compare(data, f, true, 4);
+}
+
+int
+main()
+{
+  deallog.depth_console(10);
+  try
+  {
+    run_continuous<2>(0, 3, 1);
+    run_continuous<3>(0, 2, 2);
+    run_discontinuous<2>(0, 3, 1);
+    run_discontinuous<3>(0, 2, 1);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
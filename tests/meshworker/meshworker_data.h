@@ -2,20 +2,29 @@
 #define _MESHWORKER_DATA_H
 
 #include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
 #include <deal.II/fe/fe.h>
 #include <deal.II/fe/mapping_q1.h>
 #include <deal.II/grid/grid_generator.h>
 #include <deal.II/grid/manifold_lib.h>
 #include <deal.II/grid/tria.h>
 
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
 #include <deal.II/meshworker/dof_info.h>
 #include <deal.II/meshworker/integration_info.h>
 #include <deal.II/meshworker/loop.h>
 #include <deal.II/meshworker/output.h>
 #include <deal.II/meshworker/simple.h>
 
+#include <cfl/meshworker/colored_loop.h>
 #include <cfl/meshworker/forms.h>
+#include <cfl/meshworker/meshworker_integrator.h>
 
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 using namespace dealii;
@@ -27,140 +36,23 @@ namespace dealii
 {
   namespace MeshWorker
   {
-    template <int dim, class Expr, class Test>
-    typename std::enable_if<Test::TensorTraits::rank == 0, void>::type
-    evaluate(DoFInfo<dim, dim>& dinfo, const IntegrationInfo<dim>& info, const Test& test,
-             const Expr& expr, unsigned int q)
-    {
-      static_assert(Expr::TensorTraits::rank == Test::TensorTraits::rank,
-                    "Expression and test function must have equal rank");
-      const unsigned int test_fev = test.id().fe_index;
-      const double e = expr.value(info, q) * info.fe_values(0).JxW(q);
-      for (unsigned int i = 0; i < info.fe_values(test_fev).dofs_per_cell; ++i)
-        dinfo.vector(0).block(test.id().block_index)[i] += e * test.value(i, info, q);
-    }
-
-    template <int dim, class Expr, class Test>
-    typename std::enable_if<Test::TensorTraits::rank == 1, void>::type
-    evaluate(DoFInfo<dim, dim>& dinfo, const IntegrationInfo<dim>& info, const Test& test,
-             const Expr& expr, unsigned int q)
+    /**
+     * The largest difference between the entries of two matrices, taking the
+     * entries outside of the sparsity pattern of the other matrix as zero.
+     */
+    inline double
+    max_difference(const SparseMatrix<double>& a, const SparseMatrix<double>& b)
     {
-      static_assert(Expr::TensorTraits::rank == Test::TensorTraits::rank,
-                    "Expression and test function must have equal rank");
-      const unsigned int test_fev = test.id().fe_index;
-      for (unsigned int d = 0; d < dim; ++d)
-      {
-        const double e = expr.value(d, info, q) * info.fe_values(0).JxW(q);
-        for (unsigned int i = 0; i < info.fe_values(test_fev).dofs_per_cell; ++i)
-          dinfo.vector(0).block(test.id().block_index)[i] += e * test.value(d, i, info, q);
-      }
-    }
-
-    template <int dim, class Expr, class Test>
-    typename std::enable_if<Test::TensorTraits::rank == 2, void>::type
-    evaluate(DoFInfo<dim, dim>& dinfo, const IntegrationInfo<dim>& info, const Test& test,
-             const Expr& expr, unsigned int q)
-    {
-      static_assert(Expr::TensorTraits::rank == Test::TensorTraits::rank,
-                    "Expression and test function must have equal rank");
-      const unsigned int test_fev = test.id().fe_index;
-      for (unsigned int d1 = 0; d1 < dim; ++d1)
-        for (unsigned int d2 = 0; d2 < dim; ++d2)
-        {
-          const double e = expr.value(d1, d2, info, q) * info.fe_values(0).JxW(q);
-          for (unsigned int i = 0; i < info.fe_values(test_fev).dofs_per_cell; ++i)
-            dinfo.vector(0).block(test.id().block_index)[i] += e * test.value(d1, d2, i, info, q);
-        }
+      double difference = 0.;
+      for (auto entry = a.begin(); entry != a.end(); ++entry)
+        difference =
+          std::max(difference, std::abs(entry->value() - b.el(entry->row(), entry->column())));
+      for (auto entry = b.begin(); entry != b.end(); ++entry)
+        difference =
+          std::max(difference, std::abs(entry->value() - a.el(entry->row(), entry->column())));
+      return difference;
     }
 
-    template <FormKind kind, int dim, class FORMS>
-    typename std::enable_if<FORMS::number == 0, void>::type
-    evaluate(DoFInfo<dim, dim>& dinfo, const IntegrationInfo<dim>& info, const FORMS& form,
-             [[maybe_unused]] unsigned int q)
-    {
-      if
-        constexpr(FORMS::form_kind == kind)
-          evaluate(dinfo, info, form.get_form().test(), form.get_form().expr(), q);
-    }
-
-    template <FormKind kind, int dim, class FORMS>
-    typename std::enable_if<FORMS::number != 0, void>::type
-    evaluate(DoFInfo<dim, dim>& dinfo, const IntegrationInfo<dim>& info, const FORMS& form,
-             unsigned int q)
-    {
-      evaluate<kind>(dinfo, info, form.get_other(), q);
-      if
-        constexpr(FORMS::form_kind == kind)
-          evaluate(dinfo, info, form.get_form().test(), form.get_form().expr(), q);
-    }
-
-    template <FormKind kind, int dim, class FORMS>
-    typename std::enable_if<FORMS::number == 0, void>::type
-    evaluate(DoFInfo<dim, dim>& dinfo1, DoFInfo<dim, dim>& dinfo2,
-             const IntegrationInfo<dim>& info1, const IntegrationInfo<dim>& info2,
-             const FORMS& form, [[maybe_unused]] unsigned int q)
-    {
-      if
-        constexpr(FORMS::form_kind == kind)
-          evaluate(dinfo1, dinfo2, info1, info2, form.get_form().test(), form.get_form().expr(), q);
-    }
-
-    template <FormKind kind, int dim, class FORMS>
-    typename std::enable_if<FORMS::number != 0, void>::type
-    evaluate(DoFInfo<dim, dim>& dinfo1, DoFInfo<dim, dim>& dinfo2,
-             const IntegrationInfo<dim>& info1, const IntegrationInfo<dim>& info2,
-             const FORMS& form, unsigned int q)
-    {
-      evaluate<kind>(dinfo1, dinfo2, info1, info2, form.get_other(), q);
-      if
-        constexpr(FORMS::form_kind == kind)
-          evaluate(dinfo1, dinfo2, info1, info2, form.get_form().test(), form.get_form().expr(), q);
-    }
-
-    template <int dim, class FORM>
-    class MeshWorkerIntegrator : public LocalIntegrator<dim>
-    {
-      const FORM& form;
-
-    public:
-      explicit MeshWorkerIntegrator(const FORM& form)
-        : form(form)
-      {
-        this->use_boundary = false;
-        this->use_face = false;
-        // TODO(darndt): Determine from form.
-        this->input_vector_names.push_back("u");
-      }
-
-      void
-      cell(DoFInfo<dim>& dinfo, IntegrationInfo<dim>& info) const override
-      {
-        for (unsigned int k = 0; k < info.fe_values(0).n_quadrature_points; ++k)
-        {
-          evaluate<FormKind::cell>(dinfo, info, form, k);
-        }
-      }
-
-      void
-      boundary(DoFInfo<dim>& dinfo, IntegrationInfo<dim>& info) const override
-      {
-        for (unsigned int k = 0; k < info.fe_values(0).n_quadrature_points; ++k)
-        {
-          evaluate<FormKind::boundary>(dinfo, info, form, k);
-        }
-      }
-
-      void
-      face(DoFInfo<dim>& dinfo1, DoFInfo<dim>& dinfo2, IntegrationInfo<dim>& info1,
-           IntegrationInfo<dim>& info2) const override
-      {
-        for (unsigned int k = 0; k < info1.fe_values(0).n_quadrature_points; ++k)
-        {
-          evaluate<FormKind::face>(dinfo1, dinfo2, info1, info2, form, k);
-        }
-      }
-    };
-
     template <int dim>
     class MeshworkerData
     {
@@ -168,6 +60,20 @@ namespace dealii
       SphericalManifold<dim> sphere;
       Triangulation<dim> tr;
       DoFHandler<dim> dof;
+      SparsityPattern sparsity;
+      /// Cells grouped by color, empty if the cells are not colored
+      std::vector<std::vector<typename DoFHandler<dim>::active_cell_iterator>> colored_cells;
+
+      template <class Integrator, class Assembler>
+      void
+      integrate(DoFInfo<dim>& dof_info, IntegrationInfoBox<dim>& info_box,
+                const Integrator& integrator, Assembler& assembler) const
+      {
+        if (colored_cells.empty())
+          integration_loop(dof.begin_active(), dof.end(), dof_info, info_box, integrator, assembler);
+        else
+          colored_integration_loop(colored_cells, dof_info, info_box, integrator, assembler);
+      }
 
     public:
       MeshworkerData(unsigned int grid_index, unsigned int refine, const FiniteElement<dim>& fe)
@@ -192,6 +98,29 @@ namespace dealii
                 << dof.n_dofs() << std::endl;
       }
 
+      /**
+       * Process the cells color by color in all following loops, such that
+       * threads can add to global vectors and matrices without locks. Set
+       * <code>include_neighbors</code> if the Forms contain face terms.
+       */
+      void
+      use_coloring(bool include_neighbors)
+      {
+        colored_cells = make_coloring(dof, include_neighbors);
+      }
+
+      void
+      disable_coloring()
+      {
+        colored_cells.clear();
+      }
+
+      const DoFHandler<dim>&
+      get_dof_handler() const
+      {
+        return dof;
+      }
+
       void
       resize_vector(Vector<double>& v) const
       {
@@ -225,6 +154,8 @@ namespace dealii
         }
 
         info_box.add_update_flags_all(update_flags);
+        info_box.add_update_flags_boundary(update_normal_vectors);
+        info_box.add_update_flags_face(update_normal_vectors);
         info_box.initialize(dof.get_fe(), this->mapping, in, Vector<double>(), &dof.block_info());
 
         DoFInfo<dim> dof_info(dof.block_info());
@@ -234,7 +165,38 @@ namespace dealii
         assembler.initialize(out);
 
         // Loop call
-        integration_loop(dof.begin_active(), dof.end(), dof_info, info_box, integrator, assembler);
+        integrate(dof_info, info_box, integrator, assembler);
+      }
+
+      template <class Form>
+      void
+      assemble_matrix(SparseMatrix<double>& matrix, const Form& form)
+      {
+        DynamicSparsityPattern dsp(dof.n_dofs());
+        MeshWorkerMatrixIntegrator<dim, Form> integrator(form);
+
+        if (integrator.use_face)
+          DoFTools::make_flux_sparsity_pattern(dof, dsp);
+        else
+          DoFTools::make_sparsity_pattern(dof, dsp);
+        sparsity.copy_from(dsp);
+        matrix.reinit(sparsity);
+
+        UpdateFlags update_flags =
+          update_values | update_gradients | update_hessians | update_JxW_values;
+
+        IntegrationInfoBox<dim> info_box;
+        info_box.add_update_flags_all(update_flags);
+        info_box.add_update_flags_boundary(update_normal_vectors);
+        info_box.add_update_flags_face(update_normal_vectors);
+        info_box.initialize(dof.get_fe(), this->mapping, &dof.block_info());
+
+        DoFInfo<dim> dof_info(dof.block_info());
+
+        Assembler::MatrixSimple<SparseMatrix<double>> assembler;
+        assembler.initialize(matrix);
+
+        integrate(dof_info, info_box, integrator, assembler);
       }
     };
   }
@@ -0,0 +1,154 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "meshworker_data.h"
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/fe_values_extractors.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <cfl/meshworker/forms.h>
+#include <cfl/meshworker/fefunctions.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MeshWorker;
+using namespace ::dealii;
+
+// Assemble the matrix of 2 eps(u) : eps(v) + u . v with FEValues
+template <int dim>
+void
+assemble_reference(const DoFHandler<dim>& dof, SparsityPattern& sparsity,
+                   SparseMatrix<double>& matrix)
+{
+  DynamicSparsityPattern dsp(dof.n_dofs());
+  DoFTools::make_sparsity_pattern(dof, dsp);
+  sparsity.copy_from(dsp);
+  matrix.reinit(sparsity);
+
+  const QGauss<dim> quadrature(dof.get_fe().degree + 1);
+  FEValues<dim> fe_values(
+    dof.get_fe(), quadrature, update_values | update_gradients | update_JxW_values);
+  const FEValuesExtractors::Vector displacement(0);
+  const unsigned int dofs_per_cell = dof.get_fe().dofs_per_cell;
+  FullMatrix<double> cell_matrix(dofs_per_cell, dofs_per_cell);
+  std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
+  for (const auto& cell : dof.active_cell_iterators())
+  {
+    fe_values.reinit(cell);
+    cell_matrix = 0.;
+    for (unsigned int q = 0; q < quadrature.size(); ++q)
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        for (unsigned int j = 0; j < dofs_per_cell; ++j)
+          cell_matrix(i, j) += (2. * (fe_values[displacement].symmetric_gradient(j, q) *
+                                      fe_values[displacement].symmetric_gradient(i, q)) +
+                                fe_values[displacement].value(j, q) *
+                                  fe_values[displacement].value(i, q)) *
+                               fe_values.JxW(q);
+    cell->get_dof_indices(dof_indices);
+    for (unsigned int i = 0; i < dofs_per_cell; ++i)
+      for (unsigned int j = 0; j < dofs_per_cell; ++j)
+        matrix.add(dof_indices[i], dof_indices[j], cell_matrix(i, j));
+  }
+}
+
+// Evaluate a Form summing the rank 2 linear elasticity term
+// 2 eps(u) : eps(v) and the rank 1 mass term u . v. The first version only
+// evaluates the independent components of the symmetric gradients, the
+// second contracts the full gradient of u with eps(v) instead. Check that
+// both give the same residual, that the assembled matrix is symmetric, that
+// it equals the matrix assembled with FEValues and that multiplying it with
+// a vector gives the residual. Since only the independent components of
+// eps(v) are stored, the comparison with FEValues only holds if the
+// off-diagonal components are weighted twice.
+template <int dim>
+void
+run(unsigned int grid_index, unsigned int refine, unsigned int degree)
+{
+  // The outer system makes all components one block of the local data.
+  FESystem<dim> fe(FESystem<dim>(FE_Q<dim>(degree), dim), 1);
+  MeshworkerData<dim> data(grid_index, refine, fe);
+
+  TestFunction<1, dim> v(0, 0);
+  FEFunction<1, dim> u(0, 0);
+
+  auto f = form(symmetric_grad(u), symmetric_grad(v)) * 2. + form(u, v);
+  auto g = form(grad(u), symmetric_grad(v)) * 2. + form(u, v);
+
+  Vector<double> b, residual, residual_full, product;
+  data.resize_vector(b);
+  data.resize_vector(residual);
+  data.resize_vector(residual_full);
+  data.resize_vector(product);
+
+  for (unsigned int i = 0; i < b.size(); ++i)
+    b[i] = i;
+
+  data.vmult(residual, b, f);
+  data.vmult(residual_full, b, g);
+  residual_full -= residual;
+  std::cout << "Symmetric gradient equals full gradient: "
+            << (residual_full.linfty_norm() <= 1.e-12 * residual.linfty_norm() ? "OK" : "FAILED")
+            << std::endl;
+
+  SparseMatrix<double> matrix;
+  data.assemble_matrix(matrix, f);
+  matrix.vmult(product, b);
+
+  double asymmetry = 0.;
+  for (auto entry = matrix.begin(); entry != matrix.end(); ++entry)
+    asymmetry = std::max(asymmetry,
+                         std::abs(entry->value() - matrix.el(entry->column(), entry->row())));
+  std::cout << "Matrix is symmetric: "
+            << (asymmetry <= 1.e-12 * matrix.linfty_norm() ? "OK" : "FAILED") << std::endl;
+
+  SparsityPattern reference_sparsity;
+  SparseMatrix<double> reference;
+  assemble_reference(data.get_dof_handler(), reference_sparsity, reference);
+  std::cout << "Matrix equals FEValues assembly: "
+            << (max_difference(matrix, reference) <= 1.e-12 * reference.linfty_norm() ? "OK"
+                                                                                      : "FAILED")
+            << std::endl;
+
+  product -= residual;
+  std::cout << "Matrix-vector product equals residual: "
+            << (product.linfty_norm() <= 1.e-12 * residual.linfty_norm() ? "OK" : "FAILED")
+            << std::endl;
+}
+
+int
+main()
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2>(0, 0, 1);
+    run<2>(0, 2, 2);
+    run<3>(0, 1, 1);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
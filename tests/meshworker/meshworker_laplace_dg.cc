@@ -0,0 +1,236 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "meshworker_data.h"
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <cfl/meshworker/forms.h>
+#include <cfl/meshworker/fefunctions.h>
+
+#include <array>
+#include <memory>
+
+using namespace CFL;
+using namespace CFL::dealii::MeshWorker;
+using namespace ::dealii;
+
+// Assemble the symmetric interior penalty matrix
+//   (grad u, grad v) + sum_F ([u], [v]) - ({grad u}.n, [v]) - ([u], {grad v}.n)
+//                    + sum_B (2u, v) - (grad u.n, v) - (u, grad v.n)
+// with FEValues, where n is the outward normal of the cell on the + side of
+// the face F and [u] = u^+ - u^-. The mesh has to be uniformly refined.
+template <int dim>
+void
+assemble_sipg(const DoFHandler<dim>& dof, SparsityPattern& sparsity, SparseMatrix<double>& matrix)
+{
+  DynamicSparsityPattern dsp(dof.n_dofs());
+  DoFTools::make_flux_sparsity_pattern(dof, dsp);
+  sparsity.copy_from(dsp);
+  matrix.reinit(sparsity);
+
+  const FiniteElement<dim>& fe = dof.get_fe();
+  const unsigned int dofs_per_cell = fe.dofs_per_cell;
+  const QGauss<dim> quadrature(fe.degree + 1);
+  const QGauss<dim - 1> face_quadrature(fe.degree + 1);
+  FEValues<dim> fe_values(fe, quadrature, update_gradients | update_JxW_values);
+  const UpdateFlags face_flags = update_values | update_gradients | update_quadrature_points |
+                                 update_normal_vectors | update_JxW_values;
+  // the + and - side of a face
+  std::array<std::unique_ptr<FEFaceValues<dim>>, 2> fe_face_values;
+  for (auto& side : fe_face_values)
+    side = std::make_unique<FEFaceValues<dim>>(fe, face_quadrature, face_flags);
+  std::array<std::vector<types::global_dof_index>, 2> dof_indices;
+  for (auto& indices : dof_indices)
+    indices.resize(dofs_per_cell);
+  FullMatrix<double> local_matrix(dofs_per_cell, dofs_per_cell);
+
+  for (const auto& cell : dof.active_cell_iterators())
+  {
+    cell->get_dof_indices(dof_indices[0]);
+    fe_values.reinit(cell);
+    local_matrix = 0.;
+    for (unsigned int q = 0; q < quadrature.size(); ++q)
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        for (unsigned int j = 0; j < dofs_per_cell; ++j)
+          local_matrix(i, j) +=
+            fe_values.shape_grad(j, q) * fe_values.shape_grad(i, q) * fe_values.JxW(q);
+    matrix.add(dof_indices[0], local_matrix);
+
+    for (unsigned int face = 0; face < GeometryInfo<dim>::faces_per_cell; ++face)
+    {
+      const FEFaceValues<dim>& plus = *fe_face_values[0];
+      fe_face_values[0]->reinit(cell, face);
+      if (cell->at_boundary(face))
+      {
+        local_matrix = 0.;
+        for (unsigned int q = 0; q < face_quadrature.size(); ++q)
+          for (unsigned int i = 0; i < dofs_per_cell; ++i)
+            for (unsigned int j = 0; j < dofs_per_cell; ++j)
+            {
+              const Tensor<1, dim> normal = plus.normal_vector(q);
+              local_matrix(i, j) +=
+                ((2. * plus.shape_value(j, q) - plus.shape_grad(j, q) * normal) *
+                   plus.shape_value(i, q) -
+                 plus.shape_value(j, q) * (plus.shape_grad(i, q) * normal)) *
+                plus.JxW(q);
+            }
+        matrix.add(dof_indices[0], local_matrix);
+        continue;
+      }
+
+      // visit each interior face once
+      const auto neighbor = cell->neighbor(face);
+      if (neighbor->index() < cell->index())
+        continue;
+      neighbor->get_dof_indices(dof_indices[1]);
+      fe_face_values[1]->reinit(neighbor, cell->neighbor_of_neighbor(face));
+      for (unsigned int q = 0; q < face_quadrature.size(); ++q)
+        AssertThrow(plus.quadrature_point(q).distance(fe_face_values[1]->quadrature_point(q)) <
+                      1.e-12,
+                    ExcInternalError());
+
+      for (unsigned int test_side = 0; test_side < 2; ++test_side)
+        for (unsigned int trial_side = 0; trial_side < 2; ++trial_side)
+        {
+          const FEFaceValues<dim>& test = *fe_face_values[test_side];
+          const FEFaceValues<dim>& trial = *fe_face_values[trial_side];
+          const double test_sign = test_side == 0 ? 1. : -1.;
+          const double trial_sign = trial_side == 0 ? 1. : -1.;
+          local_matrix = 0.;
+          for (unsigned int q = 0; q < face_quadrature.size(); ++q)
+          {
+            const Tensor<1, dim> normal = plus.normal_vector(q);
+            for (unsigned int i = 0; i < dofs_per_cell; ++i)
+              for (unsigned int j = 0; j < dofs_per_cell; ++j)
+              {
+                const double trial_jump = trial_sign * trial.shape_value(j, q);
+                const double test_jump = test_sign * test.shape_value(i, q);
+                local_matrix(i, j) += (trial_jump * test_jump -
+                                       .5 * (trial.shape_grad(j, q) * normal) * test_jump -
+                                       trial_jump * .5 * (test.shape_grad(i, q) * normal)) *
+                                      plus.JxW(q);
+              }
+          }
+          matrix.add(dof_indices[test_side], dof_indices[trial_side], local_matrix);
+        }
+    }
+  }
+}
+
+// Evaluate the symmetric interior penalty form for the Laplacian of
+// applications/matrixfree/matrixfree_laplace_dg.cc with the MeshWorker
+// backend. Check that the assembled matrix is symmetric, that it equals the
+// matrix assembled by hand and that multiplying it with a vector gives the
+// same result as evaluating the form for this vector. The comparison with
+// the hand-assembled matrix only holds if the normal derivatives on the
+// exterior side use the outward normal of the exterior cell.
+template <int dim>
+void
+run(unsigned int grid_index, unsigned int refine, unsigned int degree)
+{
+  FE_DGQ<dim> fe(degree);
+  MeshworkerData<dim> data(grid_index, refine, fe);
+
+  TestFunction<0, dim> v(0, 0);
+  auto Dv = grad(v);
+  TestFunctionInteriorFace<0, dim> v_p(0, 0);
+  TestFunctionExteriorFace<0, dim> v_m(0, 0);
+  TestNormalGradientInteriorFace<0, dim> Dnv_p(0, 0);
+  TestNormalGradientExteriorFace<0, dim> Dnv_m(0, 0);
+
+  FEFunction<0, dim> u(0, 0);
+  auto Du = grad(u);
+  FEFunctionInteriorFace<0, dim> u_p(0, 0);
+  FEFunctionExteriorFace<0, dim> u_m(0, 0);
+  FENormalGradientInteriorFace<0, dim> Dnu_p(0, 0);
+  FENormalGradientExteriorFace<0, dim> Dnu_m(0, 0);
+
+  auto cell = CFL::dealii::MeshWorker::form(Du, Dv);
+
+  auto flux = u_p - u_m;
+  auto flux_grad = Dnu_p - Dnu_m;
+
+  auto flux1 = -CFL::dealii::MeshWorker::face_form(flux, Dnv_p) +
+               CFL::dealii::MeshWorker::face_form(flux, Dnv_m);
+  auto flux2 = CFL::dealii::MeshWorker::face_form(-flux + .5 * flux_grad, v_p) -
+               CFL::dealii::MeshWorker::face_form(-flux + .5 * flux_grad, v_m);
+
+  auto boundary1 = CFL::dealii::MeshWorker::boundary_form(2. * u_p - Dnu_p, v_p);
+  auto boundary3 = -CFL::dealii::MeshWorker::boundary_form(u_p, Dnv_p);
+
+  auto face = -flux2 + .5 * flux1;
+  auto f = cell + face + boundary1 + boundary3;
+
+  Vector<double> b, residual, product;
+  data.resize_vector(b);
+  data.resize_vector(residual);
+  data.resize_vector(product);
+
+  for (unsigned int i = 0; i < b.size(); ++i)
+    b[i] = i;
+
+  data.vmult(residual, b, f);
+
+  SparseMatrix<double> matrix;
+  data.assemble_matrix(matrix, f);
+  matrix.vmult(product, b);
+
+  double asymmetry = 0.;
+  for (auto entry = matrix.begin(); entry != matrix.end(); ++entry)
+    asymmetry = std::max(asymmetry,
+                         std::abs(entry->value() - matrix.el(entry->column(), entry->row())));
+  std::cout << "Matrix is symmetric: "
+            << (asymmetry <= 1.e-12 * matrix.linfty_norm() ? "OK" : "FAILED") << std::endl;
+
+  SparsityPattern reference_sparsity;
+  SparseMatrix<double> reference;
+  assemble_sipg(data.get_dof_handler(), reference_sparsity, reference);
+  std::cout << "Matrix equals hand-assembled SIPG matrix: "
+            << (max_difference(matrix, reference) <= 1.e-12 * reference.linfty_norm() ? "OK"
+                                                                                      : "FAILED")
+            << std::endl;
+
+  product -= residual;
+  std::cout << "Matrix-vector product equals residual: "
+            << (product.linfty_norm() <= 1.e-12 * residual.linfty_norm() ? "OK" : "FAILED")
+            << std::endl;
+}
+
+int
+main()
+{
+  deallog.depth_console(10);
+  try
+  {
+    run<2>(0, 0, 1);
+    run<2>(0, 2, 2);
+    run<3>(0, 1, 1);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
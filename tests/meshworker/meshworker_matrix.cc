@@ -0,0 +1,188 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include "meshworker_data.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <cfl/meshworker/forms.h>
+#include <cfl/meshworker/fefunctions.h>
+
+using namespace CFL;
+using namespace CFL::dealii::MeshWorker;
+using namespace ::dealii;
+
+// u + 1, an affine expression without a matrix
+template <int dim>
+class ShiftedFEFunction
+{
+  const FEFunction<0, dim> u;
+
+public:
+  using TensorTraits = CFL::Traits::Tensor<0, dim>;
+
+  explicit ShiftedFEFunction(const FEFunction<0, dim>& u)
+    : u(u)
+  {
+  }
+
+  template <typename... Args>
+  double
+  value(const Args&... args) const
+  {
+    return 1. + u.value(args...);
+  }
+};
+
+namespace CFL::Traits
+{
+template <int dim>
+struct fe_function_set_type<ShiftedFEFunction<dim>>
+{
+  static const ObjectType value = ObjectType::cell;
+};
+}
+
+// matrix assembly rejects products of finite element functions at compile time
+template <class Expr>
+using is_linear = CFL::dealii::MeshWorker::internal::is_linear<Expr>;
+static_assert(is_linear<CFL::Base::SumFEFunctions<FEFunction<0, 2>, FEFunction<0, 2>>>::value,
+              "Sums of finite element functions are linear");
+static_assert(!is_linear<CFL::Base::ProductFEFunctions<FEFunction<0, 2>, FEFunction<0, 2>>>::value,
+              "Products of finite element functions are not linear");
+
+// Assemble 3(grad u, grad v) - (u, v) + (hess u, hess v) cell by cell with FEValues.
+template <int dim>
+void
+assemble_reference(const DoFHandler<dim>& dof, SparsityPattern& sparsity,
+                   SparseMatrix<double>& matrix)
+{
+  DynamicSparsityPattern dsp(dof.n_dofs());
+  DoFTools::make_sparsity_pattern(dof, dsp);
+  sparsity.copy_from(dsp);
+  matrix.reinit(sparsity);
+
+  const QGauss<dim> quadrature(dof.get_fe().degree + 1);
+  FEValues<dim> fe_values(dof.get_fe(),
+                          quadrature,
+                          update_values | update_gradients | update_hessians | update_JxW_values);
+  const unsigned int dofs_per_cell = dof.get_fe().dofs_per_cell;
+  FullMatrix<double> cell_matrix(dofs_per_cell, dofs_per_cell);
+  std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
+  for (const auto& cell : dof.active_cell_iterators())
+  {
+    fe_values.reinit(cell);
+    cell_matrix = 0.;
+    for (unsigned int q = 0; q < quadrature.size(); ++q)
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        for (unsigned int j = 0; j < dofs_per_cell; ++j)
+          cell_matrix(i, j) +=
+            (3. * (fe_values.shape_grad(j, q) * fe_values.shape_grad(i, q)) -
+             fe_values.shape_value(j, q) * fe_values.shape_value(i, q) +
+             scalar_product(fe_values.shape_hessian(j, q), fe_values.shape_hessian(i, q))) *
+            fe_values.JxW(q);
+    cell->get_dof_indices(dof_indices);
+    for (unsigned int i = 0; i < dofs_per_cell; ++i)
+      for (unsigned int j = 0; j < dofs_per_cell; ++j)
+        matrix.add(dof_indices[i], dof_indices[j], cell_matrix(i, j));
+  }
+}
+
+// Assemble the matrix of a linear form, compare it to the matrix assembled
+// with FEValues and check that multiplying it with a vector gives the same
+// result as evaluating the form for this vector. An affine form has to be
+// rejected.
+template <int dim>
+void
+run(unsigned int grid_index, unsigned int refine, unsigned int degree)
+{
+  FE_Q<dim> fe(degree);
+  MeshworkerData<dim> data(grid_index, refine, fe);
+
+  TestFunction<0, dim> v(0, 0);
+  FEFunction<0, dim> u(0, 0);
+  auto Dv = grad(v);
+  auto Du = grad(u);
+  auto f = 3.*CFL::dealii::MeshWorker::form(Du, Dv) - CFL::dealii::MeshWorker::form(u,v) + CFL::dealii::MeshWorker::form(grad(Du), grad(Dv));
+
+  Vector<double> b, residual, product;
+  data.resize_vector(b);
+  data.resize_vector(residual);
+  data.resize_vector(product);
+
+  for (unsigned int i = 0; i < b.size(); ++i)
+    b[i] = i;
+
+  data.vmult(residual, b, f);
+
+  SparseMatrix<double> matrix;
+  data.assemble_matrix(matrix, f);
+  matrix.vmult(product, b);
+
+  SparsityPattern reference_sparsity;
+  SparseMatrix<double> reference;
+  assemble_reference(data.get_dof_handler(), reference_sparsity, reference);
+  std::cout << "Matrix equals FEValues assembly: "
+            << (max_difference(matrix, reference) <= 1.e-12 * reference.linfty_norm() ? "OK"
+                                                                                      : "FAILED")
+            << std::endl;
+
+  product -= residual;
+  std::cout << "Matrix-vector product equals residual: "
+            << (product.linfty_norm() <= 1.e-12 * residual.linfty_norm() ? "OK" : "FAILED")
+            << std::endl;
+
+  auto affine = CFL::dealii::MeshWorker::form(ShiftedFEFunction<dim>(u), v);
+  bool rejected = false;
+  try
+  {
+    SparseMatrix<double> affine_matrix;
+    data.assemble_matrix(affine_matrix, affine);
+  }
+  catch (const ExceptionBase&)
+  {
+    rejected = true;
+  }
+  std::cout << "Affine form rejected: " << (rejected ? "OK" : "FAILED") << std::endl;
+}
+
+int
+main()
+{
+  deallog.depth_console(10);
+  // exceptions thrown by the local integrators only reach the caller in serial loops
+  MultithreadInfo::set_thread_limit(1);
+  try
+  {
+    run<2>(0, 0, 1);
+    run<2>(0, 2, 2);
+    run<3>(0, 1, 1);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+  catch (...)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Unknown exception!" << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,96 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <cfl/reference/forms.h>
+#include <cfl/reference/reference_integrator.h>
+#include <cfl/reference/solver_cg.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace CFL;
+using namespace CFL::Reference;
+
+// Solve -Laplace u = f on the unit hypercube with homogeneous Dirichlet
+// boundary conditions and the solution u = sin(pi x) sin(pi y) ... with
+// the CG method. The right hand side is the mass matrix applied to the
+// interpolant of f. Check that the error in the support points decreases
+// at least with order degree + 1 under refinement.
+template <int dim, int degree>
+double
+solve(unsigned int n_cells_1d)
+{
+  const double pi = std::acos(-1.);
+  CartesianGrid<dim> grid(n_cells_1d, degree);
+
+  constexpr Base::TestFunction<0, dim, 0> v;
+  constexpr Base::FEFunction<0, dim, 0> u;
+  auto laplace = transform(Base::form(grad(u), grad(v)));
+  auto mass = transform(Base::form(u, v));
+
+  ReferenceIntegrator<dim, degree, degree + 1, decltype(laplace)> laplace_integrator(grid,
+                                                                                    laplace);
+  ReferenceIntegrator<dim, degree, degree + 1, decltype(mass)> mass_integrator(grid, mass);
+  const std::vector<unsigned int> boundary_dofs = grid.boundary_dofs();
+  laplace_integrator.set_constrained_dofs(boundary_dofs);
+
+  const auto& support_points = laplace_integrator.get_shape_info().support_points;
+  std::vector<double> exact(grid.n_dofs()), f(grid.n_dofs()), b, x;
+  for (unsigned int i = 0; i < grid.n_dofs(); ++i)
+  {
+    const auto point = grid.support_point(i, support_points);
+    exact[i] = 1.;
+    for (unsigned int d = 0; d < dim; ++d)
+      exact[i] *= std::sin(pi * point[d]);
+    f[i] = dim * pi * pi * exact[i];
+  }
+  mass_integrator.vmult(b, f);
+  for (const unsigned int i : boundary_dofs)
+    b[i] = 0.;
+
+  SolverCG solver(1000, 1.e-12);
+  solver.solve(laplace_integrator, x, b);
+
+  double error = 0.;
+  for (unsigned int i = 0; i < grid.n_dofs(); ++i)
+    error = std::max(error, std::abs(x[i] - exact[i]));
+  return error;
+}
+
+template <int dim, int degree>
+void
+run(unsigned int n_cells_1d)
+{
+  const double coarse = solve<dim, degree>(n_cells_1d);
+  const double fine = solve<dim, degree>(2 * n_cells_1d);
+  const double rate = std::log2(coarse / fine);
+  std::cout << "dim " << dim << " degree " << degree << " convergence rate at least "
+            << degree + 1 << ": " << (rate >= degree + .8 ? "OK" : "FAILED") << std::endl;
+}
+
+int
+main()
+{
+  try
+  {
+    run<2, 1>(4);
+    run<2, 2>(4);
+    run<3, 1>(4);
+    run<3, 2>(2);
+  }
+  catch (std::exception& exc)
+  {
+    std::cerr << std::endl
+              << std::endl
+              << "----------------------------------------------------" << std::endl;
+    std::cerr << "Exception on processing: " << std::endl
+              << exc.what() << std::endl
+              << "Aborting!" << std::endl
+              << "----------------------------------------------------" << std::endl;
+
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <cfl/reference/forms.h>
+#include <cfl/reference/reference_integrator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace CFL;
+using namespace CFL::Reference;
+
+// Apply the operator of the Form (grad u, grad v) + 2 (u, v) with sum
+// factorization and compare with the product of the assembled cell
+// matrices, which are computed from the full tensor product basis without
+// any factorization. The number of cells is no multiple of the
+// vectorization width, such that the last batch is partially filled.
+template <int dim, int degree>
+void
+run(unsigned int n_cells_1d)
+{
+  CartesianGrid<dim> grid(n_cells_1d, degree);
+  std::cout << "dim " << dim << " degree " << degree << " Cells " << grid.n_cells() << " DoFs "
+            << grid.n_dofs() << std::endl;
+
+  constexpr Base::TestFunction<0, dim, 0> v;
+  constexpr Base::FEFunction<0, dim, 0> u;
+  auto f = transform(Base::form(grad(u), grad(v)) + Base::form(2. * u, v));
+  ReferenceIntegrator<dim, degree, degree + 1, decltype(f)> integrator(grid, f);
+
+  std::vector<double> src(grid.n_dofs()), dst, reference(grid.n_dofs());
+  for (unsigned int i = 0; i < src.size(); ++i)
+    src[i] = std::sin(1.3 * i);
+  integrator.vmult(dst, src);
+
+  const ShapeInfo& shape_info = integrator.get_shape_info();
+  const unsigned int n = shape_info.n_dofs_1d;
+  const unsigned int nq = shape_info.n_q_points_1d;
+  const unsigned int dofs_per_cell = grid.dofs_per_cell();
+  unsigned int n_q_points = 1;
+  for (unsigned int d = 0; d < dim; ++d)
+    n_q_points *= nq;
+
+  std::vector<unsigned int> indices;
+  for (unsigned int cell = 0; cell < grid.n_cells(); ++cell)
+  {
+    grid.get_dof_indices(cell, indices);
+    for (unsigned int i = 0; i < dofs_per_cell; ++i)
+      for (unsigned int j = 0; j < dofs_per_cell; ++j)
+      {
+        double entry = 0.;
+        for (unsigned int q = 0; q < n_q_points; ++q)
+        {
+          double JxW = 1., value_i = 1., value_j = 1.;
+          double gradient_i[dim], gradient_j[dim];
+          for (unsigned int d = 0; d < dim; ++d)
+            gradient_i[d] = gradient_j[d] = 1. / grid.h;
+          for (unsigned int d = 0, qq = q, ii = i, jj = j; d < dim;
+               ++d, qq /= nq, ii /= n, jj /= n)
+          {
+            const unsigned int q1 = qq % nq, i1 = ii % n, j1 = jj % n;
+            JxW *= shape_info.quadrature_weights[q1] * grid.h;
+            value_i *= shape_info.shape_values[q1 * n + i1];
+            value_j *= shape_info.shape_values[q1 * n + j1];
+            for (unsigned int e = 0; e < dim; ++e)
+            {
+              const auto& shape = (e == d) ? shape_info.shape_gradients : shape_info.shape_values;
+              gradient_i[e] *= shape[q1 * n + i1];
+              gradient_j[e] *= shape[q1 * n + j1];
+            }
+          }
+          double gradient_product = 0.;
+          for (unsigned int e = 0; e < dim; ++e)
+            gradient_product += gradient_i[e] * gradient_j[e];
+          entry += (gradient_product + 2. * value_i * value_j) * JxW;
+        }
+        reference[indices[i]] += entry * src[indices[j]];
+      }
+  }
+
+  double error = 0., norm = 0.;
+  for (unsigned int i = 0; i < dst.size(); ++i)
+  {
+    error = std::max(error, std::abs(dst[i] - reference[i]));
+    norm = std::max(norm, std::abs(reference[i]));
+  }
+  std::cout << "Sum factorization equals assembled matrix: "
+            << (error <= 1.e-12 * norm ? "OK" : "FAILED") << std::endl;
+}
+
+int
+main()
+{
+  run<1, 3>(5);
+  run<2, 1>(3);
+  run<2, 4>(3);
+  run<3, 1>(3);
+  run<3, 3>(2);
+
+  return 0;
+}
@@ -0,0 +1,56 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <cfl/reference/shape_info.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace CFL::Reference;
+
+// Check that the Gauss quadrature integrates polynomials of degree
+// 2n-1 exactly and that the Lagrange basis on the Gauss-Lobatto points is
+// a partition of unity with interpolation property.
+int
+main()
+{
+  for (unsigned int n = 1; n <= 8; ++n)
+  {
+    const auto [points, weights] = gauss_quadrature(n);
+    double error = 0.;
+    for (unsigned int k = 0; k < 2 * n; ++k)
+    {
+      double integral = 0.;
+      for (unsigned int q = 0; q < n; ++q)
+        integral += weights[q] * std::pow(points[q], k);
+      error = std::max(error, std::abs(integral - 1. / (k + 1)));
+    }
+    std::cout << "Gauss " << n << " points exact: " << (error < 1.e-14 ? "OK" : "FAILED")
+              << std::endl;
+  }
+
+  for (unsigned int degree = 1; degree <= 8; ++degree)
+  {
+    const ShapeInfo shape_info(degree, degree + 1);
+    double error = 0.;
+    for (unsigned int i = 0; i <= degree; ++i)
+      for (unsigned int j = 0; j <= degree; ++j)
+        error = std::max(
+          error, std::abs(shape_info.value(i, shape_info.support_points[j]) - (i == j ? 1. : 0.)));
+    for (unsigned int q = 0; q < shape_info.n_q_points_1d; ++q)
+    {
+      double sum = 0., sum_derivatives = 0.;
+      for (unsigned int i = 0; i <= degree; ++i)
+      {
+        sum += shape_info.shape_values[q * shape_info.n_dofs_1d + i];
+        sum_derivatives += shape_info.shape_gradients[q * shape_info.n_dofs_1d + i];
+      }
+      error = std::max({ error, std::abs(sum - 1.), std::abs(sum_derivatives) });
+    }
+    std::cout << "Lagrange degree " << degree << ": " << (error < 1.e-12 ? "OK" : "FAILED")
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <cfl/reference/forms.h>
+#include <cfl/reference/reference_integrator.h>
+#include <cfl/runtime/kernel_cache.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+
+using namespace CFL;
+
+// the library may be compiled with other flags than this program
+bool
+equal(const std::vector<double>& a, const std::vector<double>& b)
+{
+  double difference = 0.;
+  for (unsigned int i = 0; i < a.size(); ++i)
+    difference = std::max(difference, std::abs(a[i] - b[i]));
+  return a.size() == b.size() && difference < 1.e-12;
+}
+
+int
+main()
+{
+  const std::filesystem::path directory =
+    std::filesystem::temp_directory_path() / ("cfl_kernel_cache_" + std::to_string(getpid()));
+
+  constexpr int dim = 2;
+  constexpr int degree = 2;
+  constexpr Base::FEFunction<0, dim, 0> u;
+  constexpr Base::TestFunction<0, dim, 0> v;
+  const auto f = Reference::transform(form(grad(u), grad(v)) + 2. * form(u * u, v));
+  Reference::CartesianGrid<dim> grid(3, degree);
+  Reference::ReferenceIntegrator<dim, degree, degree + 1, decltype(f)> integrator(grid, f);
+
+  std::vector<double> src(grid.n_dofs()), dst, dst_runtime;
+  for (unsigned int i = 0; i < src.size(); ++i)
+    src[i] = std::sin(0.3 * i);
+  integrator.vmult(dst, src);
+
+  {
+    Runtime::KernelCache cache(directory.string());
+    const auto op = cache.create_operator("form(grad(u), grad(v)) + 2 * form(u * u, v)", dim,
+                                          degree, 3);
+    op->vmult(dst_runtime, src);
+    std::cout << "Compiled operator equals templates: "
+              << (equal(dst, dst_runtime) ? "OK" : "FAILED") << std::endl;
+    std::cout << "Compilations: " << cache.n_compilations() << std::endl;
+
+    // the same Form with a different formatting is taken from the cache
+    cache.create_operator("form(grad(u),grad(v))+2*form(u*u,v)", dim, degree, 4);
+    std::cout << "Compilations after reformatting: " << cache.n_compilations() << std::endl;
+  }
+
+  {
+    // a new cache object, e.g. in a later run, loads the library from disk
+    Runtime::KernelCache cache(directory.string());
+    const auto op = cache.create_operator("form(grad(u), grad(v)) + 2 * form(u * u, v)", dim,
+                                          degree, 3);
+    op->vmult(dst_runtime, src);
+    std::cout << "Compilations in a new cache: " << cache.n_compilations() << std::endl;
+    std::cout << "Loaded operator equals templates: " << (equal(dst, dst_runtime) ? "OK" : "FAILED")
+              << std::endl;
+
+    try
+    {
+      cache.create_operator("face_form(u, v)", dim, degree, 3);
+    }
+    catch (const std::invalid_argument& e)
+    {
+      std::cout << e.what() << std::endl;
+    }
+
+    try
+    {
+      // the reference backend cannot evaluate second derivatives
+      cache.create_operator("form(div(grad(u)), v)", dim, degree, 3);
+      std::cout << "Compilation error detected: FAILED" << std::endl;
+    }
+    catch (const std::runtime_error&)
+    {
+      std::cout << "Compilation error detected: OK" << std::endl;
+    }
+  }
+
+  // neither successful nor failed compilations leave sources or logs behind
+  unsigned int n_files = 0;
+  for (const auto& file : std::filesystem::directory_iterator(directory))
+    if (file.path().extension() != ".so")
+      ++n_files;
+  std::cout << "Files besides the libraries: " << n_files << std::endl;
+
+  std::filesystem::remove_all(directory);
+  return 0;
+}
@@ -0,0 +1,45 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+#include <cfl/runtime/parser.h>
+
+#include <iostream>
+
+using namespace CFL;
+
+void
+parse(const std::string& text)
+{
+  try
+  {
+    std::cout << Runtime::parse_form(text).print() << std::endl;
+  }
+  catch (const std::invalid_argument& e)
+  {
+    std::cout << e.what() << std::endl;
+  }
+}
+
+int
+main()
+{
+  parse("form(u, v)");
+  parse("form(grad(u),grad(v)) + 2*form(u*u, v)");
+  parse("  form( grad( u ) , grad( v ) )+2 * form( u * u , v )  ");
+  parse("form(v, -u + 0.5 * u * u) * 1e-3");
+  parse("form(div(grad(u)), v) + face_form(u, v) + boundary_form(u, v)");
+  parse("form(u - 2 * (u - u), v)");
+
+  parse("form(u, u)");
+  parse("form(u, v) - form(u, v)");
+  parse("u * v");
+  parse("grad(u)");
+  parse("form(u, v) * u");
+  parse("-form(u, v)");
+  parse("form(w, v)");
+  parse("curl(u)");
+  parse("form(u, v");
+  parse("form(u, v))");
+
+  return 0;
+}
@@ -0,0 +1,22 @@
+#!/bin/bash
+# Measures the time needed to compile tests/matrixfree/matrixfree_many_forms.cc
+# for different numbers of species. FLAGS has to provide the include
+# directories of deal.II. Passing the path of another checkout compares the
+# headers of that checkout with the ones of this one, e.g.
+#   git worktree add /tmp/cfl-old <commit>
+#   FLAGS="-std=c++17 -O2 -I$DEAL_II_DIR/include" tools/benchmark_forms.sh /tmp/cfl-old
+CXX=${CXX:-g++}
+FLAGS=${FLAGS:-"-std=c++17 -O2"}
+SPECIES=${SPECIES:-"10 20 40 80"}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+TREES="$ROOT $*"
+
+for n in $SPECIES; do
+  for tree in $TREES; do
+    start=$(date +%s%N)
+    $CXX $FLAGS -DCFL_N_SPECIES="$n" -I"$tree/include" -c \
+      "$ROOT/tests/matrixfree/matrixfree_many_forms.cc" -o /dev/null || exit 1
+    end=$(date +%s%N)
+    printf "%4d species  %6d ms  %s\n" "$n" $(((end - start) / 1000000)) "$tree"
+  done
+done